@@ -157,6 +157,15 @@ public abstract class CommandCodeGenerator {
         this.openWireOpCode = openWireOpCode;
     }
 
+    /**
+     * Returns true for a property whose member and accessors are generated by the
+     * subclass instead of the default code, the property is still marshaled, printed
+     * and compared through its getter and setter.
+     */
+    protected boolean isCustomProperty( JProperty property ) {
+        return false;
+    }
+
     protected String toHeaderFileName( JClass type ) {
         String name = type.getSimpleName();
 
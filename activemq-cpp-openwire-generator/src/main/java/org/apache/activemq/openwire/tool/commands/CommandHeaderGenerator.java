@@ -208,6 +208,10 @@ public class CommandHeaderGenerator extends CommandCodeGenerator {
         out.println("");
 
         for (JProperty property : getProperties()) {
+            if (isCustomProperty(property)) {
+                continue;
+            }
+
             String type = toCppType(property.getType());
             String name = decapitalize(property.getSimpleName());
 
@@ -241,6 +245,10 @@ public class CommandHeaderGenerator extends CommandCodeGenerator {
     protected void generatePropertyAccessors(PrintWriter out) {
 
         for (JProperty property : getProperties()) {
+            if (isCustomProperty(property)) {
+                continue;
+            }
+
             String type = toCppType(property.getType());
             String propertyName = property.getSimpleName();
             String parameterName = decapitalize(propertyName);
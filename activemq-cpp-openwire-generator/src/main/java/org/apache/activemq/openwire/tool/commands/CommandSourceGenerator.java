@@ -183,7 +183,7 @@ public class CommandSourceGenerator extends CommandCodeGenerator {
         if (isHashable()) {
             out.println("////////////////////////////////////////////////////////////////////////////////");
             out.println("int " + getClassName() + "::getHashCode() const {");
-            out.println("    return decaf::util::HashCode<std::string>()(this->toString());");
+            generateHashCodeBody(out);
             out.println("}");
             out.println("");
         }
@@ -236,6 +236,10 @@ public class CommandSourceGenerator extends CommandCodeGenerator {
 
         int lastLineEnds = 0;
         for( JProperty property : getProperties() ) {
+            if( isCustomProperty(property) ) {
+                continue;
+            }
+
             String value = toCppDefaultValue(property.getType());
             String propertyName = property.getSimpleName();
             String parameterName = decapitalize(propertyName);
@@ -273,6 +277,10 @@ public class CommandSourceGenerator extends CommandCodeGenerator {
 
     protected void generateCopyDataStructureBody( PrintWriter out ) {
         for( JProperty property : getProperties() ) {
+            if( isCustomProperty(property) ) {
+                continue;
+            }
+
             String getter = property.getGetter().getSimpleName();
             String setter = property.getSetter().getSimpleName();
             out.println("    this->"+setter+"(srcPtr->"+getter+"());");
@@ -425,6 +433,9 @@ public class CommandSourceGenerator extends CommandCodeGenerator {
 
     protected void generatePropertyAccessors( PrintWriter out ) {
         for( JProperty property : getProperties() ) {
+            if( isCustomProperty(property) ) {
+                continue;
+            }
 
             String type = toCppType(property.getType());
             String propertyName = property.getSimpleName();
@@ -490,7 +501,8 @@ public class CommandSourceGenerator extends CommandCodeGenerator {
                 out.println("    }");
                 out.println("");
             } else if( property.getType().getSimpleName().equals("String") ) {
-                out.println("    int "+parameterName+"Comp = StringUtils::compareIgnoreCase(this->"+parameterName+".c_str(), value."+parameterName+".c_str());");
+                out.println("    int "+parameterName+"Comp = this->"+parameterName+" == value."+parameterName+" ? 0 :");
+                out.println("        StringUtils::compareIgnoreCase(this->"+parameterName+".c_str(), value."+parameterName+".c_str());");
                 out.println("    if ("+parameterName+"Comp != 0) {");
                 out.println("        return "+parameterName+"Comp;");
                 out.println("    }");
@@ -506,6 +518,10 @@ public class CommandSourceGenerator extends CommandCodeGenerator {
         }
     }
 
+    protected void generateHashCodeBody( PrintWriter out ) {
+        out.println("    return decaf::util::HashCode<std::string>()(this->toString());");
+    }
+
     protected void generateAdditionalMethods( PrintWriter out ) {}
 
 }
@@ -59,4 +59,9 @@ public class ConnectionIdSourceGenerator extends CommandSourceGenerator {
     protected void generateToStringBody( PrintWriter out ) {
         out.println("    return this->value;");
     }
+
+    protected void generateHashCodeBody( PrintWriter out ) {
+        out.println("    return decaf::util::HashCode<std::string>()(this->value);");
+    }
+
 }
@@ -71,4 +71,12 @@ public class ConsumerIdSourceGenerator extends CommandSourceGenerator {
         out.println("    return stream.str();");
     }
 
+    protected void generateHashCodeBody( PrintWriter out ) {
+        out.println("    // Hashed from the fields so no string is built to look the id up.");
+        out.println("    int result = decaf::util::HashCode<std::string>()(this->connectionId);");
+        out.println("    result = 31 * result + decaf::util::HashCode<long long>()(this->sessionId);");
+        out.println("    result = 31 * result + decaf::util::HashCode<long long>()(this->value);");
+        out.println("    return result;");
+    }
+
 }
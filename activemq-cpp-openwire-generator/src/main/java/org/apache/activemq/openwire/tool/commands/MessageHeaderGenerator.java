@@ -19,8 +19,14 @@ package org.apache.activemq.openwire.tool.commands;
 import java.io.PrintWriter;
 import java.util.Set;
 
+import org.codehaus.jam.JProperty;
+
 public class MessageHeaderGenerator extends CommandHeaderGenerator {
 
+    protected boolean isCustomProperty( JProperty property ) {
+        return property.getSimpleName().equals("Content");
+    }
+
     protected void populateIncludeFilesSet() {
 
         super.populateIncludeFilesSet();
@@ -51,8 +57,16 @@ public class MessageHeaderGenerator extends CommandHeaderGenerator {
         out.println("        Pointer<core::ActiveMQAckHandler> ackHandler;");
         out.println("");
         out.println("        // Message properties, these are Marshaled and Unmarshaled from the Message");
-        out.println("        // Command's marshaledProperties vector.");
-        out.println("        activemq::util::PrimitiveMap properties;");
+        out.println("        // Command's marshaledProperties vector.  A received Message keeps only the");
+        out.println("        // marshaled form until the properties are first accessed.");
+        out.println("        mutable activemq::util::PrimitiveMap properties;");
+        out.println("");
+        out.println("        // Indicates if the properties map holds the decoded marshaledProperties.");
+        out.println("        mutable bool propertiesUnmarshalled;");
+        out.println("");
+        out.println("        // Indicates if the properties map may differ from marshaledProperties and");
+        out.println("        // so must be marshaled again before the Message is sent.");
+        out.println("        bool propertiesModified;");
         out.println("");
         out.println("        // Indicates if the Message Properties are Read Only");
         out.println("        bool readOnlyProperties;");
@@ -60,6 +74,14 @@ public class MessageHeaderGenerator extends CommandHeaderGenerator {
         out.println("        // Indicates if the Message Body are Read Only");
         out.println("        bool readOnlyBody;");
         out.println("");
+        out.println("        // The Message body, copies of a Message share it until one of them asks");
+        out.println("        // to modify it.");
+        out.println("        Pointer< std::vector<unsigned char> > content;");
+        out.println("");
+        out.println("        // Indicates if the content may be shared with another Message, both sides");
+        out.println("        // of a copy are marked so the source is mutable.");
+        out.println("        mutable bool contentShared;");
+        out.println("");
         out.println("    protected:");
         out.println("");
         out.println("        core::ActiveMQConnection* connection;");
@@ -165,16 +187,27 @@ public class MessageHeaderGenerator extends CommandHeaderGenerator {
         out.println("");
         out.println("        /**");
         out.println("         * Gets a reference to the Message's Properties object, allows the derived");
-        out.println("         * classes to get and set their own specific properties.");
+        out.println("         * classes to get and set their own specific properties.  The properties of a");
+        out.println("         * received Message are unmarshaled on the first call and, since the map may");
+        out.println("         * be changed through the returned reference, are marshaled again when the");
+        out.println("         * Message is next sent.");
         out.println("         *");
         out.println("         * @return a reference to the Primitive Map that holds message properties.");
+        out.println("         *");
+        out.println("         * @throws IOException if the marshaled properties cannot be read.");
         out.println("         */");
-        out.println("        util::PrimitiveMap& getMessageProperties() {");
-        out.println("            return this->properties;");
-        out.println("        }");
-        out.println("        const util::PrimitiveMap& getMessageProperties() const {");
-        out.println("            return this->properties;");
-        out.println("        }");
+        out.println("        util::PrimitiveMap& getMessageProperties();");
+        out.println("");
+        out.println("        /**");
+        out.println("         * Gets a read only reference to the Message's Properties object, the marshaled");
+        out.println("         * properties of a received Message are unmarshaled on the first call and are");
+        out.println("         * sent again unchanged if the Message is forwarded.");
+        out.println("         *");
+        out.println("         * @return a const reference to the Primitive Map that holds message properties.");
+        out.println("         *");
+        out.println("         * @throws IOException if the marshaled properties cannot be read.");
+        out.println("         */");
+        out.println("        const util::PrimitiveMap& getMessageProperties() const;");
         out.println("");
         out.println("        /**");
         out.println("         * Returns if the Message Properties Are Read Only");
@@ -208,6 +241,32 @@ public class MessageHeaderGenerator extends CommandHeaderGenerator {
         out.println("            this->readOnlyBody = value;");
         out.println("        }");
         out.println("");
+        out.println("        /**");
+        out.println("         * Gets the Message body, which may be shared with copies of this Message");
+        out.println("         * and so must not be modified through a cast.");
+        out.println("         *");
+        out.println("         * @return a const reference to the Message body.");
+        out.println("         */");
+        out.println("        virtual const std::vector<unsigned char>& getContent() const;");
+        out.println("");
+        out.println("        /**");
+        out.println("         * Gets the Message body for modification, a body still shared with a copy");
+        out.println("         * of this Message is copied first so that the change is seen only by this");
+        out.println("         * Message.  The returned reference must not be used to modify the body after");
+        out.println("         * this Message has been copied again.");
+        out.println("         *");
+        out.println("         * @return a reference to the Message body that only this Message uses.");
+        out.println("         */");
+        out.println("        virtual std::vector<unsigned char>& getContent();");
+        out.println("");
+        out.println("        /**");
+        out.println("         * Sets the Message body to a copy of the given bytes.");
+        out.println("         *");
+        out.println("         * @param content");
+        out.println("         *      The new Message body.");
+        out.println("         */");
+        out.println("        virtual void setContent(const std::vector<unsigned char>& content);");
+        out.println("");
     }
 
 }
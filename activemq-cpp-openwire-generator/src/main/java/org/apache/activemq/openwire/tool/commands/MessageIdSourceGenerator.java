@@ -110,4 +110,13 @@ public class MessageIdSourceGenerator extends CommandSourceGenerator {
         out.println("    return this->key;");
     }
 
+    protected void generateHashCodeBody( PrintWriter out ) {
+        out.println("    // Hashed from the fields so no string is built to look the id up.");
+        out.println("    int result = decaf::util::HashCode<std::string>()(this->textView);");
+        out.println("    result = 31 * result + (this->producerId != NULL ? this->producerId->getHashCode() : 0);");
+        out.println("    result = 31 * result + decaf::util::HashCode<long long>()(this->producerSequenceId);");
+        out.println("    result = 31 * result + decaf::util::HashCode<long long>()(this->brokerSequenceId);");
+        out.println("    return result;");
+    }
+
 }
@@ -19,8 +19,14 @@ package org.apache.activemq.openwire.tool.commands;
 import java.io.PrintWriter;
 import java.util.Set;
 
+import org.codehaus.jam.JProperty;
+
 public class MessageSourceGenerator extends CommandSourceGenerator {
 
+    protected boolean isCustomProperty( JProperty property ) {
+        return property.getSimpleName().equals("Content");
+    }
+
     protected void populateIncludeFilesSet() {
         super.populateIncludeFilesSet();
         Set<String> includes = getIncludeFiles();
@@ -37,8 +43,12 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         result.append(super.generateInitializerList());
         result.append(", ackHandler(NULL)");
         result.append(", properties()");
+        result.append(", propertiesUnmarshalled(true)");
+        result.append(", propertiesModified(false)");
         result.append(", readOnlyProperties(false)");
         result.append(", readOnlyBody(false)");
+        result.append(", content(new std::vector<unsigned char>())");
+        result.append(", contentShared(false)");
         result.append(", connection(NULL)");
 
         return result.toString();
@@ -48,10 +58,18 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         super.generateCopyDataStructureBody(out);
 
         out.println("    this->properties.copy(srcPtr->properties);");
+        out.println("    this->propertiesUnmarshalled = srcPtr->propertiesUnmarshalled;");
+        out.println("    this->propertiesModified = srcPtr->propertiesModified;");
         out.println("    this->setAckHandler(srcPtr->getAckHandler());");
         out.println("    this->setReadOnlyBody(srcPtr->isReadOnlyBody());");
         out.println("    this->setReadOnlyProperties(srcPtr->isReadOnlyProperties());");
         out.println("    this->setConnection(srcPtr->getConnection());");
+        out.println("");
+        out.println("    // The body is shared rather than copied, whichever Message is modified first");
+        out.println("    // takes its own copy of it.");
+        out.println("    this->content = srcPtr->content;");
+        out.println("    this->contentShared = true;");
+        out.println("    srcPtr->contentShared = true;");
     }
 
     protected void generateToStringBody( PrintWriter out ) {
@@ -65,7 +83,7 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         out.println("        return false;");
         out.println("    }");
         out.println("");
-        out.println("    if (!properties.equals(valuePtr->properties)) {");
+        out.println("    if (!getMessageProperties().equals(valuePtr->getMessageProperties())) {");
         out.println("        return false;");
         out.println("    }");
         out.println("");
@@ -112,10 +130,14 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         out.println("void Message::beforeMarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {");
         out.println("");
         out.println("    try {");
-        out.println("        marshalledProperties.clear();");
-        out.println("        if (!properties.isEmpty()) {");
-        out.println("            wireformat::openwire::marshal::PrimitiveTypesMarshaller::marshal(");
-        out.println("                &properties, marshalledProperties );");
+        out.println("        // Properties that were received and never changed go back out as they came in.");
+        out.println("        if (propertiesModified) {");
+        out.println("            marshalledProperties.clear();");
+        out.println("            if (!properties.isEmpty()) {");
+        out.println("                wireformat::openwire::marshal::PrimitiveTypesMarshaller::marshal(");
+        out.println("                    &properties, marshalledProperties );");
+        out.println("            }");
+        out.println("            propertiesModified = false;");
         out.println("        }");
         out.println("    }");
         out.println("    AMQ_CATCH_RETHROW(decaf::io::IOException)");
@@ -125,14 +147,67 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         out.println("");
         out.println("////////////////////////////////////////////////////////////////////////////////");
         out.println("void Message::afterUnmarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {");
+        out.println("    // The properties are left marshaled until getMessageProperties is first called,");
+        out.println("    // a Message that is only forwarded sends the same bytes on unchanged.");
+        out.println("    properties.clear();");
+        out.println("    propertiesUnmarshalled = false;");
+        out.println("    propertiesModified = false;");
+        out.println("}");
         out.println("");
-        out.println("    try {");
-        out.println("        wireformat::openwire::marshal::PrimitiveTypesMarshaller::unmarshal(");
-        out.println("            &properties, marshalledProperties);");
+        out.println("////////////////////////////////////////////////////////////////////////////////");
+        out.println("util::PrimitiveMap& Message::getMessageProperties() {");
+        out.println("");
+        out.println("    const Message* self = this;");
+        out.println("    self->getMessageProperties();");
+        out.println("");
+        out.println("    this->propertiesModified = true;");
+        out.println("    return this->properties;");
+        out.println("}");
+        out.println("");
+        out.println("////////////////////////////////////////////////////////////////////////////////");
+        out.println("const util::PrimitiveMap& Message::getMessageProperties() const {");
+        out.println("");
+        out.println("    if (!this->propertiesUnmarshalled) {");
+        out.println("        try {");
+        out.println("            if (!this->marshalledProperties.empty()) {");
+        out.println("                wireformat::openwire::marshal::PrimitiveTypesMarshaller::unmarshal(");
+        out.println("                    &properties, marshalledProperties);");
+        out.println("            }");
+        out.println("            this->propertiesUnmarshalled = true;");
+        out.println("        }");
+        out.println("        AMQ_CATCH_RETHROW(decaf::io::IOException)");
+        out.println("        AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)");
+        out.println("        AMQ_CATCHALL_THROW(decaf::io::IOException)");
+        out.println("    }");
+        out.println("");
+        out.println("    return this->properties;");
+        out.println("}");
+        out.println("");
+        out.println("////////////////////////////////////////////////////////////////////////////////");
+        out.println("const std::vector<unsigned char>& Message::getContent() const {");
+        out.println("    return *this->content;");
+        out.println("}");
+        out.println("");
+        out.println("////////////////////////////////////////////////////////////////////////////////");
+        out.println("std::vector<unsigned char>& Message::getContent() {");
+        out.println("");
+        out.println("    if (this->contentShared) {");
+        out.println("        this->content.reset(new std::vector<unsigned char>(*this->content));");
+        out.println("        this->contentShared = false;");
+        out.println("    }");
+        out.println("");
+        out.println("    return *this->content;");
+        out.println("}");
+        out.println("");
+        out.println("////////////////////////////////////////////////////////////////////////////////");
+        out.println("void Message::setContent(const std::vector<unsigned char>& content) {");
+        out.println("");
+        out.println("    if (this->contentShared) {");
+        out.println("        this->content.reset(new std::vector<unsigned char>(content));");
+        out.println("        this->contentShared = false;");
+        out.println("    } else {");
+        out.println("        *this->content = content;");
         out.println("    }");
-        out.println("    AMQ_CATCH_RETHROW(decaf::io::IOException)");
-        out.println("    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)");
-        out.println("    AMQ_CATCHALL_THROW(decaf::io::IOException)");
         out.println("}");
         out.println("");
     }
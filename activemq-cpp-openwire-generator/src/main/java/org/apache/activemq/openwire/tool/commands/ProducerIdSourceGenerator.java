@@ -100,4 +100,13 @@ public class ProducerIdSourceGenerator extends CommandSourceGenerator {
         out.println("");
         out.println("    return stream.str();");
     }
+
+    protected void generateHashCodeBody( PrintWriter out ) {
+        out.println("    // Hashed from the fields so no string is built to look the id up.");
+        out.println("    int result = decaf::util::HashCode<std::string>()(this->connectionId);");
+        out.println("    result = 31 * result + decaf::util::HashCode<long long>()(this->sessionId);");
+        out.println("    result = 31 * result + decaf::util::HashCode<long long>()(this->value);");
+        out.println("    return result;");
+    }
+
 }
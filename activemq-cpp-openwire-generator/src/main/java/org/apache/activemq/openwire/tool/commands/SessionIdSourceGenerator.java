@@ -86,4 +86,11 @@ public class SessionIdSourceGenerator extends CommandSourceGenerator {
         super.generateAdditionalMethods(out);
     }
 
+    protected void generateHashCodeBody( PrintWriter out ) {
+        out.println("    // Hashed from the fields so no string is built to look the id up.");
+        out.println("    int result = decaf::util::HashCode<std::string>()(this->connectionId);");
+        out.println("    result = 31 * result + decaf::util::HashCode<long long>()(this->value);");
+        out.println("    return result;");
+    }
+
 }
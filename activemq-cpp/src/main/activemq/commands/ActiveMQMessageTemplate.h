@@ -52,6 +52,20 @@ namespace commands {
         virtual ~ActiveMQMessageTemplate() throw () {
         }
 
+    private:
+
+        // The interceptor works directly on the properties map, these make sure the
+        // marshaled properties of a received message have been read into it first.
+        wireformat::openwire::utils::MessagePropertyInterceptor& getPropertiesInterceptor() {
+            this->getMessageProperties();
+            return *this->propertiesInterceptor;
+        }
+
+        const wireformat::openwire::utils::MessagePropertyInterceptor& getPropertiesInterceptor() const {
+            this->getMessageProperties();
+            return *this->propertiesInterceptor;
+        }
+
     public:
 
         virtual void acknowledge() const {
@@ -159,7 +173,7 @@ namespace commands {
 
         virtual bool getBooleanProperty(const std::string& name) const {
             try {
-                return this->propertiesInterceptor->getBooleanProperty(name);
+                return this->getPropertiesInterceptor().getBooleanProperty(name);
             } catch (decaf::lang::exceptions::UnsupportedOperationException& ex) {
                 throw activemq::util::CMSExceptionSupport::createMessageFormatException(ex);
             }
@@ -168,7 +182,7 @@ namespace commands {
 
         virtual unsigned char getByteProperty(const std::string& name) const {
             try {
-                return this->propertiesInterceptor->getByteProperty(name);
+                return this->getPropertiesInterceptor().getByteProperty(name);
             } catch (decaf::lang::exceptions::UnsupportedOperationException& ex) {
                 throw activemq::util::CMSExceptionSupport::createMessageFormatException(ex);
             }
@@ -178,7 +192,7 @@ namespace commands {
         virtual double getDoubleProperty(const std::string& name) const {
 
             try {
-                return this->propertiesInterceptor->getDoubleProperty(name);
+                return this->getPropertiesInterceptor().getDoubleProperty(name);
             } catch (decaf::lang::exceptions::UnsupportedOperationException& ex) {
                 throw activemq::util::CMSExceptionSupport::createMessageFormatException(ex);
             }
@@ -188,7 +202,7 @@ namespace commands {
         virtual float getFloatProperty(const std::string& name) const {
 
             try {
-                return this->propertiesInterceptor->getFloatProperty(name);
+                return this->getPropertiesInterceptor().getFloatProperty(name);
             } catch (decaf::lang::exceptions::UnsupportedOperationException& ex) {
                 throw activemq::util::CMSExceptionSupport::createMessageFormatException(ex);
             }
@@ -198,7 +212,7 @@ namespace commands {
         virtual int getIntProperty(const std::string& name) const {
 
             try {
-                return this->propertiesInterceptor->getIntProperty(name);
+                return this->getPropertiesInterceptor().getIntProperty(name);
             } catch (decaf::lang::exceptions::UnsupportedOperationException& ex) {
                 throw activemq::util::CMSExceptionSupport::createMessageFormatException(ex);
             }
@@ -208,7 +222,7 @@ namespace commands {
         virtual long long getLongProperty(const std::string& name) const {
 
             try {
-                return this->propertiesInterceptor->getLongProperty(name);
+                return this->getPropertiesInterceptor().getLongProperty(name);
             } catch (decaf::lang::exceptions::UnsupportedOperationException& ex) {
                 throw activemq::util::CMSExceptionSupport::createMessageFormatException(ex);
             }
@@ -218,7 +232,7 @@ namespace commands {
         virtual short getShortProperty(const std::string& name) const {
 
             try {
-                return this->propertiesInterceptor->getShortProperty(name);
+                return this->getPropertiesInterceptor().getShortProperty(name);
             } catch (decaf::lang::exceptions::UnsupportedOperationException& ex) {
                 throw activemq::util::CMSExceptionSupport::createMessageFormatException(ex);
             }
@@ -228,7 +242,7 @@ namespace commands {
         virtual std::string getStringProperty(const std::string& name) const {
 
             try {
-                return this->propertiesInterceptor->getStringProperty(name);
+                return this->getPropertiesInterceptor().getStringProperty(name);
             } catch (decaf::lang::exceptions::UnsupportedOperationException& ex) {
                 throw activemq::util::CMSExceptionSupport::createMessageFormatException(ex);
             }
@@ -243,7 +257,7 @@ namespace commands {
 
             failIfReadOnlyProperties();
             try {
-                this->propertiesInterceptor->setBooleanProperty(name, value);
+                this->getPropertiesInterceptor().setBooleanProperty(name, value);
             }
             AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
         }
@@ -256,7 +270,7 @@ namespace commands {
 
             failIfReadOnlyProperties();
             try {
-                this->propertiesInterceptor->setByteProperty(name, value);
+                this->getPropertiesInterceptor().setByteProperty(name, value);
             }
             AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
         }
@@ -269,7 +283,7 @@ namespace commands {
 
             failIfReadOnlyProperties();
             try {
-                this->propertiesInterceptor->setDoubleProperty(name, value);
+                this->getPropertiesInterceptor().setDoubleProperty(name, value);
             }
             AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
         }
@@ -282,7 +296,7 @@ namespace commands {
 
             failIfReadOnlyProperties();
             try {
-                this->propertiesInterceptor->setFloatProperty(name, value);
+                this->getPropertiesInterceptor().setFloatProperty(name, value);
             }
             AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
         }
@@ -295,7 +309,7 @@ namespace commands {
 
             failIfReadOnlyProperties();
             try {
-                this->propertiesInterceptor->setIntProperty(name, value);
+                this->getPropertiesInterceptor().setIntProperty(name, value);
             }
             AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
         }
@@ -308,7 +322,7 @@ namespace commands {
 
             failIfReadOnlyProperties();
             try {
-                this->propertiesInterceptor->setLongProperty(name, value);
+                this->getPropertiesInterceptor().setLongProperty(name, value);
             }
             AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
         }
@@ -321,7 +335,7 @@ namespace commands {
 
             failIfReadOnlyProperties();
             try {
-                this->propertiesInterceptor->setShortProperty(name, value);
+                this->getPropertiesInterceptor().setShortProperty(name, value);
             }
             AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
         }
@@ -334,7 +348,7 @@ namespace commands {
 
             failIfReadOnlyProperties();
             try {
-                this->propertiesInterceptor->setStringProperty(name, value);
+                this->getPropertiesInterceptor().setStringProperty(name, value);
             }
             AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
         }
@@ -144,7 +144,8 @@ int BrokerId::compareTo(const BrokerId& value) const {
         return 0;
     }
 
-    int valueComp = StringUtils::compareIgnoreCase(this->value.c_str(), value.value.c_str());
+    int valueComp = this->value == value.value ? 0 :
+        StringUtils::compareIgnoreCase(this->value.c_str(), value.value.c_str());
     if (valueComp != 0) {
         return valueComp;
     }
@@ -168,7 +168,8 @@ int ConnectionId::compareTo(const ConnectionId& value) const {
         return 0;
     }
 
-    int valueComp = StringUtils::compareIgnoreCase(this->value.c_str(), value.value.c_str());
+    int valueComp = this->value == value.value ? 0 :
+        StringUtils::compareIgnoreCase(this->value.c_str(), value.value.c_str());
     if (valueComp != 0) {
         return valueComp;
     }
@@ -199,6 +200,6 @@ ConnectionId& ConnectionId::operator= (const ConnectionId& other) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int ConnectionId::getHashCode() const {
-    return decaf::util::HashCode<std::string>()(this->toString());
+    return decaf::util::HashCode<std::string>()(this->value);
 }
 
@@ -188,7 +188,8 @@ int ConsumerId::compareTo(const ConsumerId& value) const {
         return 0;
     }
 
-    int connectionIdComp = StringUtils::compareIgnoreCase(this->connectionId.c_str(), value.connectionId.c_str());
+    int connectionIdComp = this->connectionId == value.connectionId ? 0 :
+        StringUtils::compareIgnoreCase(this->connectionId.c_str(), value.connectionId.c_str());
     if (connectionIdComp != 0) {
         return connectionIdComp;
     }
@@ -231,7 +232,11 @@ ConsumerId& ConsumerId::operator= (const ConsumerId& other) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int ConsumerId::getHashCode() const {
-    return decaf::util::HashCode<std::string>()(this->toString());
+    // Hashed from the fields so no string is built to look the id up.
+    int result = decaf::util::HashCode<std::string>()(this->connectionId);
+    result = 31 * result + decaf::util::HashCode<long long>()(this->sessionId);
+    result = 31 * result + decaf::util::HashCode<long long>()(this->value);
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
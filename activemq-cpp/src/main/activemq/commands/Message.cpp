@@ -46,9 +46,11 @@ using namespace decaf::lang::exceptions;
 Message::Message() :
     BaseCommand(), producerId(NULL), destination(NULL), transactionId(NULL), originalDestination(NULL), messageId(NULL), originalTransactionId(NULL), 
       groupID(""), groupSequence(0), correlationId(""), persistent(false), expiration(0), priority(0), replyTo(NULL), timestamp(0), 
-      type(""), content(), marshalledProperties(), dataStructure(NULL), targetConsumerId(NULL), compressed(false), redeliveryCounter(0), 
+      type(""), marshalledProperties(), dataStructure(NULL), targetConsumerId(NULL), compressed(false), redeliveryCounter(0), 
       brokerPath(), arrival(0), userID(""), recievedByDFBridge(false), droppable(false), cluster(), brokerInTime(0), brokerOutTime(0), 
-      jMSXGroupFirstForConsumer(false), ackHandler(NULL), properties(), readOnlyProperties(false), readOnlyBody(false), connection(NULL) {
+      jMSXGroupFirstForConsumer(false), ackHandler(NULL), properties(), propertiesUnmarshalled(true), propertiesModified(false),
+      readOnlyProperties(false), readOnlyBody(false), content(new std::vector<unsigned char>()), contentShared(false),
+      connection(NULL) {
 
 }
 
@@ -100,7 +102,6 @@ void Message::copyDataStructure(const DataStructure* src) {
     this->setReplyTo(srcPtr->getReplyTo());
     this->setTimestamp(srcPtr->getTimestamp());
     this->setType(srcPtr->getType());
-    this->setContent(srcPtr->getContent());
     this->setMarshalledProperties(srcPtr->getMarshalledProperties());
     this->setDataStructure(srcPtr->getDataStructure());
     this->setTargetConsumerId(srcPtr->getTargetConsumerId());
@@ -116,10 +117,18 @@ void Message::copyDataStructure(const DataStructure* src) {
     this->setBrokerOutTime(srcPtr->getBrokerOutTime());
     this->setJMSXGroupFirstForConsumer(srcPtr->isJMSXGroupFirstForConsumer());
     this->properties.copy(srcPtr->properties);
+    this->propertiesUnmarshalled = srcPtr->propertiesUnmarshalled;
+    this->propertiesModified = srcPtr->propertiesModified;
     this->setAckHandler(srcPtr->getAckHandler());
     this->setReadOnlyBody(srcPtr->isReadOnlyBody());
     this->setReadOnlyProperties(srcPtr->isReadOnlyProperties());
     this->setConnection(srcPtr->getConnection());
+
+    // The body is shared rather than copied, whichever Message is modified first
+    // takes its own copy of it.
+    this->content = srcPtr->content;
+    this->contentShared = true;
+    srcPtr->contentShared = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -440,7 +449,7 @@ bool Message::equals(const DataStructure* value) const {
         return false;
     }
 
-    if (!properties.equals(valuePtr->properties)) {
+    if (!getMessageProperties().equals(valuePtr->getMessageProperties())) {
         return false;
     }
 
@@ -658,21 +667,6 @@ void Message::setType(const std::string& type) {
     this->type = type;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-const std::vector<unsigned char>& Message::getContent() const {
-    return content;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-std::vector<unsigned char>& Message::getContent() {
-    return content;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-void Message::setContent(const std::vector<unsigned char>& content) {
-    this->content = content;
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 const std::vector<unsigned char>& Message::getMarshalledProperties() const {
     return marshalledProperties;
@@ -873,10 +867,14 @@ unsigned int Message::getSize() const {
 void Message::beforeMarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {
 
     try {
-        marshalledProperties.clear();
-        if (!properties.isEmpty()) {
-            wireformat::openwire::marshal::PrimitiveTypesMarshaller::marshal(
-                &properties, marshalledProperties );
+        // Properties that were received and never changed go back out as they came in.
+        if (propertiesModified) {
+            marshalledProperties.clear();
+            if (!properties.isEmpty()) {
+                wireformat::openwire::marshal::PrimitiveTypesMarshaller::marshal(
+                    &properties, marshalledProperties );
+            }
+            propertiesModified = false;
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -886,13 +884,65 @@ void Message::beforeMarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::afterUnmarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {
+    // The properties are left marshaled until getMessageProperties is first called,
+    // a Message that is only forwarded sends the same bytes on unchanged.
+    properties.clear();
+    propertiesUnmarshalled = false;
+    propertiesModified = false;
+}
 
-    try {
-        wireformat::openwire::marshal::PrimitiveTypesMarshaller::unmarshal(
-            &properties, marshalledProperties);
+////////////////////////////////////////////////////////////////////////////////
+util::PrimitiveMap& Message::getMessageProperties() {
+
+    const Message* self = this;
+    self->getMessageProperties();
+
+    this->propertiesModified = true;
+    return this->properties;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const util::PrimitiveMap& Message::getMessageProperties() const {
+
+    if (!this->propertiesUnmarshalled) {
+        try {
+            if (!this->marshalledProperties.empty()) {
+                wireformat::openwire::marshal::PrimitiveTypesMarshaller::unmarshal(
+                    &properties, marshalledProperties);
+            }
+            this->propertiesUnmarshalled = true;
+        }
+        AMQ_CATCH_RETHROW(decaf::io::IOException)
+        AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
+        AMQ_CATCHALL_THROW(decaf::io::IOException)
     }
-    AMQ_CATCH_RETHROW(decaf::io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
-    AMQ_CATCHALL_THROW(decaf::io::IOException)
+
+    return this->properties;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const std::vector<unsigned char>& Message::getContent() const {
+    return *this->content;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<unsigned char>& Message::getContent() {
+
+    if (this->contentShared) {
+        this->content.reset(new std::vector<unsigned char>(*this->content));
+        this->contentShared = false;
+    }
+
+    return *this->content;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Message::setContent(const std::vector<unsigned char>& content) {
+
+    if (this->contentShared) {
+        this->content.reset(new std::vector<unsigned char>(content));
+        this->contentShared = false;
+    } else {
+        *this->content = content;
+    }
+}
@@ -74,7 +74,6 @@ namespace commands{
         Pointer<ActiveMQDestination> replyTo;
         long long timestamp;
         std::string type;
-        std::vector<unsigned char> content;
         std::vector<unsigned char> marshalledProperties;
         Pointer<DataStructure> dataStructure;
         Pointer<ConsumerId> targetConsumerId;
@@ -101,8 +100,16 @@ namespace commands{
         Pointer<core::ActiveMQAckHandler> ackHandler;
 
         // Message properties, these are Marshaled and Unmarshaled from the Message
-        // Command's marshaledProperties vector.
-        activemq::util::PrimitiveMap properties;
+        // Command's marshaledProperties vector.  A received Message keeps only the
+        // marshaled form until the properties are first accessed.
+        mutable activemq::util::PrimitiveMap properties;
+
+        // Indicates if the properties map holds the decoded marshaledProperties.
+        mutable bool propertiesUnmarshalled;
+
+        // Indicates if the properties map may differ from marshaledProperties and
+        // so must be marshaled again before the Message is sent.
+        bool propertiesModified;
 
         // Indicates if the Message Properties are Read Only
         bool readOnlyProperties;
@@ -110,6 +117,14 @@ namespace commands{
         // Indicates if the Message Body are Read Only
         bool readOnlyBody;
 
+        // The Message body, copies of a Message share it until one of them asks
+        // to modify it.
+        Pointer< std::vector<unsigned char> > content;
+
+        // Indicates if the content may be shared with another Message, both sides
+        // of a copy are marked so the source is mutable.
+        mutable bool contentShared;
+
     protected:
 
         core::ActiveMQConnection* connection;
@@ -229,16 +244,27 @@ namespace commands{
 
         /**
          * Gets a reference to the Message's Properties object, allows the derived
-         * classes to get and set their own specific properties.
+         * classes to get and set their own specific properties.  The properties of a
+         * received Message are unmarshaled on the first call and, since the map may
+         * be changed through the returned reference, are marshaled again when the
+         * Message is next sent.
          *
          * @return a reference to the Primitive Map that holds message properties.
+         *
+         * @throws IOException if the marshaled properties cannot be read.
          */
-        util::PrimitiveMap& getMessageProperties() {
-            return this->properties;
-        }
-        const util::PrimitiveMap& getMessageProperties() const {
-            return this->properties;
-        }
+        util::PrimitiveMap& getMessageProperties();
+
+        /**
+         * Gets a read only reference to the Message's Properties object, the marshaled
+         * properties of a received Message are unmarshaled on the first call and are
+         * sent again unchanged if the Message is forwarded.
+         *
+         * @return a const reference to the Primitive Map that holds message properties.
+         *
+         * @throws IOException if the marshaled properties cannot be read.
+         */
+        const util::PrimitiveMap& getMessageProperties() const;
 
         /**
          * Returns if the Message Properties Are Read Only
@@ -272,6 +298,32 @@ namespace commands{
             this->readOnlyBody = value;
         }
 
+        /**
+         * Gets the Message body, which may be shared with copies of this Message
+         * and so must not be modified through a cast.
+         *
+         * @return a const reference to the Message body.
+         */
+        virtual const std::vector<unsigned char>& getContent() const;
+
+        /**
+         * Gets the Message body for modification, a body still shared with a copy
+         * of this Message is copied first so that the change is seen only by this
+         * Message.  The returned reference must not be used to modify the body after
+         * this Message has been copied again.
+         *
+         * @return a reference to the Message body that only this Message uses.
+         */
+        virtual std::vector<unsigned char>& getContent();
+
+        /**
+         * Sets the Message body to a copy of the given bytes.
+         *
+         * @param content
+         *      The new Message body.
+         */
+        virtual void setContent(const std::vector<unsigned char>& content);
+
         virtual const Pointer<ProducerId>& getProducerId() const;
         virtual Pointer<ProducerId>& getProducerId();
         virtual void setProducerId(const Pointer<ProducerId>& producerId);
@@ -327,10 +379,6 @@ namespace commands{
         virtual std::string& getType();
         virtual void setType(const std::string& type);
 
-        virtual const std::vector<unsigned char>& getContent() const;
-        virtual std::vector<unsigned char>& getContent();
-        virtual void setContent(const std::vector<unsigned char>& content);
-
         virtual const std::vector<unsigned char>& getMarshalledProperties() const;
         virtual std::vector<unsigned char>& getMarshalledProperties();
         virtual void setMarshalledProperties(const std::vector<unsigned char>& marshalledProperties);
@@ -241,7 +241,8 @@ int MessageId::compareTo(const MessageId& value) const {
         return 0;
     }
 
-    int textViewComp = StringUtils::compareIgnoreCase(this->textView.c_str(), value.textView.c_str());
+    int textViewComp = this->textView == value.textView ? 0 :
+        StringUtils::compareIgnoreCase(this->textView.c_str(), value.textView.c_str());
     if (textViewComp != 0) {
         return textViewComp;
     }
@@ -289,7 +290,12 @@ MessageId& MessageId::operator= (const MessageId& other) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int MessageId::getHashCode() const {
-    return decaf::util::HashCode<std::string>()(this->toString());
+    // Hashed from the fields so no string is built to look the id up.
+    int result = decaf::util::HashCode<std::string>()(this->textView);
+    result = 31 * result + (this->producerId != NULL ? this->producerId->getHashCode() : 0);
+    result = 31 * result + decaf::util::HashCode<long long>()(this->producerSequenceId);
+    result = 31 * result + decaf::util::HashCode<long long>()(this->brokerSequenceId);
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
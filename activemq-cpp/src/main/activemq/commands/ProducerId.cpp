@@ -204,7 +204,8 @@ int ProducerId::compareTo(const ProducerId& value) const {
         return 0;
     }
 
-    int connectionIdComp = StringUtils::compareIgnoreCase(this->connectionId.c_str(), value.connectionId.c_str());
+    int connectionIdComp = this->connectionId == value.connectionId ? 0 :
+        StringUtils::compareIgnoreCase(this->connectionId.c_str(), value.connectionId.c_str());
     if (connectionIdComp != 0) {
         return connectionIdComp;
     }
@@ -247,7 +248,11 @@ ProducerId& ProducerId::operator= (const ProducerId& other) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int ProducerId::getHashCode() const {
-    return decaf::util::HashCode<std::string>()(this->toString());
+    // Hashed from the fields so no string is built to look the id up.
+    int result = decaf::util::HashCode<std::string>()(this->connectionId);
+    result = 31 * result + decaf::util::HashCode<long long>()(this->sessionId);
+    result = 31 * result + decaf::util::HashCode<long long>()(this->value);
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,204 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AckCoalescer.h"
+
+#include <activemq/core/ActiveMQConnection.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // All consumers of a session share the connection id, check the numeric
+    // fields first so most mismatches never compare the id strings.
+    bool sameConsumer(const ConsumerId* left, const ConsumerId* right) {
+
+        if (left == right) {
+            return true;
+        }
+
+        if (left == NULL || right == NULL ||
+            left->getValue() != right->getValue() || left->getSessionId() != right->getSessionId()) {
+            return false;
+        }
+
+        return left->equals(*right);
+    }
+
+    bool sameDestination(const ActiveMQDestination* left, const ActiveMQDestination* right) {
+
+        if (left == NULL || right == NULL) {
+            return left == right;
+        }
+
+        return left->equals(*right);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+AckCoalescer::AckCoalescer(ActiveMQConnection* connection, int maxPending) :
+    connection(connection), maxPending(maxPending), mutex(), flushMutex(), pending(), merged(), pendingCount(0), closed(false) {
+
+    if (connection == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "AckCoalescer created with NULL Connection");
+    }
+
+    if (maxPending < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "AckCoalescer maximum pending acks must be at least one");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+AckCoalescer::~AckCoalescer() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool AckCoalescer::add(const Pointer<MessageAck>& ack) {
+
+    bool full = false;
+
+    synchronized(&this->mutex) {
+
+        if (this->closed) {
+            return false;
+        }
+
+        // Only the consumer's most recent pending ack is a merge candidate, merging
+        // past a different kind of ack would reorder the two.
+        std::size_t index = this->pending.size();
+        while (index > 0 && !sameConsumer(this->pending[index - 1]->getConsumerId().get(), ack->getConsumerId().get())) {
+            --index;
+        }
+
+        if (index > 0 && canMerge(this->pending[--index], ack)) {
+
+            // The pending ack may still be referenced by its consumer, so the first
+            // merge makes a copy and later ones update that copy in place.
+            Pointer<MessageAck>& target = this->pending[index];
+            if (!this->merged[index]) {
+                target.reset(target->cloneDataStructure());
+                this->merged[index] = true;
+            }
+
+            if (ack->getFirstMessageId() == NULL) {
+                target->setFirstMessageId(Pointer<MessageId>());
+            }
+            target->setLastMessageId(ack->getLastMessageId());
+            target->setMessageCount(target->getMessageCount() + ack->getMessageCount());
+        } else {
+            this->pending.push_back(ack);
+            this->merged.push_back(false);
+            this->pendingCount.set((int) this->pending.size());
+        }
+
+        full = (int) this->pending.size() >= this->maxPending;
+    }
+
+    if (full) {
+        flush();
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescer::flush() {
+
+    if (this->pendingCount.get() == 0) {
+        return;
+    }
+
+    try {
+
+        // Holding the flush lock while sending keeps the batches in order, the pending
+        // list is swapped out so adds and clears only wait for the swap.
+        synchronized(&this->flushMutex) {
+
+            std::vector< Pointer<MessageAck> > batch;
+
+            synchronized(&this->mutex) {
+                batch.swap(this->pending);
+                this->merged.clear();
+                this->pendingCount.set(0);
+            }
+
+            std::vector< Pointer<MessageAck> >::const_iterator iter = batch.begin();
+            for (; iter != batch.end(); ++iter) {
+                this->connection->oneway(*iter);
+            }
+        }
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescer::clear() {
+
+    synchronized(&this->mutex) {
+        this->pending.clear();
+        this->merged.clear();
+        this->pendingCount.set(0);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescer::close() {
+
+    synchronized(&this->mutex) {
+        this->closed = true;
+        this->pending.clear();
+        this->merged.clear();
+        this->pendingCount.set(0);
+    }
+
+    // Wait out a flush that is still writing so the Connection is not used once
+    // the owner has been told this AckCoalescer is closed.
+    synchronized(&this->flushMutex) {
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool AckCoalescer::canMerge(const Pointer<MessageAck>& pending, const Pointer<MessageAck>& ack) {
+
+    // Only the range acks are merged, the others carry per message state.
+    if (pending->getAckType() != ack->getAckType() || !(ack->isStandardAck() || ack->isDeliveredAck())) {
+        return false;
+    }
+
+    if (pending->getTransactionId() != NULL || ack->getTransactionId() != NULL ||
+        pending->getLastMessageId() == NULL || ack->getLastMessageId() == NULL) {
+        return false;
+    }
+
+    // A wildcard consumer acks each destination it receives from separately.
+    return sameDestination(pending->getDestination().get(), ack->getDestination().get());
+}
@@ -0,0 +1,147 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_ACKCOALESCER_H_
+#define _ACTIVEMQ_CORE_ACKCOALESCER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/MessageAck.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <vector>
+
+namespace activemq {
+namespace core {
+
+    class ActiveMQConnection;
+
+    using decaf::lang::Pointer;
+
+    /**
+     * Collects the acks that the consumers of a session send and writes them to the
+     * Connection together, a session with many consumers that each receive only a
+     * few messages would otherwise send a stream of tiny ack commands.
+     *
+     * A range ack that directly follows an ack of the same type from the same consumer
+     * on the same destination is merged into it, consumers ack their deliveries in
+     * order so the two ranges are adjacent and one ack covering both is equivalent.
+     * Any other ack is queued behind the ones already pending so that each consumer's
+     * acks still reach the Broker in the order they were made.
+     *
+     * Only acks that would have been sent as a oneway outside of a transaction should
+     * be added, the owner decides when the pending acks are flushed.  Flushing is done
+     * under a lock of its own so that clearing the pending acks never has to wait on
+     * a write that is blocked in the transport.
+     *
+     * @since 3.10.0
+     */
+    class AMQCPP_API AckCoalescer {
+    private:
+
+        ActiveMQConnection* connection;
+        int maxPending;
+
+        decaf::util::concurrent::Mutex mutex;
+        decaf::util::concurrent::Mutex flushMutex;
+        std::vector< Pointer<commands::MessageAck> > pending;
+        // Parallel to pending, true where the ack is a merged copy owned by this object.
+        std::vector<bool> merged;
+        decaf::util::concurrent::atomic::AtomicInteger pendingCount;
+        bool closed;
+
+    private:
+
+        AckCoalescer(const AckCoalescer&);
+        AckCoalescer& operator=(const AckCoalescer&);
+
+    public:
+
+        /**
+         * Creates a new AckCoalescer that sends its acks on the given Connection.
+         *
+         * @param connection
+         *      The Connection that the acks are sent on.
+         * @param maxPending
+         *      The number of pending acks that causes add to flush them, at least one.
+         *
+         * @throws NullPointerException if the Connection is NULL.
+         * @throws IllegalArgumentException if maxPending is less than one.
+         */
+        AckCoalescer(ActiveMQConnection* connection, int maxPending);
+
+        virtual ~AckCoalescer();
+
+        /**
+         * Adds an ack to the pending acks, merging it with the last pending ack of its
+         * consumer when possible, and flushes the pending acks if there are now as many
+         * as the maximum allowed.
+         *
+         * @param ack
+         *      The MessageAck to send.
+         *
+         * @return false if this AckCoalescer has been closed and the caller must send
+         *         the ack itself.
+         *
+         * @throws ActiveMQException if the pending acks were flushed and the send failed.
+         */
+        bool add(const Pointer<commands::MessageAck>& ack);
+
+        /**
+         * Sends all pending acks in the order they were added.  If the Connection
+         * fails to send one of them it and the acks behind it are discarded.
+         *
+         * @throws ActiveMQException if an ack could not be sent.
+         */
+        void flush();
+
+        /**
+         * Discards all pending acks without sending them.
+         */
+        void clear();
+
+        /**
+         * Discards all pending acks and causes any further calls to add to return false.
+         */
+        void close();
+
+        /**
+         * @return the number of acks waiting to be sent.
+         */
+        int getPendingCount() const {
+            return this->pendingCount.get();
+        }
+
+        /**
+         * @return the number of pending acks that causes add to flush them.
+         */
+        int getMaxPending() const {
+            return this->maxPending;
+        }
+
+    private:
+
+        static bool canMerge(const Pointer<commands::MessageAck>& pending,
+                             const Pointer<commands::MessageAck>& ack);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_ACKCOALESCER_H_ */
@@ -40,14 +40,21 @@
 #include <activemq/transport/DefaultTransportListener.h>
 #include <activemq/wireformat/openwire/OpenWireFormat.h>
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include <decaf/lang/Math.h>
 #include <decaf/lang/Boolean.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/lang/ThreadLocal.h>
 #include <decaf/util/Iterator.h>
 #include <decaf/util/Set.h>
 #include <decaf/util/Collection.h>
+#include <decaf/util/HashCode.h>
 #include <decaf/util/LinkedList.h>
 #include <decaf/util/UUID.h>
+#include <decaf/util/concurrent/ConcurrentHashMap.h>
 #include <decaf/util/concurrent/Mutex.h>
 #include <decaf/util/concurrent/TimeUnit.h>
 #include <decaf/util/concurrent/CountDownLatch.h>
@@ -123,6 +130,51 @@ namespace core {
 
     };
 
+    /**
+     * A snapshot of the routing table that maps a consumer to the Dispatcher that
+     * delivers its messages.  The table is never modified once it is published, a
+     * change to the set of consumers publishes a new copy with a higher version so
+     * the transport thread can route messages without holding a lock while it
+     * dispatches them.
+     *
+     * Consumers of one connection all share its connection Id, so the session and
+     * consumer values alone identify them and are used as a compact key.
+     *
+     * Each snapshot counts the dispatches that are using it so that a consumer
+     * removal can wait for the ones that might still see the removed consumer.
+     */
+    class DispatcherRoutes {
+    private:
+
+        DispatcherRoutes(const DispatcherRoutes&);
+        DispatcherRoutes& operator=(const DispatcherRoutes&);
+
+    public:
+
+        typedef std::pair<long long, long long> RouteKey;
+        typedef std::map<RouteKey, Dispatcher*> RouteTable;
+
+        RouteTable routes;
+        long long version;
+        AtomicInteger inFlight;
+
+    public:
+
+        DispatcherRoutes() : routes(), version(0), inFlight() {}
+
+        DispatcherRoutes(const DispatcherRoutes& source, long long version) :
+            routes(source.routes), version(version), inFlight() {}
+
+        static RouteKey keyFor(const commands::ConsumerId& id) {
+            return RouteKey(id.getSessionId(), id.getValue());
+        }
+
+        Dispatcher* lookup(const commands::ConsumerId& id) const {
+            RouteTable::const_iterator iter = this->routes.find(keyFor(id));
+            return iter != this->routes.end() ? iter->second : NULL;
+        }
+    };
+
     class ConnectionConfig {
     private:
 
@@ -131,17 +183,17 @@ namespace core {
 
     public:
 
-        typedef decaf::util::StlMap< Pointer<commands::ConsumerId>,
-                                     Dispatcher*,
-                                     commands::ConsumerId::COMPARATOR > DispatcherMap;
+        // Routes used by the dispatches in progress on a thread, innermost last.
+        typedef std::vector<DispatcherRoutes*> ThreadDispatches;
 
         typedef decaf::util::StlMap< Pointer<commands::ProducerId>,
                                      Pointer<ActiveMQProducerKernel>,
                                      commands::ProducerId::COMPARATOR > ProducerMap;
 
-        typedef decaf::util::concurrent::ConcurrentStlMap< Pointer<commands::ActiveMQTempDestination>,
-                                                           Pointer<commands::ActiveMQTempDestination>,
-                                                           commands::ActiveMQTempDestination::COMPARATOR > TempDestinationMap;
+        typedef decaf::util::concurrent::ConcurrentHashMap< Pointer<commands::ActiveMQTempDestination>,
+                                                            Pointer<commands::ActiveMQTempDestination>,
+                                                            decaf::util::HashCode< Pointer<commands::ActiveMQTempDestination> >,
+                                                            commands::ActiveMQTempDestination::COMPARATOR > TempDestinationMap;
 
     public:
 
@@ -153,6 +205,7 @@ namespace core {
         Pointer<util::IdGenerator> clientIdGenerator;
         Pointer<Scheduler> scheduler;
         Pointer<ExecutorService> executor;
+        Pointer<TaskRunnerFactory> sessionTaskRunner;
 
         util::LongSequenceGenerator sessionIds;
         util::LongSequenceGenerator consumerIdGenerator;
@@ -194,6 +247,10 @@ namespace core {
         long long optimizedAckScheduledAckInterval;
         long long consumerFailoverRedeliveryWaitPeriod;
         bool consumerExpiryCheckEnabled;
+        bool copyMessageOnSend;
+        bool coalesceAcks;
+        int coalesceAcksMaxPending;
+        long long coalesceAcksMaxDelay;
 
         std::auto_ptr<PrefetchPolicy> defaultPrefetchPolicy;
         std::auto_ptr<RedeliveryPolicy> defaultRedeliveryPolicy;
@@ -211,7 +268,16 @@ namespace core {
 
         Pointer<Exception> firstFailureError;
 
-        DispatcherMap dispatchers;
+        // The current dispatcher routes, dispatchersLock guards the swapping of the
+        // routes and the older routes that still have dispatches in flight, updates
+        // to the routes are serialized by dispatchersUpdateLock.  A dispatch only
+        // takes the lock to notify a removal that is waiting on it.
+        Pointer<DispatcherRoutes> dispatchers;
+        decaf::util::concurrent::Mutex dispatchersLock;
+        decaf::util::concurrent::Mutex dispatchersUpdateLock;
+        std::vector< Pointer<DispatcherRoutes> > retiredDispatchers;
+        AtomicInteger dispatchWaiters;
+        decaf::lang::ThreadLocal<ThreadDispatches> threadDispatches;
         ProducerMap activeProducers;
 
         decaf::util::concurrent::locks::ReentrantReadWriteLock sessionsLock;
@@ -229,6 +295,7 @@ namespace core {
                              clientIdGenerator(),
                              scheduler(),
                              executor(),
+                             sessionTaskRunner(),
                              sessionIds(),
                              consumerIdGenerator(),
                              tempDestinationIds(),
@@ -265,6 +332,10 @@ namespace core {
                              optimizedAckScheduledAckInterval(0),
                              consumerFailoverRedeliveryWaitPeriod(0),
                              consumerExpiryCheckEnabled(true),
+                             copyMessageOnSend(true),
+                             coalesceAcks(false),
+                             coalesceAcksMaxPending(100),
+                             coalesceAcksMaxDelay(10),
                              defaultPrefetchPolicy(NULL),
                              defaultRedeliveryPolicy(NULL),
                              exceptionListener(NULL),
@@ -276,7 +347,12 @@ namespace core {
                              brokerInfoReceived(),
                              advisoryConsumer(),
                              firstFailureError(),
-                             dispatchers(),
+                             dispatchers(new DispatcherRoutes()),
+                             dispatchersLock(),
+                             dispatchersUpdateLock(),
+                             retiredDispatchers(),
+                             dispatchWaiters(),
+                             threadDispatches(),
                              activeProducers(),
                              sessionsLock(),
                              activeSessions(),
@@ -303,12 +379,17 @@ namespace core {
 
             this->connectionInfo->setConnectionId(connectionId);
             this->scheduler.reset(new Scheduler(std::string("ActiveMQConnection[")+uniqueId+"] Scheduler"));
+            this->sessionTaskRunner.reset(new TaskRunnerFactory(
+                std::string("ActiveMQConnection[")+uniqueId+"] Session Task",
+                TaskRunnerFactory::DEFAULT_MAX_ITERATIONS_PER_RUN, true,
+                TaskRunnerFactory::DEFAULT_MAX_THREAD_POOL_SIZE));
             this->scheduler->start();
         }
 
         ~ConnectionConfig() {
             try {
                 synchronized(&onExceptionLock) {
+                    this->sessionTaskRunner->shutdown();
                     this->scheduler->shutdown();
                     this->executor->shutdown();
                     this->executor->awaitTermination(10, TimeUnit::MINUTES);
@@ -321,6 +402,94 @@ namespace core {
             this->brokerInfoReceived->await();
         }
 
+        // Takes the current routes for a dispatch on the calling thread.
+        Pointer<DispatcherRoutes> dispatchStarted() {
+
+            Pointer<DispatcherRoutes> routes;
+            synchronized(&dispatchersLock) {
+                routes = dispatchers;
+                routes->inFlight.incrementAndGet();
+            }
+
+            threadDispatches.get().push_back(routes.get());
+            return routes;
+        }
+
+        void dispatchComplete(DispatcherRoutes* routes) {
+
+            threadDispatches.get().pop_back();
+            routes->inFlight.decrementAndGet();
+
+            if (dispatchWaiters.get() > 0) {
+                synchronized(&dispatchersLock) {
+                    dispatchersLock.notifyAll();
+                }
+            }
+        }
+
+        // Must be called with the dispatchersLock held.
+        void swapDispatchers(Pointer<DispatcherRoutes>& update) {
+
+            dispatchers.swap(update);
+
+            // Dispatches only start on the current routes, so once replaced routes
+            // that have none in flight will never have any.
+            pruneRetiredDispatchers();
+            if (update->inFlight.get() > 0) {
+                retiredDispatchers.push_back(update);
+            }
+        }
+
+        // Must be called with the dispatchersLock held.
+        void waitForDispatchesBefore(long long version) {
+
+            // The current thread's own dispatches are skipped as a consumer can be
+            // closed from inside of its own dispatch.
+            const ThreadDispatches& own = threadDispatches.get();
+
+            dispatchWaiters.incrementAndGet();
+            try {
+                while (hasDispatchesBefore(version, own)) {
+                    dispatchersLock.wait();
+                }
+            } catch (...) {
+                dispatchWaiters.decrementAndGet();
+                throw;
+            }
+            dispatchWaiters.decrementAndGet();
+        }
+
+    private:
+
+        // Must be called with the dispatchersLock held.
+        void pruneRetiredDispatchers() {
+
+            std::vector< Pointer<DispatcherRoutes> >::iterator iter = retiredDispatchers.begin();
+            while (iter != retiredDispatchers.end()) {
+                if ((*iter)->inFlight.get() == 0) {
+                    iter = retiredDispatchers.erase(iter);
+                } else {
+                    ++iter;
+                }
+            }
+        }
+
+        // Must be called with the dispatchersLock held.
+        bool hasDispatchesBefore(long long version, const ThreadDispatches& own) {
+
+            pruneRetiredDispatchers();
+
+            std::vector< Pointer<DispatcherRoutes> >::const_iterator iter = retiredDispatchers.begin();
+            for (; iter != retiredDispatchers.end(); ++iter) {
+                if ((*iter)->version < version &&
+                    (*iter)->inFlight.get() > (int) std::count(own.begin(), own.end(), iter->get())) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
     };
 
     // Static init.
@@ -524,8 +693,15 @@ ActiveMQConnection::~ActiveMQConnection() {
 void ActiveMQConnection::addDispatcher(const decaf::lang::Pointer<ConsumerId>& consumer, Dispatcher* dispatcher) {
 
     try {
-        synchronized(&this->config->dispatchers) {
-            this->config->dispatchers.put(consumer, dispatcher);
+        synchronized(&this->config->dispatchersUpdateLock) {
+
+            Pointer<DispatcherRoutes> current = this->config->dispatchers;
+            Pointer<DispatcherRoutes> update(new DispatcherRoutes(*current, current->version + 1));
+            update->routes[DispatcherRoutes::keyFor(*consumer)] = dispatcher;
+
+            synchronized(&this->config->dispatchersLock) {
+                this->config->swapDispatchers(update);
+            }
         }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
@@ -535,8 +711,30 @@ void ActiveMQConnection::addDispatcher(const decaf::lang::Pointer<ConsumerId>& c
 void ActiveMQConnection::removeDispatcher(const decaf::lang::Pointer<ConsumerId>& consumer) {
 
     try {
-        synchronized(&this->config->dispatchers) {
-            this->config->dispatchers.remove(consumer);
+        long long version = -1;
+
+        synchronized(&this->config->dispatchersUpdateLock) {
+
+            Pointer<DispatcherRoutes> current = this->config->dispatchers;
+            if (current->lookup(*consumer) != NULL) {
+
+                Pointer<DispatcherRoutes> update(new DispatcherRoutes(*current, current->version + 1));
+                update->routes.erase(DispatcherRoutes::keyFor(*consumer));
+                version = update->version;
+
+                synchronized(&this->config->dispatchersLock) {
+                    this->config->swapDispatchers(update);
+                }
+            }
+        }
+
+        // The removed Dispatcher may be destroyed once we return so wait for any
+        // dispatch that started with older routes to finish, this is done after
+        // the update lock is released since that dispatch might add a consumer.
+        if (version >= 0) {
+            synchronized(&this->config->dispatchersLock) {
+                this->config->waitForDispatchesBefore(version);
+            }
         }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
@@ -776,6 +974,9 @@ void ActiveMQConnection::close() {
             if (this->config->executor != NULL) {
                 this->config->executor->shutdown();
             }
+
+            // The Sessions are all gone so nothing is using the pooled threads now.
+            this->config->sessionTaskRunner->shutdown();
         } catch (Exception& error) {
             if (!hasException) {
                 ex = error;
@@ -1057,14 +1258,16 @@ void ActiveMQConnection::onCommand(const Pointer<Command> command) {
             // Check first to see if we are recovering.
             waitForTransportInterruptionProcessingToComplete();
 
-            // Look up the dispatcher.
-            Dispatcher* dispatcher = NULL;
-            synchronized(&this->config->dispatchers) {
+            // Take the current routes and count this dispatch against them, the lock
+            // is only held for the snapshot so consumers can be added and removed
+            // while the message is being dispatched.
+            Pointer<DispatcherRoutes> routes = this->config->dispatchStarted();
 
-                dispatcher = this->config->dispatchers.get(dispatch->getConsumerId());
+            try {
 
                 // If we have no registered dispatcher, the consumer was probably
                 // just closed.
+                Dispatcher* dispatcher = routes->lookup(*dispatch->getConsumerId());
                 if (dispatcher != NULL) {
 
                     Pointer<commands::Message> message = dispatch->getMessage();
@@ -1079,8 +1282,14 @@ void ActiveMQConnection::onCommand(const Pointer<Command> command) {
 
                     dispatcher->dispatch(dispatch);
                 }
+
+            } catch (...) {
+                this->config->dispatchComplete(routes.get());
+                throw;
             }
 
+            this->config->dispatchComplete(routes.get());
+
         } else if (command->isProducerAck()) {
 
             ProducerAck* producerAck = dynamic_cast<ProducerAck*>(command.get());
@@ -1089,9 +1298,12 @@ void ActiveMQConnection::onCommand(const Pointer<Command> command) {
             Pointer<ActiveMQProducerKernel> producer;
             synchronized(&this->config->activeProducers) {
                 producer = this->config->activeProducers.get(producerAck->getProducerId());
-                if (producer != NULL) {
-                    producer->onProducerAck(*producerAck);
-                }
+            }
+
+            // Window space is returned without holding the producers lock, the
+            // producer wakes any sender that is waiting on it.
+            if (producer != NULL) {
+                producer->onProducerAck(*producerAck);
             }
 
         } else if (command->isWireFormatInfo()) {
@@ -1640,6 +1852,11 @@ Pointer<Scheduler> ActiveMQConnection::getScheduler() const {
     return this->config->scheduler;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+Pointer<TaskRunnerFactory> ActiveMQConnection::getSessionTaskRunner() const {
+    return this->config->sessionTaskRunner;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConnection::isMessagePrioritySupported() const {
     return this->config->messagePrioritySupported;
@@ -1959,6 +2176,26 @@ void ActiveMQConnection::setAlwaysSessionAsync(bool alwaysSessionAsync) {
     this->config->alwaysSessionAsync = alwaysSessionAsync;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isUseDedicatedTaskRunner() const {
+    return this->config->sessionTaskRunner->isDedicatedTaskRunner();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setUseDedicatedTaskRunner(bool useDedicatedTaskRunner) {
+    this->config->sessionTaskRunner->setDedicatedTaskRunner(useDedicatedTaskRunner);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnection::getMaxThreadPoolSize() const {
+    return this->config->sessionTaskRunner->getMaxThreadPoolSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setMaxThreadPoolSize(int maxThreadPoolSize) {
+    this->config->sessionTaskRunner->setMaxThreadPoolSize(maxThreadPoolSize);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int ActiveMQConnection::getProtocolVersion() const {
     return this->config->protocolVersion->get();
@@ -1973,3 +2210,43 @@ bool ActiveMQConnection::isConsumerExpiryCheckEnabled() {
 void ActiveMQConnection::setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled) {
     this->config->consumerExpiryCheckEnabled = consumerExpiryCheckEnabled;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isCopyMessageOnSend() const {
+    return this->config->copyMessageOnSend;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setCopyMessageOnSend(bool copyMessageOnSend) {
+    this->config->copyMessageOnSend = copyMessageOnSend;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isCoalesceAcks() const {
+    return this->config->coalesceAcks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setCoalesceAcks(bool coalesceAcks) {
+    this->config->coalesceAcks = coalesceAcks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnection::getCoalesceAcksMaxPending() const {
+    return this->config->coalesceAcksMaxPending;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setCoalesceAcksMaxPending(int coalesceAcksMaxPending) {
+    this->config->coalesceAcksMaxPending = coalesceAcksMaxPending;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnection::getCoalesceAcksMaxDelay() const {
+    return this->config->coalesceAcksMaxDelay;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setCoalesceAcksMaxDelay(long long coalesceAcksMaxDelay) {
+    this->config->coalesceAcksMaxDelay = coalesceAcksMaxDelay;
+}
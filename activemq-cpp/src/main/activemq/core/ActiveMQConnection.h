@@ -29,6 +29,7 @@
 #include <activemq/transport/Transport.h>
 #include <activemq/transport/TransportListener.h>
 #include <activemq/threads/Scheduler.h>
+#include <activemq/threads/TaskRunnerFactory.h>
 #include <activemq/core/kernels/ActiveMQProducerKernel.h>
 #include <activemq/core/kernels/ActiveMQSessionKernel.h>
 #include <decaf/util/Properties.h>
@@ -822,6 +823,36 @@ namespace core {
          */
         void setAlwaysSessionAsync(bool alwaysSessionAsync);
 
+        /**
+         * @return true if each Session is given its own thread for asynchronous dispatch.
+         */
+        bool isUseDedicatedTaskRunner() const;
+
+        /**
+         * When true each Session that dispatches asynchronously is given its own thread,
+         * when false the Sessions share a pool of at most maxThreadPoolSize threads.  By
+         * default this value is set to true.
+         *
+         * @param useDedicatedTaskRunner
+         *      The useDedicatedTaskRunner value to use for Sessions created from now on.
+         */
+        void setUseDedicatedTaskRunner(bool useDedicatedTaskRunner);
+
+        /**
+         * @return the maximum number of threads Sessions share when not using dedicated task runners.
+         */
+        int getMaxThreadPoolSize() const;
+
+        /**
+         * Sets the maximum number of threads that Sessions share for asynchronous dispatch
+         * when useDedicatedTaskRunner is false, has no effect once a Session has started
+         * to use the pool.
+         *
+         * @param maxThreadPoolSize
+         *      The maximum number of pooled Session threads.
+         */
+        void setMaxThreadPoolSize(int maxThreadPoolSize);
+
         /**
          * @return true if the consumer will skip checking messages for expiration.
          */
@@ -836,6 +867,76 @@ namespace core {
          */
         void setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled);
 
+        /**
+         * @return true if a copy of each message is sent, leaving the original free to be
+         *         reused by the application as soon as send returns (default is true).
+         */
+        bool isCopyMessageOnSend() const;
+
+        /**
+         * Sets whether the Message passed to send is copied before it is sent.  Copying the
+         * message lets the application modify and resend it while the copy is still in
+         * flight.  When disabled the application's own Message object is marshaled, which
+         * avoids copying the body of large messages.  The application must not touch the
+         * Message until send returns and it is left in the read-only state the send put it
+         * in.  Only Messages created by this client and sent without a completion callback
+         * or send timeout are sent without a copy, sends that can leave the Message held by
+         * the transport after send returns always copy it.
+         *
+         * @param copyMessageOnSend
+         *      False to send the application's Message object without copying it.
+         */
+        void setCopyMessageOnSend(bool copyMessageOnSend);
+
+        /**
+         * @return true if the sessions of this connection hold back their consumers'
+         *         acks and send them in batches (default is false).
+         */
+        bool isCoalesceAcks() const;
+
+        /**
+         * Sets whether each session collects the acks of all its consumers and sends
+         * them together instead of one at a time.  Consecutive range acks from the same
+         * consumer are merged into one, the pending acks are sent once the maximum
+         * number are waiting, the maximum delay has passed, the session has no more
+         * messages to dispatch, or before the session commits, rolls back or closes.
+         * Acks that are part of a transaction or that need a response from the Broker
+         * are never held back.  Pending acks are dropped when the transport is
+         * interrupted, the messages they covered are redelivered.
+         *
+         * @param coalesceAcks
+         *      True to coalesce the acks of each session's consumers.
+         */
+        void setCoalesceAcks(bool coalesceAcks);
+
+        /**
+         * @return the number of acks a session holds before sending them.
+         */
+        int getCoalesceAcksMaxPending() const;
+
+        /**
+         * Sets the number of acks a session holds before it sends them, merged acks
+         * count once.
+         *
+         * @param coalesceAcksMaxPending
+         *      The maximum number of acks to hold, (default is 100).
+         */
+        void setCoalesceAcksMaxPending(int coalesceAcksMaxPending);
+
+        /**
+         * @return the time in milliseconds a session holds an ack before sending it.
+         */
+        long long getCoalesceAcksMaxDelay() const;
+
+        /**
+         * Sets the longest time in milliseconds that a session holds an ack before
+         * sending it.
+         *
+         * @param coalesceAcksMaxDelay
+         *      The maximum delay in milliseconds, (default is 10).
+         */
+        void setCoalesceAcksMaxDelay(long long coalesceAcksMaxDelay);
+
         /**
          * @return the current connection's OpenWire protocol version.
          */
@@ -921,6 +1022,14 @@ namespace core {
          */
         Pointer<threads::Scheduler> getScheduler() const;
 
+        /**
+         * Gets the factory used to create the TaskRunners that perform asynchronous
+         * dispatch for the Sessions of this Connection.
+         *
+         * @return a pointer to the TaskRunnerFactory owned by this Connection.
+         */
+        Pointer<threads::TaskRunnerFactory> getSessionTaskRunner() const;
+
         /**
          * Returns the Id of the Resource Manager that this client will use should
          * it be entered into an XA Transaction.
@@ -33,6 +33,7 @@
 #include <activemq/core/ActiveMQMessageAudit.h>
 #include <activemq/core/policies/DefaultPrefetchPolicy.h>
 #include <activemq/core/policies/DefaultRedeliveryPolicy.h>
+#include <activemq/threads/TaskRunnerFactory.h>
 #include <activemq/util/URISupport.h>
 #include <activemq/util/CompositeData.h>
 #include <memory>
@@ -90,6 +91,8 @@ namespace core{
         bool transactedIndividualAck;
         bool nonBlockingRedelivery;
         bool alwaysSessionAsync;
+        bool useDedicatedTaskRunner;
+        int maxThreadPoolSize;
         int compressionLevel;
         unsigned int sendTimeout;
         unsigned int connectResponseTimeout;
@@ -101,6 +104,10 @@ namespace core{
         long long optimizedAckScheduledAckInterval;
         long long consumerFailoverRedeliveryWaitPeriod;
         bool consumerExpiryCheckEnabled;
+        bool copyMessageOnSend;
+        bool coalesceAcks;
+        int coalesceAcksMaxPending;
+        long long coalesceAcksMaxDelay;
 
         cms::ExceptionListener* defaultListener;
         cms::MessageTransformer* defaultTransformer;
@@ -127,6 +134,8 @@ namespace core{
                             transactedIndividualAck(false),
                             nonBlockingRedelivery(false),
                             alwaysSessionAsync(true),
+                            useDedicatedTaskRunner(true),
+                            maxThreadPoolSize(threads::TaskRunnerFactory::DEFAULT_MAX_THREAD_POOL_SIZE),
                             compressionLevel(-1),
                             sendTimeout(0),
                             connectResponseTimeout(0),
@@ -138,6 +147,10 @@ namespace core{
                             optimizedAckScheduledAckInterval(0),
                             consumerFailoverRedeliveryWaitPeriod(0),
                             consumerExpiryCheckEnabled(true),
+                            copyMessageOnSend(true),
+                            coalesceAcks(false),
+                            coalesceAcksMaxPending(100),
+                            coalesceAcksMaxDelay(10),
                             defaultListener(NULL),
                             defaultTransformer(NULL),
                             defaultPrefetchPolicy(new DefaultPrefetchPolicy()),
@@ -227,8 +240,20 @@ namespace core{
                 properties->getProperty("connection.watchTopicAdvisories", Boolean::toString(watchTopicAdvisories)));
             this->alwaysSessionAsync = Boolean::parseBoolean(
                 properties->getProperty("connection.alwaysSessionAsync", Boolean::toString(alwaysSessionAsync)));
+            this->useDedicatedTaskRunner = Boolean::parseBoolean(
+                properties->getProperty("connection.useDedicatedTaskRunner", Boolean::toString(useDedicatedTaskRunner)));
+            this->maxThreadPoolSize = Integer::parseInt(
+                properties->getProperty("connection.maxThreadPoolSize", Integer::toString(maxThreadPoolSize)));
             this->consumerExpiryCheckEnabled = Boolean::parseBoolean(
                 properties->getProperty("connection.consumerExpiryCheckEnabled", Boolean::toString(consumerExpiryCheckEnabled)));
+            this->copyMessageOnSend = Boolean::parseBoolean(
+                properties->getProperty("connection.copyMessageOnSend", Boolean::toString(copyMessageOnSend)));
+            this->coalesceAcks = Boolean::parseBoolean(
+                properties->getProperty("connection.coalesceAcks", Boolean::toString(coalesceAcks)));
+            this->coalesceAcksMaxPending = Integer::parseInt(
+                properties->getProperty("connection.coalesceAcksMaxPending", Integer::toString(coalesceAcksMaxPending)));
+            this->coalesceAcksMaxDelay = Long::parseLong(
+                properties->getProperty("connection.coalesceAcksMaxDelay", Long::toString(coalesceAcksMaxDelay)));
 
             this->defaultPrefetchPolicy->configure(*properties);
             this->defaultRedeliveryPolicy->configure(*properties);
@@ -426,7 +451,13 @@ void ActiveMQConnectionFactory::configureConnection(ActiveMQConnection* connecti
     connection->setNonBlockingRedelivery(this->settings->nonBlockingRedelivery);
     connection->setConsumerFailoverRedeliveryWaitPeriod(this->settings->consumerFailoverRedeliveryWaitPeriod);
     connection->setAlwaysSessionAsync(this->settings->alwaysSessionAsync);
+    connection->setUseDedicatedTaskRunner(this->settings->useDedicatedTaskRunner);
+    connection->setMaxThreadPoolSize(this->settings->maxThreadPoolSize);
     connection->setConsumerExpiryCheckEnabled(this->settings->consumerExpiryCheckEnabled);
+    connection->setCopyMessageOnSend(this->settings->copyMessageOnSend);
+    connection->setCoalesceAcks(this->settings->coalesceAcks);
+    connection->setCoalesceAcksMaxPending(this->settings->coalesceAcksMaxPending);
+    connection->setCoalesceAcksMaxDelay(this->settings->coalesceAcksMaxDelay);
 
     if (this->settings->defaultListener) {
         connection->setExceptionListener(this->settings->defaultListener);
@@ -769,6 +800,26 @@ void ActiveMQConnectionFactory::setAlwaysSessionAsync(bool alwaysSessionAsync) {
     this->settings->alwaysSessionAsync = alwaysSessionAsync;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isUseDedicatedTaskRunner() const {
+    return this->settings->useDedicatedTaskRunner;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setUseDedicatedTaskRunner(bool useDedicatedTaskRunner) {
+    this->settings->useDedicatedTaskRunner = useDedicatedTaskRunner;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnectionFactory::getMaxThreadPoolSize() const {
+    return this->settings->maxThreadPoolSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setMaxThreadPoolSize(int maxThreadPoolSize) {
+    this->settings->maxThreadPoolSize = maxThreadPoolSize;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConnectionFactory::isConsumerExpiryCheckEnabled() {
     return this->settings->consumerExpiryCheckEnabled;
@@ -778,3 +829,43 @@ bool ActiveMQConnectionFactory::isConsumerExpiryCheckEnabled() {
 void ActiveMQConnectionFactory::setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled) {
     this->settings->consumerExpiryCheckEnabled = consumerExpiryCheckEnabled;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isCopyMessageOnSend() const {
+    return this->settings->copyMessageOnSend;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setCopyMessageOnSend(bool copyMessageOnSend) {
+    this->settings->copyMessageOnSend = copyMessageOnSend;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isCoalesceAcks() const {
+    return this->settings->coalesceAcks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setCoalesceAcks(bool coalesceAcks) {
+    this->settings->coalesceAcks = coalesceAcks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnectionFactory::getCoalesceAcksMaxPending() const {
+    return this->settings->coalesceAcksMaxPending;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setCoalesceAcksMaxPending(int coalesceAcksMaxPending) {
+    this->settings->coalesceAcksMaxPending = coalesceAcksMaxPending;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnectionFactory::getCoalesceAcksMaxDelay() const {
+    return this->settings->coalesceAcksMaxDelay;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setCoalesceAcksMaxDelay(long long coalesceAcksMaxDelay) {
+    this->settings->coalesceAcksMaxDelay = coalesceAcksMaxDelay;
+}
@@ -672,6 +672,38 @@ namespace core {
          */
         void setAlwaysSessionAsync(bool alwaysSessionAsync);
 
+        /**
+         * Returns the current value of the use dedicated task runner option.
+         *
+         * @return Returns the useDedicatedTaskRunner configuration setting.
+         */
+        bool isUseDedicatedTaskRunner() const;
+
+        /**
+         * When set 'true' each Session that dispatches asynchronously gets a thread of its own,
+         * when 'false' the Sessions of a Connection share a pool of at most maxThreadPoolSize
+         * threads, which keeps the thread count flat for applications with many Sessions.
+         * By default this value is set to true.
+         *
+         * @param useDedicatedTaskRunner
+         *      The useDedicatedTaskRunner value to use when creating new connections.
+         */
+        void setUseDedicatedTaskRunner(bool useDedicatedTaskRunner);
+
+        /**
+         * @return the maximum number of threads the Sessions of a Connection share.
+         */
+        int getMaxThreadPoolSize() const;
+
+        /**
+         * Sets the maximum number of threads that the Sessions of a Connection share for
+         * asynchronous dispatch, only used when useDedicatedTaskRunner is false.
+         *
+         * @param maxThreadPoolSize
+         *      The maximum number of pooled Session threads per Connection.
+         */
+        void setMaxThreadPoolSize(int maxThreadPoolSize);
+
         /**
          * @return true if the consumer will skip checking messages for expiration.
          */
@@ -686,6 +718,63 @@ namespace core {
          */
         void setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled);
 
+        /**
+         * @return true if Connections created by this factory copy each message they send.
+         */
+        bool isCopyMessageOnSend() const;
+
+        /**
+         * Sets whether Connections created by this factory copy the Message passed to send
+         * before sending it, see ActiveMQConnection::setCopyMessageOnSend for the rules
+         * an application must follow when copying is disabled.
+         *
+         * @param copyMessageOnSend
+         *      False to send the application's Message object without copying it.
+         */
+        void setCopyMessageOnSend(bool copyMessageOnSend);
+
+        /**
+         * @return true if Connections created by this factory coalesce their sessions' acks.
+         */
+        bool isCoalesceAcks() const;
+
+        /**
+         * Sets whether the sessions of Connections created by this factory collect the
+         * acks of their consumers and send them in batches, see
+         * ActiveMQConnection::setCoalesceAcks for when the pending acks are sent.
+         *
+         * @param coalesceAcks
+         *      True to coalesce the acks of each session's consumers.
+         */
+        void setCoalesceAcks(bool coalesceAcks);
+
+        /**
+         * @return the number of acks a session holds before sending them.
+         */
+        int getCoalesceAcksMaxPending() const;
+
+        /**
+         * Sets the number of acks a session holds before it sends them.
+         *
+         * @param coalesceAcksMaxPending
+         *      The maximum number of acks to hold, (default is 100).
+         */
+        void setCoalesceAcksMaxPending(int coalesceAcksMaxPending);
+
+        /**
+         * @return the time in milliseconds a session holds an ack before sending it.
+         */
+        long long getCoalesceAcksMaxDelay() const;
+
+        /**
+         * Sets the longest time in milliseconds that a session holds an ack before
+         * sending it.
+         *
+         * @param coalesceAcksMaxDelay
+         *      The maximum delay in milliseconds, (default is 10).
+         */
+        void setCoalesceAcksMaxDelay(long long coalesceAcksMaxDelay);
+
     public:
 
         /**
@@ -128,3 +128,31 @@ void ActiveMQProducer::send(const cms::Destination* destination, cms::Message* m
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducer::trySend(cms::Message* message) {
+
+    try {
+        return this->kernel->trySend(message);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducer::trySend(const cms::Destination* destination, cms::Message* message) {
+
+    try {
+        return this->kernel->trySend(destination, message);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducer::trySend(const cms::Destination* destination, cms::Message* message,
+                               int deliveryMode, int priority, long long timeToLive, cms::AsyncCallback* callback) {
+
+    try {
+        return this->kernel->trySend(destination, message, deliveryMode, priority, timeToLive, callback);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
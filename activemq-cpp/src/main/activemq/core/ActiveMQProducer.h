@@ -182,6 +182,87 @@ namespace core {
             return this->kernel->getMessageTransformer();
         }
 
+    public:
+
+        /**
+         * Sends the message to the default producer destination only if the producer
+         * window has space for it.  Unlike send this never blocks waiting for the Broker
+         * to acknowledge earlier messages, so an application that must not park its
+         * thread can hold on to the message and retry once credit is available again.
+         * When producer flow control is disabled the message is always sent.
+         *
+         * Only sends that don't wait for the Broker's response are accepted.  A send
+         * timeout, the alwaysSyncSend option or a persistent message sent outside of a
+         * transaction without the useAsyncSend option each make the send a synchronous
+         * request, trySend refuses those.
+         *
+         * @param message
+         *      The message to be sent.
+         *
+         * @return true if the message was sent, false if the producer window is full.
+         *
+         * @throws UnsupportedOperationException if the send would wait for a response
+         *         from the Broker.
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        bool trySend(cms::Message* message);
+
+        /**
+         * Sends the message to the given destination only if the producer window has
+         * space for it, never blocking to wait for the Broker to return space.
+         *
+         * @param destination
+         *      The destination on which to send the message.
+         * @param message
+         *      The message to be sent.
+         *
+         * @return true if the message was sent, false if the producer window is full.
+         *
+         * @throws UnsupportedOperationException if the send would wait for a response
+         *         from the Broker.
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        bool trySend(const cms::Destination* destination, cms::Message* message);
+
+        /**
+         * Sends the message to the given destination only if the producer window has
+         * space for it, never blocking to wait for the Broker to return space.
+         *
+         * @param destination
+         *      The destination on which to send the message.
+         * @param message
+         *      The message to be sent.
+         * @param deliveryMode
+         *      The delivery mode to be used.
+         * @param priority
+         *      The priority for this message.
+         * @param timeToLive
+         *      The time to live value for this message in milliseconds.
+         * @param callback
+         *      The callback to notify when the send completes, or NULL.
+         *
+         * @return true if the message was sent, false if the producer window is full.
+         *
+         * @throws UnsupportedOperationException if the send would wait for a response
+         *         from the Broker.
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        bool trySend(const cms::Destination* destination, cms::Message* message,
+                     int deliveryMode, int priority, long long timeToLive, cms::AsyncCallback* callback);
+
+        /**
+         * Gets the number of bytes of message data this producer can still send before
+         * its producer window is full.  The window is configured on the connection with
+         * the producerWindowSize option and is refilled as the Broker acknowledges sent
+         * messages.
+         *
+         * @return the remaining producer window credit in bytes, or -1 if producer flow
+         *         control is not enabled for this producer.
+         */
+        long long getProducerWindowCredit() const {
+            return this->kernel->getProducerWindowCredit();
+        }
+
     public:
 
         /**
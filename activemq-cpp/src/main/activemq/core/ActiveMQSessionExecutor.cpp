@@ -24,7 +24,7 @@
 #include <activemq/core/FifoMessageDispatchChannel.h>
 #include <activemq/core/SimplePriorityMessageDispatchChannel.h>
 #include <activemq/commands/ConsumerInfo.h>
-#include <activemq/threads/DedicatedTaskRunner.h>
+#include <activemq/threads/TaskRunnerFactory.h>
 
 using namespace std;
 using namespace activemq;
@@ -110,7 +110,8 @@ void ActiveMQSessionExecutor::wakeup() {
             if (!messageQueue->isRunning()) {
                 return;
             }
-            this->taskRunner.reset(new DedicatedTaskRunner(this));
+            this->taskRunner.reset(
+                this->session->getConnection()->getSessionTaskRunner()->createTaskRunner(this));
             this->taskRunner->start();
         }
 
@@ -189,9 +190,14 @@ bool ActiveMQSessionExecutor::iterate() {
         Pointer<MessageDispatch> message = messageQueue->dequeueNoWait();
         if (message != NULL) {
             dispatch(message);
-            return !messageQueue->isEmpty();
+            if (!messageQueue->isEmpty()) {
+                return true;
+            }
         }
 
+        // Out of messages, don't leave the Broker waiting on acks the session holds.
+        this->session->flushAcks();
+
         return false;
 
     } catch (decaf::lang::Exception& ex) {
@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AdaptivePrefetchController.h"
+
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Weight of a new sample in the moving average is 1/AVERAGE_WEIGHT.
+    const long long AVERAGE_WEIGHT = 8;
+
+    // Samples needed before a change is considered, unless a full target's worth
+    // of work has already been seen.
+    const int SAMPLES_PER_CHANGE = 8;
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+AdaptivePrefetchController::AdaptivePrefetchController(int prefetch, int minimum, int maximum, long long targetMillis) :
+    prefetch(prefetch), minimum(minimum), maximum(maximum), targetNanos(targetMillis * 1000000LL),
+    averageNanos(0), samplesSinceChange(0), nanosSinceChange(0) {
+
+    if (minimum < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Adaptive prefetch minimum must be at least one");
+    }
+
+    if (maximum < minimum) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Adaptive prefetch maximum is less than its minimum");
+    }
+
+    if (targetMillis <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Adaptive prefetch target must be greater than zero");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+AdaptivePrefetchController::~AdaptivePrefetchController() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int AdaptivePrefetchController::onMessageConsumed(long long serviceNanos) {
+
+    if (serviceNanos < 0) {
+        serviceNanos = 0;
+    }
+
+    if (this->averageNanos == 0) {
+        this->averageNanos = serviceNanos;
+    } else {
+        this->averageNanos += (serviceNanos - this->averageNanos) / AVERAGE_WEIGHT;
+    }
+
+    this->samplesSinceChange++;
+    this->nanosSinceChange += serviceNanos;
+
+    if (this->samplesSinceChange < SAMPLES_PER_CHANGE && this->nanosSinceChange < this->targetNanos) {
+        return -1;
+    }
+
+    long long average = this->averageNanos > 0 ? this->averageNanos : 1;
+    long long desired = (this->targetNanos + average - 1) / average;
+
+    if (desired < this->minimum) {
+        desired = this->minimum;
+    } else if (desired > this->maximum) {
+        desired = this->maximum;
+    }
+
+    // Small corrections aren't worth a round trip to the Broker.
+    long long delta = desired > this->prefetch ? desired - this->prefetch : this->prefetch - desired;
+    if (delta == 0 || delta * 4 < this->prefetch) {
+        return -1;
+    }
+
+    setPrefetch((int) desired);
+    return this->prefetch;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchController::setPrefetch(int prefetch) {
+    this->prefetch = prefetch;
+    this->samplesSinceChange = 0;
+    this->nanosSinceChange = 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_ADAPTIVEPREFETCHCONTROLLER_H_
+#define _ACTIVEMQ_CORE_ADAPTIVEPREFETCHCONTROLLER_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace core {
+
+    /**
+     * Works out the prefetch size a consumer should run with from how long its
+     * application takes to process each message.  The goal is to keep roughly a
+     * target amount of work buffered at the consumer, a slow consumer then holds
+     * only a few messages that its faster siblings can be given instead while a
+     * fast one is allowed enough messages that it never waits on a round trip to
+     * the Broker.
+     *
+     * The service time of each message is folded into a moving average, once a
+     * few samples or a full target's worth of work has been seen since the last
+     * change the prefetch that covers the target is computed and proposed if it
+     * differs enough from the current one to be worth telling the Broker about.
+     *
+     * This class is not thread safe, the consumer only feeds it from the thread
+     * that delivers its messages.
+     *
+     * @since 3.10.0
+     */
+    class AMQCPP_API AdaptivePrefetchController {
+    private:
+
+        int prefetch;
+        int minimum;
+        int maximum;
+        long long targetNanos;
+
+        long long averageNanos;
+        int samplesSinceChange;
+        long long nanosSinceChange;
+
+    private:
+
+        AdaptivePrefetchController(const AdaptivePrefetchController&);
+        AdaptivePrefetchController& operator=(const AdaptivePrefetchController&);
+
+    public:
+
+        /**
+         * Creates a new controller.
+         *
+         * @param prefetch
+         *      The prefetch size the consumer starts out with.
+         * @param minimum
+         *      The smallest prefetch that will be proposed, at least one.
+         * @param maximum
+         *      The largest prefetch that will be proposed.
+         * @param targetMillis
+         *      How many milliseconds of work should be kept buffered at the consumer.
+         *
+         * @throws IllegalArgumentException if the bounds or the target are invalid.
+         */
+        AdaptivePrefetchController(int prefetch, int minimum, int maximum, long long targetMillis);
+
+        virtual ~AdaptivePrefetchController();
+
+        /**
+         * Records the time the application spent on one message.
+         *
+         * @param serviceNanos
+         *      The time taken to process the message in nanoseconds.
+         *
+         * @return the new prefetch size the consumer should use, or -1 to keep the
+         *         current one.
+         */
+        int onMessageConsumed(long long serviceNanos);
+
+        /**
+         * @return the prefetch size last proposed or set.
+         */
+        int getPrefetch() const {
+            return this->prefetch;
+        }
+
+        /**
+         * Sets the prefetch size the consumer is now using, for when it was changed
+         * by other means such as a request from the Broker.
+         *
+         * @param prefetch
+         *      The prefetch size now in use.
+         */
+        void setPrefetch(int prefetch);
+
+        /**
+         * @return the smallest prefetch that will be proposed.
+         */
+        int getMinimum() const {
+            return this->minimum;
+        }
+
+        /**
+         * @return the largest prefetch that will be proposed.
+         */
+        int getMaximum() const {
+            return this->maximum;
+        }
+
+        /**
+         * @return the amount of buffered work aimed for in milliseconds.
+         */
+        long long getTargetMillis() const {
+            return this->targetNanos / 1000000LL;
+        }
+
+        /**
+         * @return the moving average of the service time in nanoseconds, zero until
+         *         the first message has been recorded.
+         */
+        long long getAverageServiceNanos() const {
+            return this->averageNanos;
+        }
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_ADAPTIVEPREFETCHCONTROLLER_H_ */
@@ -17,8 +17,8 @@
 
 #include "ConnectionAudit.h"
 
-#include <decaf/util/LinkedHashMap.h>
-#include <decaf/util/StlMap.h>
+#include <decaf/util/HashCode.h>
+#include <decaf/util/concurrent/ConcurrentHashMap.h>
 
 #include <activemq/core/Dispatcher.h>
 #include <activemq/core/ActiveMQMessageAudit.h>
@@ -48,12 +48,25 @@ namespace core {
 
     public:
 
-        Mutex mutex;
+        // Every consumer of the connection checks for duplicates here, the maps are
+        // striped so that only consumers whose keys share a segment contend.
+        ConcurrentHashMap<Pointer<ActiveMQDestination>, Pointer<ActiveMQMessageAudit>,
+                          HashCode< Pointer<ActiveMQDestination> >, ActiveMQDestination::COMPARATOR> destinations;
+        ConcurrentHashMap<Dispatcher*, Pointer<ActiveMQMessageAudit> > dispatchers;
 
-        StlMap<Pointer<ActiveMQDestination>, Pointer<ActiveMQMessageAudit>, ActiveMQDestination::COMPARATOR> destinations;
-        LinkedHashMap<Dispatcher*, Pointer<ActiveMQMessageAudit> > dispatchers;
+        ConnectionAuditImpl() : destinations(), dispatchers(1000) {
+        }
 
-        ConnectionAuditImpl() : mutex(), destinations(), dispatchers(1000) {
+        template<typename K, typename MAP>
+        static Pointer<ActiveMQMessageAudit> getOrCreateAudit(MAP& map, const K& key, int auditDepth, int maxProducers) {
+            Pointer<ActiveMQMessageAudit> audit;
+            while (!map.get(key, audit)) {
+                audit.reset(new ActiveMQMessageAudit(auditDepth, maxProducers));
+                if (map.putIfAbsent(key, audit)) {
+                    break;
+                }
+            }
+            return audit;
         }
     };
 }}
@@ -83,41 +96,23 @@ ConnectionAudit::~ConnectionAudit() {
 
 ////////////////////////////////////////////////////////////////////////////////
 void ConnectionAudit::removeDispatcher(Dispatcher* dispatcher) {
-    synchronized(&this->impl->mutex) {
-        try {
-            this->impl->dispatchers.remove(dispatcher);
-        } catch (NoSuchElementException& ex) {
-        }
-    }
+    this->impl->dispatchers.remove(dispatcher);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool ConnectionAudit::isDuplicate(Dispatcher* dispatcher, Pointer<commands::Message> message) {
-    synchronized(&this->impl->mutex) {
-        if (checkForDuplicates && message != NULL) {
-            Pointer<ActiveMQDestination> destination = message->getDestination();
-            if (destination != NULL) {
-                if (destination->isQueue()) {
-                    Pointer<ActiveMQMessageAudit> audit;
-                    try {
-                        audit = this->impl->destinations.get(destination);
-                    } catch (NoSuchElementException& ex) {
-                        audit.reset(new ActiveMQMessageAudit(auditDepth, auditMaximumProducerNumber));
-                        this->impl->destinations.put(destination, audit);
-                    }
-                    bool result = audit->isDuplicate(message->getMessageId());
-                    return result;
-                }
-                Pointer<ActiveMQMessageAudit> audit;
-                try {
-                    audit = this->impl->dispatchers.get(dispatcher);
-                } catch (NoSuchElementException& ex) {
-                    audit.reset(new ActiveMQMessageAudit(auditDepth, auditMaximumProducerNumber));
-                    this->impl->dispatchers.put(dispatcher, audit);
-                }
-                bool result = audit->isDuplicate(message->getMessageId());
-                return result;
+    if (checkForDuplicates && message != NULL) {
+        Pointer<ActiveMQDestination> destination = message->getDestination();
+        if (destination != NULL) {
+            Pointer<ActiveMQMessageAudit> audit;
+            if (destination->isQueue()) {
+                audit = ConnectionAuditImpl::getOrCreateAudit(
+                    this->impl->destinations, destination, auditDepth, auditMaximumProducerNumber);
+            } else {
+                audit = ConnectionAuditImpl::getOrCreateAudit(
+                    this->impl->dispatchers, dispatcher, auditDepth, auditMaximumProducerNumber);
             }
+            return audit->isDuplicate(message->getMessageId());
         }
     }
     return false;
@@ -125,21 +120,14 @@ bool ConnectionAudit::isDuplicate(Dispatcher* dispatcher, Pointer<commands::Mess
 
 ////////////////////////////////////////////////////////////////////////////////
 void ConnectionAudit::rollbackDuplicate(Dispatcher* dispatcher, Pointer<commands::Message> message) {
-    synchronized(&this->impl->mutex) {
-        if (checkForDuplicates && message != NULL) {
-            Pointer<ActiveMQDestination> destination = message->getDestination();
-            if (destination != NULL) {
-                if (destination->isQueue()) {
-                    try {
-                        Pointer<ActiveMQMessageAudit> audit = this->impl->destinations.get(destination);
-                        audit->rollback(message->getMessageId());
-                    } catch (NoSuchElementException& ex) {}
-                } else {
-                    try {
-                        Pointer<ActiveMQMessageAudit> audit = this->impl->dispatchers.get(dispatcher);
-                        audit->rollback(message->getMessageId());
-                    } catch (NoSuchElementException& ex) {}
-                }
+    if (checkForDuplicates && message != NULL) {
+        Pointer<ActiveMQDestination> destination = message->getDestination();
+        if (destination != NULL) {
+            Pointer<ActiveMQMessageAudit> audit;
+            bool found = destination->isQueue() ? this->impl->destinations.get(destination, audit) :
+                                                  this->impl->dispatchers.get(dispatcher, audit);
+            if (found) {
+                audit->rollback(message->getMessageId());
             }
         }
     }
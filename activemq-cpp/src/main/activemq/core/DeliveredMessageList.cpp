@@ -0,0 +1,287 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DeliveredMessageList.h"
+
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/NoSuchElementException.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace core {
+
+    /**
+     * Walks the list from the newest delivery to the oldest by absolute position,
+     * positions stay valid while entries are removed or trimmed so the iterator can
+     * remove the element it last returned without disturbing the walk.
+     */
+    class DeliveredMessageListIterator : public Iterator< Pointer<MessageDispatch> > {
+    private:
+
+        const DeliveredMessageList* list;
+        DeliveredMessageList* mutableList;
+        mutable long long cursor;
+        long long lastReturned;
+        bool canRemove;
+
+    private:
+
+        DeliveredMessageListIterator(const DeliveredMessageListIterator&);
+        DeliveredMessageListIterator& operator=(const DeliveredMessageListIterator&);
+
+    public:
+
+        DeliveredMessageListIterator(const DeliveredMessageList* list, DeliveredMessageList* mutableList) :
+            Iterator< Pointer<MessageDispatch> >(), list(list), mutableList(mutableList),
+            cursor(list->offset + (long long) list->dispatches.size() - 1), lastReturned(0), canRemove(false) {
+        }
+
+        virtual ~DeliveredMessageListIterator() {}
+
+        virtual Pointer<MessageDispatch> next() {
+
+            if (!hasNext()) {
+                throw NoSuchElementException(
+                    __FILE__, __LINE__, "No more elements to return from next()");
+            }
+
+            this->lastReturned = this->cursor--;
+            this->canRemove = true;
+
+            return this->list->dispatches[(std::size_t) (this->lastReturned - this->list->offset)];
+        }
+
+        virtual bool hasNext() const {
+
+            long long back = this->list->offset + (long long) this->list->dispatches.size() - 1;
+            if (this->cursor > back) {
+                this->cursor = back;
+            }
+
+            while (this->cursor >= this->list->offset &&
+                   this->list->dispatches[(std::size_t) (this->cursor - this->list->offset)] == NULL) {
+                this->cursor--;
+            }
+
+            return this->cursor >= this->list->offset;
+        }
+
+        virtual void remove() {
+
+            if (this->mutableList == NULL) {
+                throw UnsupportedOperationException(
+                    __FILE__, __LINE__, "Cannot write to a const DeliveredMessageList.");
+            }
+
+            if (!this->canRemove) {
+                throw IllegalStateException(
+                    __FILE__, __LINE__, "Must call next() before calling remove().");
+            }
+
+            this->canRemove = false;
+            this->mutableList->removeAt(this->lastReturned);
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+DeliveredMessageList::DeliveredMessageList() :
+    AbstractCollection< Pointer<MessageDispatch> >(), dispatches(), positions(), offset(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DeliveredMessageList::~DeliveredMessageList() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageList::addFirst(const Pointer<MessageDispatch>& dispatch) {
+
+    if (dispatch == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Cannot add a NULL MessageDispatch.");
+    }
+
+    if (this->positions.containsKey(dispatch.get())) {
+        removeAt(this->positions.get(dispatch.get()));
+    }
+
+    compact();
+
+    this->positions.put(dispatch.get(), this->offset + (long long) this->dispatches.size());
+    this->dispatches.push_back(dispatch);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageList::addLast(const Pointer<MessageDispatch>& dispatch) {
+
+    if (dispatch == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Cannot add a NULL MessageDispatch.");
+    }
+
+    if (this->positions.containsKey(dispatch.get())) {
+        removeAt(this->positions.get(dispatch.get()));
+    }
+
+    compact();
+
+    this->positions.put(dispatch.get(), --this->offset);
+    this->dispatches.push_front(dispatch);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> DeliveredMessageList::getFirst() const {
+
+    if (this->dispatches.empty()) {
+        throw NoSuchElementException(__FILE__, __LINE__, "The list is Empty");
+    }
+
+    return this->dispatches.back();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> DeliveredMessageList::getLast() const {
+
+    if (this->dispatches.empty()) {
+        throw NoSuchElementException(__FILE__, __LINE__, "The list is Empty");
+    }
+
+    return this->dispatches.front();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> DeliveredMessageList::removeLast() {
+
+    if (this->dispatches.empty()) {
+        throw NoSuchElementException(__FILE__, __LINE__, "The list is Empty");
+    }
+
+    Pointer<MessageDispatch> oldest = this->dispatches.front();
+    removeAt(this->offset);
+
+    return oldest;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DeliveredMessageList::add(const Pointer<MessageDispatch>& dispatch) {
+    addLast(dispatch);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DeliveredMessageList::contains(const Pointer<MessageDispatch>& dispatch) const {
+    return this->positions.containsKey(dispatch.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DeliveredMessageList::remove(const Pointer<MessageDispatch>& dispatch) {
+
+    if (!this->positions.containsKey(dispatch.get())) {
+        return false;
+    }
+
+    removeAt(this->positions.get(dispatch.get()));
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageList::clear() {
+    this->dispatches.clear();
+    this->positions.clear();
+    this->offset = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int DeliveredMessageList::size() const {
+    return this->positions.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DeliveredMessageList::isEmpty() const {
+    return this->positions.isEmpty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Iterator< Pointer<MessageDispatch> >* DeliveredMessageList::iterator() {
+    return new DeliveredMessageListIterator(this, this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Iterator< Pointer<MessageDispatch> >* DeliveredMessageList::iterator() const {
+    return new DeliveredMessageListIterator(this, NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageList::removeAt(long long position) {
+
+    Pointer<MessageDispatch>& slot = this->dispatches[(std::size_t) (position - this->offset)];
+
+    this->positions.remove(slot.get());
+    slot.reset(NULL);
+
+    trim();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageList::trim() {
+
+    while (!this->dispatches.empty() && this->dispatches.front() == NULL) {
+        this->dispatches.pop_front();
+        this->offset++;
+    }
+
+    while (!this->dispatches.empty() && this->dispatches.back() == NULL) {
+        this->dispatches.pop_back();
+    }
+
+    if (this->dispatches.empty()) {
+        this->offset = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageList::compact() {
+
+    // Only worth a pass over the list once the empty slots left by removals
+    // from the middle outnumber the messages still being held.
+    std::size_t held = (std::size_t) this->positions.size();
+    if (this->dispatches.size() <= held * 2 + 32) {
+        return;
+    }
+
+    std::deque< Pointer<MessageDispatch> > live;
+    std::deque< Pointer<MessageDispatch> >::const_iterator iter = this->dispatches.begin();
+    for (; iter != this->dispatches.end(); ++iter) {
+        if (*iter != NULL) {
+            this->positions.put(iter->get(), (long long) live.size());
+            live.push_back(*iter);
+        }
+    }
+
+    this->dispatches.swap(live);
+    this->offset = 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_DELIVEREDMESSAGELIST_H_
+#define _ACTIVEMQ_CORE_DELIVEREDMESSAGELIST_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/MessageDispatch.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/AbstractCollection.h>
+#include <decaf/util/HashCode.h>
+#include <decaf/util/HashMap.h>
+#include <decaf/util/Iterator.h>
+
+#include <cstddef>
+#include <deque>
+
+namespace activemq {
+namespace core {
+
+    using decaf::lang::Pointer;
+    using activemq::commands::MessageDispatch;
+
+    class DeliveredMessageListIterator;
+
+    /**
+     * Holds the messages a consumer has delivered but not yet acknowledged.  The
+     * dispatches are kept in delivery order in a deque and indexed by a hash map
+     * from each dispatch to its position, so adding, finding and removing a single
+     * message and reading either end of the list are all constant time operations
+     * no matter how many messages are outstanding.
+     *
+     * Messages removed from the middle of the list leave an empty slot behind that
+     * is skipped by iteration, slots at either end are trimmed right away and the
+     * rest are compacted out once they outnumber the messages still held.
+     *
+     * The list follows the LinkedList conventions the consumer was written against,
+     * the first element is the most recently delivered message and the last is the
+     * oldest one, iteration runs from the newest message to the oldest.  A dispatch
+     * is held at most once, adding one that is already in the list moves it.
+     *
+     * This class is not thread safe, callers synchronize on the list itself.
+     *
+     * @since 3.10.0
+     */
+    class AMQCPP_API DeliveredMessageList : public decaf::util::AbstractCollection< Pointer<MessageDispatch> > {
+    private:
+
+        friend class DeliveredMessageListIterator;
+
+        // Dispatches are tracked by identity, so hash the address rather than the
+        // contents, dropping the low bits that allocation alignment leaves unset.
+        struct DispatchHashCode : public decaf::util::HashCodeUnaryBase<MessageDispatch*> {
+            int operator()(MessageDispatch* dispatch) const {
+                unsigned long long address = (unsigned long long) reinterpret_cast<std::size_t>(dispatch);
+                return (int) ((address >> 4) ^ (address >> 32));
+            }
+        };
+
+        // Oldest delivery at the front, removed entries are left as NULL slots.
+        std::deque< Pointer<MessageDispatch> > dispatches;
+
+        // Maps each held dispatch to its absolute position, offset is the absolute
+        // position of the front slot of the deque.
+        decaf::util::HashMap<MessageDispatch*, long long, DispatchHashCode> positions;
+        long long offset;
+
+    private:
+
+        DeliveredMessageList(const DeliveredMessageList&);
+        DeliveredMessageList& operator=(const DeliveredMessageList&);
+
+    public:
+
+        DeliveredMessageList();
+
+        virtual ~DeliveredMessageList();
+
+        /**
+         * Adds a newly delivered message to the front of the list.
+         *
+         * @param dispatch
+         *      The MessageDispatch that was delivered.
+         *
+         * @throws NullPointerException if the dispatch is NULL.
+         */
+        void addFirst(const Pointer<MessageDispatch>& dispatch);
+
+        /**
+         * Adds a message to the back of the list, making it the oldest delivery.
+         *
+         * @param dispatch
+         *      The MessageDispatch to add.
+         *
+         * @throws NullPointerException if the dispatch is NULL.
+         */
+        void addLast(const Pointer<MessageDispatch>& dispatch);
+
+        /**
+         * @return the most recently delivered message.
+         *
+         * @throws NoSuchElementException if the list is empty.
+         */
+        Pointer<MessageDispatch> getFirst() const;
+
+        /**
+         * @return the oldest delivered message.
+         *
+         * @throws NoSuchElementException if the list is empty.
+         */
+        Pointer<MessageDispatch> getLast() const;
+
+        /**
+         * Removes and returns the oldest delivered message.
+         *
+         * @return the oldest delivered message.
+         *
+         * @throws NoSuchElementException if the list is empty.
+         */
+        Pointer<MessageDispatch> removeLast();
+
+        virtual bool add(const Pointer<MessageDispatch>& dispatch);
+
+        virtual bool contains(const Pointer<MessageDispatch>& dispatch) const;
+
+        virtual bool remove(const Pointer<MessageDispatch>& dispatch);
+
+        virtual void clear();
+
+        virtual int size() const;
+
+        virtual bool isEmpty() const;
+
+        virtual decaf::util::Iterator< Pointer<MessageDispatch> >* iterator();
+
+        virtual decaf::util::Iterator< Pointer<MessageDispatch> >* iterator() const;
+
+    private:
+
+        void removeAt(long long position);
+
+        void trim();
+
+        void compact();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_DELIVEREDMESSAGELIST_H_ */
@@ -35,6 +35,7 @@
 #include <activemq/util/ActiveMQProperties.h>
 #include <activemq/util/ActiveMQMessageTransformation.h>
 #include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/commands/ConsumerControl.h>
 #include <activemq/commands/Message.h>
 #include <activemq/commands/MessageAck.h>
 #include <activemq/commands/MessagePull.h>
@@ -45,6 +46,8 @@
 #include <activemq/core/ActiveMQConstants.h>
 #include <activemq/core/ActiveMQTransactionContext.h>
 #include <activemq/core/ActiveMQAckHandler.h>
+#include <activemq/core/AdaptivePrefetchController.h>
+#include <activemq/core/DeliveredMessageList.h>
 #include <activemq/core/FifoMessageDispatchChannel.h>
 #include <activemq/core/SimplePriorityMessageDispatchChannel.h>
 #include <activemq/core/RedeliveryPolicy.h>
@@ -101,7 +104,7 @@ namespace kernels {
         AtomicBoolean started;
         AtomicBoolean closeSyncRegistered;
         Pointer<MessageDispatchChannel> unconsumedMessages;
-        decaf::util::LinkedList< decaf::lang::Pointer<commands::MessageDispatch> > deliveredMessages;
+        DeliveredMessageList deliveredMessages;
         long long lastDeliveredSequenceId;
         Pointer<commands::MessageAck> pendingAck;
         int deliveredCounter;
@@ -126,6 +129,9 @@ namespace kernels {
         Runnable* optimizedAckTask;
         int ackCounter;
         int dispatchedCount;
+        Pointer<AdaptivePrefetchController> adaptivePrefetch;
+        AtomicInteger brokerPrefetch;
+        long long lastReceiveNanos;
         Pointer<ExecutorService> executor;
         ActiveMQSessionKernel* session;
         ActiveMQConsumerKernel* parent;
@@ -164,6 +170,9 @@ namespace kernels {
                                          optimizedAckTask(),
                                          ackCounter(),
                                          dispatchedCount(),
+                                         adaptivePrefetch(),
+                                         brokerPrefetch(-1),
+                                         lastReceiveNanos(0),
                                          executor(),
                                          session(),
                                          parent(),
@@ -381,6 +390,64 @@ namespace kernels {
             cause->setMessage(message);
             return cause;
         }
+
+        // The prefetch the acks are batched against, with adaptive prefetch the window
+        // the Broker is using can be much smaller than the one the consumer started with
+        // but never larger, the Broker may not have seen a proposal to grow it yet.
+        int getAckWindowSize() const {
+            if (adaptivePrefetch != NULL) {
+                return Math::min(info->getPrefetchSize(), info->getCurrentPrefetchSize());
+            }
+
+            return info->getPrefetchSize();
+        }
+
+        // Feeds the time the application spent on a message to the adaptive prefetch
+        // controller and tells the Broker when it proposes a new prefetch size.
+        void adaptPrefetch(long long serviceNanos) {
+
+            // The controller isn't thread safe, a prefetch set by the Broker is handed
+            // over here on the thread that feeds it.
+            if (brokerPrefetch.get() >= 0) {
+                int fromBroker = brokerPrefetch.getAndSet(-1);
+                if (fromBroker >= 0) {
+                    adaptivePrefetch->setPrefetch(fromBroker);
+                }
+            }
+
+            int prefetch = adaptivePrefetch->onMessageConsumed(serviceNanos);
+            if (prefetch < 0) {
+                return;
+            }
+
+            info->setCurrentPrefetchSize(prefetch);
+
+            Pointer<ConsumerControl> control(new ConsumerControl());
+            control->setConsumerId(info->getConsumerId());
+            control->setDestination(info->getDestination());
+            control->setPrefetch(prefetch);
+
+            // Only advisory, the Broker keeps using the old prefetch if this is lost.
+            try {
+                session->oneway(control);
+            }
+            AMQ_CATCHALL_NOTHROW()
+        }
+
+        // A synchronous consumer's service time is the time between getting a message
+        // from receive and coming back for the next one.
+        void beforeReceive() {
+            if (adaptivePrefetch != NULL && lastReceiveNanos != 0) {
+                adaptPrefetch(System::nanoTime() - lastReceiveNanos);
+                lastReceiveNanos = 0;
+            }
+        }
+
+        void afterReceive() {
+            if (adaptivePrefetch != NULL) {
+                lastReceiveNanos = System::nanoTime();
+            }
+        }
     };
 
 }}}
@@ -1023,6 +1090,12 @@ decaf::lang::Pointer<MessageDispatch> ActiveMQConsumerKernel::dequeue(long long
 
         // Loop until the time is up or we get a non-expired message
         while (true) {
+
+            // The Broker may be waiting on acks the session holds before it sends more.
+            if (this->internal->unconsumedMessages->isEmpty()) {
+                this->session->flushAcks();
+            }
+
             Pointer<MessageDispatch> dispatch = this->internal->unconsumedMessages->dequeue(timeout);
             if (dispatch == NULL) {
                 if (timeout > 0 && !this->internal->unconsumedMessages->isClosed()) {
@@ -1074,6 +1147,7 @@ cms::Message* ActiveMQConsumerKernel::receive() {
 
         this->checkClosed();
         this->checkMessageListener();
+        this->internal->beforeReceive();
 
         // Send a request for a new message if needed
         this->sendPullRequest(0);
@@ -1086,6 +1160,7 @@ cms::Message* ActiveMQConsumerKernel::receive() {
 
         beforeMessageIsConsumed(message);
         afterMessageIsConsumed(message, false);
+        this->internal->afterReceive();
 
         // Need to clone the message because the user is responsible for freeing
         // its copy of the message, createCMSMessage will do this for us.
@@ -1105,6 +1180,8 @@ cms::Message* ActiveMQConsumerKernel::receive(int timeout) {
             return this->receive();
         }
 
+        this->internal->beforeReceive();
+
         // Send a request for a new message if needed
         this->sendPullRequest(timeout);
 
@@ -1122,6 +1199,7 @@ cms::Message* ActiveMQConsumerKernel::receive(int timeout) {
 
         beforeMessageIsConsumed(message);
         afterMessageIsConsumed(message, false);
+        this->internal->afterReceive();
 
         // Need to clone the message because the user is responsible for freeing
         // its copy of the message, createCMSMessage will do this for us.
@@ -1137,6 +1215,7 @@ cms::Message* ActiveMQConsumerKernel::receiveNoWait() {
 
         this->checkClosed();
         this->checkMessageListener();
+        this->internal->beforeReceive();
 
         // Send a request for a new message if needed
         this->sendPullRequest(-1);
@@ -1155,6 +1234,7 @@ cms::Message* ActiveMQConsumerKernel::receiveNoWait() {
 
         beforeMessageIsConsumed(message);
         afterMessageIsConsumed(message, false);
+        this->internal->afterReceive();
 
         // Need to clone the message because the user is responsible for freeing
         // its copy of the message, createCMSMessage will do this for us.
@@ -1265,7 +1345,7 @@ void ActiveMQConsumerKernel::afterMessageIsConsumed(Pointer<MessageDispatch> mes
                         if (this->internal->optimizeAcknowledge) {
 
                             this->internal->ackCounter++;
-                            if (this->internal->isTimeForOptimizedAck(this->consumerInfo->getPrefetchSize())) {
+                            if (this->internal->isTimeForOptimizedAck(this->internal->getAckWindowSize())) {
                                 Pointer<MessageAck> ack =
                                     makeAckForAllDeliveredMessages(ActiveMQConstants::ACK_TYPE_CONSUMED);
                                 if (ack != NULL) {
@@ -1391,7 +1471,7 @@ void ActiveMQConsumerKernel::ackLater(Pointer<MessageDispatch> dispatch, int ack
 
     // Need to evaluate both expired and normal messages as otherwise consumer may get stalled
     int pendingAcks = (internal->deliveredCounter + internal->ackCounter) - internal->additionalWindowSize;
-    if ((0.5 * this->consumerInfo->getPrefetchSize()) <= pendingAcks) {
+    if ((0.5 * this->internal->getAckWindowSize()) <= pendingAcks) {
         session->sendAck(this->internal->pendingAck);
         this->internal->pendingAck.reset(NULL);
         this->internal->deliveredCounter = 0;
@@ -1641,7 +1721,13 @@ void ActiveMQConsumerKernel::dispatch(const Pointer<MessageDispatch>& dispatch)
                             try {
                                 bool expired = isConsumerExpiryCheckEnabled() && dispatch->getMessage()->isExpired();
                                 if (!expired) {
-                                    this->internal->listener->onMessage(message.get());
+                                    if (this->internal->adaptivePrefetch != NULL) {
+                                        long long start = System::nanoTime();
+                                        this->internal->listener->onMessage(message.get());
+                                        this->internal->adaptPrefetch(System::nanoTime() - start);
+                                    } else {
+                                        this->internal->listener->onMessage(message.get());
+                                    }
                                 }
                                 afterMessageIsConsumed(dispatch, expired);
                             } catch (RuntimeException& e) {
@@ -1700,6 +1786,8 @@ Pointer<cms::Message> ActiveMQConsumerKernel::createCMSMessage(Pointer<MessageDi
 
     try {
 
+        // The copy shares the dispatched Message's body, it is only duplicated if the
+        // application modifies the body of the Message it was given.
         Pointer<Message> message = dispatch->getMessage()->copy();
         if (this->internal->transformer != NULL) {
             cms::Message* source = dynamic_cast<cms::Message*>(message.get());
@@ -1917,6 +2005,26 @@ void ActiveMQConsumerKernel::applyDestinationOptions(Pointer<ConsumerInfo> info)
         options.getProperty("consumer.transactedIndividualAck", "false"));
     this->internal->consumerExpiryCheckEnabled = Boolean::parseBoolean(
         options.getProperty("consumer.consumerExpiryCheckEnabled", "true"));
+
+    // A consumer pulling with a zero prefetch has nothing to adapt.
+    if (Boolean::parseBoolean(options.getProperty("consumer.adaptivePrefetch", "false")) && info->getPrefetchSize() > 0) {
+
+        // Never propose more than the configured prefetch, the acks are batched
+        // against it and the Broker could otherwise hold back messages waiting on them.
+        int maximum = Math::min(info->getPrefetchSize(), Integer::parseInt(options.getProperty(
+            "consumer.adaptivePrefetchMaximum", Integer::toString(info->getPrefetchSize()))));
+        int minimum = Integer::parseInt(options.getProperty("consumer.adaptivePrefetchMinimum", "1"));
+        if (minimum > maximum) {
+            minimum = maximum;
+        }
+        long long target = Long::parseLong(options.getProperty("consumer.adaptivePrefetchTarget", "100"));
+
+        int prefetch = Math::min(Math::max(info->getPrefetchSize(), minimum), maximum);
+        this->internal->adaptivePrefetch.reset(new AdaptivePrefetchController(prefetch, minimum, maximum, target));
+
+        info->setPrefetchSize(prefetch);
+        info->setCurrentPrefetchSize(prefetch);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2016,6 +2124,10 @@ decaf::lang::Exception* ActiveMQConsumerKernel::getFailureError() const {
 void ActiveMQConsumerKernel::setPrefetchSize(int prefetchSize) {
     deliverAcks();
     this->consumerInfo->setCurrentPrefetchSize(prefetchSize);
+
+    if (this->internal->adaptivePrefetch != NULL) {
+        this->internal->brokerPrefetch.set(prefetchSize);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -20,6 +20,7 @@
 #include <cms/Message.h>
 #include <activemq/core/kernels/ActiveMQSessionKernel.h>
 #include <activemq/core/ActiveMQConnection.h>
+#include <activemq/commands/Message.h>
 #include <activemq/commands/RemoveInfo.h>
 #include <activemq/util/CMSExceptionSupport.h>
 #include <activemq/util/ActiveMQProperties.h>
@@ -210,8 +211,59 @@ void ActiveMQProducerKernel::send(const cms::Destination* destination, cms::Mess
                                   int deliveryMode, int priority, long long timeToLive, cms::AsyncCallback* onComplete) {
 
     try {
+        this->checkClosed();
+        this->doSend(destination, message, deliveryMode, priority, timeToLive, onComplete, true);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducerKernel::trySend(cms::Message* message) {
+
+    try {
+        this->checkClosed();
+        return this->doSend(this->destination.get(), message, defaultDeliveryMode, defaultPriority, defaultTimeToLive, NULL, false);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducerKernel::trySend(const cms::Destination* destination, cms::Message* message) {
+
+    try {
+        this->checkClosed();
+        return this->doSend(destination, message, defaultDeliveryMode, defaultPriority, defaultTimeToLive, NULL, false);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducerKernel::trySend(const cms::Destination* destination, cms::Message* message,
+                                     int deliveryMode, int priority, long long timeToLive, cms::AsyncCallback* onComplete) {
 
+    try {
         this->checkClosed();
+        return this->doSend(destination, message, deliveryMode, priority, timeToLive, onComplete, false);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQProducerKernel::getProducerWindowCredit() const {
+
+    if (this->memoryUsage.get() == NULL) {
+        return -1;
+    }
+
+    return (long long) this->memoryUsage->getAvailableSpace();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducerKernel::doSend(const cms::Destination* destination, cms::Message* message,
+                                    int deliveryMode, int priority, long long timeToLive,
+                                    cms::AsyncCallback* onComplete, bool waitForSpace) {
+
+    try {
 
         if (destination == NULL) {
 
@@ -260,16 +312,36 @@ void ActiveMQProducerKernel::send(const cms::Destination* destination, cms::Mess
             }
         }
 
+        // A send that waits on the Broker's response would block a trySend caller.
+        if (!waitForSpace && onComplete == NULL) {
+            const commands::Message* amqMessage = dynamic_cast<const commands::Message*>(outbound);
+            bool responseRequired = amqMessage != NULL && amqMessage->isResponseRequired();
+
+            if (this->session->isSynchronousSend(responseRequired, deliveryMode, this->sendTimeout)) {
+                throw cms::UnsupportedOperationException(
+                    "trySend cannot send a message that waits for a response from the Broker, "
+                    "use an AsyncCallback or send instead.", NULL);
+            }
+        }
+
         if (this->memoryUsage.get() != NULL) {
-            try {
-                this->memoryUsage->waitForSpace();
-            } catch (InterruptedException& e) {
-                throw cms::CMSException("Send aborted due to thread interrupt.");
+            if (!waitForSpace) {
+                if (this->memoryUsage->isFull()) {
+                    return false;
+                }
+            } else {
+                try {
+                    this->memoryUsage->waitForSpace();
+                } catch (InterruptedException& e) {
+                    throw cms::CMSException("Send aborted due to thread interrupt.");
+                }
             }
         }
 
         this->session->send(this, dest, outbound, deliveryMode, priority, timeToLive,
                             this->memoryUsage.get(), this->sendTimeout, onComplete);
+
+        return true;
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -154,6 +154,79 @@ namespace kernels {
             return this->transformer;
         }
 
+    public:
+
+        /**
+         * Sends the message to the default producer destination only if the producer
+         * window has space for it, never blocking to wait for the Broker to return
+         * space.  When producer flow control is disabled the message is always sent.
+         * A send that would wait for the Broker's response is refused, see
+         * ActiveMQSessionKernel::isSynchronousSend.
+         *
+         * @param message
+         *      The message to be sent.
+         *
+         * @return true if the message was sent, false if the producer window is full.
+         *
+         * @throws UnsupportedOperationException if the send would wait for a response
+         *         from the Broker.
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        bool trySend(cms::Message* message);
+
+        /**
+         * Sends the message to the given destination only if the producer window has
+         * space for it, never blocking to wait for the Broker to return space.
+         *
+         * @param destination
+         *      The destination on which to send the message.
+         * @param message
+         *      The message to be sent.
+         *
+         * @return true if the message was sent, false if the producer window is full.
+         *
+         * @throws UnsupportedOperationException if the send would wait for a response
+         *         from the Broker.
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        bool trySend(const cms::Destination* destination, cms::Message* message);
+
+        /**
+         * Sends the message to the given destination only if the producer window has
+         * space for it, never blocking to wait for the Broker to return space.
+         *
+         * @param destination
+         *      The destination on which to send the message.
+         * @param message
+         *      The message to be sent.
+         * @param deliveryMode
+         *      The delivery mode to be used.
+         * @param priority
+         *      The priority for this message.
+         * @param timeToLive
+         *      The time to live value for this message in milliseconds.
+         * @param onComplete
+         *      The callback to notify when the send completes, or NULL.
+         *
+         * @return true if the message was sent, false if the producer window is full.
+         *
+         * @throws UnsupportedOperationException if the send would wait for a response
+         *         from the Broker.
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        bool trySend(const cms::Destination* destination, cms::Message* message,
+                     int deliveryMode, int priority, long long timeToLive, cms::AsyncCallback* onComplete);
+
+        /**
+         * Gets the number of bytes of message data this producer can still send before
+         * its producer window is full and sends must wait for the Broker to acknowledge
+         * earlier ones.
+         *
+         * @return the remaining producer window credit in bytes, or -1 if producer flow
+         *         control is not enabled for this producer.
+         */
+        long long getProducerWindowCredit() const;
+
         /**
          * Sets the delivery mode for this Producer
          * @param mode - The DeliveryMode to use for Message sends.
@@ -301,6 +374,12 @@ namespace kernels {
        // Checks for the closed state and throws if so.
        void checkClosed() const;
 
+       // Sends the message, when the producer window is full it either waits for space
+       // or returns false without sending.
+       bool doSend(const cms::Destination* destination, cms::Message* message,
+                   int deliveryMode, int priority, long long timeToLive,
+                   cms::AsyncCallback* onComplete, bool waitForSpace);
+
     };
 
 }}}
@@ -25,10 +25,14 @@
 #include <activemq/core/ActiveMQProducer.h>
 #include <activemq/core/ActiveMQQueueBrowser.h>
 #include <activemq/core/ActiveMQSessionExecutor.h>
+#include <activemq/core/AckCoalescer.h>
 #include <activemq/core/PrefetchPolicy.h>
 #include <activemq/util/ActiveMQProperties.h>
 #include <activemq/util/ActiveMQMessageTransformation.h>
 #include <activemq/util/CMSExceptionSupport.h>
+#include <activemq/threads/Task.h>
+#include <activemq/threads/TaskRunner.h>
+#include <activemq/threads/TaskRunnerFactory.h>
 
 #include <activemq/commands/ConsumerInfo.h>
 #include <activemq/commands/DestinationInfo.h>
@@ -55,6 +59,8 @@
 #include <decaf/lang/Math.h>
 #include <decaf/util/Queue.h>
 #include <decaf/util/LinkedList.h>
+#include <decaf/util/HashCode.h>
+#include <decaf/util/HashMap.h>
 #include <decaf/util/concurrent/Mutex.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 #include <decaf/util/concurrent/locks/ReentrantReadWriteLock.h>
@@ -82,6 +88,17 @@ namespace kernels{
 
     class CloseSynhcronization;
 
+    /**
+     * Hashes a ConsumerId using only its numeric fields, every consumer in a
+     * session shares the same connection id so hashing it for every dispatch
+     * would add nothing.
+     */
+    struct ConsumerIdHashCode : public HashCodeUnaryBase<const ConsumerId&> {
+        int operator()(const ConsumerId& id) const {
+            return 31 * HashCode<long long>()(id.getSessionId()) + HashCode<long long>()(id.getValue());
+        }
+    };
+
     class SessionConfig {
     private:
 
@@ -95,9 +112,14 @@ namespace kernels{
         decaf::util::LinkedList< Pointer<ActiveMQProducerKernel> > producers;
         decaf::util::concurrent::locks::ReentrantReadWriteLock consumerLock;
         decaf::util::LinkedList< Pointer<ActiveMQConsumerKernel> > consumers;
+        decaf::util::HashMap<ConsumerId, Pointer<ActiveMQConsumerKernel>, ConsumerIdHashCode> consumersById;
         Pointer<Scheduler> scheduler;
         Pointer<CloseSynhcronization> closeSync;
         Mutex sendMutex;
+        Pointer<AckCoalescer> ackCoalescer;
+        Pointer<Task> ackFlushTask;
+        Pointer<TaskRunner> ackFlushRunner;
+        Runnable* ackFlushTimer;
         cms::MessageTransformer* transformer;
         int hashCode;
         bool sessionAsyncDispatch;
@@ -105,9 +127,9 @@ namespace kernels{
     public:
 
         SessionConfig() : synchronizationRegistered(false),
-                          producerLock(), producers(), consumerLock(), consumers(),
-                          scheduler(), closeSync(), sendMutex(), transformer(NULL),
-                          hashCode(), sessionAsyncDispatch(true) {}
+                          producerLock(), producers(), consumerLock(), consumers(), consumersById(),
+                          scheduler(), closeSync(), sendMutex(), ackCoalescer(), ackFlushTask(), ackFlushRunner(), ackFlushTimer(NULL),
+                          transformer(NULL), hashCode(), sessionAsyncDispatch(true) {}
         ~SessionConfig() {}
     };
 
@@ -142,6 +164,99 @@ namespace kernels{
         }
     };
 
+    /**
+     * Keeps a Pointer that was handed a Message the application still owns from
+     * deleting it, the Pointer is released on every path out of the send.
+     */
+    class BorrowedMessageGuard {
+    private:
+
+        Pointer<commands::Message>& message;
+        bool borrowed;
+
+    private:
+
+        BorrowedMessageGuard(const BorrowedMessageGuard&);
+        BorrowedMessageGuard& operator=(const BorrowedMessageGuard&);
+
+    public:
+
+        BorrowedMessageGuard(Pointer<commands::Message>& message) : message(message), borrowed(false) {}
+
+        ~BorrowedMessageGuard() {
+            if (borrowed) {
+                message.release();
+            }
+        }
+
+        void borrow(commands::Message* original) {
+            message.reset(original);
+            borrowed = true;
+        }
+    };
+
+    /**
+     * Sends the acks a session's AckCoalescer is holding, run by a TaskRunner so that
+     * the write never happens on the thread of the Connection's Scheduler.  Holds the
+     * AckCoalescer rather than the session, once the session closes it the task has
+     * nothing left to send.
+     */
+    class FlushAcksTask : public Task {
+    private:
+
+        Pointer<AckCoalescer> coalescer;
+
+    private:
+
+        FlushAcksTask(const FlushAcksTask&);
+        FlushAcksTask& operator=(const FlushAcksTask&);
+
+    public:
+
+        FlushAcksTask(Pointer<AckCoalescer> coalescer) : Task(), coalescer(coalescer) {}
+
+        virtual ~FlushAcksTask() {}
+
+        virtual bool iterate() {
+            try {
+                // A failed send means the transport failed, the Connection reports that.
+                this->coalescer->flush();
+            }
+            AMQ_CATCHALL_NOTHROW()
+
+            return false;
+        }
+    };
+
+    /**
+     * Scheduled periodically so that no coalesced ack waits longer than the configured
+     * delay, it only wakes the session's FlushAcksTask runner when acks are pending.
+     */
+    class FlushAcksTimerTask : public Runnable {
+    private:
+
+        Pointer<AckCoalescer> coalescer;
+        Pointer<TaskRunner> runner;
+
+    private:
+
+        FlushAcksTimerTask(const FlushAcksTimerTask&);
+        FlushAcksTimerTask& operator=(const FlushAcksTimerTask&);
+
+    public:
+
+        FlushAcksTimerTask(Pointer<AckCoalescer> coalescer, Pointer<TaskRunner> runner) :
+            Runnable(), coalescer(coalescer), runner(runner) {}
+
+        virtual ~FlushAcksTimerTask() {}
+
+        virtual void run() {
+            if (this->coalescer->getPendingCount() > 0) {
+                this->runner->wakeup();
+            }
+        }
+    };
+
     /**
      * Class used to Hook a session that has been closed into the Transaction
      * it is currently a part of.  Once the Transaction has been Committed or
@@ -247,6 +362,23 @@ ActiveMQSessionKernel::ActiveMQSessionKernel(ActiveMQConnection* connection,
             throw;
         }
     }
+
+    if (this->connection->isCoalesceAcks()) {
+        this->config->ackCoalescer.reset(
+            new AckCoalescer(this->connection, Math::max(1, this->connection->getCoalesceAcksMaxPending())));
+
+        if (this->connection->getCoalesceAcksMaxDelay() > 0) {
+            this->config->ackFlushTask.reset(new FlushAcksTask(this->config->ackCoalescer));
+            this->config->ackFlushRunner.reset(
+                this->connection->getSessionTaskRunner()->createTaskRunner(this->config->ackFlushTask.get()));
+            this->config->ackFlushRunner->start();
+
+            this->config->ackFlushTimer =
+                new FlushAcksTimerTask(this->config->ackCoalescer, this->config->ackFlushRunner);
+            this->config->scheduler->executePeriodically(
+                this->config->ackFlushTimer, this->connection->getCoalesceAcksMaxDelay());
+        }
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -378,6 +510,7 @@ void ActiveMQSessionKernel::dispose() {
                 }
             }
             this->config->consumers.clear();
+            this->config->consumersById.clear();
             this->config->consumerLock.writeLock().unlock();
         } catch (Exception& ex) {
             this->config->consumerLock.writeLock().unlock();
@@ -411,6 +544,33 @@ void ActiveMQSessionKernel::dispose() {
         if (this->transaction->isInTransaction()) {
             this->transaction->rollback();
         }
+
+        // The consumers have handed over their last acks, send them before the session
+        // is removed.  Once closed the coalescer has the consumers send directly.
+        if (this->config->ackCoalescer != NULL) {
+            if (this->config->ackFlushTimer != NULL) {
+                try {
+                    this->config->scheduler->cancel(this->config->ackFlushTimer);
+                } catch (Exception& ex) {
+                    /* Absorb, a stopped Scheduler has already cancelled it */
+                }
+                this->config->ackFlushTimer = NULL;
+            }
+
+            // The Task is deleted with the session so a flush in progress must finish,
+            // a write blocked in a failed transport is released once it is failed by
+            // the transport's own threads, not by the Scheduler's.
+            if (this->config->ackFlushRunner != NULL) {
+                this->config->ackFlushRunner->shutdown();
+            }
+
+            try {
+                this->config->ackCoalescer->flush();
+            } catch (Exception& ex) {
+                /* Absorb */
+            }
+            this->config->ackCoalescer->close();
+        }
     }
     AMQ_CATCH_RETHROW( ActiveMQException )
     AMQ_CATCH_EXCEPTION_CONVERT( Exception, ActiveMQException )
@@ -429,6 +589,8 @@ void ActiveMQSessionKernel::commit() {
                 __FILE__, __LINE__, "ActiveMQSessionKernel::commit - This Session is not Transacted");
         }
 
+        flushAcks();
+
         // Commit the Transaction
         this->transaction->commit();
     }
@@ -447,6 +609,8 @@ void ActiveMQSessionKernel::rollback() {
                 __FILE__, __LINE__, "ActiveMQSessionKernel::rollback - This Session is not Transacted");
         }
 
+        flushAcks();
+
         // Roll back the Transaction
         this->transaction->rollback();
     }
@@ -487,6 +651,12 @@ void ActiveMQSessionKernel::clearMessagesInProgress(Pointer<AtomicInteger> trans
         this->executor->clearMessagesInProgress();
     }
 
+    // The held acks cover deliveries the Broker will now redeliver, just like the
+    // consumers' own pending acks they must not be sent on the new connection.
+    if (this->config->ackCoalescer != NULL) {
+        this->config->ackCoalescer->clear();
+    }
+
     this->config->consumerLock.readLock().lock();
     try {
         Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
@@ -953,6 +1123,7 @@ void ActiveMQSessionKernel::send(kernels::ActiveMQProducerKernel* producer, Poin
             // transform to our own message format here
             commands::Message* transformed = NULL;
             Pointer<commands::Message> amqMessage;
+            BorrowedMessageGuard borrowedMessage(amqMessage);
 
             // Always assign the message ID, regardless of the disable flag.
             // Not adding a message ID will cause an NPE at the broker.
@@ -962,22 +1133,37 @@ void ActiveMQSessionKernel::send(kernels::ActiveMQProducerKernel* producer, Poin
 
             // NOTE:
             // Now we copy the message before sending, this allows the user to reuse the
-            // message object without interfering with the copy that's being sent.  We
-            // could make this step optional to increase performance but for now we won't.
-            // To not do this implies that the user must never reuse the message object, or
-            // know that the configuration of Transports doesn't involve the message hanging
-            // around beyond the point that send returns.  When the transform step results in
-            // a new Message object being created we can just use that new instance, but when
-            // the original cms::Message pointer was already a commands::Message then we need
-            // to clone it.
-            if (ActiveMQMessageTransformation::transformMessage(message, connection, &transformed)) {
+            // message object without interfering with the copy that's being sent.  When
+            // the transform step results in a new Message object being created we can just
+            // use that new instance, but when the original cms::Message pointer was already
+            // a commands::Message then we need to clone it unless the connection has been
+            // configured not to copy messages on send.  Without a copy the user's message
+            // is handed to the transport in place, which is only safe when send is a oneway
+            // that is done with the message once it returns, requests can leave it held by
+            // the transport after a timeout or failure so those are always copied.
+            bool isForeign = ActiveMQMessageTransformation::transformMessage(message, connection, &transformed);
+            bool oneway = onComplete == NULL &&
+                          !isSynchronousSend(transformed->isResponseRequired(), deliveryMode, sendTimeout);
+
+            if (isForeign) {
                 amqMessage.reset(transformed);
+
+                // Sets the Message ID on the original message per spec, a foreign
+                // message can only take it in its string form.
+                message->setCMSMessageID(id->toString());
+            } else if (oneway && !this->connection->isCopyMessageOnSend()) {
+                borrowedMessage.borrow(transformed);
             } else {
                 amqMessage.reset(transformed->cloneDataStructure());
+
+                // Sets the Message ID on the original message per spec, our own
+                // messages keep the MessageId and only format it when the
+                // application calls getCMSMessageID.  It gets its own copy since
+                // MessageId caches its string form and the original stays with
+                // the application while the copy is sent.
+                transformed->setMessageId(Pointer<commands::MessageId>(new commands::MessageId(*id)));
             }
 
-            // Sets the Message ID on the original message per spec.
-            message->setCMSMessageID(id->toString());
             message->setCMSDestination(destination.dynamicCast<cms::Destination>().get());
 
             amqMessage->setMessageId(id);
@@ -991,14 +1177,15 @@ void ActiveMQSessionKernel::send(kernels::ActiveMQProducerKernel* producer, Poin
             amqMessage->onSend();
             amqMessage->setProducerId(producerId);
 
-            if (onComplete == NULL && sendTimeout <= 0 && !amqMessage->isResponseRequired() && !this->connection->isAlwaysSyncSend() &&
-                (!amqMessage->isPersistent() || this->connection->isUseAsyncSend() || amqMessage->getTransactionId() != NULL)) {
+            if (oneway) {
 
                 // No Response Required, send is asynchronous.
                 this->connection->oneway(amqMessage);
 
+                // The producer already waited for window space, or found some
+                // on a trySend, so only the usage is recorded here.
                 if (producerWindow != NULL) {
-                    producerWindow->enqueueUsage(amqMessage->getSize());
+                    producerWindow->increaseUsage(amqMessage->getSize());
                 }
 
             } else {
@@ -1013,6 +1200,15 @@ void ActiveMQSessionKernel::send(kernels::ActiveMQProducerKernel* producer, Poin
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQSessionKernel::isSynchronousSend(bool responseRequired, int deliveryMode, long long sendTimeout) const {
+
+    // A send is started in the session's transaction, when there is one, before
+    // this is checked so the transaction id is set exactly when isTransacted is.
+    return responseRequired || sendTimeout > 0 || this->connection->isAlwaysSyncSend() ||
+           (deliveryMode == cms::DeliveryMode::PERSISTENT && !this->connection->isUseAsyncSend() && !isTransacted());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 cms::ExceptionListener* ActiveMQSessionKernel::getExceptionListener() {
 
@@ -1211,6 +1407,7 @@ std::string ActiveMQSessionKernel::createTemporaryDestinationName() {
 void ActiveMQSessionKernel::oneway(Pointer<Command> command) {
 
     try {
+        flushAcks();
         this->connection->oneway(command);
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
@@ -1223,6 +1420,7 @@ Pointer<Response> ActiveMQSessionKernel::syncRequest(Pointer<Command> command, u
 
     try {
         this->checkClosed();
+        flushAcks();
         return this->connection->syncRequest(command, timeout);
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
@@ -1247,6 +1445,7 @@ void ActiveMQSessionKernel::addConsumer(Pointer<ActiveMQConsumerKernel> consumer
         this->config->consumerLock.writeLock().lock();
         try {
             this->config->consumers.add(consumer);
+            this->config->consumersById.put(*consumer->getConsumerId(), consumer);
             this->config->consumerLock.writeLock().unlock();
         } catch (Exception& ex) {
             this->config->consumerLock.writeLock().unlock();
@@ -1269,6 +1468,9 @@ void ActiveMQSessionKernel::removeConsumer(Pointer<ActiveMQConsumerKernel> consu
         this->config->consumerLock.writeLock().lock();
         try {
             this->config->consumers.remove(consumer);
+            if (this->config->consumersById.containsKey(*consumer->getConsumerId())) {
+                this->config->consumersById.remove(*consumer->getConsumerId());
+            }
             this->connection->removeAuditedDispatcher(consumer.get());
             this->config->consumerLock.writeLock().unlock();
         } catch (Exception& ex) {
@@ -1350,16 +1552,19 @@ Pointer<ActiveMQProducerKernel> ActiveMQSessionKernel::lookupProducerKernel(Poin
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<ActiveMQConsumerKernel> ActiveMQSessionKernel::lookupConsumerKernel(Pointer<ConsumerId> id) {
 
+    Pointer<ActiveMQConsumerKernel> consumer;
+
+    if (id == NULL) {
+        return consumer;
+    }
+
     this->config->consumerLock.readLock().lock();
     try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
+        const decaf::util::HashMap<ConsumerId, Pointer<ActiveMQConsumerKernel>, ConsumerIdHashCode>& consumers =
+            this->config->consumersById;
 
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            if (consumer->getConsumerId()->equals(*id)) {
-                this->config->consumerLock.readLock().unlock();
-                return consumer;
-            }
+        if (consumers.containsKey(*id)) {
+            consumer = consumers.get(*id);
         }
         this->config->consumerLock.readLock().unlock();
     } catch (Exception& ex) {
@@ -1367,7 +1572,7 @@ Pointer<ActiveMQConsumerKernel> ActiveMQSessionKernel::lookupConsumerKernel(Poin
         throw;
     }
 
-    return Pointer<ActiveMQConsumerKernel>();
+    return consumer;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1400,20 +1605,9 @@ bool ActiveMQSessionKernel::iterateConsumers() {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::setPrefetchSize(Pointer<ConsumerId> id, int prefetch) {
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
-
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            if (consumer->getConsumerId()->equals(*id)) {
-                consumer->setPrefetchSize(prefetch);
-            }
-        }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
+    Pointer<ActiveMQConsumerKernel> consumer = this->lookupConsumerKernel(id);
+    if (consumer != NULL) {
+        consumer->setPrefetchSize(prefetch);
     }
 }
 
@@ -1506,12 +1700,29 @@ void ActiveMQSessionKernel::checkMessageListener() const {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::sendAck(Pointer<MessageAck> ack, bool async) {
     if (async || this->connection->isSendAcksAsync() || this->isTransacted()) {
+
+        // Transacted acks are sent right away so they are tracked in the order
+        // the transaction made them.
+        if (ack->getTransactionId() == NULL && this->config->ackCoalescer != NULL &&
+            this->config->ackCoalescer->add(ack)) {
+            return;
+        }
+
+        flushAcks();
         this->connection->oneway(ack);
     } else {
+        flushAcks();
         this->connection->syncRequest(ack);
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionKernel::flushAcks() {
+    if (this->config->ackCoalescer != NULL) {
+        this->config->ackCoalescer->flush();
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQSessionKernel::isSessionAsyncDispatch() const {
     return this->config->sessionAsyncDispatch;
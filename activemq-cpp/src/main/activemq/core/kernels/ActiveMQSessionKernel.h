@@ -29,6 +29,7 @@
 #include <activemq/core/kernels/ActiveMQProducerKernel.h>
 #include <activemq/commands/ActiveMQTempDestination.h>
 #include <activemq/commands/Response.h>
+#include <activemq/commands/Message.h>
 #include <activemq/commands/MessageAck.h>
 #include <activemq/commands/SessionInfo.h>
 #include <activemq/commands/ConsumerInfo.h>
@@ -280,6 +281,22 @@ namespace kernels {
                   cms::Message* message, int deliveryMode, int priority, long long timeToLive,
                   util::MemoryUsage* producerWindow, long long sendTimeout, cms::AsyncCallback* onComplete);
 
+        /**
+         * Returns true if a message sent without an AsyncCallback using the given delivery
+         * mode and send timeout waits for the Broker's response before send returns.  Any
+         * other send is a oneway, the transport is done with the message once it returns.
+         *
+         * @param responseRequired
+         *      True if the outgoing message itself asks for a response.
+         * @param deliveryMode
+         *      The delivery mode of the outgoing message.
+         * @param sendTimeout
+         *      The send timeout of the producer, or 0 to wait forever.
+         *
+         * @return true if such a send is a synchronous request to the Broker.
+         */
+        bool isSynchronousSend(bool responseRequired, int deliveryMode, long long sendTimeout) const;
+
         /**
          * This method gets any registered exception listener of this sessions
          * connection and returns it.  Mainly intended for use by the objects
@@ -571,6 +588,14 @@ namespace kernels {
          */
         void sendAck(decaf::lang::Pointer<commands::MessageAck> ack, bool async = false);
 
+        /**
+         * Sends any acks this Session is holding back when the Connection has ack
+         * coalescing enabled, does nothing otherwise.  Called whenever the Session's
+         * consumers run out of messages to deliver so that the Broker is never left
+         * waiting on a held ack before it dispatches more.
+         */
+        void flushAcks();
+
         /**
          * Returns true if this session is dispatching messages to its consumers asynchronously.
          *
@@ -23,6 +23,8 @@
 #include <activemq/transport/discovery/DiscoveryAgentRegistry.h>
 
 #include <activemq/util/IdGenerator.h>
+#include <activemq/threads/Scheduler.h>
+#include <activemq/threads/TimerWheel.h>
 
 #include <activemq/wireformat/stomp/StompWireFormatFactory.h>
 #include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
@@ -70,6 +72,10 @@ void ActiveMQCPP::initializeLibrary(int argc, char** argv) {
 
     // Start the IdGenerator Kernel
     IdGenerator::initialize();
+
+    // Create the TimerWheel and the Scheduler threads shared by all Connections.
+    threads::TimerWheel::initialize();
+    threads::Scheduler::initializeTaskRunners();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,6 +86,11 @@ void ActiveMQCPP::initializeLibrary() {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQCPP::shutdownLibrary() {
 
+    // Stop the shared TimerWheel before the code its tasks use is torn down, it
+    // hands the due Scheduler tasks to the pool so it goes first.
+    threads::TimerWheel::shutdown();
+    threads::Scheduler::shutdownTaskRunners();
+
     // Shutdown the IdGenerator Kernel
     IdGenerator::shutdown();
 
@@ -0,0 +1,275 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PooledTaskRunner.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/RejectedExecutionException.h>
+
+using namespace activemq;
+using namespace activemq::threads;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace threads {
+
+    /**
+     * Holds the state of a PooledTaskRunner, a runnable that is waiting in the
+     * Executor keeps this alive so that it can find out that the runner was shut
+     * down even if the runner itself has been destroyed in the meantime.
+     */
+    class PooledTaskRunnerImpl {
+    private:
+
+        PooledTaskRunnerImpl(const PooledTaskRunnerImpl&);
+        PooledTaskRunnerImpl& operator=(const PooledTaskRunnerImpl&);
+
+    public:
+
+        Mutex mutex;
+        Executor* executor;
+        Task* task;
+        int maxIterationsPerRun;
+        Thread* runningThread;
+        bool started;
+        bool queued;
+        bool iterating;
+        bool shutDown;
+
+    public:
+
+        PooledTaskRunnerImpl(Executor* executor, Task* task, int maxIterationsPerRun) :
+            mutex(), executor(executor), task(task), maxIterationsPerRun(maxIterationsPerRun),
+            runningThread(NULL), started(false), queued(false), iterating(false), shutDown(false) {
+        }
+
+        // Must be called with the mutex held.
+        void schedule(const Pointer<PooledTaskRunnerImpl>& self);
+
+        void runTask(const Pointer<PooledTaskRunnerImpl>& self);
+
+    };
+
+    /**
+     * The unit of work handed to the Executor, owned and deleted by the Executor.
+     */
+    class PooledTaskRunnable : public Runnable {
+    private:
+
+        Pointer<PooledTaskRunnerImpl> impl;
+
+    private:
+
+        PooledTaskRunnable(const PooledTaskRunnable&);
+        PooledTaskRunnable& operator=(const PooledTaskRunnable&);
+
+    public:
+
+        PooledTaskRunnable(const Pointer<PooledTaskRunnerImpl>& impl) : Runnable(), impl(impl) {
+        }
+
+        virtual ~PooledTaskRunnable() {}
+
+        virtual void run() {
+            impl->runTask(impl);
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledTaskRunnerImpl::schedule(const Pointer<PooledTaskRunnerImpl>& self) {
+
+    try {
+        this->executor->execute(new PooledTaskRunnable(self), true);
+    } catch (RejectedExecutionException& ex) {
+        // The Executor is shutting down so there is nothing left to run the task.
+        this->queued = false;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledTaskRunnerImpl::runTask(const Pointer<PooledTaskRunnerImpl>& self) {
+
+    synchronized(&mutex) {
+        this->queued = false;
+        if (this->shutDown) {
+            mutex.notifyAll();
+            return;
+        }
+        this->iterating = true;
+        this->runningThread = Thread::currentThread();
+    }
+
+    // Don't synchronize while we are iterating so that multiple wakeup() calls
+    // can be executed concurrently.
+    bool done = false;
+    try {
+        for (int i = 0; i < this->maxIterationsPerRun; i++) {
+            if (!this->task->iterate()) {
+                done = true;
+                break;
+            }
+        }
+    }
+    AMQ_CATCHALL_NOTHROW()
+
+    synchronized(&mutex) {
+        this->iterating = false;
+        this->runningThread = NULL;
+
+        if (this->shutDown) {
+            this->queued = false;
+            mutex.notifyAll();
+            return;
+        }
+
+        // If we could not iterate all the items then we have to reschedule.
+        if (!done) {
+            this->queued = true;
+        }
+
+        if (this->queued) {
+            this->schedule(self);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PooledTaskRunner::PooledTaskRunner(Executor* executor, Task* task, int maxIterationsPerRun) : impl() {
+
+    if (executor == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Executor passed was null");
+    }
+
+    if (task == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Task passed was null");
+    }
+
+    this->impl.reset(new PooledTaskRunnerImpl(executor, task, maxIterationsPerRun > 0 ? maxIterationsPerRun : 1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PooledTaskRunner::~PooledTaskRunner() {
+    try {
+        this->shutdown();
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledTaskRunner::start() {
+
+    synchronized(&impl->mutex) {
+        if (impl->started || impl->shutDown) {
+            return;
+        }
+
+        impl->started = true;
+
+        // Run the task once on start as the dedicated runner does, or pick up a
+        // wakeup that arrived before we were started.
+        impl->queued = true;
+        if (!impl->iterating) {
+            impl->schedule(impl);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool PooledTaskRunner::isStarted() const {
+
+    bool result = false;
+
+    synchronized(&impl->mutex) {
+        result = impl->started;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledTaskRunner::shutdown(long long timeout) {
+
+    synchronized(&impl->mutex) {
+
+        impl->shutDown = true;
+
+        // Wait till the task stops iterating, no need to wait if shutdown is
+        // called from the thread that is iterating the task.
+        if (impl->runningThread != Thread::currentThread()) {
+
+            long long remaining = timeout;
+            long long target = System::currentTimeMillis() + timeout;
+
+            while (impl->iterating && remaining > 0) {
+                impl->mutex.wait(remaining);
+                remaining = target - System::currentTimeMillis();
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledTaskRunner::shutdown() {
+
+    synchronized(&impl->mutex) {
+
+        impl->shutDown = true;
+
+        // Wait till the task stops iterating, no need to wait if shutdown is
+        // called from the thread that is iterating the task.
+        if (impl->runningThread != Thread::currentThread()) {
+            while (impl->iterating) {
+                impl->mutex.wait();
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledTaskRunner::wakeup() {
+
+    synchronized(&impl->mutex) {
+
+        // When we get in here, we make some assumptions of state:
+        // queued=false, iterating=false: wakeup() has not be called and therefore task is not executing.
+        // queued=true,  iterating=false: wakeup() was called but, task execution has not started yet
+        // queued=false, iterating=true : wakeup() was called, which caused task execution to start.
+        // queued=true,  iterating=true : wakeup() called after task execution was started.
+        if (impl->queued || impl->shutDown) {
+            return;
+        }
+
+        impl->queued = true;
+
+        // The runTask() method will do this for me once we are done iterating.
+        if (impl->started && !impl->iterating) {
+            impl->schedule(impl);
+        }
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_THREADS_POOLEDTASKRUNNER_H_
+#define _ACTIVEMQ_THREADS_POOLEDTASKRUNNER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/threads/TaskRunner.h>
+#include <activemq/threads/Task.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Executor.h>
+
+namespace activemq {
+namespace threads {
+
+    class PooledTaskRunnerImpl;
+
+    /**
+     * A TaskRunner that runs its Task on a thread borrowed from a shared Executor
+     * instead of owning a thread of its own.  At most one thread iterates the Task
+     * at any time so the Task sees the same ordering it would with a dedicated
+     * thread, and after a fixed number of iterations the thread is handed back to
+     * the Executor so that one busy Task cannot starve the others sharing it.
+     *
+     * @since 3.10.0
+     */
+    class AMQCPP_API PooledTaskRunner : public TaskRunner {
+    private:
+
+        decaf::lang::Pointer<PooledTaskRunnerImpl> impl;
+
+    private:
+
+        PooledTaskRunner(const PooledTaskRunner&);
+        PooledTaskRunner& operator=(const PooledTaskRunner&);
+
+    public:
+
+        /**
+         * Creates a new PooledTaskRunner.
+         *
+         * @param executor
+         *      The Executor whose threads iterate the Task, must outlive this runner.
+         * @param task
+         *      The Task that is to be run.
+         * @param maxIterationsPerRun
+         *      The number of times the Task is iterated before the thread is returned
+         *      to the Executor.
+         *
+         * @throws NullPointerException if the executor or task is NULL.
+         */
+        PooledTaskRunner(decaf::util::concurrent::Executor* executor, Task* task, int maxIterationsPerRun);
+
+        virtual ~PooledTaskRunner();
+
+        virtual void start();
+
+        virtual bool isStarted() const;
+
+        /**
+         * Shutdown after a timeout, does not guarantee that the task's iterate
+         * method has completed.
+         *
+         * @param timeout - Time in Milliseconds to wait for the task to stop.
+         */
+        virtual void shutdown(long long timeout);
+
+        /**
+         * Shutdown once the task has finished its current iteration.
+         */
+        virtual void shutdown();
+
+        /**
+         * Signal the TaskRunner to wakeup and execute another iteration cycle on
+         * the task, the Task instance will be run until its iterate method has
+         * returned false indicating it is done.
+         */
+        virtual void wakeup();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_THREADS_POOLEDTASKRUNNER_H_ */
@@ -18,14 +18,23 @@
 #include "Scheduler.h"
 
 #include <activemq/exceptions/ActiveMQException.h>
-#include <activemq/threads/SchedulerTimerTask.h>
+#include <activemq/threads/Task.h>
+#include <activemq/threads/TaskRunner.h>
+#include <activemq/threads/TaskRunnerFactory.h>
+#include <activemq/threads/TimerWheel.h>
+#include <activemq/threads/TimerWheelTimeout.h>
 #include <activemq/util/ServiceStopper.h>
 
 #include <decaf/lang/Pointer.h>
-#include <decaf/util/Timer.h>
 #include <decaf/lang/Runnable.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
 #include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+
+#include <deque>
+#include <memory>
+#include <vector>
 
 using namespace activemq;
 using namespace activemq::threads;
@@ -34,11 +43,193 @@ using namespace activemq::exceptions;
 using namespace decaf;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
-Scheduler::Scheduler(const std::string& name) : mutex(), name(name), timer(NULL), tasks() {
+namespace {
+
+    // Completed one time tasks are dropped once this many handles have piled up.
+    const std::size_t MIN_DELAYED_PURGE_SIZE = 64;
+
+    // The tasks of every Scheduler share these threads, a few are kept so that one
+    // task blocked in a transport write doesn't hold up the rest.
+    const int SCHEDULER_THREAD_POOL_SIZE = 4;
+
+    // The number of due tasks a Scheduler runs before its thread goes back to the pool.
+    const int SCHEDULER_MAX_ITERATIONS_PER_RUN = 16;
+
+    TaskRunnerFactory* taskRunnerFactory = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace threads {
+
+    /**
+     * A Runnable scheduled through a Scheduler along with the TimerWheel timeout
+     * that tracks when it is next due.  The Runnable is deleted along with the
+     * last reference to this task so an owned Runnable is never deleted while a
+     * run of it is still in progress.
+     */
+    class ScheduledTask {
+    private:
+
+        Runnable* task;
+        bool ownsTask;
+
+    public:
+
+        Pointer<TimerWheelTimeout> timeout;
+        AtomicBoolean queued;
+        AtomicBoolean cancelled;
+
+    private:
+
+        ScheduledTask(const ScheduledTask&);
+        ScheduledTask& operator= (const ScheduledTask&);
+
+    public:
+
+        ScheduledTask(Runnable* task, bool ownsTask) :
+            task(task), ownsTask(ownsTask), timeout(), queued(false), cancelled(false) {
+        }
+
+        ~ScheduledTask() {
+            if (this->ownsTask) {
+                delete this->task;
+            }
+        }
+
+        void run() {
+            if (!this->cancelled.get()) {
+                this->task->run();
+            }
+        }
+
+        void cancel() {
+            this->cancelled.set(true);
+            if (this->timeout != NULL) {
+                this->timeout->cancel();
+            }
+        }
+
+        bool isDone() const {
+            return this->timeout->isDone() && !this->queued.get();
+        }
+    };
+
+    /**
+     * Runs the tasks of one Scheduler in the order they came due, one at a time,
+     * on a thread borrowed from the pool that all Schedulers share.
+     */
+    class SchedulerDispatcher : public Task {
+    private:
+
+        Mutex mutex;
+        std::deque< Pointer<ScheduledTask> > ready;
+        std::auto_ptr<TaskRunner> runner;
+
+    private:
+
+        SchedulerDispatcher(const SchedulerDispatcher&);
+        SchedulerDispatcher& operator= (const SchedulerDispatcher&);
+
+    public:
+
+        SchedulerDispatcher(TaskRunnerFactory* factory) : Task(), mutex(), ready(), runner() {
+            this->runner.reset(factory->createTaskRunner(this));
+            this->runner->start();
+        }
+
+        virtual ~SchedulerDispatcher() {
+            try {
+                this->runner->shutdown();
+            }
+            AMQ_CATCHALL_NOTHROW()
+        }
+
+        void enqueue(const Pointer<ScheduledTask>& task) {
+
+            // A task that is still waiting for its last run isn't queued twice.
+            if (task->cancelled.get() || !task->queued.compareAndSet(false, true)) {
+                return;
+            }
+
+            synchronized(&mutex) {
+                this->ready.push_back(task);
+            }
+
+            this->runner->wakeup();
+        }
+
+        void shutdown() {
+
+            this->runner->shutdown();
+
+            synchronized(&mutex) {
+                this->ready.clear();
+            }
+        }
+
+        virtual bool iterate() {
+
+            Pointer<ScheduledTask> task;
+
+            synchronized(&mutex) {
+                if (this->ready.empty()) {
+                    return false;
+                }
+
+                task = this->ready.front();
+                this->ready.pop_front();
+            }
+
+            task->queued.set(false);
+
+            try {
+                task->run();
+            }
+            AMQ_CATCHALL_NOTHROW()
+
+            return true;
+        }
+    };
+
+    /**
+     * The Runnable given to the TimerWheel, it only hands its task over to the
+     * dispatcher so that the TimerWheel thread never runs the task itself.
+     */
+    class SchedulerWheelTask : public Runnable {
+    private:
+
+        Pointer<SchedulerDispatcher> dispatcher;
+        Pointer<ScheduledTask> task;
+
+    private:
+
+        SchedulerWheelTask(const SchedulerWheelTask&);
+        SchedulerWheelTask& operator= (const SchedulerWheelTask&);
+
+    public:
+
+        SchedulerWheelTask(const Pointer<SchedulerDispatcher>& dispatcher, const Pointer<ScheduledTask>& task) :
+            Runnable(), dispatcher(dispatcher), task(task) {
+        }
+
+        virtual ~SchedulerWheelTask() {}
+
+        virtual void run() {
+            this->dispatcher->enqueue(this->task);
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+Scheduler::Scheduler(const std::string& name) :
+    mutex(), name(name), cancelled(false), dispatcher(), tasks(), delayedTasks(), delayedPurgeSize(MIN_DELAYED_PURGE_SIZE) {
 
     if (name.empty()) {
         throw IllegalArgumentException(__FILE__, __LINE__, "Scheduler name must not be empty.");
@@ -48,14 +239,7 @@ Scheduler::Scheduler(const std::string& name) : mutex(), name(name), timer(NULL)
 ////////////////////////////////////////////////////////////////////////////////
 Scheduler::~Scheduler() {
     try {
-
-        if (this->timer != NULL) {
-            this->timer->cancel();
-        }
-
-        this->tasks.clear();
-
-        delete this->timer;
+        this->cancelAll();
     }
     AMQ_CATCHALL_NOTHROW()
 }
@@ -68,9 +252,11 @@ void Scheduler::executePeriodically(Runnable* task, long long period, bool ownsT
     }
 
     synchronized(&mutex) {
-        TimerTask* timerTask = new SchedulerTimerTask(task, ownsTask);
-        this->timer->scheduleAtFixedRate(timerTask, period, period);
-        this->tasks.put(task, timerTask);
+        checkCanSchedule(task);
+        Pointer<ScheduledTask> scheduled = createTask(task, ownsTask);
+        scheduled->timeout = TimerWheel::getInstance().scheduleAtFixedRate(
+            new SchedulerWheelTask(this->dispatcher, scheduled), period, period);
+        this->tasks.put(task, scheduled);
     }
 }
 
@@ -82,9 +268,11 @@ void Scheduler::schedualPeriodically(Runnable* task, long long period, bool owns
     }
 
     synchronized(&mutex) {
-        TimerTask* timerTask = new SchedulerTimerTask(task, ownsTask);
-        this->timer->schedule(timerTask, period, period);
-        this->tasks.put(task, timerTask);
+        checkCanSchedule(task);
+        Pointer<ScheduledTask> scheduled = createTask(task, ownsTask);
+        scheduled->timeout = TimerWheel::getInstance().scheduleWithFixedDelay(
+            new SchedulerWheelTask(this->dispatcher, scheduled), period, period);
+        this->tasks.put(task, scheduled);
     }
 }
 
@@ -95,13 +283,15 @@ void Scheduler::cancel(Runnable* task) {
         throw IllegalStateException(__FILE__, __LINE__, "Scheduler is not started.");
     }
 
+    Pointer<ScheduledTask> scheduled;
+
     synchronized(&mutex) {
-        TimerTask* ticket = this->tasks.remove(task);
-        if (ticket != NULL) {
-            ticket->cancel();
-            this->timer->purge();
-        }
+        scheduled = this->tasks.remove(task);
     }
+
+    // The TimerWheel only waits for the hand off to the dispatcher, a run of the
+    // task that is in progress is not waited for.
+    scheduled->cancel();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -112,30 +302,109 @@ void Scheduler::executeAfterDelay(Runnable* task, long long delay, bool ownsTask
     }
 
     synchronized(&mutex) {
-        TimerTask* timerTask = new SchedulerTimerTask(task, ownsTask);
-        this->timer->schedule(timerTask, delay);
+        checkCanSchedule(task);
+
+        if (this->delayedTasks.size() >= this->delayedPurgeSize) {
+            std::list< Pointer<ScheduledTask> >::iterator iter = this->delayedTasks.begin();
+            while (iter != this->delayedTasks.end()) {
+                if ((*iter)->isDone()) {
+                    iter = this->delayedTasks.erase(iter);
+                } else {
+                    ++iter;
+                }
+            }
+
+            this->delayedPurgeSize = this->delayedTasks.size() * 2;
+            if (this->delayedPurgeSize < MIN_DELAYED_PURGE_SIZE) {
+                this->delayedPurgeSize = MIN_DELAYED_PURGE_SIZE;
+            }
+        }
+
+        Pointer<ScheduledTask> scheduled = createTask(task, ownsTask);
+        scheduled->timeout = TimerWheel::getInstance().schedule(
+            new SchedulerWheelTask(this->dispatcher, scheduled), delay);
+        this->delayedTasks.push_back(scheduled);
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Scheduler::shutdown() {
-    if (this->timer != NULL) {
-        this->timer->cancel();
-    }
+    this->cancelAll();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Scheduler::doStart() {
+
+    if (taskRunnerFactory == NULL) {
+        throw IllegalStateException(__FILE__, __LINE__, "Library is not initialized.");
+    }
+
     synchronized(&mutex) {
-        this->timer = new Timer(name);
+        this->cancelled = false;
+        this->dispatcher.reset(new SchedulerDispatcher(taskRunnerFactory));
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Scheduler::doStop(ServiceStopper* stopper AMQCPP_UNUSED) {
+    this->cancelAll();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Scheduler::checkCanSchedule(Runnable* task) const {
+
+    if (task == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Task to schedule cannot be NULL.");
+    }
+
+    if (this->cancelled || this->dispatcher == NULL) {
+        throw IllegalStateException(__FILE__, __LINE__, "Scheduler has been shut down.");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ScheduledTask> Scheduler::createTask(Runnable* task, bool ownsTask) {
+    return Pointer<ScheduledTask>(new ScheduledTask(task, ownsTask));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Scheduler::cancelAll() {
+
+    std::vector< Pointer<ScheduledTask> > scheduled;
+    Pointer<SchedulerDispatcher> dispatcher;
+
     synchronized(&mutex) {
-        if (this->timer != NULL) {
-            this->timer->cancel();
-        }
+        this->cancelled = true;
+
+        scheduled = this->tasks.values().toArray();
+        scheduled.insert(scheduled.end(), this->delayedTasks.begin(), this->delayedTasks.end());
+
+        this->tasks.clear();
+        this->delayedTasks.clear();
+
+        dispatcher = this->dispatcher;
+    }
+
+    // Cancel outside the lock, a running task may call back into this Scheduler.
+    std::vector< Pointer<ScheduledTask> >::iterator iter = scheduled.begin();
+    for (; iter != scheduled.end(); ++iter) {
+        (*iter)->cancel();
+    }
+
+    // Waits for a task that is running unless called by that task itself.
+    if (dispatcher != NULL) {
+        dispatcher->shutdown();
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void Scheduler::initializeTaskRunners() {
+    taskRunnerFactory = new TaskRunnerFactory("ActiveMQ Scheduler", SCHEDULER_MAX_ITERATIONS_PER_RUN,
+                                              false, SCHEDULER_THREAD_POOL_SIZE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Scheduler::shutdownTaskRunners() {
+    delete taskRunnerFactory;
+    taskRunnerFactory = NULL;
+}
@@ -21,20 +21,35 @@
 #include <activemq/util/Config.h>
 #include <activemq/util/ServiceSupport.h>
 
+#include <decaf/lang/Pointer.h>
 #include <decaf/lang/Runnable.h>
-#include <decaf/util/Timer.h>
 #include <decaf/util/StlMap.h>
 #include <decaf/util/concurrent/Mutex.h>
 
+#include <list>
 #include <string>
 
 namespace activemq {
 namespace threads {
 
+    class ScheduledTask;
+    class SchedulerDispatcher;
+
     /**
      * Scheduler class for use in executing Runnable Tasks either periodically or
      * one time only with optional delay.
      *
+     * The library wide TimerWheel only tracks when each task is due, the tasks
+     * themselves are run one at a time on a small thread pool that all Schedulers
+     * share, so a task that blocks delays the other tasks of its own Scheduler but
+     * not those of other Schedulers while the pool has threads to spare.  A run of
+     * a periodic task that comes due while the previous one is still waiting to be
+     * run is dropped rather than queued behind it.
+     *
+     * Cancelling a task stops any further runs of it but does not wait for a run
+     * that is already in progress, stopping or shutting down the Scheduler cancels
+     * only the tasks that were scheduled through it.
+     *
      * @since 3.3.0
      */
     class AMQCPP_API Scheduler : public activemq::util::ServiceSupport {
@@ -42,8 +57,11 @@ namespace threads {
 
         decaf::util::concurrent::Mutex mutex;
         std::string name;
-        decaf::util::Timer* timer;
-        decaf::util::StlMap<decaf::lang::Runnable*, decaf::util::TimerTask*> tasks;
+        bool cancelled;
+        decaf::lang::Pointer<SchedulerDispatcher> dispatcher;
+        decaf::util::StlMap<decaf::lang::Runnable*, decaf::lang::Pointer<ScheduledTask> > tasks;
+        std::list< decaf::lang::Pointer<ScheduledTask> > delayedTasks;
+        std::size_t delayedPurgeSize;
 
     private:
 
@@ -68,12 +86,33 @@ namespace threads {
 
         void shutdown();
 
+    public:
+
+        /**
+         * Creates the thread pool that the tasks of all Schedulers run on, called
+         * during library initialization.  No thread is started until a task is due.
+         */
+        static void initializeTaskRunners();
+
+        /**
+         * Stops the shared thread pool, called during library shutdown.
+         */
+        static void shutdownTaskRunners();
+
     protected:
 
         virtual void doStart();
 
         virtual void doStop(activemq::util::ServiceStopper* stopper);
 
+    private:
+
+        void checkCanSchedule(decaf::lang::Runnable* task) const;
+
+        decaf::lang::Pointer<ScheduledTask> createTask(decaf::lang::Runnable* task, bool ownsTask);
+
+        void cancelAll();
+
     };
 
 }}
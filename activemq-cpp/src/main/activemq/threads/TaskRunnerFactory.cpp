@@ -0,0 +1,159 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TaskRunnerFactory.h"
+
+#include <activemq/threads/DedicatedTaskRunner.h>
+#include <activemq/threads/PooledTaskRunner.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
+#include <decaf/util/concurrent/ThreadFactory.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+
+using namespace activemq;
+using namespace activemq::threads;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const int TaskRunnerFactory::DEFAULT_MAX_ITERATIONS_PER_RUN = 1000;
+const int TaskRunnerFactory::DEFAULT_MAX_THREAD_POOL_SIZE = 16;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class TaskRunnerThreadFactory : public ThreadFactory {
+    private:
+
+        std::string name;
+
+    public:
+
+        TaskRunnerThreadFactory(const std::string& name) : name(name) {}
+
+        virtual ~TaskRunnerThreadFactory() {}
+
+        virtual Thread* newThread(decaf::lang::Runnable* runnable) {
+            return new Thread(runnable, name);
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TaskRunnerFactory::TaskRunnerFactory(const std::string& name) :
+    mutex(), executor(), name(name), maxIterationsPerRun(DEFAULT_MAX_ITERATIONS_PER_RUN),
+    maxThreadPoolSize(DEFAULT_MAX_THREAD_POOL_SIZE), dedicatedTaskRunner(false), shutDown(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TaskRunnerFactory::TaskRunnerFactory(const std::string& name, int maxIterationsPerRun,
+                                     bool dedicatedTaskRunner, int maxThreadPoolSize) :
+    mutex(), executor(), name(name), maxIterationsPerRun(maxIterationsPerRun),
+    maxThreadPoolSize(maxThreadPoolSize), dedicatedTaskRunner(dedicatedTaskRunner), shutDown(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TaskRunnerFactory::~TaskRunnerFactory() {
+    try {
+        this->shutdown();
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TaskRunner* TaskRunnerFactory::createTaskRunner(Task* task) {
+
+    if (task == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Task passed was null");
+    }
+
+    synchronized(&mutex) {
+
+        if (this->shutDown) {
+            throw IllegalStateException(__FILE__, __LINE__, "TaskRunnerFactory has been shut down");
+        }
+
+        if (this->dedicatedTaskRunner) {
+            return new DedicatedTaskRunner(task);
+        }
+
+        if (this->executor == NULL) {
+            int poolSize = this->maxThreadPoolSize > 0 ? this->maxThreadPoolSize : DEFAULT_MAX_THREAD_POOL_SIZE;
+
+            // The queue is unbounded so the pool never grows past its core size, threads
+            // are only started as runners are scheduled so a quiet factory stays small.
+            this->executor.reset(new ThreadPoolExecutor(poolSize, poolSize, 30, TimeUnit::SECONDS,
+                new LinkedBlockingQueue<decaf::lang::Runnable*>(), new TaskRunnerThreadFactory(this->name)));
+        }
+
+        return new PooledTaskRunner(this->executor.get(), task, this->maxIterationsPerRun);
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TaskRunnerFactory::shutdown() {
+
+    Pointer<ThreadPoolExecutor> executor;
+
+    synchronized(&mutex) {
+        this->shutDown = true;
+        executor.swap(this->executor);
+    }
+
+    if (executor != NULL) {
+        executor->shutdown();
+        executor->awaitTermination(30, TimeUnit::SECONDS);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TaskRunnerFactory::isDedicatedTaskRunner() const {
+    return this->dedicatedTaskRunner;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TaskRunnerFactory::setDedicatedTaskRunner(bool dedicatedTaskRunner) {
+    this->dedicatedTaskRunner = dedicatedTaskRunner;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TaskRunnerFactory::getMaxIterationsPerRun() const {
+    return this->maxIterationsPerRun;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TaskRunnerFactory::setMaxIterationsPerRun(int maxIterationsPerRun) {
+    this->maxIterationsPerRun = maxIterationsPerRun;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TaskRunnerFactory::getMaxThreadPoolSize() const {
+    return this->maxThreadPoolSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TaskRunnerFactory::setMaxThreadPoolSize(int maxThreadPoolSize) {
+    this->maxThreadPoolSize = maxThreadPoolSize;
+}
@@ -0,0 +1,171 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_THREADS_TASKRUNNERFACTORY_H_
+#define _ACTIVEMQ_THREADS_TASKRUNNERFACTORY_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/threads/TaskRunner.h>
+#include <activemq/threads/Task.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/ThreadPoolExecutor.h>
+
+#include <string>
+
+namespace activemq {
+namespace threads {
+
+    /**
+     * Creates the TaskRunner instances for a set of Tasks.  By default every Task gets
+     * a PooledTaskRunner and all of them share one bounded pool of threads, so the
+     * number of threads no longer grows with the number of Tasks.  The factory can
+     * instead be configured to give each Task a DedicatedTaskRunner with its own thread.
+     *
+     * The thread pool is created when the first pooled TaskRunner is requested and
+     * must outlive every TaskRunner that uses it, shut the runners down before the
+     * factory.
+     *
+     * @since 3.10.0
+     */
+    class AMQCPP_API TaskRunnerFactory {
+    public:
+
+        /**
+         * The default number of Task iterations a pooled thread runs before giving
+         * the thread back to the pool.
+         */
+        static const int DEFAULT_MAX_ITERATIONS_PER_RUN;
+
+        /**
+         * The default maximum number of threads in the pool.
+         */
+        static const int DEFAULT_MAX_THREAD_POOL_SIZE;
+
+    private:
+
+        mutable decaf::util::concurrent::Mutex mutex;
+        decaf::lang::Pointer<decaf::util::concurrent::ThreadPoolExecutor> executor;
+
+        std::string name;
+        int maxIterationsPerRun;
+        int maxThreadPoolSize;
+        bool dedicatedTaskRunner;
+        bool shutDown;
+
+    private:
+
+        TaskRunnerFactory(const TaskRunnerFactory&);
+        TaskRunnerFactory& operator=(const TaskRunnerFactory&);
+
+    public:
+
+        /**
+         * Creates a factory that hands out pooled TaskRunners using the default
+         * settings.
+         *
+         * @param name
+         *      The name given to the threads created by this factory.
+         */
+        TaskRunnerFactory(const std::string& name);
+
+        /**
+         * Creates a new TaskRunnerFactory.
+         *
+         * @param name
+         *      The name given to the threads created by this factory.
+         * @param maxIterationsPerRun
+         *      The number of iterations a pooled thread runs for one Task before
+         *      giving the thread back to the pool.
+         * @param dedicatedTaskRunner
+         *      True if each Task should be given a thread of its own.
+         * @param maxThreadPoolSize
+         *      The maximum number of threads that the pooled TaskRunners share.
+         */
+        TaskRunnerFactory(const std::string& name, int maxIterationsPerRun,
+                          bool dedicatedTaskRunner, int maxThreadPoolSize);
+
+        virtual ~TaskRunnerFactory();
+
+        /**
+         * Creates a new TaskRunner for the given Task, the caller owns the returned
+         * TaskRunner and must shut it down before this factory is shut down.
+         *
+         * @param task
+         *      The Task that the new TaskRunner runs.
+         *
+         * @return a new TaskRunner instance.
+         *
+         * @throws NullPointerException if the Task is NULL.
+         * @throws IllegalStateException if the factory has been shut down.
+         */
+        TaskRunner* createTaskRunner(Task* task);
+
+        /**
+         * Stops the threads of the shared pool once the tasks they are running
+         * are done, no new TaskRunners can be created afterwards.
+         */
+        void shutdown();
+
+        /**
+         * @return true if each Task is given a DedicatedTaskRunner.
+         */
+        bool isDedicatedTaskRunner() const;
+
+        /**
+         * Sets whether each Task is given a DedicatedTaskRunner, only affects
+         * TaskRunners created after the call.
+         *
+         * @param dedicatedTaskRunner
+         *      True if each Task should be given a thread of its own.
+         */
+        void setDedicatedTaskRunner(bool dedicatedTaskRunner);
+
+        /**
+         * @return the number of iterations a pooled thread runs for one Task.
+         */
+        int getMaxIterationsPerRun() const;
+
+        /**
+         * Sets the number of iterations a pooled thread runs for one Task before
+         * giving the thread back to the pool.
+         *
+         * @param maxIterationsPerRun
+         *      The iteration limit, only affects TaskRunners created after the call.
+         */
+        void setMaxIterationsPerRun(int maxIterationsPerRun);
+
+        /**
+         * @return the maximum number of threads that the pooled TaskRunners share.
+         */
+        int getMaxThreadPoolSize() const;
+
+        /**
+         * Sets the maximum number of threads that the pooled TaskRunners share, has
+         * no effect once the first pooled TaskRunner has been created.
+         *
+         * @param maxThreadPoolSize
+         *      The maximum number of pooled threads.
+         */
+        void setMaxThreadPoolSize(int maxThreadPoolSize);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_THREADS_TASKRUNNERFACTORY_H_ */
@@ -0,0 +1,463 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TimerWheel.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+
+using namespace activemq;
+using namespace activemq::threads;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const long long TimerWheel::DEFAULT_TICK_DURATION = 10;
+const int TimerWheel::DEFAULT_TICKS_PER_WHEEL = 512;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    TimerWheel* theOnlyInstance = NULL;
+
+    int normalizeTicksPerWheel(int ticksPerWheel) {
+        int normalized = 1;
+        while (normalized < ticksPerWheel) {
+            normalized <<= 1;
+        }
+        return normalized;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimerWheelTimeout::TimerWheelTimeout(TimerWheel* wheel, Runnable* task, bool ownsTask,
+                                     long long deadline, long long period, bool fixedRate) :
+    wheel(wheel), task(task), ownsTask(ownsTask), deadline(deadline), period(period), fixedRate(fixedRate),
+    remainingRounds(0), bucket(0), position(), scheduled(false), running(false), cancelled(false), done(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimerWheelTimeout::~TimerWheelTimeout() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TimerWheelTimeout::cancel() {
+
+    TimerWheel* wheel = this->wheel.get();
+    if (wheel == NULL) {
+        return false;
+    }
+
+    return wheel->cancel(this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TimerWheelTimeout::isCancelled() const {
+
+    TimerWheel* wheel = this->wheel.get();
+    if (wheel == NULL) {
+        return this->cancelled;
+    }
+
+    bool result = false;
+    synchronized(&wheel->mutex) {
+        result = this->cancelled;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TimerWheelTimeout::isDone() const {
+
+    TimerWheel* wheel = this->wheel.get();
+    if (wheel == NULL) {
+        return this->done;
+    }
+
+    bool result = false;
+    synchronized(&wheel->mutex) {
+        result = this->done;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimerWheel::TimerWheel(const std::string& name) :
+    Runnable(), mutex(), name(name), tickDuration(DEFAULT_TICK_DURATION), wheel(DEFAULT_TICKS_PER_WHEEL),
+    mask(DEFAULT_TICKS_PER_WHEEL - 1), thread(), startTime(currentTime()), tick(0), pending(0), shutDown(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimerWheel::TimerWheel(const std::string& name, long long tickDuration, int ticksPerWheel) :
+    Runnable(), mutex(), name(name), tickDuration(tickDuration), wheel(), mask(0), thread(),
+    startTime(currentTime()), tick(0), pending(0), shutDown(false) {
+
+    if (tickDuration <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Tick duration must be positive.");
+    }
+
+    if (ticksPerWheel <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Ticks per wheel must be positive.");
+    }
+
+    int size = normalizeTicksPerWheel(ticksPerWheel);
+    this->wheel.resize(size);
+    this->mask = size - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimerWheel::~TimerWheel() {
+    try {
+
+        Pointer<Thread> thread;
+        std::vector< Pointer<TimerWheelTimeout> > cancelled;
+
+        synchronized(&mutex) {
+            this->shutDown = true;
+            thread.swap(this->thread);
+            mutex.notifyAll();
+        }
+
+        if (thread != NULL && thread.get() != Thread::currentThread()) {
+            thread->join();
+        }
+
+        synchronized(&mutex) {
+            for (std::size_t i = 0; i < this->wheel.size(); ++i) {
+                Bucket& bucket = this->wheel[i];
+                cancelled.insert(cancelled.end(), bucket.begin(), bucket.end());
+                bucket.clear();
+            }
+            this->pending = 0;
+        }
+
+        std::vector< Pointer<TimerWheelTimeout> >::iterator iter = cancelled.begin();
+        for (; iter != cancelled.end(); ++iter) {
+            TimerWheelTimeout* timeout = iter->get();
+            timeout->scheduled = false;
+            timeout->cancelled = true;
+            delete complete(timeout);
+        }
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<TimerWheelTimeout> TimerWheel::schedule(Runnable* task, long long delay, bool ownsTask) {
+    return doSchedule(task, delay, 0, false, ownsTask);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<TimerWheelTimeout> TimerWheel::scheduleAtFixedRate(Runnable* task, long long delay, long long period, bool ownsTask) {
+
+    if (period <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Period must be positive.");
+    }
+
+    return doSchedule(task, delay, period, true, ownsTask);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<TimerWheelTimeout> TimerWheel::scheduleWithFixedDelay(Runnable* task, long long delay, long long period, bool ownsTask) {
+
+    if (period <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Period must be positive.");
+    }
+
+    return doSchedule(task, delay, period, false, ownsTask);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<TimerWheelTimeout> TimerWheel::doSchedule(Runnable* task, long long delay, long long period, bool fixedRate, bool ownsTask) {
+
+    if (task == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Task to schedule cannot be NULL.");
+    }
+
+    if (delay < 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Delay cannot be negative.");
+    }
+
+    Pointer<TimerWheelTimeout> timeout;
+
+    synchronized(&mutex) {
+
+        if (this->shutDown) {
+            throw IllegalStateException(__FILE__, __LINE__, "TimerWheel has been shut down.");
+        }
+
+        long long now = currentTime();
+
+        // The wheel stops turning while it is empty, catch the tick count up to
+        // the current time before hashing the new timeout into it.
+        if (this->pending == 0) {
+            this->tick = elapsedTicks(now);
+        }
+
+        timeout.reset(new TimerWheelTimeout(this, task, ownsTask, now + delay, period, fixedRate));
+        insert(timeout);
+
+        if (this->thread == NULL) {
+            this->thread.reset(new Thread(this, this->name));
+            this->thread->start();
+        } else {
+            mutex.notifyAll();
+        }
+    }
+
+    return timeout;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TimerWheel::getPendingCount() const {
+
+    int result = 0;
+    synchronized(&mutex) {
+        result = this->pending;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long TimerWheel::getTickDuration() const {
+    return this->tickDuration;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long TimerWheel::elapsedTicks(long long now) const {
+    return (now - this->startTime) / this->tickDuration;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheel::insert(const Pointer<TimerWheelTimeout>& timeout) {
+
+    long long size = (long long) this->wheel.size();
+
+    // A timeout fires on the first tick that ends at or after its deadline, and
+    // never on the tick that is being processed right now.
+    long long deadlineTick = (timeout->deadline - this->startTime + this->tickDuration - 1) / this->tickDuration;
+    if (deadlineTick <= this->tick) {
+        deadlineTick = this->tick + 1;
+    }
+
+    timeout->remainingRounds = (deadlineTick - this->tick - 1) / size;
+    timeout->bucket = (int) (deadlineTick & this->mask);
+
+    Bucket& bucket = this->wheel[timeout->bucket];
+    timeout->position = bucket.insert(bucket.end(), timeout);
+    timeout->scheduled = true;
+    this->pending++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheel::remove(TimerWheelTimeout* timeout) {
+
+    if (timeout->scheduled) {
+        timeout->scheduled = false;
+        this->pending--;
+        this->wheel[timeout->bucket].erase(timeout->position);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TimerWheel::cancel(TimerWheelTimeout* timeout) {
+
+    Runnable* release = NULL;
+
+    synchronized(&mutex) {
+
+        if (timeout->cancelled || timeout->done) {
+            return false;
+        }
+
+        timeout->cancelled = true;
+
+        // Hold a reference since removing it from its bucket may drop the last one.
+        Pointer<TimerWheelTimeout> hold;
+        if (timeout->scheduled) {
+            hold = *timeout->position;
+            remove(timeout);
+        }
+
+        if (timeout->running) {
+
+            // The wheel thread finishes up a timeout cancelled from its own run method.
+            if (this->thread != NULL && this->thread.get() == Thread::currentThread()) {
+                return true;
+            }
+
+            while (timeout->running) {
+                mutex.wait();
+            }
+        }
+
+        if (!timeout->done) {
+            release = complete(timeout);
+        }
+    }
+
+    delete release;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Runnable* TimerWheel::complete(TimerWheelTimeout* timeout) {
+
+    Runnable* release = timeout->ownsTask ? timeout->task : NULL;
+
+    timeout->done = true;
+    timeout->task = NULL;
+    timeout->wheel.set(NULL);
+
+    return release;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheel::run() {
+
+    std::vector< Pointer<TimerWheelTimeout> > expired;
+    bool stopped = false;
+
+    while (!stopped) {
+
+        synchronized(&mutex) {
+
+            while (expired.empty() && !this->shutDown) {
+
+                if (this->pending == 0) {
+                    mutex.wait();
+                    continue;
+                }
+
+                long long now = currentTime();
+                long long nextTick = this->startTime + (this->tick + 1) * this->tickDuration;
+
+                if (now < nextTick) {
+                    mutex.wait(nextTick - now);
+                    continue;
+                }
+
+                // Process every tick that has passed, more than one if we fell behind.
+                while (nextTick <= now) {
+                    this->tick++;
+                    nextTick += this->tickDuration;
+
+                    Bucket& bucket = this->wheel[(int) (this->tick & this->mask)];
+                    Bucket::iterator iter = bucket.begin();
+                    while (iter != bucket.end()) {
+                        Pointer<TimerWheelTimeout> timeout = *iter;
+                        if (timeout->remainingRounds > 0) {
+                            timeout->remainingRounds--;
+                            ++iter;
+                        } else {
+                            iter = bucket.erase(iter);
+                            timeout->scheduled = false;
+                            this->pending--;
+                            expired.push_back(timeout);
+                        }
+                    }
+                }
+            }
+
+            stopped = this->shutDown;
+        }
+
+        std::vector< Pointer<TimerWheelTimeout> >::iterator iter = expired.begin();
+        for (; iter != expired.end(); ++iter) {
+
+            Pointer<TimerWheelTimeout> timeout = *iter;
+            Runnable* task = NULL;
+
+            synchronized(&mutex) {
+                if (!timeout->cancelled) {
+                    timeout->running = true;
+                    task = timeout->task;
+                }
+            }
+
+            if (task == NULL) {
+                continue;
+            }
+
+            try {
+                task->run();
+            }
+            AMQ_CATCHALL_NOTHROW()
+
+            Runnable* release = NULL;
+
+            synchronized(&mutex) {
+
+                timeout->running = false;
+
+                if (timeout->period > 0 && !timeout->cancelled && !this->shutDown) {
+                    if (timeout->fixedRate) {
+                        timeout->deadline += timeout->period;
+                    } else {
+                        timeout->deadline = currentTime() + timeout->period;
+                    }
+                    insert(timeout);
+                } else if (!timeout->done) {
+                    release = complete(timeout.get());
+                }
+
+                mutex.notifyAll();
+            }
+
+            delete release;
+        }
+
+        expired.clear();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long TimerWheel::currentTime() {
+    return System::nanoTime() / 1000000;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimerWheel& TimerWheel::getInstance() {
+
+    if (theOnlyInstance == NULL) {
+        throw IllegalStateException(__FILE__, __LINE__, "Library is not initialized.");
+    }
+
+    return *theOnlyInstance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheel::initialize() {
+    theOnlyInstance = new TimerWheel("ActiveMQ TimerWheel");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheel::shutdown() {
+    delete theOnlyInstance;
+    theOnlyInstance = NULL;
+}
@@ -0,0 +1,236 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_THREADS_TIMERWHEEL_H_
+#define _ACTIVEMQ_THREADS_TIMERWHEEL_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/threads/TimerWheelTimeout.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <list>
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace threads {
+
+    /**
+     * A hashed timer wheel that runs any number of delayed and periodic Runnables
+     * from a single thread.  Time is divided into ticks, each Runnable is hashed
+     * into the bucket of the tick it expires in along with the number of turns of
+     * the wheel that must pass first, so scheduling and cancelling are constant
+     * time operations no matter how many timeouts are pending.
+     *
+     * The Runnables are run on the wheel's own thread one after another and so
+     * should do little work, hand anything longer off to a TaskRunner.  Timeouts
+     * fire on the first tick at or after their deadline, so accuracy is limited to
+     * the tick duration.
+     *
+     * The library keeps one instance that is shared by all connections, see
+     * getInstance.  The thread is started when the first Runnable is scheduled
+     * and waits without ticking while nothing is pending.
+     *
+     * @since 3.10.0
+     */
+    class AMQCPP_API TimerWheel : private decaf::lang::Runnable {
+    public:
+
+        /**
+         * The default length of one tick of the wheel in milliseconds.
+         */
+        static const long long DEFAULT_TICK_DURATION;
+
+        /**
+         * The default number of buckets, one per tick, in one turn of the wheel.
+         */
+        static const int DEFAULT_TICKS_PER_WHEEL;
+
+    private:
+
+        friend class TimerWheelTimeout;
+
+        typedef std::list< decaf::lang::Pointer<TimerWheelTimeout> > Bucket;
+
+        mutable decaf::util::concurrent::Mutex mutex;
+        std::string name;
+        long long tickDuration;
+        std::vector<Bucket> wheel;
+        int mask;
+
+        decaf::lang::Pointer<decaf::lang::Thread> thread;
+        long long startTime;
+        long long tick;
+        int pending;
+        bool shutDown;
+
+    private:
+
+        TimerWheel(const TimerWheel&);
+        TimerWheel& operator= (const TimerWheel&);
+
+    public:
+
+        /**
+         * Creates a new TimerWheel with the default tick duration and wheel size.
+         *
+         * @param name
+         *      The name given to the wheel's thread.
+         */
+        TimerWheel(const std::string& name);
+
+        /**
+         * Creates a new TimerWheel.
+         *
+         * @param name
+         *      The name given to the wheel's thread.
+         * @param tickDuration
+         *      The length of one tick in milliseconds.
+         * @param ticksPerWheel
+         *      The number of buckets in the wheel, rounded up to a power of two.
+         *
+         * @throws IllegalArgumentException if the tick duration or wheel size is not positive.
+         */
+        TimerWheel(const std::string& name, long long tickDuration, int ticksPerWheel);
+
+        /**
+         * Cancels all pending timeouts and stops the wheel's thread.
+         */
+        virtual ~TimerWheel();
+
+        /**
+         * Runs the given Runnable once after the given delay.
+         *
+         * @param task
+         *      The Runnable to run.
+         * @param delay
+         *      The delay in milliseconds before the Runnable is run.
+         * @param ownsTask
+         *      Should the TimerWheel delete the Runnable once it is done with it.
+         *
+         * @return a handle that can be used to cancel the scheduled Runnable.
+         *
+         * @throws NullPointerException if the Runnable is NULL.
+         * @throws IllegalArgumentException if the delay is negative.
+         * @throws IllegalStateException if the TimerWheel has been shut down.
+         */
+        decaf::lang::Pointer<TimerWheelTimeout> schedule(decaf::lang::Runnable* task, long long delay, bool ownsTask = true);
+
+        /**
+         * Runs the given Runnable after the given delay and then repeatedly with the given
+         * period measured from the time each run was due, runs that are late are caught up.
+         *
+         * @param task
+         *      The Runnable to run.
+         * @param delay
+         *      The delay in milliseconds before the first run.
+         * @param period
+         *      The time in milliseconds between the start of successive runs.
+         * @param ownsTask
+         *      Should the TimerWheel delete the Runnable once it is done with it.
+         *
+         * @return a handle that can be used to cancel the scheduled Runnable.
+         *
+         * @throws NullPointerException if the Runnable is NULL.
+         * @throws IllegalArgumentException if the delay is negative or the period is not positive.
+         * @throws IllegalStateException if the TimerWheel has been shut down.
+         */
+        decaf::lang::Pointer<TimerWheelTimeout> scheduleAtFixedRate(decaf::lang::Runnable* task, long long delay,
+                                                                    long long period, bool ownsTask = true);
+
+        /**
+         * Runs the given Runnable after the given delay and then repeatedly with the given
+         * period measured from the end of the previous run.
+         *
+         * @param task
+         *      The Runnable to run.
+         * @param delay
+         *      The delay in milliseconds before the first run.
+         * @param period
+         *      The time in milliseconds between the end of one run and the start of the next.
+         * @param ownsTask
+         *      Should the TimerWheel delete the Runnable once it is done with it.
+         *
+         * @return a handle that can be used to cancel the scheduled Runnable.
+         *
+         * @throws NullPointerException if the Runnable is NULL.
+         * @throws IllegalArgumentException if the delay is negative or the period is not positive.
+         * @throws IllegalStateException if the TimerWheel has been shut down.
+         */
+        decaf::lang::Pointer<TimerWheelTimeout> scheduleWithFixedDelay(decaf::lang::Runnable* task, long long delay,
+                                                                       long long period, bool ownsTask = true);
+
+        /**
+         * @return the number of timeouts that are waiting to expire.
+         */
+        int getPendingCount() const;
+
+        /**
+         * @return the length of one tick of the wheel in milliseconds.
+         */
+        long long getTickDuration() const;
+
+    public:
+
+        /**
+         * Gets the TimerWheel that is shared by the whole library.
+         *
+         * @return the single TimerWheel instance.
+         *
+         * @throws IllegalStateException if the library has not been initialized.
+         */
+        static TimerWheel& getInstance();
+
+        /**
+         * Creates the shared TimerWheel, called during library initialization.
+         */
+        static void initialize();
+
+        /**
+         * Destroys the shared TimerWheel, called during library shutdown.
+         */
+        static void shutdown();
+
+    private:
+
+        virtual void run();
+
+        decaf::lang::Pointer<TimerWheelTimeout> doSchedule(decaf::lang::Runnable* task, long long delay,
+                                                           long long period, bool fixedRate, bool ownsTask);
+
+        // All of the following must be called with the mutex held.
+        long long elapsedTicks(long long now) const;
+        void insert(const decaf::lang::Pointer<TimerWheelTimeout>& timeout);
+        void remove(TimerWheelTimeout* timeout);
+
+        // Marks the timeout done and detaches it from this wheel, returns the
+        // Runnable the caller must delete once the mutex is released.
+        decaf::lang::Runnable* complete(TimerWheelTimeout* timeout);
+
+        bool cancel(TimerWheelTimeout* timeout);
+
+        static long long currentTime();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_THREADS_TIMERWHEEL_H_ */
@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_THREADS_TIMERWHEELTIMEOUT_H_
+#define _ACTIVEMQ_THREADS_TIMERWHEELTIMEOUT_H_
+
+#include <activemq/util/Config.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/util/concurrent/atomic/AtomicReference.h>
+
+#include <list>
+
+namespace activemq {
+namespace threads {
+
+    class TimerWheel;
+
+    /**
+     * Handle to a Runnable that has been scheduled with a TimerWheel, used to
+     * cancel the Runnable or to find out whether it has finished.
+     *
+     * @since 3.10.0
+     */
+    class AMQCPP_API TimerWheelTimeout {
+    private:
+
+        friend class TimerWheel;
+
+        // Cleared once the timeout is done so a handle that outlives its wheel
+        // never touches it, the other fields don't change after that.
+        decaf::util::concurrent::atomic::AtomicReference<TimerWheel> wheel;
+        decaf::lang::Runnable* task;
+        bool ownsTask;
+
+        long long deadline;
+        long long period;
+        bool fixedRate;
+
+        long long remainingRounds;
+        int bucket;
+        std::list< decaf::lang::Pointer<TimerWheelTimeout> >::iterator position;
+
+        bool scheduled;
+        bool running;
+        bool cancelled;
+        bool done;
+
+    private:
+
+        TimerWheelTimeout(const TimerWheelTimeout&);
+        TimerWheelTimeout& operator= (const TimerWheelTimeout&);
+
+        TimerWheelTimeout(TimerWheel* wheel, decaf::lang::Runnable* task, bool ownsTask,
+                          long long deadline, long long period, bool fixedRate);
+
+    public:
+
+        virtual ~TimerWheelTimeout();
+
+        /**
+         * Cancels the scheduled Runnable, it will not be run again after this method
+         * returns.  If the Runnable is currently running on the TimerWheel thread this
+         * method waits for it to complete unless it is called from that same thread.
+         *
+         * @return true if this call prevented one or more runs of the Runnable.
+         */
+        bool cancel();
+
+        /**
+         * @return true if this timeout was cancelled.
+         */
+        bool isCancelled() const;
+
+        /**
+         * @return true if the Runnable will not be run again, either because it was a
+         *         one time task that has run or because the timeout was cancelled.
+         */
+        bool isDone() const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_THREADS_TIMERWHEELTIMEOUT_H_ */
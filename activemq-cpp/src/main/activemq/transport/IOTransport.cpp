@@ -18,12 +18,17 @@
 #include "IOTransport.h"
 
 #include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/util/concurrent/Mutex.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/InterruptedException.h>
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <activemq/wireformat/WireFormat.h>
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/util/Config.h>
 #include <typeinfo>
+#include <deque>
+#include <vector>
 
 using namespace activemq;
 using namespace activemq::transport;
@@ -43,6 +48,27 @@ LOGDECAF_INITIALIZE( logger, IOTransport, "activemq.transport.IOTransport")
 namespace activemq {
 namespace transport {
 
+    /**
+     * A command waiting in the write queue, owned by the sending thread which waits
+     * until the writer marks it as done.
+     */
+    class PendingWrite {
+    private:
+
+        PendingWrite(const PendingWrite&);
+        PendingWrite& operator= (const PendingWrite&);
+
+    public:
+
+        Pointer<Command> command;
+        bool done;
+        bool failed;
+        IOException error;
+
+        PendingWrite(const Pointer<Command> command) : command(command), done(false), failed(false), error() {
+        }
+    };
+
     class IOTransportImpl {
     private:
 
@@ -59,11 +85,29 @@ namespace transport {
         AtomicBoolean closed;
         AtomicBoolean started;
 
-        IOTransportImpl() : wireFormat(), listener(NULL), inputStream(NULL), outputStream(NULL), thread(), closed(false) {
+        // Used in place of the thread when the owner pushes the incoming data.
+        bool useReaderThread;
+        Pointer<wireformat::FrameDecoder> decoder;
+
+        bool writeCoalescing;
+        int writeCoalescingMaxBytes;
+        int writeCoalescingMaxDelay;
+
+        // Guards the write queue and the writer role, senders waiting for their
+        // command to be written wait on it as well.
+        Mutex writeMutex;
+        std::deque<PendingWrite*> writeQueue;
+        bool writing;
+
+        IOTransportImpl() : wireFormat(), listener(NULL), inputStream(NULL), outputStream(NULL), thread(), closed(false),
+                            useReaderThread(true), decoder(), writeCoalescing(false), writeCoalescingMaxBytes(65536), writeCoalescingMaxDelay(0),
+                            writeMutex(), writeQueue(), writing(false) {
         }
 
         IOTransportImpl(const Pointer<WireFormat> wireFormat) :
-            wireFormat(wireFormat), listener(NULL), inputStream(NULL), outputStream(NULL), thread(), closed(false) {
+            wireFormat(wireFormat), listener(NULL), inputStream(NULL), outputStream(NULL), thread(), closed(false),
+            useReaderThread(true), decoder(), writeCoalescing(false), writeCoalescingMaxBytes(65536), writeCoalescingMaxDelay(0),
+            writeMutex(), writeQueue(), writing(false) {
         }
     };
 
@@ -108,7 +152,7 @@ void IOTransport::fire(const Pointer<Command> command) {
 
         // If we have been closed then we don't deliver any messages that
         // might have sneaked in while we where closing.
-        if (this->impl->listener == NULL || this->impl->closed.get()) {
+        if (this->impl->listener == NULL || this->impl->closed.getAcquire()) {
             return;
         }
 
@@ -122,12 +166,13 @@ void IOTransport::oneway(const Pointer<Command> command) {
 
     try {
 
-        if (impl->closed.get()) {
+        // Checked for every command, nothing else is ordered against the flag here.
+        if (impl->closed.getAcquire()) {
             throw IOException(__FILE__, __LINE__, "IOTransport::oneway() - transport is closed!");
         }
 
         // Make sure the thread has been started.
-        if (impl->thread == NULL) {
+        if (impl->thread == NULL && impl->decoder == NULL) {
             throw IOException(__FILE__, __LINE__, "IOTransport::oneway() - transport is not started");
         }
 
@@ -141,6 +186,11 @@ void IOTransport::oneway(const Pointer<Command> command) {
             throw IOException(__FILE__, __LINE__, "IOTransport::oneway() - invalid output stream");
         }
 
+        if (impl->writeCoalescing) {
+            writeCoalesced(command);
+            return;
+        }
+
         synchronized(impl->outputStream) {
             // Write the command to the output stream.
             this->impl->wireFormat->marshal(command, this, this->impl->outputStream);
@@ -152,6 +202,138 @@ void IOTransport::oneway(const Pointer<Command> command) {
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::writeCoalesced(const Pointer<Command> command) {
+
+    PendingWrite write(command);
+    bool interrupted = false;
+
+    synchronized(&impl->writeMutex) {
+        impl->writeQueue.push_back(&write);
+
+        // Wake a writer that is waiting for more commands to fill its batch.
+        impl->writeMutex.notifyAll();
+    }
+
+    // The queue holds a pointer to the stack allocated write so this thread can't
+    // leave until the write is done, an interrupt is deferred until then.
+    while (true) {
+
+        bool writer = false;
+
+        synchronized(&impl->writeMutex) {
+            while (impl->writing && !write.done) {
+                try {
+                    impl->writeMutex.wait();
+                } catch (InterruptedException&) {
+                    interrupted = true;
+                }
+            }
+
+            if (!write.done) {
+                impl->writing = true;
+                writer = true;
+            }
+        }
+
+        if (!writer) {
+            break;
+        }
+
+        // The batch can end before reaching this thread's own command, in which case
+        // it goes around again and waits for or becomes the next writer.
+        writeBatch();
+    }
+
+    if (interrupted) {
+        Thread::currentThread()->interrupt();
+    }
+
+    if (write.failed) {
+        throw write.error;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::writeBatch() {
+
+    std::vector<PendingWrite*> batch;
+    IOException error;
+    bool failed = false;
+
+    try {
+
+        long long deadline = System::nanoTime() + (long long) impl->writeCoalescingMaxDelay * 1000;
+
+        synchronized(impl->outputStream) {
+
+            long long start = impl->outputStream->size();
+
+            while (true) {
+
+                PendingWrite* next = NULL;
+
+                synchronized(&impl->writeMutex) {
+                    while (impl->writeQueue.empty() && !impl->closed.get()) {
+                        long long remaining = deadline - System::nanoTime();
+                        if (remaining <= 0) {
+                            break;
+                        }
+
+                        impl->writeMutex.wait(remaining / 1000000, (int) (remaining % 1000000));
+                    }
+
+                    if (!impl->writeQueue.empty()) {
+                        next = impl->writeQueue.front();
+                        impl->writeQueue.pop_front();
+                        batch.push_back(next);
+                    }
+                }
+
+                if (next == NULL) {
+                    break;
+                }
+
+                this->impl->wireFormat->marshal(next->command, this, this->impl->outputStream);
+
+                if (impl->writeCoalescingMaxBytes > 0 &&
+                    impl->outputStream->size() - start >= impl->writeCoalescingMaxBytes) {
+                    break;
+                }
+            }
+
+            this->impl->outputStream->flush();
+        }
+    } catch (IOException& ex) {
+        error = ex;
+        error.setMark(__FILE__, __LINE__);
+        failed = true;
+    } catch (Exception& ex) {
+        error = IOException(ex);
+        error.setMark(__FILE__, __LINE__);
+        failed = true;
+    } catch (...) {
+        error = IOException(__FILE__, __LINE__, "IOTransport::writeBatch - caught unknown exception");
+        failed = true;
+    }
+
+    // Nothing in a failed batch is known to have reached the wire so every sender
+    // in it gets the error.
+    synchronized(&impl->writeMutex) {
+        std::vector<PendingWrite*>::iterator iter = batch.begin();
+        for (; iter != batch.end(); ++iter) {
+            if (failed) {
+                (*iter)->failed = true;
+                (*iter)->error = error;
+            }
+            (*iter)->done = true;
+        }
+
+        impl->writing = false;
+        impl->writeMutex.notifyAll();
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void IOTransport::start() {
 
@@ -164,11 +346,23 @@ void IOTransport::start() {
             }
 
             // Make sure all variables that we need have been set.
-            if (impl->inputStream == NULL || impl->outputStream == NULL || impl->wireFormat.get() == NULL) {
+            if ((impl->useReaderThread && impl->inputStream == NULL) ||
+                impl->outputStream == NULL || impl->wireFormat.get() == NULL) {
                 throw IOException(__FILE__, __LINE__, "IOTransport::start() - "
                         "IO streams and wireFormat instances must be set before calling start");
             }
 
+            if (!impl->useReaderThread) {
+
+                if (!impl->wireFormat->hasFrameDecoder()) {
+                    throw IOException(__FILE__, __LINE__, "IOTransport::start() - "
+                            "the WireFormat can't decode pushed data, a reader thread is required");
+                }
+
+                impl->decoder = impl->wireFormat->createFrameDecoder();
+                return;
+            }
+
             // Start the polling thread.
             impl->thread.reset(new Thread(this, "IOTransport reader Thread"));
             impl->thread->start();
@@ -204,6 +398,10 @@ void IOTransport::close() {
 
         ~Finalizer() {
             try {
+                if (target == NULL) {
+                    return;
+                }
+
                 target->join();
                 target.reset(NULL);
             }
@@ -265,7 +463,7 @@ void IOTransport::run() {
 
     try {
 
-        while (this->impl->started.get() && !this->impl->closed.get()) {
+        while (this->impl->started.getAcquire() && !this->impl->closed.getAcquire()) {
 
             // Read the next command from the input stream.
             Pointer<Command> command(impl->wireFormat->unmarshal(this, this->impl->inputStream));
@@ -287,6 +485,42 @@ void IOTransport::run() {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::receive(const unsigned char* buffer, int size, int offset, int length) {
+
+    try {
+
+        if (impl->decoder == NULL) {
+            throw IOException(__FILE__, __LINE__, "IOTransport::receive() - transport must be started without a reader thread");
+        }
+
+        impl->decoder->receive(buffer, size, offset, length);
+
+        // The same as the reader thread, stop delivering once stopped or closed and
+        // leave the rest of the data undecoded.
+        while (this->impl->started.getAcquire() && !this->impl->closed.getAcquire()) {
+
+            Pointer<Command> command(impl->decoder->next(this));
+            if (command == NULL) {
+                break;
+            }
+
+            fire(command);
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::receiveFailed(const decaf::lang::Exception& error) {
+
+    exceptions::ActiveMQException ex(error);
+    ex.setMark(__FILE__, __LINE__);
+    fire(ex);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<FutureResponse> IOTransport::asyncRequest(const Pointer<Command> command AMQCPP_UNUSED,
                                                   const Pointer<ResponseCallback> responseCallback AMQCPP_UNUSED) {
@@ -316,6 +550,46 @@ void IOTransport::setOutputStream(decaf::io::DataOutputStream* os) {
     this->impl->outputStream = os;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setWriteCoalescing(bool value) {
+    this->impl->writeCoalescing = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool IOTransport::isWriteCoalescing() const {
+    return this->impl->writeCoalescing;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setWriteCoalescingMaxBytes(int maxBytes) {
+    this->impl->writeCoalescingMaxBytes = maxBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int IOTransport::getWriteCoalescingMaxBytes() const {
+    return this->impl->writeCoalescingMaxBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setWriteCoalescingMaxDelay(int maxDelay) {
+    this->impl->writeCoalescingMaxDelay = maxDelay;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int IOTransport::getWriteCoalescingMaxDelay() const {
+    return this->impl->writeCoalescingMaxDelay;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setUseReaderThread(bool value) {
+    this->impl->useReaderThread = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool IOTransport::isUseReaderThread() const {
+    return this->impl->useReaderThread;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<wireformat::WireFormat> IOTransport::getWireFormat() const {
     return this->impl->wireFormat;
@@ -24,6 +24,7 @@
 #include <activemq/commands/Command.h>
 #include <activemq/commands/Response.h>
 #include <activemq/wireformat/WireFormat.h>
+#include <activemq/wireformat/FrameDecoder.h>
 
 #include <decaf/lang/Runnable.h>
 #include <decaf/lang/Thread.h>
@@ -51,6 +52,9 @@ namespace transport {
      * however, because the read operation is blocking the transport my still pull one command
      * off the wire even after the stop method has been called.
      *
+     * The polling thread can be disabled, the owner then reads the connection without
+     * blocking and pushes the data to receive, see setUseReaderThread.
+     *
      * The close method will close the associated
      * streams.  Close can be called explicitly by the user, but is also called in the
      * destructor.  Once this object has been closed, it cannot be restarted.
@@ -87,6 +91,23 @@ namespace transport {
          */
         void fire(const Pointer<Command> command);
 
+        /**
+         * Queues the command for the next coalesced write and returns once it has
+         * been written, the calling thread writes the batch itself if no other
+         * thread is already doing so.
+         *
+         * @param command
+         *      The command to write.
+         */
+        void writeCoalesced(const Pointer<Command> command);
+
+        /**
+         * Writes the commands waiting in the write queue to the output stream and
+         * flushes it once, must only be called by the thread that holds the
+         * writer role.
+         */
+        void writeBatch();
+
     public:
 
         /**
@@ -121,6 +142,101 @@ namespace transport {
          */
         virtual void setOutputStream(decaf::io::DataOutputStream* os);
 
+        /**
+         * Enables or disables write coalescing, it is disabled by default.  When
+         * enabled commands sent concurrently are queued and one of the sending threads
+         * marshals the whole queue and flushes the output stream once, so a burst of
+         * small commands reaches the socket in a few large writes instead of one write
+         * per command.  The oneway method still returns only after the command has been
+         * written and still throws if the write fails.
+         *
+         * @param value
+         *      True if writes should be coalesced.
+         */
+        void setWriteCoalescing(bool value);
+
+        /**
+         * @return true if concurrent writes are coalesced into batches.
+         */
+        bool isWriteCoalescing() const;
+
+        /**
+         * Sets the number of bytes after which a coalesced batch is flushed even if
+         * more commands are waiting, a value of zero or less places no limit on the
+         * batch size.
+         *
+         * @param maxBytes
+         *      The maximum number of bytes to write before flushing.
+         */
+        void setWriteCoalescingMaxBytes(int maxBytes);
+
+        /**
+         * @return the number of bytes after which a coalesced batch is flushed.
+         */
+        int getWriteCoalescingMaxBytes() const;
+
+        /**
+         * Sets how long in microseconds the writing thread waits for more commands
+         * before it flushes a batch that is smaller than the maximum batch size.  The
+         * default of zero never delays a write, a batch then holds only the commands
+         * that were queued while the previous batch was being written.
+         *
+         * @param maxDelay
+         *      The maximum time in microseconds to wait for more commands.
+         */
+        void setWriteCoalescingMaxDelay(int maxDelay);
+
+        /**
+         * @return the time in microseconds the writer waits for more commands.
+         */
+        int getWriteCoalescingMaxDelay() const;
+
+        /**
+         * Sets whether start creates the thread that reads and unmarshals the incoming
+         * commands, it is used by default.  Without it the owner of this Transport reads
+         * from the connection itself, usually on a thread shared with other connections,
+         * and passes the data to receive, which requires a WireFormat that can create a
+         * FrameDecoder.
+         *
+         * @param value
+         *      False if the owner pushes the incoming data to this Transport.
+         */
+        void setUseReaderThread(bool value);
+
+        /**
+         * @return true if start creates a thread to read the incoming commands.
+         */
+        bool isUseReaderThread() const;
+
+        /**
+         * Decodes data read from the connection and passes every command it completes to
+         * the listener, the data of a command that hasn't fully arrived is kept until
+         * the rest of it is received.  Only used when the reader thread is disabled and
+         * never by more than one thread at a time.
+         *
+         * @param buffer
+         *      The buffer holding the data.
+         * @param size
+         *      The size of the buffer.
+         * @param offset
+         *      The offset into the buffer where the data starts.
+         * @param length
+         *      The number of bytes of data.
+         *
+         * @throws IOException if the Transport wasn't started without a reader thread or
+         *         the data can't be decoded, the connection is unusable afterwards.
+         */
+        void receive(const unsigned char* buffer, int size, int offset, int length);
+
+        /**
+         * Tells the listener that reading from the connection failed, used in place of
+         * the reader thread's own error reporting when the reader thread is disabled.
+         *
+         * @param error
+         *      The error that ended reading from the connection.
+         */
+        void receiveFailed(const decaf::lang::Exception& error);
+
     public:  // Transport methods
 
         virtual void oneway(const Pointer<Command> command);
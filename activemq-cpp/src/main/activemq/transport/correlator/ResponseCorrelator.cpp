@@ -18,10 +18,15 @@
 #include "ResponseCorrelator.h"
 #include <algorithm>
 
+#include <decaf/io/InterruptedIOException.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
 #include <decaf/util/ArrayList.h>
 #include <decaf/util/concurrent/Mutex.h>
 #include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/util/concurrent/locks/LockSupport.h>
 #include <decaf/util/HashMap.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
 
 #include <activemq/commands/Response.h>
 #include <activemq/commands/ExceptionResponse.h>
@@ -38,6 +43,8 @@ using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::locks;
+using namespace decaf::internal::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace {
@@ -70,18 +77,70 @@ namespace {
     };
 }
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Must be a power of two, command ids are mapped onto the slots by masking.
+    const int NUM_RESPONSE_SLOTS = 256;
+    const int RESPONSE_SLOT_MASK = NUM_RESPONSE_SLOTS - 1;
+
+    const int SLOT_PENDING = 0;
+    const int SLOT_COMPLETING = 1;
+    const int SLOT_COMPLETE = 2;
+
+    /**
+     * Holds the response for one synchronous request while its thread waits.
+     *
+     * The owner is the command id of the waiting request, a completer claims the
+     * slot by negating it so that a stale response for an earlier request that
+     * used the same slot can never complete a later one.  Only the waiting thread
+     * hands the slot back by resetting the owner to zero.
+     */
+    class ResponseSlot {
+    private:
+
+        ResponseSlot(const ResponseSlot&);
+        ResponseSlot& operator= (const ResponseSlot&);
+
+    public:
+
+        volatile int owner;
+        volatile int state;
+        volatile void* waiter;
+        Pointer<Response> response;
+
+    public:
+
+        ResponseSlot() : owner(0), state(SLOT_PENDING), waiter(NULL), response() {}
+
+    };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 namespace activemq{
 namespace transport{
 namespace correlator{
 
     class CorrelatorData {
+    private:
+
+        CorrelatorData(const CorrelatorData&);
+        CorrelatorData& operator= (const CorrelatorData&);
+
     public:
 
         // The next command id for sent commands.
         decaf::util::concurrent::atomic::AtomicInteger nextCommandId;
 
-        // Map of request ids to future response objects.
+        // Synchronous requests wait on these, indexed by their command id.
+        ResponseSlot slots[NUM_RESPONSE_SLOTS];
+
+        // Set once the filter is disposed, read without the lock by requests
+        // that are waiting in a slot.
+        volatile int disposed;
+
+        // Map of request ids to future response objects, used for asynchronous
+        // requests and for synchronous ones whose slot is still in use.
         HashMap<unsigned int, Pointer<FutureResponse> > requestMap;
 
         // Sync object for accessing the request map.
@@ -92,7 +151,184 @@ namespace correlator{
 
     public:
 
-        CorrelatorData() : nextCommandId(1), requestMap(), mapMutex(), priorError(NULL) {}
+        CorrelatorData() : nextCommandId(1), slots(), disposed(0), requestMap(), mapMutex(), priorError(NULL) {}
+
+        ResponseSlot* claimSlot(int commandId) {
+
+            if (commandId <= 0) {
+                return NULL;
+            }
+
+            ResponseSlot* slot = &this->slots[commandId & RESPONSE_SLOT_MASK];
+            if (!Atomics::compareAndSet32(&slot->owner, 0, commandId, Atomics::ACQUIRE)) {
+                return NULL;
+            }
+
+            // Published before the disposed check so that one of dispose or the
+            // waiter always sees the other, see completeSlot.
+            Atomics::store(&slot->waiter, (void*) Thread::currentThread());
+            return slot;
+        }
+
+        bool completeSlot(int commandId, const Pointer<Response>& response) {
+
+            if (commandId <= 0) {
+                return false;
+            }
+
+            ResponseSlot* slot = &this->slots[commandId & RESPONSE_SLOT_MASK];
+            if (!Atomics::compareAndSet32(&slot->owner, commandId, -commandId, Atomics::ACQUIRE)) {
+                return false;
+            }
+
+            slot->response = response;
+            Atomics::store(&slot->state, SLOT_COMPLETING);
+
+            // The waiter keeps the slot until the state is complete, so its thread
+            // is still around to be unparked.
+            Thread* waiter = (Thread*) Atomics::load(&slot->waiter);
+            if (waiter != NULL) {
+                LockSupport::unpark(waiter);
+            }
+
+            Atomics::store(&slot->state, SLOT_COMPLETE, Atomics::RELEASE);
+            return true;
+        }
+
+        void releaseSlot(ResponseSlot* slot) {
+            slot->response.reset(NULL);
+            Atomics::store(&slot->state, SLOT_PENDING, Atomics::RELAXED);
+            Atomics::store(&slot->waiter, NULL, Atomics::RELAXED);
+            Atomics::store(&slot->owner, 0, Atomics::RELEASE);
+        }
+
+        // Gives up on a request that has not been completed, returns false when a
+        // completer has already claimed it and the response must be collected with
+        // finishSlot instead.
+        bool abandonSlot(ResponseSlot* slot, int commandId) {
+            Atomics::store(&slot->waiter, NULL);
+            return Atomics::compareAndSet32(&slot->owner, commandId, 0, Atomics::RELEASE);
+        }
+
+        // Collects the response from a slot a completer has claimed, the completer is
+        // already running so this only spins for the few instructions it has left.
+        Pointer<Response> finishSlot(ResponseSlot* slot) {
+            while (Atomics::load(&slot->state, Atomics::ACQUIRE) != SLOT_COMPLETE) {
+                Thread::yield();
+            }
+
+            Pointer<Response> response = slot->response;
+            releaseSlot(slot);
+            return response;
+        }
+
+        // Waits for the slot to be completed, a timeout of -1 waits forever.  Returns
+        // NULL if the wait timed out and the slot was handed back without a response.
+        Pointer<Response> awaitSlot(ResponseSlot* slot, int commandId, long long timeout) {
+
+            long long deadline = timeout < 0 ? 0 : System::currentTimeMillis() + timeout;
+
+            while (Atomics::load(&slot->state, Atomics::ACQUIRE) == SLOT_PENDING) {
+
+                if (Thread::currentThread()->isInterrupted()) {
+                    if (!abandonSlot(slot, commandId)) {
+                        break;
+                    }
+
+                    // Same contract as FutureResponse, only the untimed wait keeps
+                    // the interrupted status.
+                    if (timeout >= 0) {
+                        Thread::interrupted();
+                    }
+                    throw decaf::io::InterruptedIOException(
+                        __FILE__, __LINE__, "Interrupted while awaiting a response");
+                }
+
+                if (timeout < 0) {
+                    LockSupport::park();
+                } else {
+                    long long remaining = deadline - System::currentTimeMillis();
+                    if (remaining <= 0) {
+                        if (!abandonSlot(slot, commandId)) {
+                            break;
+                        }
+                        return Pointer<Response>();
+                    }
+
+                    LockSupport::parkNanos(remaining * 1000000LL);
+                }
+            }
+
+            return finishSlot(slot);
+        }
+
+        Pointer<Response> request(Transport* next, const Pointer<Command>& command, long long timeout) {
+
+            ResponseSlot* slot = claimSlot(command->getCommandId());
+            if (slot == NULL) {
+                return requestWithFuture(next, command, timeout);
+            }
+
+            if (Atomics::load(&this->disposed) != 0) {
+                if (abandonSlot(slot, command->getCommandId())) {
+                    throwPriorError();
+                }
+
+                // Already failed by dispose, hand back the error response.
+                return finishSlot(slot);
+            }
+
+            try {
+                next->oneway(command);
+            } catch (...) {
+                if (!abandonSlot(slot, command->getCommandId())) {
+                    finishSlot(slot);
+                }
+                throw;
+            }
+
+            return awaitSlot(slot, command->getCommandId(), timeout);
+        }
+
+        Pointer<Response> requestWithFuture(Transport* next, const Pointer<Command>& command, long long timeout) {
+
+            // Add a future response object to the map indexed by this command id.
+            Pointer<FutureResponse> futureResponse(new FutureResponse());
+            Pointer<Exception> error;
+
+            synchronized(&this->mapMutex) {
+                error = this->priorError;
+                if (error == NULL) {
+                    this->requestMap.put((unsigned int) command->getCommandId(), futureResponse);
+                }
+            }
+
+            if (error != NULL) {
+                throw IOException(__FILE__, __LINE__, error->getMessage().c_str());
+            }
+
+            // The finalizer will cleanup the map even if an exception is thrown.
+            ResponseFinalizer finalizer(&this->mapMutex, command->getCommandId(), &this->requestMap);
+
+            // Send the request.
+            next->oneway(command);
+
+            // Get the response.
+            if (timeout < 0) {
+                return futureResponse->getResponse();
+            }
+
+            return futureResponse->getResponse((unsigned int) timeout);
+        }
+
+        void throwPriorError() {
+            Pointer<Exception> error;
+            synchronized(&this->mapMutex) {
+                error = this->priorError;
+            }
+
+            throw IOException(__FILE__, __LINE__, error != NULL ? error->getMessage().c_str() : "Transport Stopped");
+        }
 
     };
 
@@ -193,32 +429,7 @@ Pointer<Response> ResponseCorrelator::request(const Pointer<Command> command) {
         command->setCommandId(this->impl->nextCommandId.getAndIncrement());
         command->setResponseRequired(true);
 
-        // Add a future response object to the map indexed by this command id.
-        Pointer<FutureResponse> futureResponse(new FutureResponse());
-        Pointer<Exception> priorError;
-
-        synchronized(&this->impl->mapMutex) {
-            priorError = this->impl->priorError;
-            if (priorError == NULL) {
-                this->impl->requestMap.put((unsigned int) command->getCommandId(), futureResponse);
-            }
-        }
-
-        if (priorError != NULL) {
-            throw IOException(__FILE__, __LINE__, this->impl->priorError->getMessage().c_str());
-        }
-
-        // The finalizer will cleanup the map even if an exception is thrown.
-        ResponseFinalizer finalizer(&this->impl->mapMutex, command->getCommandId(), &this->impl->requestMap);
-
-        // Wait to be notified of the response via the futureResponse object.
-        Pointer<commands::Response> response;
-
-        // Send the request.
-        next->oneway(command);
-
-        // Get the response.
-        response = futureResponse->getResponse();
+        Pointer<commands::Response> response = this->impl->request(next.get(), command, -1);
 
         if (response == NULL) {
             throw IOException(__FILE__, __LINE__,
@@ -244,32 +455,7 @@ Pointer<Response> ResponseCorrelator::request(const Pointer<Command> command, un
         command->setCommandId(this->impl->nextCommandId.getAndIncrement());
         command->setResponseRequired(true);
 
-        // Add a future response object to the map indexed by this command id.
-        Pointer<FutureResponse> futureResponse(new FutureResponse());
-        Pointer<Exception> priorError;
-
-        synchronized(&this->impl->mapMutex) {
-            priorError = this->impl->priorError;
-            if (priorError == NULL) {
-                this->impl->requestMap.put((unsigned int) command->getCommandId(), futureResponse);
-            }
-        }
-
-        if (priorError != NULL) {
-            throw IOException(__FILE__, __LINE__, this->impl->priorError->getMessage().c_str());
-        }
-
-        // The finalizer will cleanup the map even if an exception is thrown.
-        ResponseFinalizer finalizer(&this->impl->mapMutex, command->getCommandId(), &this->impl->requestMap);
-
-        // Wait to be notified of the response via the futureResponse object.
-        Pointer<commands::Response> response;
-
-        // Send the request.
-        next->oneway(command);
-
-        // Get the response.
-        response = futureResponse->getResponse(timeout);
+        Pointer<commands::Response> response = this->impl->request(next.get(), command, (long long) timeout);
 
         if (response == NULL) {
             throw IOException(__FILE__, __LINE__,
@@ -297,7 +483,12 @@ void ResponseCorrelator::onCommand(const Pointer<Command> command) {
 
     Pointer<Response> response = command.dynamicCast<Response>();
 
-    // It is a response - let's correlate ...
+    // It is a response - let's correlate, synchronous requests are normally waiting
+    // in their slot and only the rest need the map.
+    if (this->impl->completeSlot(response->getCorrelationId(), response)) {
+        return;
+    }
+
     synchronized(&this->impl->mapMutex) {
 
         Pointer<FutureResponse> futureResponse;
@@ -332,16 +523,19 @@ void ResponseCorrelator::onException(const decaf::lang::Exception& ex) {
 void ResponseCorrelator::dispose(Pointer<Exception> error) {
 
     ArrayList<Pointer<FutureResponse> > requests;
+    bool disposing = false;
     synchronized(&this->impl->mapMutex) {
         if (this->impl->priorError == NULL) {
             this->impl->priorError = error;
+            Atomics::store(&this->impl->disposed, 1);
             requests.ensureCapacity((int)this->impl->requestMap.size());
             requests.copy(this->impl->requestMap.values());
             this->impl->requestMap.clear();
+            disposing = true;
         }
     }
 
-    if (!requests.isEmpty()) {
+    if (disposing) {
         Pointer<commands::BrokerError> exception(new commands::BrokerError);
         exception->setExceptionClass("java.io.IOException");
         exception->setMessage(error->getMessage());
@@ -354,5 +548,12 @@ void ResponseCorrelator::dispose(Pointer<Exception> error) {
             Pointer<FutureResponse> response = iter->next();
             response->setResponse(errorResponse);
         }
+
+        for (int i = 0; i < NUM_RESPONSE_SLOTS; ++i) {
+            int owner = Atomics::load(&this->impl->slots[i].owner);
+            if (owner > 0) {
+                this->impl->completeSlot(owner, errorResponse);
+            }
+        }
     }
 }
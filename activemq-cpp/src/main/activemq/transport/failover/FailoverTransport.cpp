@@ -103,6 +103,12 @@ namespace failover {
         mutable Mutex sleepMutex;
         mutable Mutex listenerMutex;
 
+        // Guards the connectedTransport and the state tracker.  Senders hold it only
+        // while taking a snapshot of the transport and tracking the command, the write
+        // itself happens without any lock held.  When both locks are needed the
+        // reconnectMutex must be taken first.
+        mutable Mutex trackerMutex;
+
         StlMap<int, Pointer<Command> > requestMap;
 
         Pointer<URIPool> uris;
@@ -150,6 +156,7 @@ namespace failover {
             reconnectMutex(),
             sleepMutex(),
             listenerMutex(),
+            trackerMutex(),
             requestMap(),
             uris(new URIPool()),
             priorityUris(new URIPool()),
@@ -254,9 +261,19 @@ namespace failover {
             return connectedTransport != NULL && !doRebalance && !backups->isPriorityBackupAvailable();
         }
 
+        Pointer<Transport> getConnectedTransport() const {
+            synchronized(&trackerMutex) {
+                return connectedTransport;
+            }
+
+            return Pointer<Transport>();
+        }
+
         void disconnect() {
             Pointer<Transport> transport;
-            transport.swap(this->connectedTransport);
+            synchronized(&trackerMutex) {
+                transport.swap(this->connectedTransport);
+            }
 
             if (transport != NULL) {
 
@@ -401,134 +418,101 @@ void FailoverTransport::oneway(const Pointer<Command> command) {
 
     try {
 
-        synchronized(&this->impl->reconnectMutex) {
-
-            if (command != NULL && this->impl->connectedTransport == NULL) {
-
-                if (command->isShutdownInfo()) {
-                    // Skipping send of ShutdownInfo command when not connected.
-                    return;
-                }
-
-                if (command->isRemoveInfo() || command->isMessageAck()) {
-                    // Simulate response to RemoveInfo command or Ack as they will be stale.
-                    stateTracker.track(command);
-
-                    if (command->isResponseRequired()) {
-                        Pointer<Response> response(new Response());
-                        response->setCorrelationId(command->getCommandId());
-                        this->impl->myTransportListener->onCommand(response);
-                    }
+        // Keep trying until the message is sent.
+        for (int i = 0; !this->impl->closed; i++) {
 
-                    return;
-                } else if (command->isMessagePull()) {
-                    // Simulate response to MessagePull if timed as we can't honor that now.
-                    Pointer<MessagePull> pullRequest = command.dynamicCast<MessagePull>();
-                    if (pullRequest->getTimeout() != 0) {
-                        Pointer<MessageDispatch> dispatch(new MessageDispatch());
-                        dispatch->setConsumerId(pullRequest->getConsumerId());
-                        dispatch->setDestination(pullRequest->getDestination());
-                        this->impl->myTransportListener->onCommand(dispatch);
-                    }
-
-                    return;
-                }
-            }
-
-            // Keep trying until the message is sent.
-            for (int i = 0; !this->impl->closed; i++) {
-                try {
-
-                    // Wait for transport to be connected.
-                    Pointer<Transport> transport = this->impl->connectedTransport;
-                    long long start = System::currentTimeMillis();
-                    bool timedout = false;
+            Pointer<Transport> transport;
 
-                    while (transport == NULL && !this->impl->closed &&
-                           this->impl->connectionFailure == NULL && this->impl->willReconnect()) {
+            try {
 
-                        long long end = System::currentTimeMillis();
-                        if (command->isMessage() && this->impl->timeout > 0 && (end - start > this->impl->timeout)) {
-                            timedout = true;
-                            break;
+                // If it was a request and it was not being tracked by the state
+                // tracker, then hold it in the requestMap so that we can replay
+                // it later.  The snapshot of the connected transport is taken with
+                // the command tracked so a reconnect either restores the command or
+                // happens before the snapshot is taken.
+                Pointer<Tracked> tracked;
+                synchronized(&this->impl->trackerMutex) {
+                    transport = this->impl->connectedTransport;
+                    if (transport != NULL) {
+                        try {
+                            tracked = stateTracker.track(command);
+                            synchronized(&this->impl->requestMap) {
+                                if (tracked != NULL && tracked->isWaitingForResponse()) {
+                                    this->impl->requestMap.put(command->getCommandId(), tracked);
+                                } else if (tracked == NULL && command->isResponseRequired()) {
+                                    this->impl->requestMap.put(command->getCommandId(), command);
+                                }
+                            }
+                        } catch (Exception& ex) {
+                            ex.setMark(__FILE__, __LINE__);
+                            error.reset(ex.clone());
                         }
-
-                        this->impl->reconnectMutex.wait(100);
-                        transport = this->impl->connectedTransport;
                     }
+                }
 
-                    if (transport == NULL) {
-                        // Previous loop may have exited due to us being disposed.
-                        if (this->impl->closed) {
-                            error.reset(new IOException(__FILE__, __LINE__, "Transport disposed."));
-                        } else if (this->impl->connectionFailure != NULL) {
-                            error = this->impl->connectionFailure;
-                        } else if (timedout == true) {
-                            error.reset(new IOException(__FILE__, __LINE__,
-                                "Failover timeout of %d ms reached.", this->impl->timeout));
-                        } else if (!this->impl->willReconnect()) {
-                            error.reset(new IOException(__FILE__, __LINE__,
-                                "Maximum reconnection attempts exceeded"));
-                        } else {
-                            error.reset(new IOException(__FILE__, __LINE__, "Unexpected failure."));
-                        }
-
-                        break;
-                    }
+                if (error != NULL) {
+                    break;
+                }
 
-                    // If it was a request and it was not being tracked by the state
-                    // tracker, then hold it in the requestMap so that we can replay
-                    // it later.
-                    Pointer<Tracked> tracked;
-                    try {
-                        tracked = stateTracker.track(command);
-                        synchronized(&this->impl->requestMap) {
-                            if (tracked != NULL && tracked->isWaitingForResponse()) {
-                                this->impl->requestMap.put(command->getCommandId(), tracked);
-                            } else if (tracked == NULL && command->isResponseRequired()) {
-                                this->impl->requestMap.put(command->getCommandId(), command);
-                            }
-                        }
-                    } catch (Exception& ex) {
-                        ex.setMark(__FILE__, __LINE__);
-                        error.reset(ex.clone());
+                if (transport == NULL) {
+                    // Only senders that find no connected transport park on the reconnect
+                    // monitor, once connected the send is retried.
+                    if (!waitForTransport(command, error)) {
                         break;
                     }
+                    continue;
+                }
 
-                    // Send the message.
-                    try {
-                        transport->oneway(command);
+                // Send the message.
+                try {
+                    transport->oneway(command);
+                    synchronized(&this->impl->trackerMutex) {
                         stateTracker.trackBack(command);
-                        if (command->isShutdownInfo()) {
-                            this->impl->shutdown = true;
-                        }
-                    } catch (IOException& e) {
-
-                        e.setMark(__FILE__, __LINE__);
+                    }
+                    if (command->isShutdownInfo()) {
+                        this->impl->shutdown = true;
+                    }
+                } catch (IOException& e) {
 
-                        // If the command was not tracked.. we will retry in this method
-                        if (tracked == NULL && this->impl->canReconnect()) {
+                    e.setMark(__FILE__, __LINE__);
 
-                            // since we will retry in this method.. take it out of the
-                            // request map so that it is not sent 2 times on recovery
-                            if (command->isResponseRequired()) {
-                                this->impl->requestMap.remove(command->getCommandId());
+                    // If the command was not tracked.. we will retry in this method
+                    if (tracked == NULL && this->impl->canReconnect()) {
+
+                        // Once a reconnect has replaced the transport that failed its
+                        // restore sends the command from the request map, decided under
+                        // the tracker lock so the restore can't be part way through.
+                        bool restored = false;
+
+                        if (command->isResponseRequired()) {
+                            synchronized(&this->impl->trackerMutex) {
+                                restored = transport != this->impl->connectedTransport;
+
+                                // since we will retry in this method.. take it out of the
+                                // request map so that it is not sent 2 times on recovery
+                                if (!restored) {
+                                    synchronized(&this->impl->requestMap) {
+                                        this->impl->requestMap.remove(command->getCommandId());
+                                    }
+                                }
                             }
+                        }
 
-                            // re-throw the exception so it will handled by the outer catch
+                        // re-throw the exception so it will handled by the outer catch
+                        if (!restored) {
                             throw;
-                        } else {
-                            // Trigger the reconnect since we can't count on inactivity or
-                            // other socket events to trip the failover condition.
-                            handleTransportFailure(e);
                         }
+                    } else {
+                        // Trigger the reconnect since we can't count on inactivity or
+                        // other socket events to trip the failover condition.
+                        handleTransportFailure(transport, e);
                     }
-
-                    return;
-                } catch (IOException& e) {
-                    e.setMark(__FILE__, __LINE__);
-                    handleTransportFailure(e);
                 }
+
+                return;
+            } catch (IOException& e) {
+                e.setMark(__FILE__, __LINE__);
+                handleTransportFailure(transport, e);
             }
         }
     } catch (InterruptedException& ex) {
@@ -544,6 +528,84 @@ void FailoverTransport::oneway(const Pointer<Command> command) {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool FailoverTransport::waitForTransport(const Pointer<Command> command, Pointer<Exception>& error) {
+
+    synchronized(&this->impl->reconnectMutex) {
+
+        if (command != NULL && this->impl->connectedTransport == NULL) {
+
+            if (command->isShutdownInfo()) {
+                // Skipping send of ShutdownInfo command when not connected.
+                return false;
+            }
+
+            if (command->isRemoveInfo() || command->isMessageAck()) {
+                // Simulate response to RemoveInfo command or Ack as they will be stale.
+                synchronized(&this->impl->trackerMutex) {
+                    stateTracker.track(command);
+                }
+
+                if (command->isResponseRequired()) {
+                    Pointer<Response> response(new Response());
+                    response->setCorrelationId(command->getCommandId());
+                    this->impl->myTransportListener->onCommand(response);
+                }
+
+                return false;
+            } else if (command->isMessagePull()) {
+                // Simulate response to MessagePull if timed as we can't honor that now.
+                Pointer<MessagePull> pullRequest = command.dynamicCast<MessagePull>();
+                if (pullRequest->getTimeout() != 0) {
+                    Pointer<MessageDispatch> dispatch(new MessageDispatch());
+                    dispatch->setConsumerId(pullRequest->getConsumerId());
+                    dispatch->setDestination(pullRequest->getDestination());
+                    this->impl->myTransportListener->onCommand(dispatch);
+                }
+
+                return false;
+            }
+        }
+
+        // Wait for transport to be connected.
+        long long start = System::currentTimeMillis();
+        bool timedout = false;
+
+        while (this->impl->connectedTransport == NULL && !this->impl->closed &&
+               this->impl->connectionFailure == NULL && this->impl->willReconnect()) {
+
+            long long end = System::currentTimeMillis();
+            if (command->isMessage() && this->impl->timeout > 0 && (end - start > this->impl->timeout)) {
+                timedout = true;
+                break;
+            }
+
+            this->impl->reconnectMutex.wait(100);
+        }
+
+        if (this->impl->connectedTransport != NULL) {
+            return true;
+        }
+
+        // Previous loop may have exited due to us being disposed.
+        if (this->impl->closed) {
+            error.reset(new IOException(__FILE__, __LINE__, "Transport disposed."));
+        } else if (this->impl->connectionFailure != NULL) {
+            error = this->impl->connectionFailure;
+        } else if (timedout == true) {
+            error.reset(new IOException(__FILE__, __LINE__,
+                "Failover timeout of %d ms reached.", this->impl->timeout));
+        } else if (!this->impl->willReconnect()) {
+            error.reset(new IOException(__FILE__, __LINE__,
+                "Maximum reconnection attempts exceeded"));
+        } else {
+            error.reset(new IOException(__FILE__, __LINE__, "Unexpected failure."));
+        }
+    }
+
+    return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<FutureResponse> FailoverTransport::asyncRequest(const Pointer<Command> command AMQCPP_UNUSED,
                                                         const Pointer<ResponseCallback> responseCallback AMQCPP_UNUSED) {
@@ -584,7 +646,9 @@ void FailoverTransport::start() {
             stateTracker.setTrackTransactionProducers(this->isTrackTransactionProducers());
 
             if (this->impl->connectedTransport != NULL) {
-                stateTracker.restore(this->impl->connectedTransport);
+                synchronized(&this->impl->trackerMutex) {
+                    stateTracker.restore(this->impl->connectedTransport);
+                }
             } else {
                 reconnect(false);
             }
@@ -629,7 +693,7 @@ void FailoverTransport::close() {
             this->impl->backups->setEnabled(false);
             this->impl->requestMap.clear();
 
-            if (this->impl->connectedTransport != NULL) {
+            synchronized(&this->impl->trackerMutex) {
                 transportToStop.swap(this->impl->connectedTransport);
             }
 
@@ -719,7 +783,14 @@ void FailoverTransport::handleTransportFailure(const decaf::lang::Exception& err
         }
 
         Pointer<Transport> transport;
-        this->impl->connectedTransport.swap(transport);
+        synchronized(&this->impl->trackerMutex) {
+            this->impl->connectedTransport.swap(transport);
+
+            if (transport != NULL) {
+                // Place the State Tracker into a reconnection state.
+                this->stateTracker.transportInterrupted();
+            }
+        }
 
         if (transport != NULL) {
 
@@ -739,9 +810,6 @@ void FailoverTransport::handleTransportFailure(const decaf::lang::Exception& err
             this->impl->connected = false;
             this->impl->connectedToPrioirty = false;
 
-            // Place the State Tracker into a reconnection state.
-            this->stateTracker.transportInterrupted();
-
             // Notify before we attempt to reconnect so that the consumers have a chance
             // to cleanup their state.
             if (reconnectOk) {
@@ -759,6 +827,22 @@ void FailoverTransport::handleTransportFailure(const decaf::lang::Exception& err
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::handleTransportFailure(const Pointer<Transport> transport, const decaf::lang::Exception& error) {
+
+    if (this->impl->shutdown) {
+        return;
+    }
+
+    synchronized(&this->impl->reconnectMutex) {
+        // A sender's snapshot can be stale, if a reconnect has already replaced the
+        // transport that failed there is nothing left to do.
+        if (transport != NULL && transport == this->impl->connectedTransport) {
+            handleTransportFailure(error);
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void FailoverTransport::handleConnectionControl(const Pointer<Command> control) {
 
@@ -955,13 +1039,18 @@ bool FailoverTransport::iterate() {
                         transport->setTransportListener(this->impl->myTransportListener.get());
                         transport->start();
 
-                        if (this->impl->started && !this->impl->firstConnection) {
-                            restoreTransport(transport);
+                        // Senders can't track new state between the restore and the new
+                        // transport being published, so nothing is missed by the restore.
+                        synchronized(&this->impl->trackerMutex) {
+                            if (this->impl->started && !this->impl->firstConnection) {
+                                restoreTransport(transport);
+                            }
+
+                            this->impl->connectedTransport = transport;
                         }
 
                         this->impl->reconnectDelay = this->impl->initialReconnectDelay;
                         this->impl->connectedTransportURI.reset(new URI(uri));
-                        this->impl->connectedTransport = transport;
                         this->impl->reconnectMutex.notifyAll();
                         this->impl->connectFailures = 0;
                         this->impl->connected = true;
@@ -1078,7 +1167,9 @@ Pointer<Transport> FailoverTransport::createTransport(const URI& location) const
 void FailoverTransport::setConnectionInterruptProcessingComplete(const Pointer<commands::ConnectionId> connectionId) {
 
     synchronized(&this->impl->reconnectMutex) {
-        stateTracker.connectionInterruptProcessingComplete(this, connectionId);
+        synchronized(&this->impl->trackerMutex) {
+            stateTracker.connectionInterruptProcessingComplete(this, connectionId);
+        }
     }
 }
 
@@ -1109,8 +1200,9 @@ Transport* FailoverTransport::narrow(const std::type_info& typeId) {
         return this;
     }
 
-    if (this->impl->connectedTransport != NULL) {
-        return this->impl->connectedTransport->narrow(typeId);
+    Pointer<Transport> transport = this->impl->getConnectedTransport();
+    if (transport != NULL) {
+        return transport->narrow(typeId);
     }
 
     return NULL;
@@ -1142,7 +1234,7 @@ void FailoverTransport::processResponse(const Pointer<Response> response) {
 Pointer<wireformat::WireFormat> FailoverTransport::getWireFormat() const {
 
     Pointer<wireformat::WireFormat> result;
-    Pointer<Transport> transport = this->impl->connectedTransport;
+    Pointer<Transport> transport = this->impl->getConnectedTransport();
 
     if (transport != NULL) {
         result = transport->getWireFormat();
@@ -260,6 +260,16 @@ namespace failover {
          */
         void handleTransportFailure(const decaf::lang::Exception& error);
 
+        /**
+         * Called when a send on the given Transport fails, the failure is only handled
+         * if that Transport is still the connected one.
+         *
+         * @param transport - The Transport the send was attempted on.
+         * @param error - The CMS Exception that was thrown.
+         * @throw Exception if an error occurs.
+         */
+        void handleTransportFailure(const Pointer<Transport> transport, const decaf::lang::Exception& error);
+
         /**
          * Called when the Broker sends a ConnectionControl command which could
          * signal that this Client needs to reconnect in order to rebalance the
@@ -286,6 +296,10 @@ namespace failover {
 
         void processResponse(const Pointer<Response> response);
 
+        // Parks the sending thread until a transport is connected, returns false if
+        // the command should not be sent, in which case error is set on a failure.
+        bool waitForTransport(const Pointer<Command> command, Pointer<decaf::lang::Exception>& error);
+
     };
 
 }}}
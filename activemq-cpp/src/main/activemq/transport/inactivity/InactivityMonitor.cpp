@@ -22,10 +22,10 @@
 
 #include <activemq/threads/CompositeTask.h>
 #include <activemq/threads/CompositeTaskRunner.h>
+#include <activemq/threads/TimerWheel.h>
 #include <activemq/commands/WireFormatInfo.h>
 #include <activemq/commands/KeepAliveInfo.h>
 
-#include <decaf/util/Timer.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 #include <decaf/util/concurrent/atomic/AtomicInteger.h>
 #include <decaf/lang/Math.h>
@@ -72,8 +72,8 @@ namespace inactivity {
         Pointer<ReadChecker> readCheckerTask;
         Pointer<WriteChecker> writeCheckerTask;
 
-        Timer readCheckTimer;
-        Timer writeCheckTimer;
+        Pointer<TimerWheelTimeout> readCheckTimeout;
+        Pointer<TimerWheelTimeout> writeCheckTimeout;
 
         Pointer<CompositeTaskRunner> asyncTasks;
 
@@ -104,8 +104,8 @@ namespace inactivity {
             remoteWireFormatInfo(),
             readCheckerTask(),
             writeCheckerTask(),
-            readCheckTimer("InactivityMonitor Read Check Timer"),
-            writeCheckTimer("InactivityMonitor Write Check Timer"),
+            readCheckTimeout(),
+            writeCheckTimeout(),
             asyncTasks(),
             asyncReadTask(),
             asyncWriteTask(),
@@ -457,8 +457,13 @@ void InactivityMonitor::startMonitorThreads() {
             this->members->readCheckerTask.reset(new ReadChecker(this));
             this->members->writeCheckTime = this->members->readCheckTime > 3 ? this->members->readCheckTime / 3 : this->members->readCheckTime;
 
-            this->members->writeCheckTimer.scheduleAtFixedRate(this->members->writeCheckerTask, this->members->initialDelayTime, this->members->writeCheckTime);
-            this->members->readCheckTimer.scheduleAtFixedRate(this->members->readCheckerTask, this->members->initialDelayTime, this->members->readCheckTime);
+            // The checks only signal the async tasks so they can share the library's TimerWheel
+            // instead of each monitor running two Timer threads.
+            TimerWheel& timerWheel = TimerWheel::getInstance();
+            this->members->writeCheckTimeout = timerWheel.scheduleAtFixedRate(
+                this->members->writeCheckerTask.get(), this->members->initialDelayTime, this->members->writeCheckTime, false);
+            this->members->readCheckTimeout = timerWheel.scheduleAtFixedRate(
+                this->members->readCheckerTask.get(), this->members->initialDelayTime, this->members->readCheckTime, false);
         }
     }
 }
@@ -470,13 +475,9 @@ void InactivityMonitor::stopMonitorThreads() {
 
         synchronized(&this->members->monitor) {
 
-            this->members->readCheckerTask->cancel();
-            this->members->writeCheckerTask->cancel();
-
-            this->members->readCheckTimer.purge();
-            this->members->readCheckTimer.cancel();
-            this->members->writeCheckTimer.purge();
-            this->members->writeCheckTimer.cancel();
+            // Waits for a check that is running right now so none run after this.
+            this->members->readCheckTimeout->cancel();
+            this->members->writeCheckTimeout->cancel();
 
             this->members->asyncTasks->shutdown();
         }
@@ -20,12 +20,17 @@
 #include <activemq/transport/IOTransport.h>
 #include <activemq/transport/TransportFactory.h>
 
+#include <decaf/internal/net/tcp/EpollSelector.h>
+#include <decaf/internal/net/tcp/EpollSocket.h>
+#include <decaf/internal/net/tcp/EpollSocketImplFactory.h>
+#include <decaf/io/EOFException.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
 #include <decaf/net/SocketFactory.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 
 #include <memory>
+#include <vector>
 
 using namespace std;
 using namespace activemq;
@@ -35,6 +40,7 @@ using namespace activemq::transport::tcp;
 using namespace activemq::exceptions;
 using namespace decaf;
 using namespace decaf::net;
+using namespace decaf::internal::net::tcp;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
 using namespace decaf::util::concurrent::atomic;
@@ -46,6 +52,120 @@ namespace activemq {
 namespace transport {
 namespace tcp {
 
+    /**
+     * Reads only the data the socket already has, so that the reads done on a
+     * selector thread can still be wrapped for tcp tracing.
+     */
+    class AvailableInputStream : public InputStream {
+    private:
+
+        EpollSocket* socket;
+
+    private:
+
+        AvailableInputStream(const AvailableInputStream&);
+        AvailableInputStream& operator= (const AvailableInputStream&);
+
+    public:
+
+        AvailableInputStream(EpollSocket* socket) : InputStream(), socket(socket) {
+        }
+
+        virtual ~AvailableInputStream() {
+        }
+
+    protected:
+
+        virtual int doReadByte() {
+
+            unsigned char c = 0;
+            int result = this->socket->readAvailable(&c, 1, 0, 1);
+            if (result == 0) {
+                throw IOException(__FILE__, __LINE__, "AvailableInputStream - no data is available");
+            }
+
+            return result == -1 ? result : c;
+        }
+
+        virtual int doReadArrayBounded(unsigned char* buffer, int size, int offset, int length) {
+            return this->socket->readAvailable(buffer, size, offset, length);
+        }
+    };
+
+    /**
+     * Reads the socket on a thread of the EpollSelector and pushes the data to the
+     * IOTransport, taking the place of the IOTransport's own reader thread.
+     */
+    class TcpReactorReader : public SelectionListener {
+    private:
+
+        // Bounds the reads done for one event so a busy connection can't starve the
+        // other connections of its selector thread, the selector calls again while
+        // the socket still has data.
+        static const int MAX_READS_PER_EVENT = 16;
+
+        EpollSelector* selector;
+        IOTransport* transport;
+        std::auto_ptr<InputStream> input;
+        std::vector<unsigned char> buffer;
+
+    private:
+
+        TcpReactorReader(const TcpReactorReader&);
+        TcpReactorReader& operator= (const TcpReactorReader&);
+
+    public:
+
+        TcpReactorReader(EpollSelector* selector, IOTransport* transport, EpollSocket* socket, int bufferSize, bool trace) :
+            SelectionListener(), selector(selector), transport(transport), input(new AvailableInputStream(socket)),
+            buffer(bufferSize > 0 ? bufferSize : 8192) {
+
+            if (trace) {
+                this->input.reset(new LoggingInputStream(this->input.release(), true));
+            }
+        }
+
+        virtual ~TcpReactorReader() {
+        }
+
+        EpollSelector* getSelector() const {
+            return this->selector;
+        }
+
+        virtual void onReadable() {
+
+            try {
+
+                int size = (int) this->buffer.size();
+
+                for (int i = 0; i < MAX_READS_PER_EVENT; ++i) {
+
+                    int count = this->input->read(&this->buffer[0], size, 0, size);
+
+                    if (count == -1) {
+                        throw EOFException(__FILE__, __LINE__, "TcpTransport - the connection was closed by the remote peer");
+                    }
+
+                    if (count == 0) {
+                        return;
+                    }
+
+                    this->transport->receive(&this->buffer[0], size, 0, count);
+
+                    if (count < size) {
+                        return;
+                    }
+                }
+            } catch (Exception& ex) {
+
+                // Nothing more can be read, stop the selector from reporting the
+                // failed socket over and over.
+                this->selector->remove(this);
+                this->transport->receiveFailed(ex);
+            }
+        }
+    };
+
     class TcpTransportImpl {
     private:
 
@@ -73,6 +193,16 @@ namespace tcp {
         int soSendBufferSize;
         bool tcpNoDelay;
 
+        bool writeCoalescing;
+        int writeCoalescingMaxBytes;
+        int writeCoalescingMaxDelay;
+
+        bool ioReactor;
+
+        // Only set when the reactor reads the socket, the socket owns the EpollSocket.
+        EpollSocket* epollSocket;
+        std::auto_ptr<TcpReactorReader> reactorReader;
+
         TcpTransportImpl(const decaf::net::URI& location) :
             connectTimeout(0),
             socket(),
@@ -86,7 +216,21 @@ namespace tcp {
             soKeepAlive(false),
             soReceiveBufferSize(-1),
             soSendBufferSize(-1),
-            tcpNoDelay(true) {
+            tcpNoDelay(true),
+            writeCoalescing(false),
+            writeCoalescingMaxBytes(65536),
+            writeCoalescingMaxDelay(0),
+            ioReactor(false),
+            epollSocket(NULL),
+            reactorReader() {
+        }
+
+        // Stops the selector from reading the socket, waiting for a read that is in
+        // progress unless called from within that read.
+        void stopReading() {
+            if (this->reactorReader.get() != NULL) {
+                this->reactorReader->getSelector()->remove(this->reactorReader.get());
+            }
         }
     };
 }}}
@@ -119,6 +263,37 @@ void TcpTransport::beforeNextIsStarted() {
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::afterNextIsStarted() {
+    try {
+
+        if (!impl->ioReactor) {
+            return;
+        }
+
+        // The IOTransport is started without its reader thread so from here on
+        // the selector delivers the incoming data.
+        IOTransport* ioTransport = dynamic_cast<IOTransport*>(next.get());
+
+        impl->reactorReader.reset(new TcpReactorReader(EpollSelector::getDefault(), ioTransport,
+            impl->epollSocket, impl->inputBufferSize, impl->trace));
+        impl->reactorReader->getSelector()->add(impl->epollSocket, impl->reactorReader.get());
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::beforeNextIsStopped() {
+    try {
+        impl->stopReading();
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void TcpTransport::afterNextIsStopped() {
     try {
@@ -136,6 +311,8 @@ void TcpTransport::afterNextIsStopped() {
 ////////////////////////////////////////////////////////////////////////////////
 void TcpTransport::doClose() {
     try {
+        impl->stopReading();
+
         if (impl->socket.get() != NULL) {
             impl->socket->close();
         }
@@ -150,8 +327,15 @@ void TcpTransport::connect() {
 
     try {
 
+        impl->epollSocket = NULL;
         impl->socket.reset(this->createSocket());
 
+        // A subclass may create its own kind of socket, which the reactor can't read.
+        if (impl->ioReactor && impl->epollSocket == NULL) {
+            throw IOException(__FILE__, __LINE__,
+                "TcpTransport::connect - ioReactor is not supported with this transport's sockets");
+        }
+
         // Set all Socket Options from the URI options.
         this->configureSocket(impl->socket.get());
 
@@ -180,8 +364,12 @@ void TcpTransport::connect() {
         // Get the read buffer size.
         int inputBufferSize = this->impl->inputBufferSize;
 
-        // Get the write buffer size.
+        // Get the write buffer size, when writes are coalesced it must be able to hold
+        // a whole batch so that each batch reaches the socket in a single send.
         int outputBufferSize = this->impl->outputBufferSize;
+        if (this->impl->writeCoalescing && this->impl->writeCoalescingMaxBytes > outputBufferSize) {
+            outputBufferSize = this->impl->writeCoalescingMaxBytes;
+        }
 
         // We don't own these ever, socket object owns.
         InputStream* socketIStream = impl->socket->getInputStream();
@@ -214,6 +402,11 @@ void TcpTransport::connect() {
         // Give the IOTransport the streams.
         ioTransport->setInputStream(impl->dataInputStream.get());
         ioTransport->setOutputStream(impl->dataOutputStream.get());
+
+        ioTransport->setWriteCoalescing(this->impl->writeCoalescing);
+        ioTransport->setWriteCoalescingMaxBytes(this->impl->writeCoalescingMaxBytes);
+        ioTransport->setWriteCoalescingMaxDelay(this->impl->writeCoalescingMaxDelay);
+        ioTransport->setUseReaderThread(!this->impl->ioReactor);
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
@@ -224,6 +417,14 @@ void TcpTransport::connect() {
 Socket* TcpTransport::createSocket() {
 
     try {
+
+        if (impl->ioReactor) {
+            EpollSocketImplFactory factory;
+            std::auto_ptr<SocketImpl> socketImpl(factory.createSocketImpl());
+            impl->epollSocket = dynamic_cast<EpollSocket*>(socketImpl.get());
+            return new Socket(socketImpl.release());
+        }
+
         SocketFactory* factory = SocketFactory::getDefault();
         return factory->createSocket();
     }
@@ -363,6 +564,46 @@ bool TcpTransport::isTcpNoDelay() const {
     return this->impl->tcpNoDelay;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setWriteCoalescing(bool writeCoalescing) {
+    this->impl->writeCoalescing = writeCoalescing;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpTransport::isWriteCoalescing() const {
+    return this->impl->writeCoalescing;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setWriteCoalescingMaxBytes(int writeCoalescingMaxBytes) {
+    this->impl->writeCoalescingMaxBytes = writeCoalescingMaxBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getWriteCoalescingMaxBytes() const {
+    return this->impl->writeCoalescingMaxBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setWriteCoalescingMaxDelay(int writeCoalescingMaxDelay) {
+    this->impl->writeCoalescingMaxDelay = writeCoalescingMaxDelay;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getWriteCoalescingMaxDelay() const {
+    return this->impl->writeCoalescingMaxDelay;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setIOReactor(bool ioReactor) {
+    this->impl->ioReactor = ioReactor;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpTransport::isIOReactor() const {
+    return this->impl->ioReactor;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 decaf::net::URI TcpTransport::getLocation() const {
     return this->impl->location;
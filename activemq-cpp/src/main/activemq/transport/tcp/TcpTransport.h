@@ -97,6 +97,28 @@ namespace tcp {
         void setTcpNoDelay(bool tcpNoDelay);
         bool isTcpNoDelay() const;
 
+        void setWriteCoalescing(bool writeCoalescing);
+        bool isWriteCoalescing() const;
+
+        void setWriteCoalescingMaxBytes(int writeCoalescingMaxBytes);
+        int getWriteCoalescingMaxBytes() const;
+
+        void setWriteCoalescingMaxDelay(int writeCoalescingMaxDelay);
+        int getWriteCoalescingMaxDelay() const;
+
+        /**
+         * Sets whether the incoming data is read on the threads of the shared
+         * EpollSelector rather than on a reader thread of this connection's own, which
+         * lets a process hold many connections with a few threads.  The socket is then
+         * an EpollSocket, so this is only supported where epoll is, and a listener that
+         * blocks in onCommand holds up the other connections of its selector thread.
+         *
+         * @param ioReactor
+         *      True to read the incoming data on the shared selector threads.
+         */
+        void setIOReactor(bool ioReactor);
+        bool isIOReactor() const;
+
     public: // Transport Methods
 
         virtual bool isFaultTolerant() const {
@@ -111,6 +133,10 @@ namespace tcp {
 
         virtual void beforeNextIsStarted();
 
+        virtual void afterNextIsStarted();
+
+        virtual void beforeNextIsStopped();
+
         virtual void afterNextIsStopped();
 
         virtual void doClose();
@@ -137,6 +137,10 @@ void TcpTransportFactory::doConfigureTransport(Pointer<Transport> transport,
         tcp->setSendBufferSize(Integer::parseInt(properties.getProperty("soSendBufferSize", "-1")));
         tcp->setTcpNoDelay(Boolean::parseBoolean(properties.getProperty("tcpNoDelay", "true")));
         tcp->setConnectTimeout(Integer::parseInt(properties.getProperty("soConnectTimeout", "0")));
+        tcp->setWriteCoalescing(Boolean::parseBoolean(properties.getProperty("writeCoalescing", "false")));
+        tcp->setWriteCoalescingMaxBytes(Integer::parseInt(properties.getProperty("writeCoalescingMaxBytes", "65536")));
+        tcp->setWriteCoalescingMaxDelay(Integer::parseInt(properties.getProperty("writeCoalescingMaxDelay", "0")));
+        tcp->setIOReactor(Boolean::parseBoolean(properties.getProperty("ioReactor", "false")));
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
@@ -19,7 +19,6 @@
 #define _ACTIVEMQ_UTIL_LONGSEQUENCEGENERATOR_H_
 
 #include <activemq/util/Config.h>
-#include <decaf/util/concurrent/Mutex.h>
 
 namespace activemq {
 namespace util {
@@ -32,8 +31,7 @@ namespace util {
     class AMQCPP_API LongSequenceGenerator {
     private:
 
-        long long lastSequenceId;
-        decaf::util::concurrent::Mutex mutex;
+        volatile long long lastSequenceId;
 
     public:
 
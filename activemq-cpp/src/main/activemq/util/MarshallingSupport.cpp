@@ -21,12 +21,16 @@
 #include <activemq/exceptions/ExceptionDefines.h>
 #include <decaf/lang/Short.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/internal/util/StringUtils.h>
+
+#include <string.h>
 
 using namespace activemq;
 using namespace activemq::util;
 using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::lang;
+using namespace decaf::internal::util;
 using namespace std;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -140,12 +144,20 @@ std::string MarshallingSupport::asciiToModifiedUtf8(const std::string& asciiStri
 
         if (asciiString.length() > 0) {
 
-            int utfLength = 0;
             std::size_t length = asciiString.length();
+            const unsigned char* bytes = (const unsigned char*) asciiString.data();
+
+            // Plain ASCII is already valid modified UTF-8.
+            std::size_t plain = StringUtils::plainAsciiLength(bytes, length);
+            if (plain == length) {
+                return asciiString;
+            }
 
-            for (std::size_t i = 0; i < length; ++i) {
+            int utfLength = (int) plain;
 
-                unsigned int charValue = (unsigned char) asciiString.at(i);
+            for (std::size_t i = plain; i < length; ++i) {
+
+                unsigned int charValue = bytes[i];
 
                 // Written to allow for expansion to wide character strings at some
                 // point, as it stands now the value can never be > 255 since the
@@ -166,12 +178,13 @@ std::string MarshallingSupport::asciiToModifiedUtf8(const std::string& asciiStri
                                 + " bytes long.").c_str());
             }
 
-            std::string utfBytes((std::size_t) utfLength, '\0');
-            unsigned int utfIndex = 0;
+            std::string utfBytes(asciiString, 0, plain);
+            utfBytes.resize((std::size_t) utfLength);
+            unsigned int utfIndex = (unsigned int) plain;
 
-            for (std::size_t i = 0; i < length; i++) {
+            for (std::size_t i = plain; i < length; i++) {
 
-                unsigned int charValue = (unsigned char) asciiString.at(i);
+                unsigned int charValue = bytes[i];
 
                 // Written to allow for expansion to wide character strings at some
                 // point, as it stands now the value can never be > 255 since the
@@ -209,12 +222,20 @@ std::string MarshallingSupport::modifiedUtf8ToAscii(const std::string modifiedUt
             return "";
         }
 
-        std::vector<unsigned char> result(utfLength);
+        // Plain ASCII decodes to itself.
+        std::size_t count = StringUtils::plainAsciiLength((const unsigned char*) modifiedUtf8String.data(), utfLength);
+        if (count == utfLength) {
+            return modifiedUtf8String;
+        }
 
-        std::size_t count = 0;
-        std::size_t index = 0;
+        std::vector<unsigned char> result(utfLength);
+        std::size_t index = count;
         unsigned char a = 0;
 
+        if (count > 0) {
+            ::memcpy(&result[0], modifiedUtf8String.data(), count);
+        }
+
         while (count < utfLength) {
             if ((result[index] = modifiedUtf8String[count++]) < 0x80) {
                 index++;
@@ -17,19 +17,21 @@
 
 #include "MemoryUsage.h"
 #include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
 
 using namespace activemq;
 using namespace activemq::util;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
+using namespace decaf::internal::util::concurrent;
 using namespace std;
 
 ////////////////////////////////////////////////////////////////////////////////
-MemoryUsage::MemoryUsage() : limit(0), usage(0), mutex() {
+MemoryUsage::MemoryUsage() : limit(0), usage(0), waiters(0), mutex() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-MemoryUsage::MemoryUsage(unsigned long long limit) : limit(limit), usage(), mutex() {
+MemoryUsage::MemoryUsage(unsigned long long limit) : limit((long long) limit), usage(0), waiters(0), mutex() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,20 +41,42 @@ MemoryUsage::~MemoryUsage() {
 ////////////////////////////////////////////////////////////////////////////////
 void MemoryUsage::waitForSpace() {
 
+    if (!this->isFull()) {
+        return;
+    }
+
     synchronized(&mutex) {
-        while (this->isFull()) {
-            mutex.wait();
+        Atomics::incrementAndGet(&this->waiters);
+        try {
+            while (this->isFull()) {
+                mutex.wait();
+            }
+        } catch (...) {
+            Atomics::decrementAndGet(&this->waiters);
+            throw;
         }
+        Atomics::decrementAndGet(&this->waiters);
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void MemoryUsage::waitForSpace(unsigned int timeout) {
 
-    if (this->isFull()) {
-        synchronized(&mutex) {
-            mutex.wait(timeout);
+    if (!this->isFull()) {
+        return;
+    }
+
+    synchronized(&mutex) {
+        Atomics::incrementAndGet(&this->waiters);
+        try {
+            if (this->isFull()) {
+                mutex.wait(timeout);
+            }
+        } catch (...) {
+            Atomics::decrementAndGet(&this->waiters);
+            throw;
         }
+        Atomics::decrementAndGet(&this->waiters);
     }
 }
 
@@ -63,9 +87,7 @@ void MemoryUsage::increaseUsage(unsigned long long value) {
         return;
     }
 
-    synchronized(&mutex) {
-        this->usage += value;
-    }
+    Atomics::addAndGet(&this->usage, (long long) value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -75,19 +97,67 @@ void MemoryUsage::decreaseUsage(unsigned long long value) {
         return;
     }
 
-    synchronized(&mutex) {
-        value > this->usage ? this->usage = 0 : this->usage -= value;
-        mutex.notifyAll();
-    }
+    long long current;
+    long long update;
+    do {
+        current = Atomics::load(&this->usage);
+        update = (unsigned long long) current < value ? 0 : current - (long long) value;
+    } while (!Atomics::compareAndSet64(&this->usage, current, update));
+
+    signalWaiters();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool MemoryUsage::isFull() const {
-    bool result = false;
+    return Atomics::load(&this->usage) >= Atomics::load(&this->limit);
+}
 
-    synchronized(&mutex) {
-        result = this->usage >= this->limit;
-    }
+////////////////////////////////////////////////////////////////////////////////
+unsigned long long MemoryUsage::getAvailableSpace() const {
+    long long available = Atomics::load(&this->limit) - Atomics::load(&this->usage);
+    return available > 0 ? (unsigned long long) available : 0;
+}
 
-    return result;
+////////////////////////////////////////////////////////////////////////////////
+unsigned long long MemoryUsage::getUsage() const {
+    return (unsigned long long) Atomics::load(&this->usage);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsage::setUsage(unsigned long long usage) {
+
+    long long current;
+    do {
+        current = Atomics::load(&this->usage);
+    } while (!Atomics::compareAndSet64(&this->usage, current, (long long) usage));
+
+    signalWaiters();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned long long MemoryUsage::getLimit() const {
+    return (unsigned long long) Atomics::load(&this->limit);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsage::setLimit(unsigned long long limit) {
+
+    long long current;
+    do {
+        current = Atomics::load(&this->limit);
+    } while (!Atomics::compareAndSet64(&this->limit, current, (long long) limit));
+
+    signalWaiters();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsage::signalWaiters() {
+
+    // A waiter registers itself before its last check of the usage, so either it
+    // sees the change made by the caller or the caller sees it waiting here.
+    if (Atomics::load(&this->waiters) > 0) {
+        synchronized(&mutex) {
+            mutex.notifyAll();
+        }
+    }
 }
@@ -25,18 +25,35 @@
 namespace activemq {
 namespace util {
 
+    /**
+     * A Usage limit on memory, such as the producer window that bounds how many bytes
+     * of messages a producer can have sent but not yet acknowledged by the Broker.
+     *
+     * The usage is tracked atomically so adding to it, returning space and checking
+     * for available space never take a lock, only threads that actually block in one
+     * of the waitForSpace methods and the calls that must wake them use the mutex.
+     */
     class AMQCPP_API MemoryUsage : public Usage {
     private:
 
         // The physical limit of memory usage this object allows.
-        unsigned long long limit;
+        volatile long long limit;
 
         // Amount of memory currently used in.
-        unsigned long long usage;
+        volatile long long usage;
+
+        // Number of threads blocked waiting for space, space returned with no
+        // waiters doesn't need to take the mutex.
+        volatile int waiters;
 
         // Mutex to lock usage and wait on.
         mutable decaf::util::concurrent::Mutex mutex;
 
+    private:
+
+        MemoryUsage(const MemoryUsage&);
+        MemoryUsage& operator= (const MemoryUsage&);
+
     public:
 
         /**
@@ -91,37 +108,40 @@ namespace util {
          */
         virtual bool isFull() const;
 
+        /**
+         * Gets the amount that can still be used before this object is full.
+         * @return the limit less the current usage, or zero when full.
+         */
+        unsigned long long getAvailableSpace() const;
+
         /**
          * Gets the current usage amount.
          * @return the amount of bytes currently used.
          */
-        unsigned long long getUsage() const {
-            return usage;
-        }
+        unsigned long long getUsage() const;
 
         /**
          * Sets the current usage amount
          * @param usage - The amount to tag as used.
          */
-        void setUsage(unsigned long long usage) {
-            this->usage = usage;
-        }
+        void setUsage(unsigned long long usage);
 
         /**
          * Gets the current limit amount.
          * @return the amount that can be used before full.
          */
-        unsigned long long getLimit() const {
-            return limit;
-        }
+        unsigned long long getLimit() const;
 
         /**
          * Sets the current limit amount
          * @param limit - The amount that can be used before full.
          */
-        void setLimit(unsigned long long limit) {
-            this->limit = limit;
-        }
+        void setLimit(unsigned long long limit);
+
+    private:
+
+        // Wakes any threads waiting for space, cheap when there are none.
+        void signalWaiters();
 
     };
 
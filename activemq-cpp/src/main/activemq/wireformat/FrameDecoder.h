@@ -0,0 +1,89 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_FRAMEDECODER_H_
+#define _ACTIVEMQ_WIREFORMAT_FRAMEDECODER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/Command.h>
+
+#include <decaf/lang/Pointer.h>
+
+namespace activemq {
+namespace transport {
+    class Transport;
+}
+namespace wireformat {
+
+    using decaf::lang::Pointer;
+
+    /**
+     * Unmarshals commands from data that is pushed to it as it arrives rather than
+     * pulled from a blocking stream.  The data is handed over in pieces of any size,
+     * the decoder keeps the bytes of a command that hasn't fully arrived until the
+     * rest of it does.
+     *
+     * A FrameDecoder is created by its WireFormat and keeps a reference to it, it must
+     * not outlive the WireFormat and is meant to be used by one thread at a time.
+     *
+     * @since 3.10.0
+     */
+    class AMQCPP_API FrameDecoder {
+    public:
+
+        virtual ~FrameDecoder();
+
+        /**
+         * Adds data read from the connection to the data waiting to be decoded.
+         *
+         * @param buffer
+         *      The buffer holding the data.
+         * @param size
+         *      The size of the buffer.
+         * @param offset
+         *      The offset into the buffer where the data starts.
+         * @param length
+         *      The number of bytes of data.
+         *
+         * @throws IOException if the data can't be the start of a valid command.
+         * @throws NullPointerException if buffer is NULL.
+         * @throws IndexOutOfBoundsException if offset + length is greater than size.
+         */
+        virtual void receive(const unsigned char* buffer, int size, int offset, int length) = 0;
+
+        /**
+         * Unmarshals the next command if all of its data has been received.
+         *
+         * @param transport
+         *      The transport that the data was read from.
+         *
+         * @return the next Command or NULL if more data is needed to complete it.
+         *
+         * @throws IOException if the command can't be unmarshaled.
+         */
+        virtual Pointer<commands::Command> next(const transport::Transport* transport) = 0;
+
+        /**
+         * @return the number of received bytes that haven't been unmarshaled yet.
+         */
+        virtual int getPendingBytes() const = 0;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_FRAMEDECODER_H_ */
@@ -19,6 +19,18 @@
 
 using namespace activemq;
 using namespace activemq::wireformat;
+using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
 WireFormat::~WireFormat() {}
+
+////////////////////////////////////////////////////////////////////////////////
+bool WireFormat::hasFrameDecoder() const {
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<FrameDecoder> WireFormat::createFrameDecoder() {
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "WireFormat::createFrameDecoder - this WireFormat can't decode pushed data");
+}
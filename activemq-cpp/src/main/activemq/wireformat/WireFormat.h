@@ -19,6 +19,7 @@
 #define _ACTIVEMQ_WIREFORMAT_WIREFORMAT_H_
 
 #include <activemq/wireformat/WireFormatNegotiator.h>
+#include <activemq/wireformat/FrameDecoder.h>
 
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/DataOutputStream.h>
@@ -126,6 +127,25 @@ namespace wireformat {
         virtual Pointer<transport::Transport> createNegotiator(
             const Pointer<transport::Transport> transport) = 0;
 
+        /**
+         * Returns true if this WireFormat can create a FrameDecoder, which lets a
+         * Transport unmarshal commands from data pushed to it as it is read instead
+         * of blocking a thread on the input stream for each command.
+         *
+         * @return true if the WireFormat provides a FrameDecoder.
+         */
+        virtual bool hasFrameDecoder() const;
+
+        /**
+         * If the WireFormat provides a FrameDecoder this method creates a new one, each
+         * connection needs a decoder of its own.
+         *
+         * @return new instance of a FrameDecoder that uses this WireFormat.
+         *
+         * @throws UnsupportedOperationException if the WireFormat doesn't have a FrameDecoder.
+         */
+        virtual Pointer<FrameDecoder> createFrameDecoder();
+
     };
 
 }}
@@ -20,18 +20,32 @@
 #include <decaf/lang/Boolean.h>
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Long.h>
+#include <decaf/lang/Short.h>
 #include <decaf/util/UUID.h>
 #include <decaf/lang/Math.h>
+#include <decaf/io/ByteArrayInputStream.h>
 #include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
 #include <activemq/wireformat/openwire/OpenWireFormatNegotiator.h>
 #include <activemq/wireformat/openwire/utils/BooleanStream.h>
 #include <activemq/wireformat/MarshalAware.h>
 #include <activemq/commands/WireFormatInfo.h>
 #include <activemq/commands/DataStructure.h>
+#include <activemq/commands/ActiveMQDestination.h>
+#include <activemq/commands/BrokerId.h>
+#include <activemq/commands/ConnectionId.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/LocalTransactionId.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/commands/SessionId.h>
+#include <activemq/commands/XATransactionId.h>
 #include <activemq/wireformat/openwire/marshal/DataStreamMarshaller.h>
 #include <activemq/wireformat/openwire/marshal/generated/MarshallerFactory.h>
 #include <activemq/exceptions/ActiveMQException.h>
 
+#include <string.h>
+
 using namespace std;
 using namespace activemq;
 using namespace activemq::util;
@@ -51,13 +65,199 @@ using namespace decaf::lang::exceptions;
 const unsigned char OpenWireFormat::NULL_TYPE = 0;
 const int OpenWireFormat::DEFAULT_VERSION = 1;
 const int OpenWireFormat::MAX_SUPPORTED_VERSION = 11;
+const int OpenWireFormat::DEFAULT_MARSHAL_CACHE_SIZE = 1024;
+const int OpenWireFormat::MARSHAL_CACHE_FREE_SPACE = 100;
+const int OpenWireFormat::MAX_RETAINED_MARSHAL_BUFFER_SIZE = 64 * 1024;
+const int OpenWireFormat::MARSHAL_BUFFER_TRIM_FRAMES = 32;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    template<typename T>
+    bool compareCachedObjects(const DataStructure* left, const DataStructure* right, int& result) {
+
+        const T* leftValue = dynamic_cast<const T*>(left);
+        const T* rightValue = dynamic_cast<const T*>(right);
+
+        if (leftValue == NULL || rightValue == NULL) {
+            return false;
+        }
+
+        result = leftValue->compareTo(*rightValue);
+        return true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+
+    /**
+     * Splits the size prefixed frames out of the data pushed to it and unmarshals
+     * each one once all of its bytes have arrived.
+     */
+    class OpenWireFrameDecoder : public FrameDecoder {
+    private:
+
+        OpenWireFormat* format;
+
+        // Received bytes are appended at limit and decoded from position.
+        std::vector<unsigned char> buffer;
+        int position;
+        int limit;
+
+    private:
+
+        OpenWireFrameDecoder(const OpenWireFrameDecoder&);
+        OpenWireFrameDecoder& operator= (const OpenWireFrameDecoder&);
+
+    public:
+
+        OpenWireFrameDecoder(OpenWireFormat* format) : FrameDecoder(), format(format), buffer(), position(0), limit(0) {
+        }
+
+        virtual ~OpenWireFrameDecoder() {
+        }
+
+        virtual void receive(const unsigned char* data, int size, int offset, int length) {
+
+            if (data == NULL) {
+                throw NullPointerException(__FILE__, __LINE__, "OpenWireFrameDecoder::receive - Buffer passed is Null");
+            }
+
+            if (size < 0 || offset < 0 || offset > size || length < 0 || length > size - offset) {
+                throw IndexOutOfBoundsException(__FILE__, __LINE__,
+                    "OpenWireFrameDecoder::receive - size{%d}, offset{%d} and length{%d} are out of bounds", size, offset, length);
+            }
+
+            if (length == 0) {
+                return;
+            }
+
+            // Move the bytes not yet decoded to the front before growing the buffer.
+            if ((int) this->buffer.size() - this->limit < length && this->position > 0) {
+                if (this->limit > this->position) {
+                    ::memmove(&this->buffer[0], &this->buffer[this->position], this->limit - this->position);
+                }
+                this->limit -= this->position;
+                this->position = 0;
+            }
+
+            if ((int) this->buffer.size() - this->limit < length) {
+                this->buffer.resize(this->limit + length);
+            }
+
+            ::memcpy(&this->buffer[this->limit], data + offset, length);
+            this->limit += length;
+
+            // Fail as soon as an oversized frame announces itself rather than buffering it.
+            frameSize();
+        }
+
+        virtual Pointer<Command> next(const Transport* transport) {
+
+            if (this->format->isSizePrefixDisabled()) {
+                throw IOException(__FILE__, __LINE__,
+                    "OpenWireFrameDecoder::next - frames can't be found without the size prefix");
+            }
+
+            Pointer<Command> command;
+
+            int size = frameSize();
+            if (size >= 0 && this->limit - this->position - 4 >= size) {
+
+                ByteArrayInputStream bytes(&this->buffer[this->position], 4 + size);
+                DataInputStream in(&bytes);
+
+                command = this->format->unmarshal(transport, &in);
+                this->position += 4 + size;
+            }
+
+            if (this->position == this->limit) {
+                this->position = 0;
+                this->limit = 0;
+
+                // Don't hold a buffer sized for one large message for the life of the connection.
+                if ((int) this->buffer.size() > utils::FrameDataInputStream::MAX_RETAINED_SIZE) {
+                    std::vector<unsigned char>().swap(this->buffer);
+                }
+            }
+
+            // A frame that is still arriving counts as being received, the same as
+            // when a reader thread is blocked in unmarshal waiting for its bytes.
+            this->format->receiving.set(this->limit > this->position);
+
+            return command;
+        }
+
+        virtual int getPendingBytes() const {
+            return this->limit - this->position;
+        }
+
+    private:
+
+        // Returns the size of the frame at the current position, or -1 if its size
+        // prefix hasn't fully arrived yet.
+        int frameSize() const {
+
+            if (this->limit - this->position < 4) {
+                return -1;
+            }
+
+            const unsigned char* prefix = &this->buffer[this->position];
+            int size = (int) (((unsigned int) prefix[0] << 24) | ((unsigned int) prefix[1] << 16) |
+                              ((unsigned int) prefix[2] << 8) | (unsigned int) prefix[3]);
+
+            if (size < 0 || size > this->format->getMaxFrameSize()) {
+                throw IOException(__FILE__, __LINE__,
+                    "Frame size of %d bytes is larger than the max allowed %lld bytes", size, this->format->getMaxFrameSize());
+            }
+
+            return size;
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+bool OpenWireFormat::DataStructureComparator::operator()(const DataStructure* left, const DataStructure* right) const {
+
+    if (left->getDataStructureType() != right->getDataStructureType()) {
+        return left->getDataStructureType() < right->getDataStructureType();
+    }
+
+    // The OpenWire cached fields are all destinations or identifiers, these
+    // can be ordered without creating their string forms.
+    int result = 0;
+    if (compareCachedObjects<ActiveMQDestination>(left, right, result) ||
+        compareCachedObjects<ConsumerId>(left, right, result) ||
+        compareCachedObjects<ProducerId>(left, right, result) ||
+        compareCachedObjects<ConnectionId>(left, right, result) ||
+        compareCachedObjects<SessionId>(left, right, result) ||
+        compareCachedObjects<BrokerId>(left, right, result) ||
+        compareCachedObjects<LocalTransactionId>(left, right, result) ||
+        compareCachedObjects<XATransactionId>(left, right, result)) {
+
+        return result < 0;
+    }
+
+    if (left->equals(right)) {
+        return false;
+    }
+
+    return left->toString() < right->toString();
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 OpenWireFormat::OpenWireFormat(const decaf::util::Properties& properties) :
     properties(properties), preferedWireFormatInfo(), dataMarshallers(256),
     id(UUID::randomUUID().toString()), receiving(), version(0), stackTraceEnabled(true),
-    tcpNoDelayEnabled(true), cacheEnabled(true), cacheSize(1024), tightEncodingEnabled(false),
-    sizePrefixDisabled(false), maxInactivityDuration(30000), maxInactivityDurationInitialDelay(10000) {
+    tcpNoDelayEnabled(true), cacheEnabled(false), cacheSize(DEFAULT_MARSHAL_CACHE_SIZE), tightEncodingEnabled(false),
+    sizePrefixDisabled(false), maxInactivityDuration(30000), maxInactivityDurationInitialDelay(10000),
+    maxFrameSize(Long::MAX_VALUE),
+    marshallCache(), unmarshallCache(), marshallCacheMap(), nextMarshallCacheIndex(0), nextMarshallCacheEvictionIndex(0),
+    marshalBuffer(), marshalBufferOut(&marshalBuffer), marshalBufferSmallFrames(0), unmarshalFrame() {
 
     // initialize the universal marshalers, don't need to reset them again
     // after this so its safe to do this here.
@@ -86,6 +286,22 @@ Pointer<Transport> OpenWireFormat::createNegotiator(const Pointer<Transport> tra
     AMQ_CATCHALL_THROW(UnsupportedOperationException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool OpenWireFormat::hasFrameDecoder() const {
+    return this->preferedWireFormatInfo == NULL || !this->preferedWireFormatInfo->isSizePrefixDisabled();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<FrameDecoder> OpenWireFormat::createFrameDecoder() {
+
+    if (!hasFrameDecoder()) {
+        throw UnsupportedOperationException(__FILE__, __LINE__,
+            "OpenWireFormat::createFrameDecoder - frames can't be found without the size prefix");
+    }
+
+    return Pointer<FrameDecoder>(new OpenWireFrameDecoder(this));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void OpenWireFormat::destroyMarshalers() {
 
@@ -120,6 +336,122 @@ void OpenWireFormat::setVersion(int version) {
     AMQ_CATCHALL_THROW(IllegalArgumentException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormat::setCacheEnabled(bool cacheEnabled) {
+    this->cacheEnabled = cacheEnabled;
+    this->resetMarshalCaches();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormat::setCacheSize(int value) {
+    this->cacheSize = value;
+    this->resetMarshalCaches();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormat::resetMarshalCaches() {
+
+    this->marshallCacheMap.clear();
+    this->marshallCache.clear();
+    this->unmarshallCache.clear();
+    this->nextMarshallCacheIndex = 0;
+    this->nextMarshallCacheEvictionIndex = 0;
+
+    if (this->cacheEnabled) {
+
+        // Cache indexes are sent as a short so the size is capped to that range.
+        int size = this->cacheSize > 0 ? this->cacheSize : DEFAULT_MARSHAL_CACHE_SIZE;
+        size = Math::min(size, (int) Short::MAX_VALUE);
+
+        this->marshallCache.resize(size);
+        this->unmarshallCache.resize(size);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+short OpenWireFormat::getMarshallCacheIndex(const DataStructure* object) const {
+
+    MarshallCacheMap::const_iterator iter = this->marshallCacheMap.find(object);
+    if (iter != this->marshallCacheMap.end()) {
+        return iter->second;
+    }
+
+    return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+short OpenWireFormat::addToMarshallCache(const DataStructure* object) {
+
+    int size = (int) this->marshallCache.size();
+
+    // We can only cache the object if there is space left, -1 tells the
+    // receiver that the object was not cached.
+    if (size == 0 || (int) this->marshallCacheMap.size() >= size) {
+        return -1;
+    }
+
+    short index = (short) this->nextMarshallCacheIndex++;
+    if (this->nextMarshallCacheIndex >= size) {
+        this->nextMarshallCacheIndex = 0;
+    }
+
+    // Hold our own copy since the object belongs to the command being sent.
+    Pointer<DataStructure> copy(object->cloneDataStructure());
+    this->marshallCache[index] = copy;
+    this->marshallCacheMap[copy.get()] = index;
+
+    return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormat::runMarshallCacheEvictionSweep() {
+
+    int size = (int) this->marshallCache.size();
+    int limit = size - Math::min(MARSHAL_CACHE_FREE_SPACE, size / 2);
+
+    while ((int) this->marshallCacheMap.size() > limit) {
+
+        Pointer<DataStructure>& evicted = this->marshallCache[this->nextMarshallCacheEvictionIndex++];
+        if (evicted != NULL) {
+            this->marshallCacheMap.erase(evicted.get());
+            evicted.reset(NULL);
+        }
+
+        if (this->nextMarshallCacheEvictionIndex >= size) {
+            this->nextMarshallCacheEvictionIndex = 0;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormat::setInUnmarshallCache(short index, const DataStructure* object) {
+
+    // The sender had no space left in its cache so this object isn't cached.
+    if (index == -1) {
+        return;
+    }
+
+    if (index < 0 || index >= (int) this->unmarshallCache.size()) {
+        throw IOException(__FILE__, __LINE__,
+            "OpenWireFormat::setInUnmarshallCache - Invalid cache index: %d", (int) index);
+    }
+
+    // The sender is allowed to cache a null value.
+    this->unmarshallCache[index].reset(object != NULL ? object->cloneDataStructure() : NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DataStructure* OpenWireFormat::getFromUnmarshallCache(short index) const {
+
+    if (index < 0 || index >= (int) this->unmarshallCache.size()) {
+        throw IOException(__FILE__, __LINE__,
+            "OpenWireFormat::getFromUnmarshallCache - Invalid cache index: %d", (int) index);
+    }
+
+    const Pointer<DataStructure>& object = this->unmarshallCache[index];
+    return object != NULL ? object->cloneDataStructure() : NULL;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void OpenWireFormat::addMarshaller(DataStreamMarshaller* marshaller) {
     unsigned char type = marshaller->getDataStructureType();
@@ -158,6 +490,10 @@ void OpenWireFormat::marshal(const Pointer<commands::Command> command, const act
                 throw IOException(__FILE__, __LINE__, (string("OpenWireFormat::marshal - Unknown data type: ") + Integer::toString(type)).c_str());
             }
 
+            if (cacheEnabled) {
+                runMarshallCacheEvictionSweep();
+            }
+
             if (tightEncodingEnabled) {
                 BooleanStream bs;
                 size += dsm->tightMarshal1(this, dataStructure, &bs);
@@ -178,27 +514,33 @@ void OpenWireFormat::marshal(const Pointer<commands::Command> command, const act
                     dsm->looseMarshal(this, dataStructure, dataOut);
                 } else {
 
-                    ByteArrayOutputStream* baos = new ByteArrayOutputStream();
-                    std::auto_ptr<DataOutputStream> looseOut(new DataOutputStream(baos, true));
-
-                    looseOut->writeByte(type);
-                    dsm->looseMarshal(this, dataStructure, looseOut.get());
-                    looseOut->close();
-
-                    // Now the data goes to the transport from out byte buffer.
-                    dataOut->writeInt((int) baos->size());
-
-                    if (baos->size() > 0) {
-                        std::pair<unsigned char*, int> array = baos->toByteArray();
-
-                        try {
-                            dataOut->write(array.first, array.second);
-                        } catch (Exception& ex) {
-                            delete[] array.first;
-                            throw;
-                        }
-
-                        delete[] array.first;
+                    // Marshal into the reusable frame buffer behind a placeholder for
+                    // the size prefix, once the size is known it is filled in and the
+                    // whole frame goes to the transport in a single write.
+                    marshalBuffer.reset();
+                    marshalBufferOut.writeInt(0);
+                    marshalBufferOut.writeByte(type);
+                    dsm->looseMarshal(this, dataStructure, &marshalBufferOut);
+
+                    std::pair<unsigned char*, int> frame = marshalBuffer.toByteArrayRef();
+                    int frameSize = frame.second - 4;
+
+                    frame.first[0] = (unsigned char) ((frameSize >> 24) & 0xFF);
+                    frame.first[1] = (unsigned char) ((frameSize >> 16) & 0xFF);
+                    frame.first[2] = (unsigned char) ((frameSize >> 8) & 0xFF);
+                    frame.first[3] = (unsigned char) (frameSize & 0xFF);
+
+                    dataOut->write(frame.first, frame.second);
+
+                    // Don't hold a buffer sized for one large message for the life of
+                    // the connection, but keep it while large messages keep coming so
+                    // it isn't grown again from scratch for each of them.
+                    if (frame.second > MAX_RETAINED_MARSHAL_BUFFER_SIZE) {
+                        marshalBufferSmallFrames = 0;
+                    } else if (marshalBufferSmallFrames < MARSHAL_BUFFER_TRIM_FRAMES &&
+                               ++marshalBufferSmallFrames == MARSHAL_BUFFER_TRIM_FRAMES) {
+                        marshalBuffer.reset();
+                        marshalBuffer.trimToSize(MAX_RETAINED_MARSHAL_BUFFER_SIZE);
                     }
                 }
             }
@@ -222,13 +564,56 @@ Pointer<commands::Command> OpenWireFormat::unmarshal(const activemq::transport::
             throw decaf::io::IOException(__FILE__, __LINE__, "DataInputStream passed is NULL");
         }
 
+        class Finally {
+        private:
+
+            decaf::util::concurrent::atomic::AtomicBoolean* state;
+
+        private:
+
+            Finally(const Finally&);
+            Finally& operator=(const Finally&);
+
+        public:
+
+            Finally(decaf::util::concurrent::atomic::AtomicBoolean* state) : state(state) {
+            }
+
+            ~Finally() {
+                state->set(false);
+            }
+        }
+
+        finalizer(&(this->receiving));
+
+        // With the size prefix the whole frame is read in one pass and the command
+        // is decoded from memory rather than through the stream a field at a time.
         if (!sizePrefixDisabled) {
-            dis->readInt();
+
+            int size = dis->readInt();
+            if (size > maxFrameSize) {
+                throw IOException(__FILE__, __LINE__,
+                    "Frame size of %d bytes is larger than the max allowed %lld bytes", size, maxFrameSize);
+            }
+
+            // The rest of a large frame can take a while to arrive, that counts as
+            // receiving so the inactivity monitor doesn't fail the connection.
+            this->receiving.set(true);
+
+            unmarshalFrame.readFrame(dis, size);
+            dis = &unmarshalFrame;
+        } else {
+            this->receiving.set(true);
         }
 
         // Get the unmarshalled DataStructure
         Pointer<DataStructure> data(doUnmarshal(dis));
 
+        // The command holds its own copy of the frame's data now.
+        if (!sizePrefixDisabled) {
+            unmarshalFrame.releaseFrame();
+        }
+
         if (data == NULL) {
             throw IOException(__FILE__, __LINE__, "OpenWireFormat::doUnmarshal - "
                     "Failed to unmarshal an Object");
@@ -252,29 +637,6 @@ commands::DataStructure* OpenWireFormat::doUnmarshal(DataInputStream* dis) {
 
     try {
 
-        class Finally {
-        private:
-
-            decaf::util::concurrent::atomic::AtomicBoolean* state;
-
-        private:
-
-            Finally(const Finally&);
-            Finally& operator=(const Finally&);
-
-        public:
-
-            Finally(decaf::util::concurrent::atomic::AtomicBoolean* state) : state(state) {
-                state->set(true);
-            }
-
-            ~Finally() {
-                state->set(false);
-            }
-        }
-
-        finalizer(&(this->receiving));
-
         unsigned char dataType = dis->readByte();
 
         if (dataType != NULL_TYPE) {
@@ -492,6 +854,7 @@ void OpenWireFormat::renegotiateWireFormat(const WireFormatInfo& info) {
     this->tightEncodingEnabled = info.isTightEncodingEnabled() && preferedWireFormatInfo->isTightEncodingEnabled();
     this->sizePrefixDisabled = info.isSizePrefixDisabled() && preferedWireFormatInfo->isSizePrefixDisabled();
     this->cacheSize = min(info.getCacheSize(), preferedWireFormatInfo->getCacheSize());
+    this->resetMarshalCaches();
     this->maxInactivityDuration = min(info.getMaxInactivityDuration(), preferedWireFormatInfo->getMaxInactivityDuration());
     this->maxInactivityDurationInitialDelay = min(info.getMaxInactivityDurationInitalDelay(), preferedWireFormatInfo->getMaxInactivityDurationInitalDelay());
 }
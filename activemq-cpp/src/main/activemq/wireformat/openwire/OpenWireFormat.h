@@ -23,12 +23,17 @@
 #include <activemq/commands/DataStructure.h>
 #include <activemq/wireformat/WireFormat.h>
 #include <activemq/wireformat/openwire/utils/BooleanStream.h>
+#include <activemq/wireformat/openwire/utils/FrameDataInputStream.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/util/Properties.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataOutputStream.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 #include <decaf/lang/exceptions/IllegalStateException.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
 #include <memory>
+#include <vector>
+#include <map>
 
 namespace activemq {
 namespace wireformat {
@@ -38,6 +43,8 @@ namespace marshal {
     class DataStreamMarshaller;
 }
 
+    class OpenWireFrameDecoder;
+
     using decaf::lang::Pointer;
 
     class AMQCPP_API OpenWireFormat : public wireformat::WireFormat {
@@ -52,8 +59,36 @@ namespace marshal {
         // Defines the maximum supported openwire version
         static const int MAX_SUPPORTED_VERSION;
 
+        // Cache size used when the negotiated cache size is zero.
+        static const int DEFAULT_MARSHAL_CACHE_SIZE;
+
+        // Number of cache slots kept free so a single command can always be cached.
+        static const int MARSHAL_CACHE_FREE_SPACE;
+
+        // Largest marshal buffer kept for reuse between commands.
+        static const int MAX_RETAINED_MARSHAL_BUFFER_SIZE;
+
+        // Number of frames in a row that fit the retained size before a larger
+        // marshal buffer is released.
+        static const int MARSHAL_BUFFER_TRIM_FRAMES;
+
     private:
 
+        friend class OpenWireFrameDecoder;
+
+        /**
+         * Orders the cached DataStructure values so that logically equal objects
+         * map to the same marshal cache index.
+         */
+        class DataStructureComparator {
+        public:
+
+            bool operator()(const commands::DataStructure* left, const commands::DataStructure* right) const;
+
+        };
+
+        typedef std::map<const commands::DataStructure*, short, DataStructureComparator> MarshallCacheMap;
+
         // Configuration parameters
         decaf::util::Properties properties;
 
@@ -66,7 +101,7 @@ namespace marshal {
         // Uniquely Generated ID, initialize in the Ctor
         std::string id;
 
-        // Indicates when we are in the doUnmarshal call
+        // Indicates when a command is being read in the unmarshal call
         decaf::util::concurrent::atomic::AtomicBoolean receiving;
 
         // WireFormat Data
@@ -79,6 +114,25 @@ namespace marshal {
         bool sizePrefixDisabled;
         long long maxInactivityDuration;
         long long maxInactivityDurationInitialDelay;
+        long long maxFrameSize;
+
+        // Marshal and Unmarshal caches, only used when cacheEnabled is true.
+        std::vector< Pointer<commands::DataStructure> > marshallCache;
+        std::vector< Pointer<commands::DataStructure> > unmarshallCache;
+        MarshallCacheMap marshallCacheMap;
+        int nextMarshallCacheIndex;
+        int nextMarshallCacheEvictionIndex;
+
+        // Reusable frame buffer for size prefixed loose encoding, grows to the
+        // largest frame sent and is only touched by the thread sending a command.
+        // Counts the frames sent since the last one larger than the retained size.
+        decaf::io::ByteArrayOutputStream marshalBuffer;
+        decaf::io::DataOutputStream marshalBufferOut;
+        int marshalBufferSmallFrames;
+
+        // Holds the size prefixed frame being unmarshaled, grows to the largest
+        // frame received and is only touched by the thread reading commands.
+        utils::FrameDataInputStream unmarshalFrame;
 
     public:
 
@@ -102,6 +156,19 @@ namespace marshal {
          */
         virtual Pointer<transport::Transport> createNegotiator(const Pointer<transport::Transport> transport);
 
+        /**
+         * The frames can only be found in pushed data when they are size prefixed, so
+         * there is no FrameDecoder if the preferred wire format disables the prefix.
+         *
+         * {@inheritDoc}
+         */
+        virtual bool hasFrameDecoder() const;
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual Pointer<FrameDecoder> createFrameDecoder();
+
         /**
          * Allows an external source to add marshalers to this object for
          * types that may be marshaled or unmarshaled.
@@ -255,7 +322,8 @@ namespace marshal {
         /**
          * Is there a Message being unmarshaled?
          *
-         * @return true while in the doUnmarshal method.
+         * @return true from the time the size of a frame is read until its command
+         *         has been unmarshaled.
          */
         virtual bool inReceive() const {
             return this->receiving.get();
@@ -270,12 +338,12 @@ namespace marshal {
         }
 
         /**
-         * Sets if the cacheEnabled flag is on
+         * Sets if the cacheEnabled flag is on, the marshal caches are reset
+         * whenever this value is set.
+         *
          * @param cacheEnabled - true to turn flag is on
          */
-        void setCacheEnabled(bool cacheEnabled) {
-            this->cacheEnabled = cacheEnabled;
-        }
+        void setCacheEnabled(bool cacheEnabled);
 
         /**
          * Returns the currently set Cache size.
@@ -286,12 +354,61 @@ namespace marshal {
         }
 
         /**
-         * Sets the current Cache size.
+         * Sets the current Cache size, the marshal caches are reset whenever
+         * this value is set.
+         *
          * @param value - the value to send as the broker's cache size.
          */
-        void setCacheSize(int value) {
-            this->cacheSize = value;
-        }
+        void setCacheSize(int value);
+
+        /**
+         * Returns the index in the marshal cache of an object that is equal to
+         * the given value, or -1 if no such object has been cached.
+         *
+         * @param object
+         *      The DataStructure to look up in the marshal cache.
+         *
+         * @return the cache index or -1 if not cached.
+         */
+        short getMarshallCacheIndex(const commands::DataStructure* object) const;
+
+        /**
+         * Stores a copy of the given object in the marshal cache and returns
+         * the index it was assigned, the receiver is told to store the object
+         * at the same index.  Returns -1 if there is no room left in the cache.
+         *
+         * @param object
+         *      The DataStructure to add to the marshal cache.
+         *
+         * @return the index assigned to the object or -1 if it was not cached.
+         */
+        short addToMarshallCache(const commands::DataStructure* object);
+
+        /**
+         * Stores a copy of the unmarshaled object at the index the sender
+         * assigned to it, an index of -1 means the sender did not cache it.
+         *
+         * @param index
+         *      The cache index read from the wire.
+         * @param object
+         *      The DataStructure that was unmarshaled.
+         *
+         * @throws IOException if the index is not valid for this cache.
+         */
+        void setInUnmarshallCache(short index, const commands::DataStructure* object);
+
+        /**
+         * Returns a new copy of the object stored at the given index of the
+         * unmarshal cache, the caller owns the returned object.
+         *
+         * @param index
+         *      The cache index read from the wire.
+         *
+         * @return a newly allocated copy of the cached DataStructure or NULL.
+         *
+         * @throws IOException if the index is not valid for this cache.
+         */
+        commands::DataStructure* getFromUnmarshallCache(short index) const;
 
         /**
          * Checks if the tightEncodingEnabled flag is on
@@ -357,6 +474,23 @@ namespace marshal {
             this->maxInactivityDurationInitialDelay = value;
         }
 
+        /**
+         * Gets the largest size prefixed frame that will be read, a larger frame fails
+         * the unmarshal before any memory is allocated for it.
+         * @return the maximum frame size in bytes.
+         */
+        long long getMaxFrameSize() const {
+            return this->maxFrameSize;
+        }
+
+        /**
+         * Sets the largest size prefixed frame that will be read.
+         * @param value - the maximum frame size in bytes.
+         */
+        void setMaxFrameSize(long long value) {
+            this->maxFrameSize = value;
+        }
+
     protected:
 
         /**
@@ -381,6 +515,18 @@ namespace marshal {
          */
         void destroyMarshalers();
 
+        /**
+         * Discards the contents of the marshal and unmarshal caches and sizes
+         * them based on the current cache settings.
+         */
+        void resetMarshalCaches();
+
+        /**
+         * Evicts the oldest entries from the marshal cache until there is
+         * enough free space to cache the objects of the next command.
+         */
+        void runMarshallCacheEvictionSweep();
+
     };
 
 }}}
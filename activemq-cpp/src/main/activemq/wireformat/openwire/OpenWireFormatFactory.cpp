@@ -74,6 +74,9 @@ Pointer<WireFormat> OpenWireFormatFactory::createWireFormat(const decaf::util::P
         // Create the Openwire Format Object
         Pointer<OpenWireFormat> wireFormat(new OpenWireFormat(properties));
 
+        wireFormat->setMaxFrameSize(Long::parseLong(
+            properties.getProperty("wireFormat.maxFrameSize", Long::toString(Long::MAX_VALUE))));
+
         // give the format object the ownership
         wireFormat->setPreferedWireFormatInfo(info);
 
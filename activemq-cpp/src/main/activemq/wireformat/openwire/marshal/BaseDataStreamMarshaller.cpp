@@ -28,6 +28,7 @@
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Pointer.h>
 #include <activemq/util/Config.h>
+#include <memory>
 
 using namespace std;
 using namespace activemq;
@@ -48,6 +49,20 @@ utils::HexTable BaseDataStreamMarshaller::hexTable;
 ////////////////////////////////////////////////////////////////////////////////
 commands::DataStructure* BaseDataStreamMarshaller::tightUnmarshalCachedObject(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn,utils::BooleanStream* bs) {
     try {
+
+        if (wireFormat->isCacheEnabled()) {
+
+            if (bs->readBoolean()) {
+                short index = dataIn->readShort();
+                std::auto_ptr<commands::DataStructure> object(wireFormat->tightUnmarshalNestedObject(dataIn, bs));
+                wireFormat->setInUnmarshallCache(index, object.get());
+                return object.release();
+            } else {
+                short index = dataIn->readShort();
+                return wireFormat->getFromUnmarshallCache(index);
+            }
+        }
+
         return wireFormat->tightUnmarshalNestedObject(dataIn, bs);
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -58,6 +73,24 @@ commands::DataStructure* BaseDataStreamMarshaller::tightUnmarshalCachedObject(Op
 ////////////////////////////////////////////////////////////////////////////////
 int BaseDataStreamMarshaller::tightMarshalCachedObject1(OpenWireFormat* wireFormat, commands::DataStructure* data, utils::BooleanStream* bs) {
     try {
+
+        if (wireFormat->isCacheEnabled()) {
+
+            // A null value is still written in full, it costs only one bit.
+            short index = data != NULL ? wireFormat->getMarshallCacheIndex(data) : (short) -1;
+            bs->writeBoolean(index == -1);
+
+            if (index == -1) {
+                int rc = wireFormat->tightMarshalNestedObject1(data, bs);
+                if (data != NULL) {
+                    wireFormat->addToMarshallCache(data);
+                }
+                return 2 + rc;
+            } else {
+                return 2;
+            }
+        }
+
         return wireFormat->tightMarshalNestedObject1(data, bs);
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -68,6 +101,21 @@ int BaseDataStreamMarshaller::tightMarshalCachedObject1(OpenWireFormat* wireForm
 ////////////////////////////////////////////////////////////////////////////////
 void BaseDataStreamMarshaller::tightMarshalCachedObject2(OpenWireFormat* wireFormat, commands::DataStructure* data, decaf::io::DataOutputStream* dataOut,utils::BooleanStream* bs) {
     try {
+
+        if (wireFormat->isCacheEnabled()) {
+
+            short index = data != NULL ? wireFormat->getMarshallCacheIndex(data) : (short) -1;
+
+            if (bs->readBoolean()) {
+                dataOut->writeShort(index);
+                wireFormat->tightMarshalNestedObject2(data, dataOut, bs);
+            } else {
+                dataOut->writeShort(index);
+            }
+
+            return;
+        }
+
         wireFormat->tightMarshalNestedObject2(data, dataOut, bs);
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -78,6 +126,25 @@ void BaseDataStreamMarshaller::tightMarshalCachedObject2(OpenWireFormat* wireFor
 ////////////////////////////////////////////////////////////////////////////////
 void BaseDataStreamMarshaller::looseMarshalCachedObject(OpenWireFormat* wireFormat, commands::DataStructure* data, decaf::io::DataOutputStream* dataOut) {
     try {
+
+        if (wireFormat->isCacheEnabled()) {
+
+            short index = data != NULL ? wireFormat->getMarshallCacheIndex(data) : (short) -1;
+            dataOut->writeBoolean(index == -1);
+
+            if (index == -1) {
+                if (data != NULL) {
+                    index = wireFormat->addToMarshallCache(data);
+                }
+                dataOut->writeShort(index);
+                wireFormat->looseMarshalNestedObject(data, dataOut);
+            } else {
+                dataOut->writeShort(index);
+            }
+
+            return;
+        }
+
         wireFormat->looseMarshalNestedObject(data, dataOut);
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -88,6 +155,20 @@ void BaseDataStreamMarshaller::looseMarshalCachedObject(OpenWireFormat* wireForm
 ////////////////////////////////////////////////////////////////////////////////
 commands::DataStructure* BaseDataStreamMarshaller::looseUnmarshalCachedObject(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn) {
     try {
+
+        if (wireFormat->isCacheEnabled()) {
+
+            if (dataIn->readBoolean()) {
+                short index = dataIn->readShort();
+                std::auto_ptr<commands::DataStructure> object(wireFormat->looseUnmarshalNestedObject(dataIn));
+                wireFormat->setInUnmarshallCache(index, object.get());
+                return object.release();
+            } else {
+                short index = dataIn->readShort();
+                return wireFormat->getFromUnmarshallCache(index);
+            }
+        }
+
         return wireFormat->looseUnmarshalNestedObject(dataIn);
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -0,0 +1,348 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameDataInputStream.h"
+
+#include <activemq/exceptions/ExceptionDefines.h>
+
+#include <decaf/io/EOFException.h>
+#include <decaf/io/IOException.h>
+#include <decaf/internal/util/StringUtils.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+
+#include <vector>
+#include <string.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::internal::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+namespace utils {
+
+    class FrameDataInputStream::FrameBuffer : public decaf::io::InputStream {
+    private:
+
+        FrameBuffer(const FrameBuffer&);
+        FrameBuffer& operator= (const FrameBuffer&);
+
+    public:
+
+        std::vector<unsigned char> data;
+        std::size_t position;
+        std::size_t limit;
+
+    public:
+
+        FrameBuffer() : InputStream(), data(), position(0), limit(0) {
+        }
+
+        virtual ~FrameBuffer() {
+        }
+
+        /**
+         * Returns a pointer to the next count bytes of the frame and moves the read
+         * position past them.
+         *
+         * @throws EOFException if fewer than count bytes remain in the frame.
+         */
+        const unsigned char* take(std::size_t count) {
+
+            if (count > this->limit - this->position) {
+                this->position = this->limit;
+                throw EOFException(__FILE__, __LINE__, "Read past the end of the OpenWire frame.");
+            }
+
+            const unsigned char* result = &this->data[0] + this->position;
+            this->position += count;
+            return result;
+        }
+
+        virtual int available() const {
+            return (int) (this->limit - this->position);
+        }
+
+        virtual long long skip(long long num) {
+
+            if (num <= 0) {
+                return 0;
+            }
+
+            std::size_t remaining = this->limit - this->position;
+            std::size_t count = (unsigned long long) num < remaining ? (std::size_t) num : remaining;
+            this->position += count;
+            return (long long) count;
+        }
+
+    protected:
+
+        virtual int doReadByte() {
+
+            if (this->position == this->limit) {
+                return -1;
+            }
+
+            return this->data[this->position++];
+        }
+
+        virtual int doReadArrayBounded(unsigned char* buffer, int size, int offset, int length) {
+
+            if (length == 0) {
+                return 0;
+            }
+
+            if (buffer == NULL) {
+                throw NullPointerException(__FILE__, __LINE__, "Buffer passed was NULL.");
+            }
+
+            if (size < 0 || offset < 0 || offset > size || length < 0 || length > size - offset) {
+                throw IndexOutOfBoundsException(__FILE__, __LINE__, "Given buffer bounds are invalid.");
+            }
+
+            std::size_t remaining = this->limit - this->position;
+            if (remaining == 0) {
+                return -1;
+            }
+
+            std::size_t count = (std::size_t) length < remaining ? (std::size_t) length : remaining;
+            ::memcpy(buffer + offset, &this->data[0] + this->position, count);
+            this->position += count;
+            return (int) count;
+        }
+    };
+
+}}}}
+
+////////////////////////////////////////////////////////////////////////////////
+const int FrameDataInputStream::MAX_RETAINED_SIZE = 64 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+FrameDataInputStream::FrameDataInputStream() : DataInputStream(new FrameBuffer(), true), frame(NULL) {
+    this->frame = static_cast<FrameBuffer*>(this->inputStream);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameDataInputStream::~FrameDataInputStream() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameDataInputStream::readFrame(decaf::io::DataInputStream* source, int size) {
+
+    try {
+
+        if (source == NULL) {
+            throw IOException(__FILE__, __LINE__, "Source stream passed is NULL");
+        }
+
+        if (size < 0) {
+            throw IOException(__FILE__, __LINE__, "Invalid OpenWire frame size: %d", size);
+        }
+
+        // Discard whatever is left of the previous frame first so that a failed read
+        // never leaves a partial frame that could be mistaken for valid data.
+        this->releaseFrame();
+
+        if (this->frame->data.size() < (std::size_t) size) {
+            this->frame->data.resize((std::size_t) size);
+        }
+
+        if (size > 0) {
+            source->readFully(&this->frame->data[0], size);
+        }
+
+        this->frame->limit = (std::size_t) size;
+    }
+    AMQ_CATCH_RETHROW(EOFException)
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameDataInputStream::releaseFrame() {
+
+    this->frame->position = 0;
+    this->frame->limit = 0;
+
+    if (this->frame->data.size() > (std::size_t) MAX_RETAINED_SIZE) {
+        std::vector<unsigned char>().swap(this->frame->data);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FrameDataInputStream::getRemaining() const {
+    return (int) (this->frame->limit - this->frame->position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool FrameDataInputStream::readBoolean() {
+    return *this->frame->take(1) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+char FrameDataInputStream::readByte() {
+    return (char) *this->frame->take(1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned char FrameDataInputStream::readUnsignedByte() {
+    return *this->frame->take(1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+char FrameDataInputStream::readChar() {
+    return (char) *this->frame->take(1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+short FrameDataInputStream::readShort() {
+    const unsigned char* bytes = this->frame->take(2);
+    return (short) ((bytes[0] << 8) | bytes[1]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned short FrameDataInputStream::readUnsignedShort() {
+    const unsigned char* bytes = this->frame->take(2);
+    return (unsigned short) ((bytes[0] << 8) | bytes[1]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FrameDataInputStream::readInt() {
+    const unsigned char* bytes = this->frame->take(4);
+    return (int) (((unsigned int) bytes[0] << 24) | ((unsigned int) bytes[1] << 16) |
+                  ((unsigned int) bytes[2] << 8) | (unsigned int) bytes[3]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FrameDataInputStream::readLong() {
+
+    const unsigned char* bytes = this->frame->take(8);
+
+    unsigned long long value = 0;
+    for (int ix = 0; ix < 8; ++ix) {
+        value = (value << 8) | (unsigned long long) bytes[ix];
+    }
+
+    return (long long) value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+float FrameDataInputStream::readFloat() {
+    unsigned int lvalue = (unsigned int) this->readInt();
+    float value = 0.0f;
+    ::memcpy(&value, &lvalue, sizeof(unsigned int));
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double FrameDataInputStream::readDouble() {
+    unsigned long long lvalue = (unsigned long long) this->readLong();
+    double value = 0.0;
+    ::memcpy(&value, &lvalue, sizeof(unsigned long long));
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string FrameDataInputStream::readString() {
+
+    std::size_t remaining = this->frame->limit - this->frame->position;
+
+    // An empty frame has no storage to point into.
+    const unsigned char* start = NULL;
+    const unsigned char* terminator = NULL;
+
+    if (remaining > 0) {
+        start = &this->frame->data[0] + this->frame->position;
+        terminator = static_cast<const unsigned char*>(::memchr(start, '\0', remaining));
+    }
+
+    if (terminator == NULL) {
+        this->frame->position = this->frame->limit;
+        throw EOFException(__FILE__, __LINE__, "FrameDataInputStream::readString - Reached EOF");
+    }
+
+    this->frame->position += (std::size_t) (terminator - start) + 1;
+    return std::string(reinterpret_cast<const char*>(start), (std::size_t) (terminator - start));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string FrameDataInputStream::readUTF() {
+
+    std::size_t remaining = this->frame->limit - this->frame->position;
+
+    // Plain ASCII strings are taken straight from the frame, anything else is
+    // decoded by the base class which reads the same bytes through the frame.
+    if (remaining >= 2) {
+
+        const unsigned char* start = &this->frame->data[0] + this->frame->position;
+        std::size_t utfLength = (std::size_t) ((start[0] << 8) | start[1]);
+
+        if (utfLength <= remaining - 2 && StringUtils::plainAsciiLength(start + 2, utfLength) == utfLength) {
+            this->frame->position += utfLength + 2;
+            return std::string(reinterpret_cast<const char*>(start + 2), utfLength);
+        }
+    }
+
+    return DataInputStream::readUTF();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameDataInputStream::readFully(unsigned char* buffer, int size) {
+    this->readFully(buffer, size, 0, size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameDataInputStream::readFully(unsigned char* buffer, int size, int offset, int length) {
+
+    if (length == 0) {
+        return;
+    }
+
+    if (buffer == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Buffer is null");
+    }
+
+    if (size < 0) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "size parameter out of Bounds: %d.", size);
+    }
+
+    if (offset > size || offset < 0) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "offset parameter out of Bounds: %d.", offset);
+    }
+
+    if (length < 0 || length > size - offset) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "length parameter out of Bounds: %d.", length);
+    }
+
+    ::memcpy(buffer + offset, this->frame->take((std::size_t) length), (std::size_t) length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FrameDataInputStream::skipBytes(long long num) {
+    return this->frame->skip(num);
+}
@@ -0,0 +1,132 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FRAMEDATAINPUTSTREAM_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FRAMEDATAINPUTSTREAM_H_
+
+#include <activemq/util/Config.h>
+
+#include <decaf/io/DataInputStream.h>
+
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+namespace utils {
+
+    /**
+     * A DataInputStream that decodes from a single, fully read OpenWire frame held in
+     * memory.  The frame is read from the source stream with one bulk read and the
+     * primitive read methods then load their bytes directly from the frame buffer,
+     * each read is bounds checked against the end of the frame instead of passing
+     * through the chain of buffered and filtered streams below it.
+     *
+     * The marshallers receive this stream through the DataInputStream interface so
+     * no change is needed for them to decode from a frame.  Reading past the end of
+     * the current frame throws an EOFException.
+     *
+     * The frame buffer is reused between frames that fit in MAX_RETAINED_SIZE bytes,
+     * the buffer for a larger frame is freed once the frame has been decoded so that
+     * a single large message doesn't stay allocated for the life of the connection.
+     * The stream is not thread safe.
+     *
+     * @since 3.10.0
+     */
+    class AMQCPP_API FrameDataInputStream : public decaf::io::DataInputStream {
+    public:
+
+        // Largest frame buffer that is kept for reuse once its frame is released.
+        static const int MAX_RETAINED_SIZE;
+
+    private:
+
+        class FrameBuffer;
+
+        // Owned by the base class, which reads any data not read by the methods
+        // overridden here through it.
+        FrameBuffer* frame;
+
+    private:
+
+        FrameDataInputStream(const FrameDataInputStream&);
+        FrameDataInputStream& operator= (const FrameDataInputStream&);
+
+    public:
+
+        FrameDataInputStream();
+
+        virtual ~FrameDataInputStream();
+
+        /**
+         * Reads the next frame of the given size from the source stream, replacing
+         * the current frame along with any of its data that has not been read.
+         *
+         * @param source
+         *      The stream to read the frame from.
+         * @param size
+         *      The size of the frame in bytes, not including its size prefix.
+         *
+         * @throws IOException if the size is negative or an error occurs while reading.
+         * @throws EOFException if the source ends before the whole frame is read.
+         */
+        void readFrame(decaf::io::DataInputStream* source, int size);
+
+        /**
+         * Discards the current frame along with any of its data that has not been read,
+         * freeing the frame buffer if it has grown beyond MAX_RETAINED_SIZE.
+         */
+        void releaseFrame();
+
+        /**
+         * @return the number of bytes of the current frame that have not been read.
+         */
+        int getRemaining() const;
+
+        virtual bool readBoolean();
+
+        virtual char readByte();
+
+        virtual unsigned char readUnsignedByte();
+
+        virtual char readChar();
+
+        virtual double readDouble();
+
+        virtual float readFloat();
+
+        virtual int readInt();
+
+        virtual long long readLong();
+
+        virtual short readShort();
+
+        virtual unsigned short readUnsignedShort();
+
+        virtual std::string readString();
+
+        virtual std::string readUTF();
+
+        virtual void readFully(unsigned char* buffer, int size);
+
+        virtual void readFully(unsigned char* buffer, int size, int offset, int length);
+
+        virtual long long skipBytes(long long num);
+
+    };
+
+}}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FRAMEDATAINPUTSTREAM_H_ */
@@ -178,7 +178,10 @@ namespace stomp {
         void toStream(decaf::io::DataOutputStream* stream) const;
 
         /**
-         * Reads a Stop Frame from a DataInputStream in the Stomp Wire format.
+         * Reads a Stop Frame from a DataInputStream in the Stomp Wire format.  Exactly
+         * one frame is consumed from the stream, which means the command and headers are
+         * read a byte at a time, a StompFrameReader should be used to read a stream of
+         * frames.
          *
          * @param stream - The stream to read the Frame from.
          *
@@ -186,38 +189,6 @@ namespace stomp {
          */
         void fromStream(decaf::io::DataInputStream* stream);
 
-    private:
-
-        /**
-         * Read the Stomp Command from the Frame
-         * @param in - The stream to read the Frame from.
-         * @throws IOException
-         */
-        void readCommandHeader(decaf::io::DataInputStream* in);
-
-        /**
-         * Read all the Stomp Headers for the incoming Frame
-         * @param in - The stream to read the Frame from.
-         * @throws IOException
-         */
-        void readHeaders(decaf::io::DataInputStream* in);
-
-        /**
-         * Reads a Stomp Header line and stores it in the buffer object
-         * @param buffer - reference to a memory buffer to store the read line in.
-         * @param in - The stream to read the Frame from.
-         * @return number of bytes read, zero if there was a problem.
-         * @throws IOException
-         */
-        std::size_t readHeaderLine(std::vector<unsigned char>& buffer, decaf::io::DataInputStream* in);
-
-        /**
-         * Reads the Stomp Body from the Wire and store it in the frame.
-         * @param in - The stream to read the Frame from.
-         * @throws IOException
-         */
-        void readBody(decaf::io::DataInputStream* in);
-
     };
 
 }}}
@@ -0,0 +1,261 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StompFrameReader.h"
+
+#include <activemq/wireformat/stomp/StompCommandConstants.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/lang/Character.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/io/EOFException.h>
+#include <decaf/io/IOException.h>
+
+#include <string.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::stomp;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+const int StompFrameReader::DEFAULT_BUFFER_SIZE = 8192;
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameReader::StompFrameReader() :
+    buffer(DEFAULT_BUFFER_SIZE), position(0), limit(0), readAhead(true) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameReader::StompFrameReader(bool readAhead, int bufferSize) :
+    buffer(), position(0), limit(0), readAhead(readAhead) {
+
+    if (bufferSize <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Buffer size must be greater than zero.");
+    }
+
+    this->buffer.resize((std::size_t) bufferSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameReader::~StompFrameReader() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReader::clear() {
+    this->position = 0;
+    this->limit = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReader::readFrame(StompFrame& frame, decaf::io::DataInputStream* in) {
+
+    if (in == NULL) {
+        throw decaf::io::IOException(__FILE__, __LINE__, "DataInputStream passed is NULL");
+    }
+
+    try {
+        readCommand(frame, in);
+        readHeaders(frame, in);
+        readBody(frame, in);
+    }
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReader::readCommand(StompFrame& frame, decaf::io::DataInputStream* in) {
+
+    while (true) {
+
+        // The command header is formatted just like any other stomp header.
+        std::size_t length = 0;
+        const char* line = readLine(in, length);
+
+        // Ignore all white space before the command, including the blank
+        // lines that may follow the end of the previous frame.
+        for (std::size_t ix = 0; ix < length; ++ix) {
+            if (!Character::isWhitespace(line[ix])) {
+                frame.setCommand(std::string(line + ix, length - ix));
+                return;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReader::readHeaders(StompFrame& frame, decaf::io::DataInputStream* in) {
+
+    while (true) {
+
+        std::size_t length = 0;
+        const char* line = readLine(in, length);
+
+        // An empty line marks the end of the header section.
+        if (length == 0) {
+            return;
+        }
+
+        const char* separator = static_cast<const char*>(::memchr(line, ':', length));
+        if (separator == NULL) {
+            continue;
+        }
+
+        std::string key(line, separator);
+
+        // Only the first occurrence of a repeated header is used.
+        if (!frame.getProperties().hasProperty(key)) {
+            frame.getProperties().setProperty(key, std::string(separator + 1, line + length));
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReader::readBody(StompFrame& frame, decaf::io::DataInputStream* in) {
+
+    std::vector<unsigned char>& body = frame.getBody();
+    body.clear();
+
+    std::size_t contentLength = 0;
+
+    if (frame.hasProperty(StompCommandConstants::HEADER_CONTENTLENGTH)) {
+        string length = frame.getProperty(StompCommandConstants::HEADER_CONTENTLENGTH);
+        contentLength = (std::size_t) (unsigned int) Integer::parseInt(length);
+    }
+
+    if (contentLength != 0) {
+
+        body.resize(contentLength);
+
+        // Take what has already been buffered and read the rest straight into the body.
+        std::size_t buffered = this->limit - this->position;
+        std::size_t copied = buffered < contentLength ? buffered : contentLength;
+
+        if (copied > 0) {
+            ::memcpy(&body[0], &this->buffer[0] + this->position, copied);
+            this->position += copied;
+        }
+
+        if (copied < contentLength) {
+            in->readFully(&body[copied], (int) (contentLength - copied));
+        }
+
+        // Content Length read, now pop the end terminator off.
+        if (this->position == this->limit) {
+            fill(in);
+        }
+
+        if (this->buffer[this->position++] != '\0') {
+            throw decaf::io::IOException(__FILE__, __LINE__, "StompWireFormat::readStompBody: "
+                    "Read Content Length, and no trailing null");
+        }
+
+    } else {
+
+        // Content length was either zero, or not set, so the body runs up to and
+        // includes the first null.
+        while (true) {
+
+            const unsigned char* start = &this->buffer[0] + this->position;
+            std::size_t available = this->limit - this->position;
+            const unsigned char* terminator =
+                static_cast<const unsigned char*>(::memchr(start, '\0', available));
+
+            if (terminator != NULL) {
+                body.insert(body.end(), start, terminator + 1);
+                this->position += (std::size_t) (terminator - start) + 1;
+                return;
+            }
+
+            body.insert(body.end(), start, start + available);
+            this->position = this->limit;
+
+            fill(in);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const char* StompFrameReader::readLine(decaf::io::DataInputStream* in, std::size_t& length) {
+
+    std::size_t scanned = 0;
+
+    while (true) {
+
+        const unsigned char* start = &this->buffer[0] + this->position;
+        std::size_t available = this->limit - this->position;
+
+        const unsigned char* lineFeed =
+            static_cast<const unsigned char*>(::memchr(start + scanned, '\n', available - scanned));
+
+        if (lineFeed != NULL) {
+            length = (std::size_t) (lineFeed - start);
+            this->position += length + 1;
+            return reinterpret_cast<const char*>(start);
+        }
+
+        // The line continues past what has been read, fill moves it to the front
+        // of the buffer so only the newly read bytes need to be scanned.
+        scanned = available;
+        fill(in);
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReader::fill(decaf::io::DataInputStream* in) {
+
+    std::size_t remaining = this->limit - this->position;
+
+    if (this->position > 0) {
+        if (remaining > 0) {
+            ::memmove(&this->buffer[0], &this->buffer[this->position], remaining);
+        }
+
+        this->position = 0;
+        this->limit = remaining;
+    }
+
+    if (this->limit == this->buffer.size()) {
+        this->buffer.resize(this->buffer.size() * 2);
+    }
+
+    if (!this->readAhead) {
+        this->buffer[this->limit++] = (unsigned char) in->readByte();
+        return;
+    }
+
+    int space = (int) (this->buffer.size() - this->limit);
+    int result = 0;
+
+    while (result == 0) {
+        result = in->read(&this->buffer[0], (int) this->buffer.size(), (int) this->limit, space);
+    }
+
+    if (result < 0) {
+        throw EOFException(__FILE__, __LINE__, "StompFrameReader::fill - Reached end of stream.");
+    }
+
+    this->limit += (std::size_t) result;
+}
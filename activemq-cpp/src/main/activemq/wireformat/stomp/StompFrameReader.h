@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_STOMP_STOMPFRAMEREADER_H_
+#define _ACTIVEMQ_WIREFORMAT_STOMP_STOMPFRAMEREADER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/wireformat/stomp/StompFrame.h>
+
+#include <decaf/io/DataInputStream.h>
+
+#include <vector>
+
+namespace activemq {
+namespace wireformat {
+namespace stomp {
+
+    /**
+     * Decodes StompFrames from a DataInputStream a block at a time.  Data is read
+     * into an internal buffer which is scanned for the line and frame terminators,
+     * the command and headers are sliced directly out of that buffer and a body with
+     * a content-length header is read with a single bulk read.
+     *
+     * When read ahead is enabled the reader takes whatever the stream has available,
+     * so bytes belonging to the next frame can be left in its buffer and the same
+     * reader must be used for every frame read from a stream.  With read ahead
+     * disabled the reader consumes exactly one frame from the stream but has to read
+     * the command and headers one byte at a time.
+     *
+     * @since 3.10.0
+     */
+    class AMQCPP_API StompFrameReader {
+    public:
+
+        /**
+         * The default initial size of the read buffer, it grows to fit the longest
+         * header line seen.
+         */
+        static const int DEFAULT_BUFFER_SIZE;
+
+    private:
+
+        std::vector<unsigned char> buffer;
+        std::size_t position;
+        std::size_t limit;
+        bool readAhead;
+
+    private:
+
+        StompFrameReader(const StompFrameReader&);
+        StompFrameReader& operator=(const StompFrameReader&);
+
+    public:
+
+        /**
+         * Creates a reader that reads ahead using the default buffer size.
+         */
+        StompFrameReader();
+
+        /**
+         * Creates a new reader.
+         *
+         * @param readAhead
+         *      Can the reader buffer bytes past the end of the frame being read.
+         * @param bufferSize
+         *      The initial size of the read buffer.
+         *
+         * @throws IllegalArgumentException if the buffer size is not positive.
+         */
+        StompFrameReader(bool readAhead, int bufferSize);
+
+        virtual ~StompFrameReader();
+
+        /**
+         * Reads the next frame from the given stream into the given StompFrame,
+         * blocking until the whole frame has arrived.
+         *
+         * @param frame
+         *      The StompFrame to populate.
+         * @param in
+         *      The stream to read the frame from.
+         *
+         * @throws IOException if an error occurs while reading the frame.
+         * @throws EOFException if the stream ends before the frame is complete.
+         */
+        void readFrame(StompFrame& frame, decaf::io::DataInputStream* in);
+
+        /**
+         * @return the number of bytes read from the stream that belong to frames
+         *         which have not been read yet.
+         */
+        std::size_t getBufferedCount() const {
+            return this->limit - this->position;
+        }
+
+        /**
+         * Discards any buffered bytes, used when the reader is moved to a new stream.
+         */
+        void clear();
+
+    private:
+
+        void readCommand(StompFrame& frame, decaf::io::DataInputStream* in);
+        void readHeaders(StompFrame& frame, decaf::io::DataInputStream* in);
+        void readBody(StompFrame& frame, decaf::io::DataInputStream* in);
+
+        // Returns the start of the next line in the buffer and its length without the
+        // line feed, the line is only valid until the next read from the buffer.
+        const char* readLine(decaf::io::DataInputStream* in, std::size_t& length);
+
+        // Moves unread bytes to the front of the buffer and reads more data after them.
+        void fill(decaf::io::DataInputStream* in);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_STOMP_STOMPFRAMEREADER_H_ */
@@ -18,6 +18,7 @@
 #include "StompWireFormat.h"
 
 #include <activemq/wireformat/stomp/StompFrame.h>
+#include <activemq/wireformat/stomp/StompFrameReader.h>
 #include <activemq/wireformat/stomp/StompHelper.h>
 #include <activemq/wireformat/stomp/StompCommandConstants.h>
 #include <activemq/core/ActiveMQConstants.h>
@@ -83,13 +84,25 @@ namespace stomp {
         // Prefix used to address Temporary Queues (default is /temp-queue/
         std::string tempQueuePrefix;
 
+        // Decodes incoming frames, it can hold bytes of the next frame read from
+        // the stream it was last used with.
+        StompFrameReader frameReader;
+        decaf::io::DataInputStream* frameReaderStream;
+
+    private:
+
+        StompWireformatProperties(const StompWireformatProperties&);
+        StompWireformatProperties& operator=(const StompWireformatProperties&);
+
     public:
 
         StompWireformatProperties() : connectResponseId(-1),
                                       topicPrefix("/topic/"),
                                       queuePrefix("/queue/"),
                                       tempTopicPrefix("/temp-topic/"),
-                                      tempQueuePrefix("/temp-queue/") {
+                                      tempQueuePrefix("/temp-queue/"),
+                                      frameReader(),
+                                      frameReaderStream(NULL) {
 
         }
 
@@ -188,8 +201,14 @@ Pointer<Command> StompWireFormat::unmarshal(const activemq::transport::Transport
         // Create a new Frame for reading to.
         frame.reset(new StompFrame());
 
-        // Read the command header.
-        frame->fromStream(in);
+        // Bytes buffered from some other stream don't belong to this one.
+        if (this->properties->frameReaderStream != in) {
+            this->properties->frameReader.clear();
+            this->properties->frameReaderStream = in;
+        }
+
+        // Read the whole frame.
+        this->properties->frameReader.readFrame(*frame, in);
 
         // Return the Command.
         const std::string commandId = frame->getCommand();
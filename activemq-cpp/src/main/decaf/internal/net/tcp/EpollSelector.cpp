@@ -0,0 +1,526 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EpollSelector.h"
+
+#include <decaf/internal/net/Network.h>
+#include <decaf/internal/net/SocketFileDescriptor.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/net/SocketError.h>
+#include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::internal::net::tcp;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::net;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+EpollSelector* EpollSelector::defaultSelector = NULL;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class ShutdownTask : public decaf::lang::Runnable {
+    private:
+
+        EpollSelector** defaultRef;
+
+    private:
+
+        ShutdownTask(const ShutdownTask&);
+        ShutdownTask& operator= (const ShutdownTask&);
+
+    public:
+
+        ShutdownTask(EpollSelector** defaultRef) : defaultRef(defaultRef) {}
+        virtual ~ShutdownTask() {}
+
+        virtual void run() {
+            *defaultRef = NULL;
+        }
+    };
+
+#ifdef HAVE_SYS_EPOLL_H
+
+    /**
+     * One thread of the selector along with the epoll instance it waits on and the
+     * listeners of the sockets registered with it.
+     */
+    class SelectorThread : public Runnable {
+    private:
+
+        static const int MAX_EVENTS = 64;
+
+        int poller;
+
+        // Only signaled on shutdown, it stays readable so the thread can't miss it.
+        int wakeup;
+
+        Mutex mutex;
+        std::map<int, SelectionListener*> listeners;
+        SelectionListener* current;
+        bool closed;
+
+        Pointer<Thread> thread;
+
+    private:
+
+        SelectorThread(const SelectorThread&);
+        SelectorThread& operator= (const SelectorThread&);
+
+    public:
+
+        SelectorThread(const std::string& name) : poller(-1), wakeup(-1), mutex(), listeners(),
+                                                  current(NULL), closed(false), thread() {
+
+            this->poller = ::epoll_create(MAX_EVENTS);
+            this->wakeup = ::eventfd(0, EFD_NONBLOCK);
+
+            struct epoll_event event;
+            ::memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN;
+            event.data.fd = this->wakeup;
+
+            if (this->poller == -1 || this->wakeup == -1 ||
+                ::epoll_ctl(this->poller, EPOLL_CTL_ADD, this->wakeup, &event) == -1) {
+
+                std::string error = SocketError::getErrorString();
+                closeDescriptors();
+                throw IOException(__FILE__, __LINE__, "Failed to create the selector - %s", error.c_str());
+            }
+
+            this->thread.reset(new Thread(this, name));
+            this->thread->start();
+        }
+
+        virtual ~SelectorThread() {
+            try {
+                shutdown();
+            }
+            DECAF_CATCHALL_NOTHROW()
+
+            closeDescriptors();
+        }
+
+        int size() {
+            synchronized(&this->mutex) {
+                return (int) this->listeners.size();
+            }
+
+            return 0;
+        }
+
+        void add(int descriptor, SelectionListener* listener) {
+
+            synchronized(&this->mutex) {
+
+                if (this->closed) {
+                    throw IllegalStateException(__FILE__, __LINE__, "The selector has been shut down.");
+                }
+
+                struct epoll_event event;
+                ::memset(&event, 0, sizeof(event));
+                event.events = EPOLLIN | EPOLLRDHUP;
+                event.data.fd = descriptor;
+
+                if (::epoll_ctl(this->poller, EPOLL_CTL_ADD, descriptor, &event) == -1) {
+                    throw IOException(__FILE__, __LINE__,
+                        "Failed to register the socket - %s", SocketError::getErrorString().c_str());
+                }
+
+                this->listeners[descriptor] = listener;
+            }
+        }
+
+        void remove(int descriptor, SelectionListener* listener) {
+
+            synchronized(&this->mutex) {
+
+                std::map<int, SelectionListener*>::iterator iter = this->listeners.find(descriptor);
+                if (iter != this->listeners.end() && iter->second == listener) {
+                    this->listeners.erase(iter);
+                    ::epoll_ctl(this->poller, EPOLL_CTL_DEL, descriptor, NULL);
+                }
+
+                // The listener may be removing itself from within its callback.
+                if (Thread::currentThread() != this->thread.get()) {
+                    while (this->current == listener) {
+                        this->mutex.wait();
+                    }
+                }
+            }
+        }
+
+        void shutdown() {
+
+            synchronized(&this->mutex) {
+                if (this->closed) {
+                    return;
+                }
+
+                this->closed = true;
+                this->listeners.clear();
+            }
+
+            ::eventfd_write(this->wakeup, 1);
+
+            if (Thread::currentThread() != this->thread.get()) {
+                this->thread->join();
+            }
+        }
+
+        virtual void run() {
+
+            struct epoll_event events[MAX_EVENTS];
+
+            while (true) {
+
+                int count = ::epoll_wait(this->poller, events, MAX_EVENTS, -1);
+
+                if (count == -1 && errno != EINTR) {
+                    return;
+                }
+
+                for (int i = 0; i < count; ++i) {
+
+                    SelectionListener* listener = NULL;
+
+                    // An event collected before its socket was removed finds no listener.
+                    synchronized(&this->mutex) {
+
+                        if (this->closed) {
+                            return;
+                        }
+
+                        std::map<int, SelectionListener*>::iterator iter = this->listeners.find(events[i].data.fd);
+                        if (iter != this->listeners.end()) {
+                            listener = iter->second;
+                            this->current = listener;
+                        }
+                    }
+
+                    if (listener == NULL) {
+                        continue;
+                    }
+
+                    try {
+                        listener->onReadable();
+                    } catch (...) {
+                    }
+
+                    synchronized(&this->mutex) {
+                        this->current = NULL;
+                        this->mutex.notifyAll();
+                    }
+                }
+
+                synchronized(&this->mutex) {
+                    if (this->closed) {
+                        return;
+                    }
+                }
+            }
+        }
+
+    private:
+
+        void closeDescriptors() {
+
+            if (this->poller != -1) {
+                ::close(this->poller);
+                this->poller = -1;
+            }
+
+            if (this->wakeup != -1) {
+                ::close(this->wakeup);
+                this->wakeup = -1;
+            }
+        }
+    };
+
+#endif
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+
+    class EpollSelectorImpl {
+    private:
+
+        EpollSelectorImpl(const EpollSelectorImpl&);
+        EpollSelectorImpl& operator= (const EpollSelectorImpl&);
+
+    public:
+
+#ifdef HAVE_SYS_EPOLL_H
+        typedef std::pair<SelectorThread*, int> Registration;
+
+        Mutex mutex;
+        std::vector<SelectorThread*> threads;
+        std::map<SelectionListener*, Registration> registrations;
+        bool closed;
+
+        EpollSelectorImpl() : mutex(), threads(), registrations(), closed(false) {
+        }
+
+        ~EpollSelectorImpl() {
+            std::vector<SelectorThread*>::iterator iter = this->threads.begin();
+            for (; iter != this->threads.end(); ++iter) {
+                delete *iter;
+            }
+        }
+#else
+        EpollSelectorImpl() {
+        }
+#endif
+    };
+
+}}}}
+
+#ifdef HAVE_SYS_EPOLL_H
+
+////////////////////////////////////////////////////////////////////////////////
+EpollSelector::EpollSelector(int threads) : impl(NULL) {
+
+    if (threads < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "EpollSelector needs at least one thread: %d", threads);
+    }
+
+    std::auto_ptr<EpollSelectorImpl> selector(new EpollSelectorImpl());
+
+    for (int i = 0; i < threads; ++i) {
+        selector->threads.push_back(new SelectorThread("EpollSelector Thread " + Integer::toString(i)));
+    }
+
+    this->impl = selector.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+EpollSelector::~EpollSelector() {
+    try {
+        shutdown();
+    }
+    DECAF_CATCHALL_NOTHROW()
+
+    try {
+        delete this->impl;
+    }
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSelector::add(const SocketImpl* socket, SelectionListener* listener) {
+
+    try {
+
+        if (socket == NULL || listener == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "EpollSelector::add - the socket and listener can't be NULL");
+        }
+
+        const SocketFileDescriptor* descriptor =
+            dynamic_cast<const SocketFileDescriptor*>(socket->getFileDescriptor());
+
+        if (descriptor == NULL) {
+            throw IOException(__FILE__, __LINE__, "EpollSelector::add - the socket is not connected");
+        }
+
+        synchronized(&this->impl->mutex) {
+
+            if (this->impl->closed) {
+                throw IllegalStateException(__FILE__, __LINE__, "EpollSelector::add - the selector has been shut down");
+            }
+
+            if (this->impl->registrations.find(listener) != this->impl->registrations.end()) {
+                throw IllegalStateException(__FILE__, __LINE__, "EpollSelector::add - the listener is already registered");
+            }
+
+            SelectorThread* target = this->impl->threads.front();
+            int targetSize = target->size();
+
+            std::vector<SelectorThread*>::iterator iter = this->impl->threads.begin();
+            for (++iter; iter != this->impl->threads.end() && targetSize > 0; ++iter) {
+                int size = (*iter)->size();
+                if (size < targetSize) {
+                    target = *iter;
+                    targetSize = size;
+                }
+            }
+
+            target->add((int) descriptor->getValue(), listener);
+            this->impl->registrations[listener] = EpollSelectorImpl::Registration(target, (int) descriptor->getValue());
+        }
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IllegalStateException)
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSelector::remove(SelectionListener* listener) {
+
+    EpollSelectorImpl::Registration registration(NULL, -1);
+
+    synchronized(&this->impl->mutex) {
+
+        std::map<SelectionListener*, EpollSelectorImpl::Registration>::iterator iter =
+            this->impl->registrations.find(listener);
+
+        if (iter == this->impl->registrations.end()) {
+            return;
+        }
+
+        registration = iter->second;
+        this->impl->registrations.erase(iter);
+    }
+
+    // Waiting for a running callback is done outside the selector lock so other
+    // sockets can still be added and removed meanwhile.
+    registration.first->remove(registration.second, listener);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSelector::shutdown() {
+
+    synchronized(&this->impl->mutex) {
+        if (this->impl->closed) {
+            return;
+        }
+
+        this->impl->closed = true;
+        this->impl->registrations.clear();
+    }
+
+    std::vector<SelectorThread*>::iterator iter = this->impl->threads.begin();
+    for (; iter != this->impl->threads.end(); ++iter) {
+        (*iter)->shutdown();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int EpollSelector::getThreadCount() const {
+    return (int) this->impl->threads.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int EpollSelector::getSocketCount() const {
+
+    synchronized(&this->impl->mutex) {
+        return (int) this->impl->registrations.size();
+    }
+
+    return 0;
+}
+
+#else
+
+////////////////////////////////////////////////////////////////////////////////
+EpollSelector::EpollSelector(int threads DECAF_UNUSED) : impl(NULL) {
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "Epoll based selectors are not supported on this platform.");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+EpollSelector::~EpollSelector() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSelector::add(const SocketImpl* socket DECAF_UNUSED, SelectionListener* listener DECAF_UNUSED) {
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "Epoll based selectors are not supported on this platform.");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSelector::remove(SelectionListener* listener DECAF_UNUSED) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSelector::shutdown() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int EpollSelector::getThreadCount() const {
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int EpollSelector::getSocketCount() const {
+    return 0;
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+EpollSelector* EpollSelector::getDefault() {
+
+    Network* networkRuntime = Network::getNetworkRuntime();
+
+    synchronized(networkRuntime->getRuntimeLock()) {
+
+        if (defaultSelector == NULL) {
+            int processors = System::availableProcessors();
+            defaultSelector = new EpollSelector(processors > 0 ? processors : 1);
+            networkRuntime->addAsResource(defaultSelector);
+            networkRuntime->addShutdownTask(new ShutdownTask(&defaultSelector));
+        }
+    }
+
+    return defaultSelector;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool EpollSelector::isSupported() {
+
+#ifdef HAVE_SYS_EPOLL_H
+    return true;
+#else
+    return false;
+#endif
+}
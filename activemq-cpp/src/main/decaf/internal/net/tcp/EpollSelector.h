@@ -0,0 +1,138 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_TCP_EPOLLSELECTOR_H_
+#define _DECAF_INTERNAL_NET_TCP_EPOLLSELECTOR_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/net/SocketImpl.h>
+#include <decaf/internal/net/tcp/SelectionListener.h>
+
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+
+    class EpollSelectorImpl;
+
+    /**
+     * Waits for input on many sockets with a small fixed number of threads.  Each
+     * thread has its own epoll instance, a socket is assigned to the thread with the
+     * fewest sockets when it is added and its SelectionListener is always called on
+     * that thread, so the listener never runs concurrently with itself.
+     *
+     * Listeners are expected to read the available data without blocking, which
+     * requires a non-blocking socket such as the EpollSocket.  A listener that blocks
+     * holds up every other socket that shares its thread.
+     *
+     * @since 3.10.0
+     */
+    class DECAF_API EpollSelector {
+    private:
+
+        EpollSelectorImpl* impl;
+
+        static EpollSelector* defaultSelector;
+
+    private:
+
+        EpollSelector(const EpollSelector&);
+        EpollSelector& operator=(const EpollSelector&);
+
+    public:
+
+        /**
+         * Creates a new EpollSelector and starts its threads.
+         *
+         * @param threads
+         *      The number of threads that wait on the sockets, at least one.
+         *
+         * @throws IllegalArgumentException if threads is less than one.
+         * @throws UnsupportedOperationException if epoll is not available on this platform.
+         * @throws IOException if the epoll instances can't be created.
+         */
+        EpollSelector(int threads);
+
+        virtual ~EpollSelector();
+
+        /**
+         * Starts calling the given listener whenever the socket has input.  The socket
+         * must stay open until the listener has been removed.
+         *
+         * @param socket
+         *      The connected socket to wait on.
+         * @param listener
+         *      The listener to call, not owned by the selector.
+         *
+         * @throws NullPointerException if the socket or listener is NULL.
+         * @throws IllegalStateException if the listener is already registered or the
+         *         selector has been shut down.
+         * @throws IOException if the socket is not connected or can't be registered.
+         */
+        void add(const decaf::net::SocketImpl* socket, SelectionListener* listener);
+
+        /**
+         * Stops calling the given listener.  When called from a thread other than the
+         * listener's selector thread this waits for a call to the listener that is in
+         * progress to return, so the listener can be destroyed once this returns.
+         * Removing a listener that isn't registered does nothing.
+         *
+         * @param listener
+         *      The listener to remove.
+         */
+        void remove(SelectionListener* listener);
+
+        /**
+         * Stops the selector threads and waits for them to exit, listeners that are
+         * still registered are no longer called.
+         */
+        void shutdown();
+
+        /**
+         * @return the number of threads that wait on the sockets.
+         */
+        int getThreadCount() const;
+
+        /**
+         * @return the number of sockets currently registered.
+         */
+        int getSocketCount() const;
+
+    public:
+
+        /**
+         * Gets the EpollSelector shared by the whole process, it is created with one
+         * thread per available processor on first use and is destroyed when the Decaf
+         * runtime shuts down.
+         *
+         * @return the shared EpollSelector.
+         *
+         * @throws UnsupportedOperationException if epoll is not available on this platform.
+         */
+        static EpollSelector* getDefault();
+
+        /**
+         * @return true if the platform supports the epoll based selector.
+         */
+        static bool isSupported();
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_NET_TCP_EPOLLSELECTOR_H_ */
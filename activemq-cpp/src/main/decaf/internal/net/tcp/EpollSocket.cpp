@@ -0,0 +1,981 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EpollSocket.h"
+
+#ifdef HAVE_SYS_EPOLL_H
+
+#include <decaf/internal/net/SocketFileDescriptor.h>
+
+#include <decaf/net/ConnectException.h>
+#include <decaf/net/SocketError.h>
+#include <decaf/net/SocketOptions.h>
+#include <decaf/net/SocketTimeoutException.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::internal::net::tcp;
+using namespace decaf::net;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class EpollSocketInputStream : public InputStream {
+    private:
+
+        EpollSocket* socket;
+        volatile bool closed;
+
+    private:
+
+        EpollSocketInputStream(const EpollSocketInputStream&);
+        EpollSocketInputStream& operator= (const EpollSocketInputStream&);
+
+    public:
+
+        EpollSocketInputStream(EpollSocket* socket) : InputStream(), socket(socket), closed(false) {
+        }
+
+        virtual ~EpollSocketInputStream() {
+        }
+
+        virtual int available() const {
+
+            if (this->closed) {
+                throw IOException(__FILE__, __LINE__, "The stream is closed");
+            }
+
+            return this->socket->available();
+        }
+
+        virtual void close() {
+
+            if (this->closed) {
+                return;
+            }
+
+            try {
+                this->closed = true;
+                this->socket->close();
+            }
+            DECAF_CATCH_RETHROW(IOException)
+            DECAF_CATCHALL_THROW(IOException)
+        }
+
+    protected:
+
+        virtual int doReadByte() {
+
+            if (this->closed) {
+                throw IOException(__FILE__, __LINE__, "The stream is closed");
+            }
+
+            unsigned char buffer[1];
+            int result = this->socket->read(buffer, 1, 0, 1);
+            return result == -1 ? result : buffer[0];
+        }
+
+        virtual int doReadArrayBounded(unsigned char* buffer, int size, int offset, int length) {
+
+            if (this->closed) {
+                throw IOException(__FILE__, __LINE__, "The stream is closed");
+            }
+
+            return this->socket->read(buffer, size, offset, length);
+        }
+    };
+
+    class EpollSocketOutputStream : public OutputStream {
+    private:
+
+        EpollSocket* socket;
+        volatile bool closed;
+
+    private:
+
+        EpollSocketOutputStream(const EpollSocketOutputStream&);
+        EpollSocketOutputStream& operator= (const EpollSocketOutputStream&);
+
+    public:
+
+        EpollSocketOutputStream(EpollSocket* socket) : OutputStream(), socket(socket), closed(false) {
+        }
+
+        virtual ~EpollSocketOutputStream() {
+        }
+
+        virtual void close() {
+
+            if (this->closed) {
+                return;
+            }
+
+            try {
+                this->closed = true;
+                this->socket->close();
+            }
+            DECAF_CATCH_RETHROW(IOException)
+            DECAF_CATCHALL_THROW(IOException)
+        }
+
+    protected:
+
+        virtual void doWriteByte(unsigned char c) {
+            this->doWriteArrayBounded(&c, 1, 0, 1);
+        }
+
+        virtual void doWriteArrayBounded(const unsigned char* buffer, int size, int offset, int length) {
+
+            if (this->closed) {
+                throw IOException(__FILE__, __LINE__, "This Stream has been closed.");
+            }
+
+            this->socket->write(buffer, size, offset, length);
+        }
+    };
+
+    void checkBounds(const unsigned char* buffer, int size, int offset, int length) {
+
+        if (buffer == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "Buffer passed is Null");
+        }
+
+        if (size < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "size parameter out of Bounds: %d.", size);
+        }
+
+        if (offset > size || offset < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "offset parameter out of Bounds: %d.", offset);
+        }
+
+        if (length < 0 || length > size - offset) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "length parameter out of Bounds: %d.", length);
+        }
+    }
+
+    // Resolves a host name or address literal to its first IPv4 address, the port
+    // is left for the caller to fill in.
+    void resolve(const std::string& host, struct sockaddr_in* address) {
+
+        struct addrinfo hints;
+        ::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+
+        struct addrinfo* addresses = NULL;
+        int result = ::getaddrinfo(host.c_str(), NULL, &hints, &addresses);
+        if (result != 0 || addresses == NULL) {
+            throw SocketException(__FILE__, __LINE__,
+                "Unable to resolve host %s - %s", host.c_str(), ::gai_strerror(result));
+        }
+
+        ::memcpy(address, addresses->ai_addr, sizeof(struct sockaddr_in));
+        ::freeaddrinfo(addresses);
+    }
+
+    void closeDescriptor(int& descriptor) {
+        if (descriptor != -1) {
+            ::close(descriptor);
+            descriptor = -1;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+
+    class EpollSocketImpl {
+    private:
+
+        EpollSocketImpl(const EpollSocketImpl&);
+        EpollSocketImpl& operator= (const EpollSocketImpl&);
+
+    public:
+
+        int socket;
+
+        // Readers and writers wait on separate epoll instances so that a socket
+        // with unread data doesn't keep waking a thread that is waiting to write.
+        int readPoller;
+        int writePoller;
+
+        // Registered with both pollers and signaled on close to wake any waiters.
+        int wakeup;
+
+        InputStream* inputStream;
+        OutputStream* outputStream;
+        bool inputShutdown;
+        bool outputShutdown;
+        AtomicBoolean closed;
+        bool connected;
+        int soTimeout;
+        int soLinger;
+
+        EpollSocketImpl() : socket(-1),
+                            readPoller(-1),
+                            writePoller(-1),
+                            wakeup(-1),
+                            inputStream(NULL),
+                            outputStream(NULL),
+                            inputShutdown(false),
+                            outputShutdown(false),
+                            closed(false),
+                            connected(false),
+                            soTimeout(-1),
+                            soLinger(-1) {
+        }
+    };
+
+}}}}
+
+////////////////////////////////////////////////////////////////////////////////
+EpollSocket::EpollSocket() : impl(new EpollSocketImpl) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+EpollSocket::~EpollSocket() {
+
+    try {
+        close();
+    }
+    DECAF_CATCHALL_NOTHROW()
+
+    try {
+        delete this->impl->inputStream;
+        delete this->impl->outputStream;
+
+        // Nothing can be waiting on the descriptors anymore so they can be released.
+        closeDescriptor(this->impl->readPoller);
+        closeDescriptor(this->impl->writePoller);
+        closeDescriptor(this->impl->wakeup);
+        closeDescriptor(this->impl->socket);
+
+        delete this->impl;
+    }
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocket::initialize(int descriptor) {
+
+    this->impl->socket = descriptor;
+    this->fd = new SocketFileDescriptor(descriptor);
+
+    if (::fcntl(descriptor, F_SETFL, ::fcntl(descriptor, F_GETFL, 0) | O_NONBLOCK) == -1) {
+        throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+    }
+
+    this->impl->readPoller = ::epoll_create(2);
+    this->impl->writePoller = ::epoll_create(2);
+    this->impl->wakeup = ::eventfd(0, EFD_NONBLOCK);
+
+    if (this->impl->readPoller == -1 || this->impl->writePoller == -1 || this->impl->wakeup == -1) {
+        throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+    }
+
+    struct epoll_event event;
+    ::memset(&event, 0, sizeof(event));
+
+    event.events = EPOLLIN;
+    event.data.fd = this->impl->wakeup;
+    if (::epoll_ctl(this->impl->readPoller, EPOLL_CTL_ADD, this->impl->wakeup, &event) == -1 ||
+        ::epoll_ctl(this->impl->writePoller, EPOLL_CTL_ADD, this->impl->wakeup, &event) == -1) {
+        throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+    }
+
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.fd = descriptor;
+    if (::epoll_ctl(this->impl->readPoller, EPOLL_CTL_ADD, descriptor, &event) == -1) {
+        throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+    }
+
+    event.events = EPOLLOUT;
+    if (::epoll_ctl(this->impl->writePoller, EPOLL_CTL_ADD, descriptor, &event) == -1) {
+        throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool EpollSocket::await(bool forWrite, int timeout) const {
+
+    int poller = forWrite ? this->impl->writePoller : this->impl->readPoller;
+    long long deadline = timeout > 0 ? System::currentTimeMillis() + timeout : 0;
+
+    struct epoll_event events[2];
+
+    while (true) {
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__, "The connection is closed");
+        }
+
+        int remaining = -1;
+        if (timeout > 0) {
+            remaining = (int) (deadline - System::currentTimeMillis());
+            if (remaining <= 0) {
+                return false;
+            }
+        }
+
+        int result = ::epoll_wait(poller, events, 2, remaining);
+
+        if (result == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+        }
+
+        // The wakeup descriptor stays signaled once the socket is closed, that
+        // case is picked up by the closed check at the top of the loop.
+        for (int i = 0; i < result; ++i) {
+            if (events[i].data.fd == this->impl->socket) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocket::create() {
+
+    try {
+
+        if (this->impl->socket != -1) {
+            throw IOException(__FILE__, __LINE__, "The System level socket has already been created.");
+        }
+
+        int descriptor = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (descriptor == -1) {
+            throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+        }
+
+        initialize(descriptor);
+    }
+    DECAF_CATCH_RETHROW(decaf::io::IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    DECAF_CATCHALL_THROW(decaf::io::IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocket::accept(SocketImpl* socket) {
+
+    try {
+
+        if (socket == NULL) {
+            throw IOException(__FILE__, __LINE__, "SocketImpl instance passed was null.");
+        }
+
+        EpollSocket* epollSocket = dynamic_cast<EpollSocket*>(socket);
+        if (epollSocket == NULL) {
+            throw IOException(__FILE__, __LINE__, "SocketImpl instance passed was not an EpollSocket.");
+        }
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__, "The Socket is closed.");
+        }
+
+        while (true) {
+
+            int descriptor = ::accept(this->impl->socket, NULL, NULL);
+
+            if (descriptor != -1) {
+                epollSocket->initialize(descriptor);
+                epollSocket->impl->connected = true;
+                return;
+            }
+
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                throw SocketException(__FILE__, __LINE__,
+                    "ServerSocket::accept - %s", SocketError::getErrorString().c_str());
+            }
+
+            if (!await(false, this->impl->soTimeout)) {
+                throw SocketTimeoutException(__FILE__, __LINE__, "ServerSocket::accept - timed out");
+            }
+        }
+    }
+    DECAF_CATCH_RETHROW(decaf::io::IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    DECAF_CATCHALL_THROW(decaf::io::IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+InputStream* EpollSocket::getInputStream() {
+
+    if (this->impl->socket == -1 || isClosed()) {
+        throw IOException(__FILE__, __LINE__, "The Socket is not Connected.");
+    }
+
+    if (this->impl->inputShutdown) {
+        throw IOException(__FILE__, __LINE__, "Input has been shut down on this Socket.");
+    }
+
+    if (this->impl->inputStream == NULL) {
+        this->impl->inputStream = new EpollSocketInputStream(this);
+    }
+
+    return this->impl->inputStream;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OutputStream* EpollSocket::getOutputStream() {
+
+    if (this->impl->socket == -1 || isClosed()) {
+        throw IOException(__FILE__, __LINE__, "The Socket is not Connected.");
+    }
+
+    if (this->impl->outputShutdown) {
+        throw IOException(__FILE__, __LINE__, "Output has been shut down on this Socket.");
+    }
+
+    if (this->impl->outputStream == NULL) {
+        this->impl->outputStream = new EpollSocketOutputStream(this);
+    }
+
+    return this->impl->outputStream;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocket::bind(const std::string& ipaddress, int port) {
+
+    try {
+
+        if (port < 0 || port > 65535) {
+            throw IllegalArgumentException(__FILE__, __LINE__, "Given port is out of range: %d", port);
+        }
+
+        if (this->impl->socket == -1) {
+            throw IOException(__FILE__, __LINE__, "The socket was not yet created.");
+        }
+
+        struct sockaddr_in address;
+        ::memset(&address, 0, sizeof(address));
+
+        if (ipaddress.empty()) {
+            address.sin_addr.s_addr = htonl(INADDR_ANY);
+        } else {
+            resolve(ipaddress, &address);
+        }
+
+        address.sin_family = AF_INET;
+        address.sin_port = htons((unsigned short) port);
+
+        int reuse = 1;
+        ::setsockopt(this->impl->socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        if (::bind(this->impl->socket, (struct sockaddr*) &address, sizeof(address)) == -1) {
+            std::string error = SocketError::getErrorString();
+            close();
+            throw SocketException(__FILE__, __LINE__, "ServerSocket::bind - %s", error.c_str());
+        }
+
+        if (port != 0) {
+            this->localPort = port;
+        } else {
+            socklen_t length = sizeof(address);
+            if (::getsockname(this->impl->socket, (struct sockaddr*) &address, &length) == -1) {
+                throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+            }
+            this->localPort = ntohs(address.sin_port);
+        }
+    }
+    DECAF_CATCH_RETHROW(decaf::io::IOException)
+    DECAF_CATCH_RETHROW(IllegalArgumentException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    DECAF_CATCHALL_THROW(decaf::io::IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocket::connect(const std::string& hostname, int port, int timeout) {
+
+    try {
+
+        if (port < 0 || port > 65535) {
+            throw IllegalArgumentException(__FILE__, __LINE__, "Given port is out of range: %d", port);
+        }
+
+        if (this->impl->socket == -1) {
+            throw IOException(__FILE__, __LINE__, "The socket was not yet created.");
+        }
+
+        struct sockaddr_in address;
+        resolve(hostname, &address);
+        address.sin_port = htons((unsigned short) port);
+
+        int result = 0;
+        do {
+            result = ::connect(this->impl->socket, (struct sockaddr*) &address, sizeof(address));
+        } while (result == -1 && errno == EINTR);
+
+        if (result == -1) {
+
+            if (errno != EINPROGRESS) {
+                throw ConnectException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+            }
+
+            // The socket becomes writable once the connection attempt completes,
+            // whether it succeeded or not.
+            if (!await(true, timeout)) {
+                throw SocketTimeoutException(__FILE__, __LINE__, "Timed out connecting to %s:%d", hostname.c_str(), port);
+            }
+
+            int error = 0;
+            socklen_t length = sizeof(error);
+            ::getsockopt(this->impl->socket, SOL_SOCKET, SO_ERROR, &error, &length);
+
+            if (error != 0) {
+                throw ConnectException(__FILE__, __LINE__, "%s", ::strerror(error));
+            }
+        }
+
+        // Now that we connected, cache the port value for later lookups.
+        this->port = port;
+        this->impl->connected = true;
+
+    } catch (IOException& ex) {
+        ex.setMark(__FILE__, __LINE__);
+        try {
+            close();
+        } catch (lang::Exception& cx) { /* Absorb */
+        }
+        throw;
+    } catch (IllegalArgumentException& ex) {
+        ex.setMark(__FILE__, __LINE__);
+        try {
+            close();
+        } catch (lang::Exception& cx) { /* Absorb */
+        }
+        throw;
+    } catch (Exception& ex) {
+        try {
+            close();
+        } catch (lang::Exception& cx) { /* Absorb */
+        }
+        throw SocketException(ex.clone());
+    } catch (...) {
+        try {
+            close();
+        } catch (lang::Exception& cx) { /* Absorb */
+        }
+        throw SocketException(__FILE__, __LINE__, "EpollSocket::connect() - caught unknown exception");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string EpollSocket::getLocalAddress() const {
+
+    if (!isClosed() && this->impl->socket != -1) {
+
+        struct sockaddr_in address;
+        socklen_t length = sizeof(address);
+
+        if (::getsockname(this->impl->socket, (struct sockaddr*) &address, &length) == 0) {
+            char buffer[INET_ADDRSTRLEN] = { 0 };
+            if (::inet_ntop(AF_INET, &address.sin_addr, buffer, sizeof(buffer)) != NULL) {
+                return std::string(buffer);
+            }
+        }
+    }
+
+    return "0.0.0.0";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocket::listen(int backlog) {
+
+    try {
+
+        if (isClosed() || this->impl->socket == -1) {
+            throw IOException(__FILE__, __LINE__, "The stream is closed");
+        }
+
+        if (::listen(this->impl->socket, backlog) == -1) {
+            std::string error = SocketError::getErrorString();
+            close();
+            throw SocketException(__FILE__, __LINE__, "Error on Listen - %s", error.c_str());
+        }
+    }
+    DECAF_CATCH_RETHROW(decaf::io::IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    DECAF_CATCHALL_THROW(decaf::io::IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int EpollSocket::available() {
+
+    if (isClosed()) {
+        throw IOException(__FILE__, __LINE__, "The stream is closed");
+    }
+
+    int numBytes = 0;
+    if (::ioctl(this->impl->socket, FIONREAD, &numBytes) == -1) {
+        throw IOException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+    }
+
+    return numBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocket::close() {
+
+    try {
+
+        if (this->impl->closed.compareAndSet(false, true)) {
+            this->impl->connected = false;
+
+            if (this->impl->inputStream != NULL) {
+                this->impl->inputStream->close();
+            }
+
+            if (this->impl->outputStream != NULL) {
+                this->impl->outputStream->close();
+            }
+
+            if (this->impl->socket != -1) {
+
+                if (this->impl->soLinger > 0) {
+                    struct linger linger;
+                    linger.l_onoff = 1;
+                    linger.l_linger = this->impl->soLinger;
+                    ::setsockopt(this->impl->socket, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+                }
+
+                ::shutdown(this->impl->socket, SHUT_RDWR);
+
+                // Wake every thread blocked in a read, write or accept, the descriptors
+                // themselves are released when this object is destroyed.
+                eventfd_write(this->impl->wakeup, 1);
+
+                delete this->fd;
+                this->fd = NULL;
+                this->port = 0;
+                this->localPort = 0;
+            }
+        }
+    }
+    DECAF_CATCH_RETHROW(decaf::io::IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    DECAF_CATCHALL_THROW(decaf::io::IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocket::shutdownInput() {
+
+    if (isClosed()) {
+        throw IOException(__FILE__, __LINE__, "The stream is closed");
+    }
+
+    this->impl->inputShutdown = true;
+    ::shutdown(this->impl->socket, SHUT_RD);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocket::shutdownOutput() {
+
+    if (isClosed()) {
+        throw IOException(__FILE__, __LINE__, "The stream is closed");
+    }
+
+    this->impl->outputShutdown = true;
+    ::shutdown(this->impl->socket, SHUT_WR);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int EpollSocket::getOption(int option) const {
+
+    try {
+
+        if (isClosed() || this->impl->socket == -1) {
+            throw IOException(__FILE__, __LINE__, "The Socket is closed.");
+        }
+
+        if (option == SocketOptions::SOCKET_OPTION_TIMEOUT) {
+            return this->impl->soTimeout;
+        } else if (option == SocketOptions::SOCKET_OPTION_LINGER) {
+            return this->impl->soLinger;
+        }
+
+        int level = SOL_SOCKET;
+        int name = 0;
+
+        if (option == SocketOptions::SOCKET_OPTION_REUSEADDR) {
+            name = SO_REUSEADDR;
+        } else if (option == SocketOptions::SOCKET_OPTION_SNDBUF) {
+            name = SO_SNDBUF;
+        } else if (option == SocketOptions::SOCKET_OPTION_RCVBUF) {
+            name = SO_RCVBUF;
+        } else if (option == SocketOptions::SOCKET_OPTION_TCP_NODELAY) {
+            level = IPPROTO_TCP;
+            name = TCP_NODELAY;
+        } else if (option == SocketOptions::SOCKET_OPTION_KEEPALIVE) {
+            name = SO_KEEPALIVE;
+        } else {
+            throw IOException(__FILE__, __LINE__, "Socket Option is not valid for this Socket type.");
+        }
+
+        int value = 0;
+        socklen_t length = sizeof(value);
+
+        if (::getsockopt(this->impl->socket, level, name, &value, &length) == -1) {
+            throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+        }
+
+        return value;
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocket::setOption(int option, int value) {
+
+    try {
+
+        if (isClosed() || this->impl->socket == -1) {
+            throw IOException(__FILE__, __LINE__, "The Socket is closed.");
+        }
+
+        // The descriptor is always non-blocking, the timeout is applied while
+        // waiting on the epoll instance.
+        if (option == SocketOptions::SOCKET_OPTION_TIMEOUT) {
+            this->impl->soTimeout = value;
+            return;
+        } else if (option == SocketOptions::SOCKET_OPTION_LINGER) {
+
+            // Applied on close, a non-blocking socket would otherwise return from
+            // close without waiting for the linger period.
+            this->impl->soLinger = value;
+            return;
+        }
+
+        int level = SOL_SOCKET;
+        int name = 0;
+
+        if (option == SocketOptions::SOCKET_OPTION_REUSEADDR) {
+            name = SO_REUSEADDR;
+        } else if (option == SocketOptions::SOCKET_OPTION_SNDBUF) {
+            name = SO_SNDBUF;
+        } else if (option == SocketOptions::SOCKET_OPTION_RCVBUF) {
+            name = SO_RCVBUF;
+        } else if (option == SocketOptions::SOCKET_OPTION_TCP_NODELAY) {
+            level = IPPROTO_TCP;
+            name = TCP_NODELAY;
+        } else if (option == SocketOptions::SOCKET_OPTION_KEEPALIVE) {
+            name = SO_KEEPALIVE;
+        } else {
+            throw IOException(__FILE__, __LINE__, "Socket Option is not valid for this Socket type.");
+        }
+
+        if (::setsockopt(this->impl->socket, level, name, &value, sizeof(value)) == -1) {
+            throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool EpollSocket::isConnected() const {
+    return this->impl->connected;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool EpollSocket::isClosed() const {
+    return this->impl->closed.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int EpollSocket::read(unsigned char* buffer, int size, int offset, int length) {
+
+    try {
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__, "The Stream has been closed");
+        }
+
+        if (this->impl->inputShutdown == true) {
+            return -1;
+        }
+
+        if (length == 0) {
+            return 0;
+        }
+
+        checkBounds(buffer, size, offset, length);
+
+        while (true) {
+
+            ssize_t result = ::recv(this->impl->socket, buffer + offset, (size_t) length, 0);
+
+            if (result > 0) {
+                return (int) result;
+            }
+
+            if (isClosed()) {
+                throw IOException(__FILE__, __LINE__, "The connection is closed");
+            }
+
+            if (result == 0) {
+                this->impl->inputShutdown = true;
+                return -1;
+            }
+
+            if (errno == EINTR) {
+                continue;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                throw IOException(__FILE__, __LINE__,
+                    "Socket Read Error - %s", SocketError::getErrorString().c_str());
+            }
+
+            if (!await(false, this->impl->soTimeout)) {
+                throw SocketTimeoutException(__FILE__, __LINE__, "Read timed out");
+            }
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int EpollSocket::readAvailable(unsigned char* buffer, int size, int offset, int length) {
+
+    try {
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__, "The Stream has been closed");
+        }
+
+        if (this->impl->inputShutdown == true) {
+            return -1;
+        }
+
+        if (length == 0) {
+            return 0;
+        }
+
+        checkBounds(buffer, size, offset, length);
+
+        while (true) {
+
+            ssize_t result = ::recv(this->impl->socket, buffer + offset, (size_t) length, 0);
+
+            if (result > 0) {
+                return (int) result;
+            }
+
+            if (result == 0) {
+                this->impl->inputShutdown = true;
+                return -1;
+            }
+
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+
+            throw IOException(__FILE__, __LINE__,
+                "Socket Read Error - %s", SocketError::getErrorString().c_str());
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocket::write(const unsigned char* buffer, int size, int offset, int length) {
+
+    try {
+
+        if (length == 0) {
+            return;
+        }
+
+        checkBounds(buffer, size, offset, length);
+
+        const unsigned char* position = buffer + offset;
+        std::size_t remaining = (std::size_t) length;
+
+        while (remaining > 0) {
+
+            if (isClosed()) {
+                throw IOException(__FILE__, __LINE__, "The connection is closed");
+            }
+
+            ssize_t result = ::send(this->impl->socket, position, remaining, MSG_NOSIGNAL);
+
+            if (result >= 0) {
+                position += result;
+                remaining -= (std::size_t) result;
+                continue;
+            }
+
+            if (errno == EINTR) {
+                continue;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                throw IOException(__FILE__, __LINE__,
+                    "Socket Write Error - %s", SocketError::getErrorString().c_str());
+            }
+
+            await(true, -1);
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+#endif /* HAVE_SYS_EPOLL_H */
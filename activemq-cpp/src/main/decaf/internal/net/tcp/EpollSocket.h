@@ -0,0 +1,181 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_TCP_EPOLLSOCKET_H_
+#define _DECAF_INTERNAL_NET_TCP_EPOLLSOCKET_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/net/SocketImpl.h>
+#include <decaf/io/InputStream.h>
+#include <decaf/io/OutputStream.h>
+
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+
+    class EpollSocketImpl;
+
+    /**
+     * Linux native SocketImpl that works directly on a non-blocking socket file
+     * descriptor instead of going through APR.  Reads, writes, accepts and connects
+     * that can't complete immediately wait on an epoll instance for the socket to
+     * become ready, which lets the socket honor its SO_TIMEOUT without switching the
+     * descriptor between blocking modes and lets close wake any thread that is
+     * waiting on the socket.
+     *
+     * The implementation is only available on platforms that provide epoll, use the
+     * EpollSocketImplFactory to install it as the default for new Sockets.  Instead of
+     * dedicating a thread to each socket, its input can be handled by one of the
+     * shared threads of an EpollSelector through readAvailable.
+     *
+     * @since 3.10.0
+     */
+    class DECAF_API EpollSocket : public decaf::net::SocketImpl {
+    private:
+
+        EpollSocketImpl* impl;
+
+    private:
+
+        EpollSocket(const EpollSocket&);
+        EpollSocket& operator=(const EpollSocket&);
+
+    public:
+
+        EpollSocket();
+
+        virtual ~EpollSocket();
+
+        /**
+         * @return true if the socket is connected
+         */
+        bool isConnected() const;
+
+        /**
+         * @return true if the socket is closed
+         */
+        bool isClosed() const;
+
+        virtual std::string getLocalAddress() const;
+
+        virtual void create();
+
+        virtual void accept(SocketImpl* socket);
+
+        virtual void bind(const std::string& ipaddress, int port);
+
+        virtual void connect(const std::string& hostname, int port, int timeout);
+
+        virtual void listen(int backlog);
+
+        virtual decaf::io::InputStream* getInputStream();
+
+        virtual decaf::io::OutputStream* getOutputStream();
+
+        virtual int available();
+
+        virtual void close();
+
+        virtual void shutdownInput();
+
+        virtual void shutdownOutput();
+
+        virtual int getOption(int option) const;
+
+        virtual void setOption(int option, int value);
+
+    public:
+
+        /**
+         * Reads the requested data from the Socket and write it into the passed in buffer,
+         * waiting no longer than the configured SO_TIMEOUT for data to arrive.
+         *
+         * @param buffer
+         *      The buffer to read into
+         * @param size
+         *      The size of the specified buffer
+         * @param offset
+         *      The offset into the buffer where reading should start filling.
+         * @param length
+         *      The number of bytes past offset to fill with data.
+         *
+         * @return the actual number of bytes read or -1 if at EOF.
+         *
+         * @throw IOException if an I/O error occurs during the read.
+         * @throw SocketTimeoutException if no data arrives before the SO_TIMEOUT expires.
+         * @throw NullPointerException if buffer is Null.
+         * @throw IndexOutOfBoundsException if offset + length is greater than buffer size.
+         */
+        int read(unsigned char* buffer, int size, int offset, int length);
+
+        /**
+         * Reads whatever data the Socket already has without waiting for more to arrive,
+         * used by the listeners of an EpollSelector which must never block.
+         *
+         * @param buffer
+         *      The buffer to read into
+         * @param size
+         *      The size of the specified buffer
+         * @param offset
+         *      The offset into the buffer where reading should start filling.
+         * @param length
+         *      The maximum number of bytes past offset to fill with data.
+         *
+         * @return the number of bytes read, zero if no data is available or -1 if at EOF.
+         *
+         * @throw IOException if an I/O error occurs during the read.
+         * @throw NullPointerException if buffer is Null.
+         * @throw IndexOutOfBoundsException if offset + length is greater than buffer size.
+         */
+        int readAvailable(unsigned char* buffer, int size, int offset, int length);
+
+        /**
+         * Writes the specified data in the passed in buffer to the Socket, returning
+         * once all of it has been handed to the kernel.
+         *
+         * @param buffer
+         *      The buffer to write to the socket.
+         * @param size
+         *      The size of the given buffer.
+         * @param offset
+         *      The offset into the buffer where the data to write starts at.
+         * @param length
+         *      The number of bytes past offset to write.
+         *
+         * @throw IOException if an I/O error occurs during the write.
+         * @throw NullPointerException if buffer is Null.
+         * @throw IndexOutOfBoundsException if offset + length is greater than buffer size.
+         */
+        void write(const unsigned char* buffer, int size, int offset, int length);
+
+    private:
+
+        // Takes ownership of a connected or listening descriptor and registers it
+        // with this socket's epoll instances.
+        void initialize(int descriptor);
+
+        // Waits for the socket to be ready for reading or writing, returns false if
+        // the timeout in milliseconds expires first, a negative timeout waits forever.
+        bool await(bool forWrite, int timeout) const;
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_NET_TCP_EPOLLSOCKET_H_ */
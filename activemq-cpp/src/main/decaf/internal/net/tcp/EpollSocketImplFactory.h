@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_TCP_EPOLLSOCKETIMPLFACTORY_H_
+#define _DECAF_INTERNAL_NET_TCP_EPOLLSOCKETIMPLFACTORY_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/net/SocketImplFactory.h>
+
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+
+    /**
+     * SocketImplFactory that creates EpollSocket instances, install it with
+     * Socket::setSocketImplFactory and ServerSocket::setSocketImplFactory to use
+     * the epoll based sockets in place of the APR based TcpSocket.
+     *
+     * @since 3.10.0
+     */
+    class DECAF_API EpollSocketImplFactory : public decaf::net::SocketImplFactory {
+    private:
+
+        EpollSocketImplFactory(const EpollSocketImplFactory&);
+        EpollSocketImplFactory& operator= (const EpollSocketImplFactory&);
+
+    public:
+
+        EpollSocketImplFactory();
+
+        virtual ~EpollSocketImplFactory();
+
+        /**
+         * {@inheritDoc}
+         *
+         * @throws UnsupportedOperationException if epoll is not available on this platform.
+         */
+        virtual decaf::net::SocketImpl* createSocketImpl();
+
+        /**
+         * @return true if the platform supports the epoll based sockets.
+         */
+        static bool isSupported();
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_NET_TCP_EPOLLSOCKETIMPLFACTORY_H_ */
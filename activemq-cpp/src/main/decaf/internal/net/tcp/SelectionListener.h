@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_TCP_SELECTIONLISTENER_H_
+#define _DECAF_INTERNAL_NET_TCP_SELECTIONLISTENER_H_
+
+#include <decaf/util/Config.h>
+
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+
+    /**
+     * Callback for a socket registered with an EpollSelector.  The selector calls
+     * the listener from one of its threads whenever the socket has data to read or
+     * has been closed by the peer, never from two threads at once.
+     *
+     * The listener shares the selector thread with many other sockets, so it must
+     * only read what is already available and return without blocking.
+     *
+     * @since 3.10.0
+     */
+    class DECAF_API SelectionListener {
+    public:
+
+        virtual ~SelectionListener();
+
+        /**
+         * Called when the socket has data to read, has reached end of stream or has
+         * failed.  The selector keeps calling as long as any of these holds so the
+         * listener must remove itself from the selector once the socket is done.
+         */
+        virtual void onReadable() = 0;
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_NET_TCP_SELECTIONLISTENER_H_ */
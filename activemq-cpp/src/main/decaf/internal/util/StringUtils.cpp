@@ -23,6 +23,8 @@
 #include <decaf/lang/exceptions/RuntimeException.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 
+#include <string.h>
+
 using namespace decaf;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
@@ -168,3 +170,33 @@ int StringUtils::compareIgnoreCase(const char* left, const char* right) {
 int StringUtils::compare(const char* left, const char* right) {
     return doCompare(left, right, false);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t StringUtils::plainAsciiLength(const unsigned char* bytes, std::size_t length) {
+
+    static const unsigned long long ONES = 0x0101010101010101ULL;
+    static const unsigned long long HIGH_BITS = 0x8080808080808080ULL;
+
+    std::size_t index = 0;
+
+    // A byte has its high bit set after the subtraction only if it was zero, or
+    // if a lower zero byte borrowed from it, so together with the high bits of
+    // the original bytes the word is clean only when every byte is in 1-127.
+    while (length - index >= sizeof(unsigned long long)) {
+
+        unsigned long long word = 0;
+        ::memcpy(&word, bytes + index, sizeof(word));
+
+        if (((word - ONES) | word) & HIGH_BITS) {
+            break;
+        }
+
+        index += sizeof(unsigned long long);
+    }
+
+    while (index < length && bytes[index] != 0 && bytes[index] < 0x80) {
+        index++;
+    }
+
+    return index;
+}
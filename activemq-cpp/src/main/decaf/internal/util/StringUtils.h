@@ -20,11 +20,13 @@
 
 #include <decaf/util/Config.h>
 
+#include <cstddef>
+
 namespace decaf {
 namespace internal {
 namespace util {
 
-    class StringUtils {
+    class DECAF_API StringUtils {
     private:
 
         StringUtils(const StringUtils&);
@@ -78,6 +80,22 @@ namespace util {
          */
         static int compare(const char* left, const char* right);
 
+        /**
+         * Returns the length of the run of bytes at the start of the given buffer
+         * whose values are in the range 1-127.  Those are the bytes that modified
+         * UTF-8 encodes as themselves, so a run covering the whole buffer means the
+         * data can be copied as is when converting to or from modified UTF-8.  The
+         * buffer is scanned a machine word at a time.
+         *
+         * @param bytes
+         *      The bytes to scan.
+         * @param length
+         *      The number of bytes in the buffer.
+         *
+         * @return the number of leading bytes that are in the range 1-127.
+         */
+        static std::size_t plainAsciiLength(const unsigned char* bytes, std::size_t length);
+
     };
 
 }}}
@@ -20,6 +20,16 @@
 
 #include <decaf/util/Config.h>
 
+// Compilers that provide the C++11 style __atomic builtins get the operations inlined
+// into the callers with the requested memory ordering, everything else calls into the
+// platform implementation which always applies a full barrier.
+#if defined(__ATOMIC_RELAXED) && defined(__ATOMIC_ACQUIRE) && defined(__ATOMIC_RELEASE) && \
+    defined(__GCC_ATOMIC_INT_LOCK_FREE) && __GCC_ATOMIC_INT_LOCK_FREE == 2 && \
+    defined(__GCC_ATOMIC_POINTER_LOCK_FREE) && __GCC_ATOMIC_POINTER_LOCK_FREE == 2 && \
+    defined(__GCC_ATOMIC_LLONG_LOCK_FREE) && __GCC_ATOMIC_LLONG_LOCK_FREE == 2
+#define DECAF_INLINE_ATOMICS
+#endif
+
 namespace decaf {
 namespace internal {
 namespace util {
@@ -28,6 +38,22 @@ namespace concurrent {
     class Threading;
 
     class DECAF_API Atomics {
+    public:
+
+        /**
+         * The ordering an atomic operation imposes on the memory accesses around it,
+         * these follow the C++11 memory_order values.  Loads may only use RELAXED,
+         * ACQUIRE or SEQ_CST and stores RELAXED, RELEASE or SEQ_CST.  Platforms
+         * without ordered atomics treat every value as SEQ_CST.
+         */
+        enum MemoryOrder {
+            RELAXED,
+            ACQUIRE,
+            RELEASE,
+            ACQ_REL,
+            SEQ_CST
+        };
+
     private:
 
         Atomics();
@@ -44,29 +70,167 @@ namespace concurrent {
 
     public:
 
-        static bool compareAndSet32(volatile int* target, int expect, int update);
-        static bool compareAndSet(volatile void** target, void* expect, void* update);
+        static int load(const volatile int* target, MemoryOrder order = SEQ_CST);
+        static long long load(const volatile long long* target, MemoryOrder order = SEQ_CST);
+        static void* load(volatile void** target, MemoryOrder order = SEQ_CST);
+
+        static void store(volatile int* target, int value, MemoryOrder order = SEQ_CST);
+        static void store(volatile void** target, void* value, MemoryOrder order = SEQ_CST);
+
+        static bool compareAndSet32(volatile int* target, int expect, int update, MemoryOrder order = SEQ_CST);
+        static bool compareAndSet64(volatile long long* target, long long expect, long long update, MemoryOrder order = SEQ_CST);
+        static bool compareAndSet(volatile void** target, void* expect, void* update, MemoryOrder order = SEQ_CST);
 
-        static void* getAndSet(volatile void** target, void* value);
-        static int getAndSet(volatile int* target, int value);
+        static void* getAndSet(volatile void** target, void* value, MemoryOrder order = SEQ_CST);
+        static int getAndSet(volatile int* target, int value, MemoryOrder order = SEQ_CST);
 
-        static int getAndIncrement(volatile int* target);
-        static int getAndDecrement(volatile int* target);
+        static int getAndIncrement(volatile int* target, MemoryOrder order = SEQ_CST);
+        static int getAndDecrement(volatile int* target, MemoryOrder order = SEQ_CST);
 
-        static int getAndAdd(volatile int* target, int delta);
-        static int addAndGet(volatile int* target, int delta);
+        static int getAndAdd(volatile int* target, int delta, MemoryOrder order = SEQ_CST);
+        static int addAndGet(volatile int* target, int delta, MemoryOrder order = SEQ_CST);
 
-        static int incrementAndGet(volatile int* target);
-        static int decrementAndGet(volatile int* target);
+        static long long getAndAdd(volatile long long* target, long long delta, MemoryOrder order = SEQ_CST);
+        static long long addAndGet(volatile long long* target, long long delta, MemoryOrder order = SEQ_CST);
+
+        static int incrementAndGet(volatile int* target, MemoryOrder order = SEQ_CST);
+        static int decrementAndGet(volatile int* target, MemoryOrder order = SEQ_CST);
 
     private:
 
+#ifdef DECAF_INLINE_ATOMICS
+        static int builtinOrder(MemoryOrder order) {
+            switch (order) {
+                case RELAXED:
+                    return __ATOMIC_RELAXED;
+                case ACQUIRE:
+                    return __ATOMIC_ACQUIRE;
+                case RELEASE:
+                    return __ATOMIC_RELEASE;
+                case ACQ_REL:
+                    return __ATOMIC_ACQ_REL;
+                default:
+                    return __ATOMIC_SEQ_CST;
+            }
+        }
+
+        // A failed compare and set only loads, so it cannot carry the release half.
+        static int builtinFailureOrder(MemoryOrder order) {
+            switch (order) {
+                case RELEASE:
+                    return __ATOMIC_RELAXED;
+                case ACQ_REL:
+                    return __ATOMIC_ACQUIRE;
+                default:
+                    return builtinOrder(order);
+            }
+        }
+#endif
+
         static void initialize();
         static void shutdown();
 
         friend class Threading;
     };
 
+#ifdef DECAF_INLINE_ATOMICS
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline int Atomics::load(const volatile int* target, MemoryOrder order) {
+        return __atomic_load_n(target, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline long long Atomics::load(const volatile long long* target, MemoryOrder order) {
+        return __atomic_load_n(target, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline void* Atomics::load(volatile void** target, MemoryOrder order) {
+        return (void*) __atomic_load_n(target, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline void Atomics::store(volatile int* target, int value, MemoryOrder order) {
+        __atomic_store_n(target, value, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline void Atomics::store(volatile void** target, void* value, MemoryOrder order) {
+        __atomic_store_n(target, value, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline bool Atomics::compareAndSet32(volatile int* target, int expect, int update, MemoryOrder order) {
+        return __atomic_compare_exchange_n(target, &expect, update, false,
+                                           builtinOrder(order), builtinFailureOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline bool Atomics::compareAndSet64(volatile long long* target, long long expect, long long update, MemoryOrder order) {
+        return __atomic_compare_exchange_n(target, &expect, update, false,
+                                           builtinOrder(order), builtinFailureOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline bool Atomics::compareAndSet(volatile void** target, void* expect, void* update, MemoryOrder order) {
+        volatile void* expected = expect;
+        return __atomic_compare_exchange_n(target, &expected, update, false,
+                                           builtinOrder(order), builtinFailureOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline void* Atomics::getAndSet(volatile void** target, void* value, MemoryOrder order) {
+        return (void*) __atomic_exchange_n(target, value, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline int Atomics::getAndSet(volatile int* target, int value, MemoryOrder order) {
+        return __atomic_exchange_n(target, value, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline int Atomics::getAndIncrement(volatile int* target, MemoryOrder order) {
+        return __atomic_fetch_add(target, 1, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline int Atomics::getAndDecrement(volatile int* target, MemoryOrder order) {
+        return __atomic_fetch_sub(target, 1, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline int Atomics::getAndAdd(volatile int* target, int delta, MemoryOrder order) {
+        return __atomic_fetch_add(target, delta, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline int Atomics::addAndGet(volatile int* target, int delta, MemoryOrder order) {
+        return __atomic_add_fetch(target, delta, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline long long Atomics::getAndAdd(volatile long long* target, long long delta, MemoryOrder order) {
+        return __atomic_fetch_add(target, delta, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline long long Atomics::addAndGet(volatile long long* target, long long delta, MemoryOrder order) {
+        return __atomic_add_fetch(target, delta, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline int Atomics::incrementAndGet(volatile int* target, MemoryOrder order) {
+        return __atomic_add_fetch(target, 1, builtinOrder(order));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    inline int Atomics::decrementAndGet(volatile int* target, MemoryOrder order) {
+        return __atomic_sub_fetch(target, 1, builtinOrder(order));
+    }
+
+#endif
+
 }}}}
 
 #endif /* _DECAF_INTERNAL_UTIL_CONCURRENT_ATOMICS_H_ */
@@ -52,8 +52,98 @@ void Atomics::shutdown() {
 #endif
 }
 
+#ifndef DECAF_INLINE_ATOMICS
+
+////////////////////////////////////////////////////////////////////////////////
+int Atomics::load(const volatile int* target, MemoryOrder order DECAF_UNUSED) {
+#ifdef HAVE_ATOMIC_BUILTINS
+    return __sync_fetch_and_add((volatile int*)target, 0);
+#elif defined(SOLARIS2) && SOLARIS2 >= 10
+    return atomic_add_32_nv((volatile unsigned int*)target, 0);
+#else
+    int value;
+    PlatformThread::lockMutex(atomicMutex);
+
+    value = *target;
+
+    PlatformThread::unlockMutex(atomicMutex);
+
+    return value;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::load(const volatile long long* target, MemoryOrder order DECAF_UNUSED) {
+#ifdef HAVE_ATOMIC_BUILTINS
+    return __sync_fetch_and_add((volatile long long*)target, 0);
+#elif defined(SOLARIS2) && SOLARIS2 >= 10
+    return atomic_add_64_nv((volatile uint64_t*)target, 0);
+#else
+    long long value;
+    PlatformThread::lockMutex(atomicMutex);
+
+    value = *target;
+
+    PlatformThread::unlockMutex(atomicMutex);
+
+    return value;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* Atomics::load(volatile void** target, MemoryOrder order DECAF_UNUSED) {
+#ifdef HAVE_ATOMIC_BUILTINS
+    return (void*) __sync_val_compare_and_swap(target, (void*)NULL, (void*)NULL);
+#elif defined(SOLARIS2) && SOLARIS2 >= 10
+    return atomic_cas_ptr(target, NULL, NULL);
+#else
+    void* value;
+    PlatformThread::lockMutex(atomicMutex);
+
+    value = (void*)*target;
+
+    PlatformThread::unlockMutex(atomicMutex);
+
+    return value;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Atomics::store(volatile int* target, int value, MemoryOrder order) {
+    Atomics::getAndSet(target, value, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Atomics::store(volatile void** target, void* value, MemoryOrder order) {
+    Atomics::getAndSet(target, value, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::getAndAdd(volatile long long* target, long long delta, MemoryOrder order DECAF_UNUSED) {
+#ifdef HAVE_ATOMIC_BUILTINS
+    return __sync_fetch_and_add(target, delta);
+#elif defined(SOLARIS2) && SOLARIS2 >= 10
+    return atomic_add_64_nv((volatile uint64_t*)target, delta) - delta;
+#else
+    long long oldValue;
+    PlatformThread::lockMutex(atomicMutex);
+
+    oldValue = *target;
+    *target += delta;
+
+    PlatformThread::unlockMutex(atomicMutex);
+
+    return oldValue;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::addAndGet(volatile long long* target, long long delta, MemoryOrder order) {
+    return Atomics::getAndAdd(target, delta, order) + delta;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-bool Atomics::compareAndSet32(volatile int* target, int expect, int update ) {
+bool Atomics::compareAndSet32(volatile int* target, int expect, int update, MemoryOrder order DECAF_UNUSED) {
 
 #ifdef HAVE_ATOMIC_BUILTINS
     return __sync_val_compare_and_swap(target, expect, update)  == expect;
@@ -75,7 +165,29 @@ bool Atomics::compareAndSet32(volatile int* target, int expect, int update ) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool Atomics::compareAndSet(volatile void** target, void* expect, void* update) {
+bool Atomics::compareAndSet64(volatile long long* target, long long expect, long long update, MemoryOrder order DECAF_UNUSED) {
+
+#ifdef HAVE_ATOMIC_BUILTINS
+    return __sync_val_compare_and_swap(target, expect, update) == expect;
+#elif defined(SOLARIS2) && SOLARIS2 >= 10
+    return atomic_cas_64((volatile uint64_t*)target, expect, update) == (uint64_t)expect;
+#else
+    bool result = false;
+    PlatformThread::lockMutex(atomicMutex);
+
+    if (*target == expect) {
+        *target = update;
+        result = true;
+    }
+
+    PlatformThread::unlockMutex(atomicMutex);
+
+    return result;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Atomics::compareAndSet(volatile void** target, void* expect, void* update, MemoryOrder order DECAF_UNUSED) {
 #ifdef HAVE_ATOMIC_BUILTINS
     return __sync_val_compare_and_swap(target, (void*)expect, (void*)update) == (void*)expect;
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
@@ -96,7 +208,7 @@ bool Atomics::compareAndSet(volatile void** target, void* expect, void* update)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::getAndSet(volatile int* target, int newValue) {
+int Atomics::getAndSet(volatile int* target, int newValue, MemoryOrder order DECAF_UNUSED) {
 #ifdef HAVE_ATOMIC_BUILTINS
     __sync_synchronize();
     return __sync_lock_test_and_set(target, newValue);
@@ -116,7 +228,7 @@ int Atomics::getAndSet(volatile int* target, int newValue) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void* Atomics::getAndSet(volatile void** target, void* newValue) {
+void* Atomics::getAndSet(volatile void** target, void* newValue, MemoryOrder order DECAF_UNUSED) {
 #ifdef HAVE_ATOMIC_BUILTINS
     __sync_synchronize();
     return (void*) __sync_lock_test_and_set(target, newValue);
@@ -138,7 +250,7 @@ void* Atomics::getAndSet(volatile void** target, void* newValue) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::getAndIncrement(volatile int* target) {
+int Atomics::getAndIncrement(volatile int* target, MemoryOrder order DECAF_UNUSED) {
 #ifdef HAVE_ATOMIC_BUILTINS
     return __sync_fetch_and_add(target, 1);
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
@@ -157,7 +269,7 @@ int Atomics::getAndIncrement(volatile int* target) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::getAndDecrement(volatile int* target) {
+int Atomics::getAndDecrement(volatile int* target, MemoryOrder order DECAF_UNUSED) {
 #ifdef HAVE_ATOMIC_BUILTINS
     return __sync_fetch_and_add(target, 0xFFFFFFFF);
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
@@ -176,7 +288,7 @@ int Atomics::getAndDecrement(volatile int* target) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::getAndAdd(volatile int* target, int delta) {
+int Atomics::getAndAdd(volatile int* target, int delta, MemoryOrder order DECAF_UNUSED) {
 #ifdef HAVE_ATOMIC_BUILTINS
     return __sync_fetch_and_add(target, delta);
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
@@ -195,7 +307,7 @@ int Atomics::getAndAdd(volatile int* target, int delta) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::addAndGet(volatile int* target, int delta) {
+int Atomics::addAndGet(volatile int* target, int delta, MemoryOrder order DECAF_UNUSED) {
 #ifdef HAVE_ATOMIC_BUILTINS
     return __sync_fetch_and_add(target, delta) + delta;
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
@@ -214,7 +326,7 @@ int Atomics::addAndGet(volatile int* target, int delta) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::incrementAndGet(volatile int* target) {
+int Atomics::incrementAndGet(volatile int* target, MemoryOrder order DECAF_UNUSED) {
 #ifdef HAVE_ATOMIC_BUILTINS
     return __sync_fetch_and_add(target, 1) + 1;
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
@@ -233,7 +345,7 @@ int Atomics::incrementAndGet(volatile int* target) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::decrementAndGet(volatile int* target) {
+int Atomics::decrementAndGet(volatile int* target, MemoryOrder order DECAF_UNUSED) {
 #ifdef HAVE_ATOMIC_BUILTINS
     return __sync_fetch_and_add(target, 0xFFFFFFFF) - 1;
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
@@ -251,3 +363,4 @@ int Atomics::decrementAndGet(volatile int* target) {
 #endif
 }
 
+#endif
@@ -29,53 +29,96 @@ void Atomics::initialize() {
 void Atomics::shutdown() {
 }
 
+#ifndef DECAF_INLINE_ATOMICS
+
+////////////////////////////////////////////////////////////////////////////////
+int Atomics::load(const volatile int* target, MemoryOrder order DECAF_UNUSED) {
+    return ::InterlockedCompareExchange((volatile LONG*)target, 0, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::load(const volatile long long* target, MemoryOrder order DECAF_UNUSED) {
+    return ::InterlockedCompareExchange64((volatile LONGLONG*)target, 0, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* Atomics::load(volatile void** target, MemoryOrder order DECAF_UNUSED) {
+    return ::InterlockedCompareExchangePointer((volatile PVOID*)target, NULL, NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Atomics::store(volatile int* target, int value, MemoryOrder order DECAF_UNUSED) {
+    ::InterlockedExchange((volatile LONG*)target, value);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-bool Atomics::compareAndSet32(volatile int* target, int expect, int update ) {
+void Atomics::store(volatile void** target, void* value, MemoryOrder order DECAF_UNUSED) {
+    InterlockedExchangePointer((volatile PVOID*)target, value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::getAndAdd(volatile long long* target, long long delta, MemoryOrder order DECAF_UNUSED) {
+    return ::InterlockedExchangeAdd64((volatile LONGLONG*)target, delta);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::addAndGet(volatile long long* target, long long delta, MemoryOrder order DECAF_UNUSED) {
+    return ::InterlockedExchangeAdd64((volatile LONGLONG*)target, delta) + delta;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Atomics::compareAndSet32(volatile int* target, int expect, int update, MemoryOrder order DECAF_UNUSED) {
     return ::InterlockedCompareExchange((volatile LONG*)target, update, expect) == (unsigned int)expect;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool Atomics::compareAndSet(volatile void** target, void* expect, void* update) {
+bool Atomics::compareAndSet64(volatile long long* target, long long expect, long long update, MemoryOrder order DECAF_UNUSED) {
+    return ::InterlockedCompareExchange64((volatile LONGLONG*)target, update, expect) == expect;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Atomics::compareAndSet(volatile void** target, void* expect, void* update, MemoryOrder order DECAF_UNUSED) {
     return ::InterlockedCompareExchangePointer((volatile PVOID*)target, (void*)update, (void*)expect ) == (void*)expect;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::getAndSet(volatile int* target, int newValue) {
+int Atomics::getAndSet(volatile int* target, int newValue, MemoryOrder order DECAF_UNUSED) {
     return ::InterlockedExchange((volatile LONG*)target, newValue);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void* Atomics::getAndSet(volatile void** target, void* newValue) {
+void* Atomics::getAndSet(volatile void** target, void* newValue, MemoryOrder order DECAF_UNUSED) {
     return InterlockedExchangePointer((volatile PVOID*)target, newValue);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::getAndIncrement(volatile int* target) {
+int Atomics::getAndIncrement(volatile int* target, MemoryOrder order DECAF_UNUSED) {
     return ::InterlockedIncrement((volatile LONG*)target) - 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::getAndDecrement(volatile int* target) {
+int Atomics::getAndDecrement(volatile int* target, MemoryOrder order DECAF_UNUSED) {
     return ::InterlockedExchangeAdd((volatile LONG*)target, 0xFFFFFFFF);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::getAndAdd(volatile int* target, int delta) {
+int Atomics::getAndAdd(volatile int* target, int delta, MemoryOrder order DECAF_UNUSED) {
     return ::InterlockedExchangeAdd((volatile LONG*)target, delta);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::addAndGet(volatile int* target, int delta) {
+int Atomics::addAndGet(volatile int* target, int delta, MemoryOrder order DECAF_UNUSED) {
     return ::InterlockedExchangeAdd((volatile LONG*)target, delta) + delta;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::incrementAndGet(volatile int* target) {
+int Atomics::incrementAndGet(volatile int* target, MemoryOrder order DECAF_UNUSED) {
     return ::InterlockedIncrement((volatile LONG*)target);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int Atomics::decrementAndGet(volatile int* target) {
+int Atomics::decrementAndGet(volatile int* target, MemoryOrder order DECAF_UNUSED) {
     return ::InterlockedExchangeAdd((volatile LONG*)target, 0xFFFFFFFF) - 1;
 }
 
+#endif
@@ -66,6 +66,11 @@ std::pair<unsigned char*, int> ByteArrayOutputStream::toByteArray() const {
     return std::make_pair(temp, this->count);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::pair<unsigned char*, int> ByteArrayOutputStream::toByteArrayRef() {
+    return std::make_pair(this->buffer, this->count);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 long long ByteArrayOutputStream::size() const {
     return this->count;
@@ -76,6 +81,27 @@ void ByteArrayOutputStream::reset() {
     this->count = 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayOutputStream::trimToSize(int size) {
+
+    if (size <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Buffer size given was invalid: %d", size);
+    }
+
+    if (this->bufferSize <= size || this->count > size) {
+        return;
+    }
+
+    unsigned char* temp = new unsigned char[size];
+    System::arraycopy(this->buffer, 0, temp, 0, this->count);
+
+    std::swap(temp, this->buffer);
+
+    this->bufferSize = size;
+
+    delete[] temp;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ByteArrayOutputStream::doWriteByte(unsigned char c) {
 
@@ -82,6 +82,16 @@ namespace io{
          */
         std::pair<unsigned char*, int> toByteArray() const;
 
+        /**
+         * Returns the internal byte array and the number of valid bytes it holds without
+         * making a copy.  The array remains the property of this stream and is only valid
+         * until the next write to or reset of this stream, callers may overwrite bytes that
+         * have already been written, for instance to fill in a size prefix.
+         *
+         * @return an STL pair containing the internal array and the number of valid bytes.
+         */
+        std::pair<unsigned char*, int> toByteArrayRef();
+
         /**
          * Gets the current count of bytes written into this ByteArrayOutputStream.
          *
@@ -95,6 +105,18 @@ namespace io{
          */
         virtual void reset();
 
+        /**
+         * Replaces the internal buffer with one of the given size if it has grown larger
+         * than that and the bytes written since the last reset still fit, so that a stream
+         * that is reused after one large write doesn't keep the large buffer.
+         *
+         * @param size
+         *      The largest buffer size to keep, must be greater than zero.
+         *
+         * @throws IllegalArgumentException if the size is not greater than zero.
+         */
+        void trimToSize(int size);
+
         /**
          * Converts the bytes in the buffer into a standard C++ string
          * @return a string containing the bytes in the buffer
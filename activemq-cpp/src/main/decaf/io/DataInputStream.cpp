@@ -18,6 +18,7 @@
 #include <decaf/io/DataInputStream.h>
 
 #include <decaf/io/PushbackInputStream.h>
+#include <decaf/internal/util/StringUtils.h>
 
 #ifdef HAVE_STRING_H
 #include <string.h>
@@ -30,6 +31,7 @@ using namespace std;
 using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::util;
+using namespace decaf::internal::util;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
@@ -240,12 +242,18 @@ std::string DataInputStream::readUTF() {
         }
 
         std::vector<unsigned char> buffer(utfLength);
-        std::vector<unsigned char> result(utfLength);
 
         this->readFully(&buffer[0], utfLength);
 
-        std::size_t count = 0;
-        std::size_t index = 0;
+        // Plain ASCII decodes to itself, only the rest of the data is decoded and
+        // that is done in place since the decoded form is never longer.
+        std::size_t count = StringUtils::plainAsciiLength(&buffer[0], utfLength);
+        if (count == utfLength) {
+            return std::string((char*) (&buffer[0]), utfLength);
+        }
+
+        std::vector<unsigned char>& result = buffer;
+        std::size_t index = count;
         unsigned char a = 0;
 
         while (count < utfLength) {
@@ -18,12 +18,14 @@
 #include <decaf/io/DataOutputStream.h>
 #include <decaf/io/UTFDataFormatException.h>
 #include <decaf/util/Config.h>
+#include <decaf/internal/util/StringUtils.h>
 #include <string.h>
 #include <stdio.h>
 
 using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::util;
+using namespace decaf::internal::util;
 using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -273,20 +275,44 @@ void DataOutputStream::writeUTF(const std::string& value) {
 
     try {
 
-        unsigned int utfLength = this->countUTFLength(value);
+        std::size_t length = value.length();
+        const unsigned char* bytes = (const unsigned char*) value.data();
+        std::size_t plain = StringUtils::plainAsciiLength(bytes, length);
+
+        // Plain ASCII encodes as itself, so the string can be written without
+        // being copied into an encoding buffer first.
+        if (plain == length) {
+
+            if (length > 65535) {
+                throw UTFDataFormatException(__FILE__, __LINE__, "Attempted to write a string as UTF-8 whose length is longer "
+                        "than the supported 65535 bytes");
+            }
+
+            this->writeUnsignedShort((unsigned short) length);
+            if (length > 0) {
+                this->write(bytes, (int) length, 0, (int) length);
+            }
+
+            return;
+        }
+
+        unsigned int utfLength = (unsigned int) plain + this->countUTFLength(value, plain);
 
         if (utfLength > 65535) {
             throw UTFDataFormatException(__FILE__, __LINE__, "Attempted to write a string as UTF-8 whose length is longer "
                     "than the supported 65535 bytes");
         }
 
-        std::size_t length = value.length();
         std::vector<unsigned char> utfBytes((std::size_t) utfLength);
-        unsigned int utfIndex = 0;
+        unsigned int utfIndex = (unsigned int) plain;
 
-        for (std::size_t i = 0; i < length; i++) {
+        if (plain > 0) {
+            ::memcpy(&utfBytes[0], bytes, plain);
+        }
+
+        for (std::size_t i = plain; i < length; i++) {
 
-            unsigned int charValue = (unsigned char) value.at(i);
+            unsigned int charValue = bytes[i];
 
             // Written to allow for expansion to wide character strings at some
             // point, as it stands now the value can never be > 255 since the
@@ -304,9 +330,7 @@ void DataOutputStream::writeUTF(const std::string& value) {
         }
 
         this->writeUnsignedShort((unsigned short) utfLength);
-        if (utfLength > 0) {
-            this->write(&utfBytes[0], utfIndex, 0, utfIndex);
-        }
+        this->write(&utfBytes[0], utfIndex, 0, utfIndex);
     }
     DECAF_CATCH_RETHROW(UTFDataFormatException)
     DECAF_CATCH_RETHROW(IOException)
@@ -314,14 +338,15 @@ void DataOutputStream::writeUTF(const std::string& value) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-unsigned int DataOutputStream::countUTFLength(const std::string& value) {
+unsigned int DataOutputStream::countUTFLength(const std::string& value, std::size_t offset) {
 
     unsigned int utfCount = 0;
     std::size_t length = value.length();
+    const unsigned char* bytes = (const unsigned char*) value.data();
 
-    for (std::size_t i = 0; i < length; ++i) {
+    for (std::size_t i = offset; i < length; ++i) {
 
-        unsigned int charValue = (unsigned char) value.at(i);
+        unsigned int charValue = bytes[i];
 
         // Written to allow for expansion to wide character strings at some
         // point, as it stands now the value can never be > 255 since the
@@ -136,8 +136,9 @@ namespace io{
 
     private:
 
-        // Determine the encoded length of a string when written as modified UTF-8
-        unsigned int countUTFLength(const std::string& value);
+        // Determine the encoded length of the part of a string that starts at the
+        // given offset when written as modified UTF-8
+        unsigned int countUTFLength(const std::string& value, std::size_t offset);
 
     };
 
@@ -42,6 +42,11 @@ namespace lang {
      * which provide a means of using invasive reference counting if desired using
      * a custom implementation of <code>ReferenceCounter</code>.
      * <p>
+     * The default Reference Counter allocates nothing until a Pointer is first copied,
+     * so a Pointer that stays the only reference to its value, or that is NULL, costs
+     * no allocation of its own.  Pointer has no virtual methods and is not meant to be
+     * used as a base class.
+     * <p>
      * The Decaf smart pointer provide comparison operators for comparing Pointer
      * instances in the same manner as normal pointer, except that it does not provide
      * an overload of operators ( <, <=, >, >= ).  To allow use of a Pointer in a STL
@@ -51,17 +56,10 @@ namespace lang {
      */
     template<typename T, typename REFCOUNTER = decaf::util::concurrent::atomic::AtomicRefCounter>
     class Pointer : public REFCOUNTER {
-    private:
-
-        typedef void (*deletionFuncPtr)(T* p);
-
     private:
 
         T* value;
 
-        // Pointer to our internal delete function.
-        deletionFuncPtr onDelete;
-
     public:
 
         typedef T* PointerType;         // type returned by operator->
@@ -76,7 +74,7 @@ namespace lang {
          * Initialized the contained pointer to NULL, using the -> operator
          * results in an exception unless reset to contain a real value.
          */
-        Pointer() : REFCOUNTER(), value(NULL), onDelete(onDeleteFunc) {}
+        Pointer() : REFCOUNTER(), value(NULL) {}
 
         /**
          * Explicit Constructor, creates a Pointer that contains value with a
@@ -85,7 +83,7 @@ namespace lang {
          * @param value -
          *      The instance of the type we are containing here.
          */
-        explicit Pointer(const PointerType value) : REFCOUNTER(), value(value), onDelete(onDeleteFunc) {}
+        explicit Pointer(const PointerType value) : REFCOUNTER(), value(value) {}
 
         /**
          * Copy constructor. Copies the value contained in the pointer to the new
@@ -94,7 +92,7 @@ namespace lang {
          * @param value
          *      Another instance of a Pointer<T> that this Pointer will copy.
          */
-        Pointer(const Pointer& value) : REFCOUNTER(value), value(value.value), onDelete(onDeleteFunc) {}
+        Pointer(const Pointer& value) : REFCOUNTER(value), value(value.value) {}
 
         /**
          * Copy constructor. Copies the value contained in the pointer to the new
@@ -104,7 +102,7 @@ namespace lang {
          *      A different but compatible Pointer instance that this Pointer will copy.
          */
         template<typename T1, typename R1>
-        Pointer(const Pointer<T1, R1>& value) : REFCOUNTER(value), value(value.get()), onDelete(onDeleteFunc) {}
+        Pointer(const Pointer<T1, R1>& value) : REFCOUNTER(value), value(value.get()) {}
 
         /**
          * Static Cast constructor. Copies the value contained in the pointer to the new
@@ -116,7 +114,7 @@ namespace lang {
          */
         template<typename T1, typename R1>
         Pointer(const Pointer<T1, R1>& value, const STATIC_CAST_TOKEN&) :
-            REFCOUNTER(value), value(static_cast<T*> (value.get())), onDelete(onDeleteFunc) {}
+            REFCOUNTER(value), value(static_cast<T*> (value.get())) {}
 
         /**
          * Dynamic Cast constructor. Copies the value contained in the pointer to the new
@@ -131,7 +129,7 @@ namespace lang {
          */
         template<typename T1, typename R1>
         Pointer(const Pointer<T1, R1>& value, const DYNAMIC_CAST_TOKEN&) :
-            REFCOUNTER(value), value(dynamic_cast<T*> (value.get())), onDelete(onDeleteFunc) {
+            REFCOUNTER(value), value(dynamic_cast<T*> (value.get())) {
 
             if (this->value == NULL) {
                 // Remove the reference we took in the Reference Counter's ctor since we
@@ -143,9 +141,9 @@ namespace lang {
             }
         }
 
-        virtual ~Pointer() {
+        ~Pointer() {
             if (REFCOUNTER::release() == true) {
-                onDelete(this->value);
+                onDeleteFunc(this->value);
             }
         }
 
@@ -20,15 +20,1119 @@
 
 #include <decaf/util/Config.h>
 
+#include <decaf/util/concurrent/ConcurrentMap.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/AbstractCollection.h>
+#include <decaf/util/AbstractSet.h>
+#include <decaf/util/HashCode.h>
+#include <decaf/util/Iterator.h>
+#include <decaf/util/Map.h>
+#include <decaf/util/NoSuchElementException.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace decaf {
 namespace util {
 namespace concurrent {
 
-    class ConcurrentHashMap {
+    /**
+     * A hash table supporting full concurrency of retrievals and adjustable expected
+     * concurrency for updates.
+     *
+     * The table is divided into a number of segments, each of which is a small hash
+     * table guarded by its own lock.  A key's hash code selects the segment that holds
+     * it so operations on keys in different segments never contend with each other,
+     * unlike ConcurrentStlMap where every operation takes the same lock.  The number
+     * of segments is set by the concurrency level given when the map is created.
+     *
+     * Keys are compared using the COMPARATOR, two keys are equal when neither is less
+     * than the other, so the same comparators used with StlMap and ConcurrentStlMap,
+     * such as PointerComparator, can be used here.  The HASHCODE function must return
+     * the same value for keys that the COMPARATOR considers equal.
+     *
+     * Aggregate operations such as size, putAll and clear are not atomic with respect
+     * to updates in other segments.  The iterators returned by the views of this map
+     * are weakly consistent, they never throw ConcurrentModificationException and
+     * return each segment's entries as they were when the iterator reached it.
+     *
+     * The Synchronizable methods of this map operate on a lock that is separate from
+     * the segment locks, holding it does not block the operations of the map.
+     *
+     * @since 3.10.0
+     */
+    template <typename K, typename V, typename HASHCODE = HashCode<K>, typename COMPARATOR = std::less<K> >
+    class ConcurrentHashMap : public ConcurrentMap<K, V> {
+    private:
+
+        static const int DEFAULT_INITIAL_CAPACITY = 16;
+        static const int DEFAULT_CONCURRENCY_LEVEL = 16;
+        static const int MAXIMUM_SEGMENTS = 1 << 16;
+        static const int MAXIMUM_CAPACITY = 1 << 30;
+
+        class HashEntry {
+        private:
+
+            HashEntry(const HashEntry&);
+            HashEntry& operator= (const HashEntry&);
+
+        public:
+
+            const K key;
+            V value;
+            const int hash;
+            HashEntry* next;
+
+            HashEntry(const K& key, const V& value, int hash, HashEntry* next) :
+                key(key), value(value), hash(hash), next(next) {
+            }
+        };
+
+        // The entries of one segment, all fields are guarded by the segment's mutex.
+        class Segment {
+        private:
+
+            Segment(const Segment&);
+            Segment& operator= (const Segment&);
+
+        public:
+
+            mutable Mutex mutex;
+            HashEntry** table;
+            int capacity;
+            int count;
+            int threshold;
+            float loadFactor;
+
+            Segment() : mutex(), table(NULL), capacity(0), count(0), threshold(0), loadFactor(0) {
+            }
+
+            ~Segment() {
+                clear();
+                delete [] table;
+            }
+
+            void initialize(int capacity, float loadFactor) {
+                this->loadFactor = loadFactor;
+                this->setTable(new HashEntry*[capacity], capacity);
+            }
+
+            void clear() {
+                for (int i = 0; i < capacity; ++i) {
+                    HashEntry* entry = table[i];
+                    while (entry != NULL) {
+                        HashEntry* next = entry->next;
+                        delete entry;
+                        entry = next;
+                    }
+                    table[i] = NULL;
+                }
+                count = 0;
+            }
+
+            HashEntry*& bucket(int hash) {
+                return table[hash & (capacity - 1)];
+            }
+
+            HashEntry* bucket(int hash) const {
+                return table[hash & (capacity - 1)];
+            }
+
+            // Doubles the table, entries are relinked rather than copied so that
+            // references returned by get remain valid.
+            void rehash() {
+                if (capacity >= MAXIMUM_CAPACITY) {
+                    return;
+                }
+
+                HashEntry** oldTable = table;
+                int oldCapacity = capacity;
+
+                this->setTable(new HashEntry*[oldCapacity * 2], oldCapacity * 2);
+
+                for (int i = 0; i < oldCapacity; ++i) {
+                    HashEntry* entry = oldTable[i];
+                    while (entry != NULL) {
+                        HashEntry* next = entry->next;
+                        HashEntry*& head = bucket(entry->hash);
+                        entry->next = head;
+                        head = entry;
+                        entry = next;
+                    }
+                }
+
+                delete [] oldTable;
+            }
+
+        private:
+
+            void setTable(HashEntry** newTable, int newCapacity) {
+                for (int i = 0; i < newCapacity; ++i) {
+                    newTable[i] = NULL;
+                }
+
+                table = newTable;
+                capacity = newCapacity;
+                threshold = (int) ((float) newCapacity * loadFactor);
+            }
+        };
+
+    private:
+
+        // Walks the segments one at a time taking a copy of each segment's entries
+        // as it reaches it, the map can be freely modified while iterating.
+        class AbstractMapIterator {
+        protected:
+
+            const ConcurrentHashMap* associatedMap;
+            ConcurrentHashMap* mutableMap;
+
+            mutable int segment;
+            mutable std::size_t position;
+            mutable std::vector< std::pair<K, V> > snapshot;
+
+            bool hasCurrent;
+            K currentKey;
+
+        private:
+
+            AbstractMapIterator(const AbstractMapIterator&);
+            AbstractMapIterator& operator= (const AbstractMapIterator&);
+
+        public:
+
+            AbstractMapIterator(const ConcurrentHashMap* parent, ConcurrentHashMap* mutableParent) :
+                associatedMap(parent), mutableMap(mutableParent), segment(0), position(0),
+                snapshot(), hasCurrent(false), currentKey() {
+            }
+
+            virtual ~AbstractMapIterator() {}
+
+            bool checkHasNext() const {
+                while (position >= snapshot.size()) {
+                    if (segment >= associatedMap->segmentCount) {
+                        return false;
+                    }
+
+                    snapshot.clear();
+                    position = 0;
+                    associatedMap->snapshotSegment(associatedMap->segments[segment++], snapshot);
+                }
+
+                return true;
+            }
+
+            const std::pair<K, V>& makeNext() {
+                if (!checkHasNext()) {
+                    throw NoSuchElementException(__FILE__, __LINE__, "No next element");
+                }
+
+                const std::pair<K, V>& entry = snapshot[position++];
+                currentKey = entry.first;
+                hasCurrent = true;
+                return entry;
+            }
+
+            void doRemove() {
+                if (mutableMap == NULL) {
+                    throw lang::exceptions::UnsupportedOperationException(
+                        __FILE__, __LINE__, "Cannot write to a const Iterator.");
+                }
+
+                if (!hasCurrent) {
+                    throw lang::exceptions::IllegalStateException(
+                        __FILE__, __LINE__, "Remove called before call to next()");
+                }
+
+                mutableMap->removeEntry(currentKey, NULL);
+                hasCurrent = false;
+            }
+        };
+
+        class EntryIterator : public Iterator< MapEntry<K, V> >, public AbstractMapIterator {
+        private:
+
+            EntryIterator(const EntryIterator&);
+            EntryIterator& operator= (const EntryIterator&);
+
+        public:
+
+            EntryIterator(const ConcurrentHashMap* parent, ConcurrentHashMap* mutableParent) :
+                AbstractMapIterator(parent, mutableParent) {
+            }
+
+            virtual ~EntryIterator() {}
+
+            virtual bool hasNext() const {
+                return this->checkHasNext();
+            }
+
+            virtual MapEntry<K, V> next() {
+                const std::pair<K, V>& entry = this->makeNext();
+                return MapEntry<K, V>(entry.first, entry.second);
+            }
+
+            virtual void remove() {
+                this->doRemove();
+            }
+        };
+
+        class KeyIterator : public Iterator<K>, public AbstractMapIterator {
+        private:
+
+            KeyIterator(const KeyIterator&);
+            KeyIterator& operator= (const KeyIterator&);
+
+        public:
+
+            KeyIterator(const ConcurrentHashMap* parent, ConcurrentHashMap* mutableParent) :
+                AbstractMapIterator(parent, mutableParent) {
+            }
+
+            virtual ~KeyIterator() {}
+
+            virtual bool hasNext() const {
+                return this->checkHasNext();
+            }
+
+            virtual K next() {
+                return this->makeNext().first;
+            }
+
+            virtual void remove() {
+                this->doRemove();
+            }
+        };
+
+        class ValueIterator : public Iterator<V>, public AbstractMapIterator {
+        private:
+
+            ValueIterator(const ValueIterator&);
+            ValueIterator& operator= (const ValueIterator&);
+
+        public:
+
+            ValueIterator(const ConcurrentHashMap* parent, ConcurrentHashMap* mutableParent) :
+                AbstractMapIterator(parent, mutableParent) {
+            }
+
+            virtual ~ValueIterator() {}
+
+            virtual bool hasNext() const {
+                return this->checkHasNext();
+            }
+
+            virtual V next() {
+                return this->makeNext().second;
+            }
+
+            virtual void remove() {
+                this->doRemove();
+            }
+        };
+
+    private:
+
+        // The views are backed by this map, the const versions are created with a
+        // NULL mutable map and throw UnsupportedOperationException on modification.
+        class HashMapEntrySet : public AbstractSet< MapEntry<K, V> > {
+        private:
+
+            const ConcurrentHashMap* associatedMap;
+            ConcurrentHashMap* mutableMap;
+
+        private:
+
+            HashMapEntrySet(const HashMapEntrySet&);
+            HashMapEntrySet& operator= (const HashMapEntrySet&);
+
+        public:
+
+            HashMapEntrySet(const ConcurrentHashMap* parent, ConcurrentHashMap* mutableParent) :
+                AbstractSet< MapEntry<K, V> >(), associatedMap(parent), mutableMap(mutableParent) {
+            }
+
+            virtual ~HashMapEntrySet() {}
+
+            virtual int size() const {
+                return associatedMap->size();
+            }
+
+            virtual void clear() {
+                checkWritable();
+                mutableMap->clear();
+            }
+
+            virtual bool remove(const MapEntry<K, V>& entry) {
+                checkWritable();
+                return mutableMap->remove(entry.getKey(), entry.getValue());
+            }
+
+            virtual bool contains(const MapEntry<K, V>& entry) const {
+                return associatedMap->containsEntry(entry.getKey(), entry.getValue());
+            }
+
+            virtual Iterator< MapEntry<K, V> >* iterator() {
+                checkWritable();
+                return new EntryIterator(associatedMap, mutableMap);
+            }
+
+            virtual Iterator< MapEntry<K, V> >* iterator() const {
+                return new EntryIterator(associatedMap, NULL);
+            }
+
+        private:
+
+            void checkWritable() const {
+                if (mutableMap == NULL) {
+                    throw decaf::lang::exceptions::UnsupportedOperationException(
+                        __FILE__, __LINE__, "Can't modify a const collection");
+                }
+            }
+        };
+
+        class HashMapKeySet : public AbstractSet<K> {
+        private:
+
+            const ConcurrentHashMap* associatedMap;
+            ConcurrentHashMap* mutableMap;
+
+        private:
+
+            HashMapKeySet(const HashMapKeySet&);
+            HashMapKeySet& operator= (const HashMapKeySet&);
+
+        public:
+
+            HashMapKeySet(const ConcurrentHashMap* parent, ConcurrentHashMap* mutableParent) :
+                AbstractSet<K>(), associatedMap(parent), mutableMap(mutableParent) {
+            }
+
+            virtual ~HashMapKeySet() {}
+
+            virtual bool contains(const K& key) const {
+                return associatedMap->containsKey(key);
+            }
+
+            virtual int size() const {
+                return associatedMap->size();
+            }
+
+            virtual void clear() {
+                checkWritable();
+                mutableMap->clear();
+            }
+
+            virtual bool remove(const K& key) {
+                checkWritable();
+                return mutableMap->removeEntry(key, NULL);
+            }
+
+            virtual Iterator<K>* iterator() {
+                checkWritable();
+                return new KeyIterator(associatedMap, mutableMap);
+            }
+
+            virtual Iterator<K>* iterator() const {
+                return new KeyIterator(associatedMap, NULL);
+            }
+
+        private:
+
+            void checkWritable() const {
+                if (mutableMap == NULL) {
+                    throw decaf::lang::exceptions::UnsupportedOperationException(
+                        __FILE__, __LINE__, "Can't modify a const collection");
+                }
+            }
+        };
+
+        class HashMapValueCollection : public AbstractCollection<V> {
+        private:
+
+            const ConcurrentHashMap* associatedMap;
+            ConcurrentHashMap* mutableMap;
+
+        private:
+
+            HashMapValueCollection(const HashMapValueCollection&);
+            HashMapValueCollection& operator= (const HashMapValueCollection&);
+
+        public:
+
+            HashMapValueCollection(const ConcurrentHashMap* parent, ConcurrentHashMap* mutableParent) :
+                AbstractCollection<V>(), associatedMap(parent), mutableMap(mutableParent) {
+            }
+
+            virtual ~HashMapValueCollection() {}
+
+            virtual bool contains(const V& value) const {
+                return associatedMap->containsValue(value);
+            }
+
+            virtual int size() const {
+                return associatedMap->size();
+            }
+
+            virtual void clear() {
+                if (mutableMap == NULL) {
+                    throw decaf::lang::exceptions::UnsupportedOperationException(
+                        __FILE__, __LINE__, "Can't modify a const collection");
+                }
+                mutableMap->clear();
+            }
+
+            virtual Iterator<V>* iterator() {
+                if (mutableMap == NULL) {
+                    throw decaf::lang::exceptions::UnsupportedOperationException(
+                        __FILE__, __LINE__, "Can't return a non-const iterator for a const collection");
+                }
+                return new ValueIterator(associatedMap, mutableMap);
+            }
+
+            virtual Iterator<V>* iterator() const {
+                return new ValueIterator(associatedMap, NULL);
+            }
+        };
+
+    private:
+
+        Segment* segments;
+        int segmentCount;
+        int segmentShift;
+        int segmentMask;
+
+        HASHCODE hashFunc;
+        COMPARATOR comparator;
+
+        // Only used to implement the Synchronizable interface and guard the cached views.
+        mutable Mutex mutex;
+
+        // Cached values that are only initialized once a request for them is made.
+        decaf::lang::Pointer<HashMapEntrySet> cachedEntrySet;
+        decaf::lang::Pointer<HashMapKeySet> cachedKeySet;
+        decaf::lang::Pointer<HashMapValueCollection> cachedValueCollection;
+
+        // Cached values that are only initialized once a request for them is made.
+        mutable decaf::lang::Pointer<HashMapEntrySet> cachedConstEntrySet;
+        mutable decaf::lang::Pointer<HashMapKeySet> cachedConstKeySet;
+        mutable decaf::lang::Pointer<HashMapValueCollection> cachedConstValueCollection;
+
+    private:
+
+        ConcurrentHashMap& operator= (const ConcurrentHashMap&);
+
+    public:
+
+        /**
+         * Creates a new empty map with the default initial capacity (16), load
+         * factor (0.75) and concurrency level (16).
+         */
+        ConcurrentHashMap() : ConcurrentMap<K, V>(), segments(NULL), segmentCount(0), segmentShift(0), segmentMask(0),
+                              hashFunc(), comparator(), mutex(), cachedEntrySet(), cachedKeySet(),
+                              cachedValueCollection(), cachedConstEntrySet(), cachedConstKeySet(),
+                              cachedConstValueCollection() {
+            this->initialize(DEFAULT_INITIAL_CAPACITY, 0.75f, DEFAULT_CONCURRENCY_LEVEL);
+        }
+
+        /**
+         * Creates a new empty map with the given initial capacity and the default
+         * load factor (0.75) and concurrency level (16).
+         *
+         * @param initialCapacity
+         *      The number of entries the map can hold before it needs to grow.
+         *
+         * @throws IllegalArgumentException if the initial capacity is negative.
+         */
+        ConcurrentHashMap(int initialCapacity) :
+            ConcurrentMap<K, V>(), segments(NULL), segmentCount(0), segmentShift(0), segmentMask(0),
+            hashFunc(), comparator(), mutex(), cachedEntrySet(), cachedKeySet(),
+            cachedValueCollection(), cachedConstEntrySet(), cachedConstKeySet(),
+            cachedConstValueCollection() {
+            this->initialize(initialCapacity, 0.75f, DEFAULT_CONCURRENCY_LEVEL);
+        }
+
+        /**
+         * Creates a new empty map.
+         *
+         * @param initialCapacity
+         *      The number of entries the map can hold before it needs to grow.
+         * @param loadFactor
+         *      The ratio of entries to buckets at which a segment grows.
+         * @param concurrencyLevel
+         *      The estimated number of threads updating the map at once, this is the
+         *      number of segments the map is divided into, rounded up to a power of two.
+         *
+         * @throws IllegalArgumentException if the initial capacity is negative or the load
+         *         factor or concurrency level are not positive.
+         */
+        ConcurrentHashMap(int initialCapacity, float loadFactor, int concurrencyLevel) :
+            ConcurrentMap<K, V>(), segments(NULL), segmentCount(0), segmentShift(0), segmentMask(0),
+            hashFunc(), comparator(), mutex(), cachedEntrySet(), cachedKeySet(),
+            cachedValueCollection(), cachedConstEntrySet(), cachedConstKeySet(),
+            cachedConstValueCollection() {
+            this->initialize(initialCapacity, loadFactor, concurrencyLevel);
+        }
+
+        /**
+         * Copy constructor - copies the content of the given map into this one.
+         *
+         * @param source
+         *      The source map.
+         */
+        ConcurrentHashMap(const ConcurrentHashMap& source) :
+            ConcurrentMap<K, V>(), segments(NULL), segmentCount(0), segmentShift(0), segmentMask(0),
+            hashFunc(), comparator(), mutex(), cachedEntrySet(), cachedKeySet(),
+            cachedValueCollection(), cachedConstEntrySet(), cachedConstKeySet(),
+            cachedConstValueCollection() {
+            this->initialize(source.size(), 0.75f, source.segmentCount);
+            this->putAll(source);
+        }
+
+        /**
+         * Copy constructor - copies the content of the given map into this one.
+         *
+         * @param source
+         *      The source map.
+         */
+        ConcurrentHashMap(const Map<K, V>& source) :
+            ConcurrentMap<K, V>(), segments(NULL), segmentCount(0), segmentShift(0), segmentMask(0),
+            hashFunc(), comparator(), mutex(), cachedEntrySet(), cachedKeySet(),
+            cachedValueCollection(), cachedConstEntrySet(), cachedConstKeySet(),
+            cachedConstValueCollection() {
+            this->initialize(source.size(), 0.75f, DEFAULT_CONCURRENCY_LEVEL);
+            this->putAll(source);
+        }
+
+        virtual ~ConcurrentHashMap() {
+            delete [] segments;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool equals(const Map<K, V>& source) const {
+            if (&source == this) {
+                return true;
+            }
+
+            if (source.size() != this->size()) {
+                return false;
+            }
+
+            std::vector< std::pair<K, V> > entries;
+            for (int i = 0; i < segmentCount; ++i) {
+                entries.clear();
+                snapshotSegment(segments[i], entries);
+
+                typename std::vector< std::pair<K, V> >::const_iterator iter = entries.begin();
+                for (; iter != entries.end(); ++iter) {
+                    if (!source.containsKey(iter->first) || !(source.get(iter->first) == iter->second)) {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual void copy(const Map<K, V>& source) {
+            if (&source == this) {
+                return;
+            }
+
+            this->clear();
+            this->putAll(source);
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual void clear() {
+            for (int i = 0; i < segmentCount; ++i) {
+                synchronized(&segments[i].mutex) {
+                    segments[i].clear();
+                }
+            }
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool containsKey(const K& key) const {
+            int hash = hashOf(key);
+            const Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                return findEntry(segment, key, hash) != NULL;
+            }
+
+            return false;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool containsValue(const V& value) const {
+            for (int i = 0; i < segmentCount; ++i) {
+                const Segment& segment = segments[i];
+                synchronized(&segment.mutex) {
+                    for (int j = 0; j < segment.capacity; ++j) {
+                        for (HashEntry* entry = segment.table[j]; entry != NULL; entry = entry->next) {
+                            if (entry->value == value) {
+                                return true;
+                            }
+                        }
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool isEmpty() const {
+            for (int i = 0; i < segmentCount; ++i) {
+                synchronized(&segments[i].mutex) {
+                    if (segments[i].count != 0) {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual int size() const {
+            long long result = 0;
+            for (int i = 0; i < segmentCount; ++i) {
+                synchronized(&segments[i].mutex) {
+                    result += segments[i].count;
+                }
+            }
+
+            return result > decaf::lang::Integer::MAX_VALUE ? decaf::lang::Integer::MAX_VALUE : (int) result;
+        }
+
+        /**
+         * {@inheritDoc}
+         *
+         * The returned reference remains valid until the mapping is removed.
+         */
+        virtual V& get(const K& key) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = findEntry(segment, key, hash);
+                if (entry != NULL) {
+                    return entry->value;
+                }
+            }
+
+            throw NoSuchElementException(
+                __FILE__, __LINE__, "Key does not exist in map");
+        }
+
+        /**
+         * {@inheritDoc}
+         *
+         * The returned reference remains valid until the mapping is removed.
+         */
+        virtual const V& get(const K& key) const {
+            int hash = hashOf(key);
+            const Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = findEntry(segment, key, hash);
+                if (entry != NULL) {
+                    return entry->value;
+                }
+            }
+
+            throw NoSuchElementException(
+                __FILE__, __LINE__, "Key does not exist in map");
+        }
+
+        /**
+         * Copies the value mapped to the given key while the key's segment is locked,
+         * unlike the reference returned from get the copy remains valid if another
+         * thread removes the mapping.
+         *
+         * @param key
+         *      The key whose value is to be returned.
+         * @param value
+         *      Assigned the value mapped to the key if there is one.
+         *
+         * @return true if the key was mapped and the value was assigned.
+         */
+        bool get(const K& key, V& value) const {
+            int hash = hashOf(key);
+            const Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = findEntry(segment, key, hash);
+                if (entry != NULL) {
+                    value = entry->value;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool put(const K& key, const V& value) {
+            return this->putEntry(key, value, NULL, false);
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool put(const K& key, const V& value, V& oldValue) {
+            return this->putEntry(key, value, &oldValue, false);
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual void putAll(const Map<K, V>& other) {
+            if (&other == this) {
+                return;
+            }
+
+            std::auto_ptr< Iterator< MapEntry<K, V> > > iterator(other.entrySet().iterator());
+            while (iterator->hasNext()) {
+                MapEntry<K, V> entry = iterator->next();
+                this->put(entry.getKey(), entry.getValue());
+            }
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual V remove(const K& key) {
+            V result = V();
+            this->removeEntry(key, NULL, &result);
+            return result;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool putIfAbsent(const K& key, const V& value) {
+            return !this->putEntry(key, value, NULL, true);
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool remove(const K& key, const V& value) {
+            return this->removeEntry(key, &value);
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool replace(const K& key, const V& oldValue, const V& newValue) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = findEntry(segment, key, hash);
+                if (entry != NULL && entry->value == oldValue) {
+                    entry->value = newValue;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual V replace(const K& key, const V& value) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = findEntry(segment, key, hash);
+                if (entry != NULL) {
+                    V result = entry->value;
+                    entry->value = value;
+                    return result;
+                }
+            }
+
+            throw NoSuchElementException(
+                __FILE__, __LINE__, "Value to Replace was not in the Map." );
+        }
+
+        virtual Set< MapEntry<K, V> >& entrySet() {
+            synchronized(&mutex) {
+                if (this->cachedEntrySet == NULL) {
+                    this->cachedEntrySet.reset(new HashMapEntrySet(this, this));
+                }
+            }
+            return *(this->cachedEntrySet);
+        }
+
+        virtual const Set< MapEntry<K, V> >& entrySet() const {
+            synchronized(&mutex) {
+                if (this->cachedConstEntrySet == NULL) {
+                    this->cachedConstEntrySet.reset(new HashMapEntrySet(this, NULL));
+                }
+            }
+            return *(this->cachedConstEntrySet);
+        }
+
+        virtual Set<K>& keySet() {
+            synchronized(&mutex) {
+                if (this->cachedKeySet == NULL) {
+                    this->cachedKeySet.reset(new HashMapKeySet(this, this));
+                }
+            }
+            return *(this->cachedKeySet);
+        }
+
+        virtual const Set<K>& keySet() const {
+            synchronized(&mutex) {
+                if (this->cachedConstKeySet == NULL) {
+                    this->cachedConstKeySet.reset(new HashMapKeySet(this, NULL));
+                }
+            }
+            return *(this->cachedConstKeySet);
+        }
+
+        virtual Collection<V>& values() {
+            synchronized(&mutex) {
+                if (this->cachedValueCollection == NULL) {
+                    this->cachedValueCollection.reset(new HashMapValueCollection(this, this));
+                }
+            }
+            return *(this->cachedValueCollection);
+        }
+
+        virtual const Collection<V>& values() const {
+            synchronized(&mutex) {
+                if (this->cachedConstValueCollection == NULL) {
+                    this->cachedConstValueCollection.reset(new HashMapValueCollection(this, NULL));
+                }
+            }
+            return *(this->cachedConstValueCollection);
+        }
+
     public:
 
-        ConcurrentHashMap() {}
-        virtual ~ConcurrentHashMap() {}
+        virtual void lock() {
+            mutex.lock();
+        }
+
+        virtual bool tryLock() {
+            return mutex.tryLock();
+        }
+
+        virtual void unlock() {
+            mutex.unlock();
+        }
+
+        virtual void wait() {
+            mutex.wait();
+        }
+
+        virtual void wait(long long millisecs) {
+            mutex.wait(millisecs);
+        }
+
+        virtual void wait(long long millisecs, int nanos) {
+            mutex.wait(millisecs, nanos);
+        }
+
+        virtual void notify() {
+            mutex.notify();
+        }
+
+        virtual void notifyAll() {
+            mutex.notifyAll();
+        }
+
+    private:
+
+        void initialize(int initialCapacity, float loadFactor, int concurrencyLevel) {
+
+            if (initialCapacity < 0) {
+                throw decaf::lang::exceptions::IllegalArgumentException(
+                    __FILE__, __LINE__, "Initial capacity must not be negative: %d", initialCapacity);
+            }
+
+            if (!(loadFactor > 0) || concurrencyLevel <= 0) {
+                throw decaf::lang::exceptions::IllegalArgumentException(
+                    __FILE__, __LINE__, "Load factor and concurrency level must be greater than zero.");
+            }
+
+            if (concurrencyLevel > MAXIMUM_SEGMENTS) {
+                concurrencyLevel = MAXIMUM_SEGMENTS;
+            }
+
+            if (initialCapacity > MAXIMUM_CAPACITY) {
+                initialCapacity = MAXIMUM_CAPACITY;
+            }
+
+            // The segment is chosen by the upper bits of the hash and the bucket within
+            // the segment by the lower bits.
+            int shift = 0;
+            int count = 1;
+            while (count < concurrencyLevel) {
+                ++shift;
+                count <<= 1;
+            }
+
+            int perSegment = initialCapacity / count;
+            if (perSegment * count < initialCapacity) {
+                ++perSegment;
+            }
+
+            int capacity = 2;
+            while (capacity < perSegment) {
+                capacity <<= 1;
+            }
+
+            this->segmentShift = 32 - shift;
+            this->segmentMask = count - 1;
+            this->segmentCount = count;
+            this->segments = new Segment[count];
+
+            for (int i = 0; i < count; ++i) {
+                this->segments[i].initialize(capacity, loadFactor);
+            }
+        }
+
+        // Spreads the bits of the key's hash code so that both the segment index taken
+        // from the upper bits and the bucket index taken from the lower bits are well
+        // distributed, the same variant of the Wang/Jenkins hash the JDK uses.
+        int hashOf(const K& key) const {
+            unsigned int h = (unsigned int) hashFunc(key);
+            h += (h << 15) ^ 0xffffcd7dU;
+            h ^= (h >> 10);
+            h += (h << 3);
+            h ^= (h >> 6);
+            h += (h << 2) + (h << 14);
+            return (int) (h ^ (h >> 16));
+        }
+
+        Segment& segmentFor(int hash) {
+            return segments[segmentShift == 32 ? 0 : ((unsigned int) hash >> segmentShift) & segmentMask];
+        }
+
+        const Segment& segmentFor(int hash) const {
+            return segments[segmentShift == 32 ? 0 : ((unsigned int) hash >> segmentShift) & segmentMask];
+        }
+
+        bool keysEqual(const K& left, const K& right) const {
+            return !comparator(left, right) && !comparator(right, left);
+        }
+
+        // Must be called with the segment's mutex held.
+        HashEntry* findEntry(const Segment& segment, const K& key, int hash) const {
+            HashEntry* entry = segment.bucket(hash);
+            while (entry != NULL && (entry->hash != hash || !keysEqual(entry->key, key))) {
+                entry = entry->next;
+            }
+            return entry;
+        }
+
+        // Returns true if the key was already mapped, the old value is copied out
+        // when requested and the mapping is left alone if onlyIfAbsent is set.
+        bool putEntry(const K& key, const V& value, V* oldValue, bool onlyIfAbsent) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = findEntry(segment, key, hash);
+                if (entry != NULL) {
+                    if (oldValue != NULL) {
+                        *oldValue = entry->value;
+                    }
+                    if (!onlyIfAbsent) {
+                        entry->value = value;
+                    }
+                    return true;
+                }
+
+                if (segment.count >= segment.threshold) {
+                    segment.rehash();
+                }
+
+                HashEntry*& head = segment.bucket(hash);
+                head = new HashEntry(key, value, hash, head);
+                segment.count++;
+            }
+
+            return false;
+        }
+
+        // Removes the key's mapping, if a value is given the mapping is only removed
+        // when it maps to that value.  Returns true if a mapping was removed.
+        bool removeEntry(const K& key, const V* value, V* oldValue = NULL) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry** link = &segment.bucket(hash);
+                while (*link != NULL) {
+                    HashEntry* entry = *link;
+                    if (entry->hash == hash && keysEqual(entry->key, key)) {
+                        if (value != NULL && !(entry->value == *value)) {
+                            return false;
+                        }
+
+                        if (oldValue != NULL) {
+                            *oldValue = entry->value;
+                        }
+
+                        *link = entry->next;
+                        segment.count--;
+                        delete entry;
+                        return true;
+                    }
+                    link = &entry->next;
+                }
+            }
+
+            return false;
+        }
+
+        bool containsEntry(const K& key, const V& value) const {
+            int hash = hashOf(key);
+            const Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = findEntry(segment, key, hash);
+                return entry != NULL && entry->value == value;
+            }
+
+            return false;
+        }
+
+        void snapshotSegment(const Segment& segment, std::vector< std::pair<K, V> >& entries) const {
+            synchronized(&segment.mutex) {
+                entries.reserve(segment.count);
+                for (int i = 0; i < segment.capacity; ++i) {
+                    for (HashEntry* entry = segment.table[i]; entry != NULL; entry = entry->next) {
+                        entries.push_back(std::make_pair(entry->key, entry->value));
+                    }
+                }
+            }
+        }
 
     };
 
@@ -20,6 +20,7 @@
 
 #include <string>
 #include <decaf/util/Config.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
 
 namespace decaf {
 namespace util {
@@ -61,7 +62,8 @@ namespace atomic {
          * @return the currently set value.
          */
         bool get() const {
-            return value == 0 ? false : true;
+            return internal::util::concurrent::Atomics::load(
+                &this->value, internal::util::concurrent::Atomics::SEQ_CST) != 0;
         }
 
         /**
@@ -69,7 +71,30 @@ namespace atomic {
          * @param newValue - the new value
          */
         void set(bool newValue) {
-            this->value = newValue ? 1 : 0;
+            internal::util::concurrent::Atomics::store(
+                &this->value, newValue ? 1 : 0, internal::util::concurrent::Atomics::SEQ_CST);
+        }
+
+        /**
+         * Gets the current value with only an acquire load, writes made before the
+         * store of the value read are visible but the load may be ordered before an
+         * earlier store by this thread.
+         * @return the current value.
+         */
+        bool getAcquire() const {
+            return internal::util::concurrent::Atomics::load(
+                &this->value, internal::util::concurrent::Atomics::ACQUIRE) != 0;
+        }
+
+        /**
+         * Eventually sets to the given value.  The store is only a release, writes
+         * made before it are visible to a thread that reads the new value but a
+         * later load by this thread may be ordered before it.
+         * @param newValue - the new value
+         */
+        void lazySet(bool newValue) {
+            internal::util::concurrent::Atomics::store(
+                &this->value, newValue ? 1 : 0, internal::util::concurrent::Atomics::RELEASE);
         }
 
         /**
@@ -81,7 +106,9 @@ namespace atomic {
          * @return true if successful. False return indicates that the actual value
          * was not equal to the expected value.
          */
-        bool compareAndSet(bool expect, bool update);
+        bool compareAndSet(bool expect, bool update) {
+            return internal::util::concurrent::Atomics::compareAndSet32(&this->value, expect ? 1 : 0, update ? 1 : 0);
+        }
 
         /**
          * Atomically sets to the given value and returns the previous value.
@@ -89,7 +116,9 @@ namespace atomic {
          * @param newValue - the new value
          * @return the previous value
          */
-        bool getAndSet(bool newValue);
+        bool getAndSet(bool newValue) {
+            return internal::util::concurrent::Atomics::getAndSet(&this->value, newValue ? 1 : 0) != 0;
+        }
 
         /**
          * Returns the String representation of the current value.
@@ -18,14 +18,12 @@
 #include "AtomicInteger.h"
 
 #include <decaf/lang/Integer.h>
-#include <decaf/internal/util/concurrent/Atomics.h>
 
 using namespace decaf;
 using namespace decaf::lang;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
 using namespace decaf::util::concurrent::atomic;
-using namespace decaf::internal::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
 AtomicInteger::AtomicInteger() :
@@ -37,67 +35,27 @@ AtomicInteger::AtomicInteger(int initialValue) :
     value(initialValue) {
 }
 
-////////////////////////////////////////////////////////////////////////////////
-int AtomicInteger::getAndSet(int newValue) {
-    return Atomics::getAndSet(&this->value, newValue);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-bool AtomicInteger::compareAndSet(int expect, int update) {
-    return Atomics::compareAndSet32(&this->value, expect, update);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-int AtomicInteger::getAndIncrement() {
-    return Atomics::getAndIncrement(&this->value);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-int AtomicInteger::getAndDecrement() {
-    return Atomics::getAndDecrement(&this->value);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-int AtomicInteger::getAndAdd(int delta) {
-    return Atomics::getAndAdd(&this->value, delta);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-int AtomicInteger::incrementAndGet() {
-    return Atomics::incrementAndGet(&this->value);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-int AtomicInteger::decrementAndGet() {
-    return Atomics::decrementAndGet(&this->value);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-int AtomicInteger::addAndGet(int delta) {
-    return Atomics::addAndGet(&this->value, delta);
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 std::string AtomicInteger::toString() const {
-    return Integer::toString(this->value);
+    return Integer::toString(get());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int AtomicInteger::intValue() const {
-    return this->value;
+    return get();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 long long AtomicInteger::longValue() const {
-    return Integer(value).longValue();
+    return Integer(get()).longValue();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 float AtomicInteger::floatValue() const {
-    return Integer(value).floatValue();
+    return Integer(get()).floatValue();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 double AtomicInteger::doubleValue() const {
-    return Integer(value).doubleValue();
+    return Integer(get()).doubleValue();
 }
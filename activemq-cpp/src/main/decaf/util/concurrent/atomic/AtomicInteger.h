@@ -20,6 +20,7 @@
 
 #include <decaf/util/Config.h>
 #include <decaf/lang/Number.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
 #include <string>
 
 namespace decaf {
@@ -64,7 +65,8 @@ namespace atomic {
          * @return the current value.
          */
         int get() const {
-            return this->value;
+            return internal::util::concurrent::Atomics::load(
+                &this->value, internal::util::concurrent::Atomics::SEQ_CST);
         }
 
         /**
@@ -72,7 +74,30 @@ namespace atomic {
          * @param newValue - the new value
          */
         void set( int newValue ) {
-            this->value = newValue;
+            internal::util::concurrent::Atomics::store(
+                &this->value, newValue, internal::util::concurrent::Atomics::SEQ_CST);
+        }
+
+        /**
+         * Gets the current value with only an acquire load, writes made before the
+         * store of the value read are visible but the load may be ordered before an
+         * earlier store by this thread.
+         * @return the current value.
+         */
+        int getAcquire() const {
+            return internal::util::concurrent::Atomics::load(
+                &this->value, internal::util::concurrent::Atomics::ACQUIRE);
+        }
+
+        /**
+         * Eventually sets to the given value.  The store is only a release, writes
+         * made before it are visible to a thread that reads the new value but a
+         * later load by this thread may be ordered before it.
+         * @param newValue - the new value
+         */
+        void lazySet( int newValue ) {
+            internal::util::concurrent::Atomics::store(
+                &this->value, newValue, internal::util::concurrent::Atomics::RELEASE);
         }
 
         /**
@@ -80,7 +105,9 @@ namespace atomic {
          * @param newValue - the new value.
          * @return the previous value.
          */
-        int getAndSet( int newValue );
+        int getAndSet( int newValue ) {
+            return internal::util::concurrent::Atomics::getAndSet(&this->value, newValue);
+        }
 
         /**
          * Atomically sets the value to the given updated value if the current
@@ -91,45 +118,59 @@ namespace atomic {
          * @return true if successful. False return indicates that the actual
          * value was not equal to the expected value.
          */
-        bool compareAndSet( int expect, int update );
+        bool compareAndSet( int expect, int update ) {
+            return internal::util::concurrent::Atomics::compareAndSet32(&this->value, expect, update);
+        }
 
         /**
          * Atomically increments by one the current value.
          * @return the previous value.
          */
-        int getAndIncrement();
+        int getAndIncrement() {
+            return internal::util::concurrent::Atomics::getAndIncrement(&this->value);
+        }
 
         /**
          * Atomically decrements by one the current value.
          * @return the previous value.
          */
-        int getAndDecrement();
+        int getAndDecrement() {
+            return internal::util::concurrent::Atomics::getAndDecrement(&this->value);
+        }
 
         /**
          * Atomically adds the given value to the current value.
          * @param delta - The value to add.
          * @return the previous value.
          */
-        int getAndAdd( int delta );
+        int getAndAdd( int delta ) {
+            return internal::util::concurrent::Atomics::getAndAdd(&this->value, delta);
+        }
 
         /**
          * Atomically increments by one the current value.
          * @return the updated value.
          */
-        int incrementAndGet();
+        int incrementAndGet() {
+            return internal::util::concurrent::Atomics::incrementAndGet(&this->value);
+        }
 
         /**
          * Atomically decrements by one the current value.
          * @return the updated value.
          */
-        int decrementAndGet();
+        int decrementAndGet() {
+            return internal::util::concurrent::Atomics::decrementAndGet(&this->value);
+        }
 
         /**
          * Atomically adds the given value to the current value.
          * @param delta - the value to add.
          * @return the updated value.
          */
-        int addAndGet( int delta );
+        int addAndGet( int delta ) {
+            return internal::util::concurrent::Atomics::addAndGet(&this->value, delta);
+        }
 
         /**
          * Returns the String representation of the current value.
@@ -16,3 +16,50 @@
  */
 
 #include "AtomicRefCounter.h"
+
+#include <decaf/internal/util/concurrent/Atomics.h>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::util;
+using namespace decaf::internal::util::concurrent;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+volatile int* AtomicRefCounter::share() const {
+
+    volatile int* current = (volatile int*)Atomics::load( (volatile void**)&this->counter, Atomics::ACQUIRE );
+
+    if( current == NULL ) {
+
+        // This was the only reference so the count starts at one, if another thread
+        // copying this same reference got there first its count is used instead.
+        volatile int* created = new int( 1 );
+        if( !Atomics::compareAndSet( (volatile void**)&this->counter, NULL, (void*)created, Atomics::ACQ_REL ) ) {
+            delete created;
+        }
+
+        current = (volatile int*)Atomics::load( (volatile void**)&this->counter, Atomics::ACQUIRE );
+    }
+
+    // Taking another reference needs no ordering, the copy being made already
+    // holds one so the count cannot reach zero underneath it.
+    Atomics::incrementAndGet( current, Atomics::RELAXED );
+    return current;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool AtomicRefCounter::releaseShared() {
+
+    // Releasing publishes this owner's writes to the pointee, the acquire half makes
+    // them all visible to whichever owner ends up deleting it.
+    if( Atomics::decrementAndGet( this->counter, Atomics::ACQ_REL ) == 0 ) {
+        delete this->counter;
+        this->counter = NULL;
+        return true;
+    }
+
+    return false;
+}
@@ -18,7 +18,7 @@
 #ifndef _DECAF_UTIL_CONCURRENT_ATOMIC_ATOMICREFCOUNTER_H_
 #define _DECAF_UTIL_CONCURRENT_ATOMIC_ATOMICREFCOUNTER_H_
 
-#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/util/Config.h>
 #include <algorithm>
 
 namespace decaf{
@@ -26,10 +26,21 @@ namespace util{
 namespace concurrent{
 namespace atomic{
 
-    class AtomicRefCounter {
+    /**
+     * The default reference counter used by decaf::lang::Pointer.
+     *
+     * The shared count is only allocated once a reference is copied, until then the
+     * single holder is known to be the only reference, so a Pointer that is never
+     * copied (including every NULL Pointer that is never copied) costs no allocation
+     * beyond that of the object it points to.  Once allocated the count is a plain
+     * integer that is updated atomically.
+     */
+    class DECAF_API AtomicRefCounter {
     private:
 
-        decaf::util::concurrent::atomic::AtomicInteger* counter;
+        // NULL while this is the only reference, otherwise the count shared by
+        // all the references.
+        mutable volatile int* counter;
 
     private:
 
@@ -37,13 +48,10 @@ namespace atomic{
 
     public:
 
-        AtomicRefCounter() :
-            counter( new decaf::util::concurrent::atomic::AtomicInteger( 1 ) ) {}
-        AtomicRefCounter( const AtomicRefCounter& other ) : counter( other.counter ) {
-            this->counter->incrementAndGet();
-        }
+        AtomicRefCounter() : counter( NULL ) {}
+        AtomicRefCounter( const AtomicRefCounter& other ) : counter( other.share() ) {}
 
-        virtual ~AtomicRefCounter() {}
+        ~AtomicRefCounter() {}
 
     protected:
 
@@ -66,12 +74,19 @@ namespace atomic{
          * @return true if the count is now zero.
          */
         bool release() {
-            if( this->counter->decrementAndGet() == 0 ) {
-                delete this->counter;
+            if( this->counter == NULL ) {
                 return true;
             }
-            return false;
+            return releaseShared();
         }
+
+    private:
+
+        // Creates the shared count on first use and adds a reference to it.
+        volatile int* share() const;
+
+        bool releaseShared();
+
     };
 
 }}}}
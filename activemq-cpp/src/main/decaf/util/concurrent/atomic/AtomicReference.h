@@ -53,17 +53,33 @@ namespace atomic {
          * @return the current value of this Reference.
          */
         T* get() const {
-            return (T*)value;
+            return (T*)internal::util::concurrent::Atomics::load(
+                const_cast<volatile void**>(&this->value), internal::util::concurrent::Atomics::ACQUIRE);
         }
 
         /**
-         * Sets the Current value of this Reference.
+         * Sets the Current value of this Reference, the store is sequentially consistent
+         * with the other atomic operations.
          *
          * @param newValue
          *        The new Value of this Reference.
          */
         void set( T* newValue ) {
-            internal::util::concurrent::Atomics::getAndSet(&this->value, (void*)newValue);
+            internal::util::concurrent::Atomics::store(
+                &this->value, (void*)newValue, internal::util::concurrent::Atomics::SEQ_CST);
+        }
+
+        /**
+         * Eventually sets the Current value of this Reference.  The store is only a
+         * release, writes made before it are visible to a thread that reads the new
+         * value but a later load by this thread may be ordered before it.
+         *
+         * @param newValue
+         *        The new Value of this Reference.
+         */
+        void lazySet( T* newValue ) {
+            internal::util::concurrent::Atomics::store(
+                &this->value, (void*)newValue, internal::util::concurrent::Atomics::RELEASE);
         }
 
         /**
@@ -96,7 +112,7 @@ namespace atomic {
          * @return string representation of the current value.
          */
         std::string toString() const {
-            return decaf::lang::Long::toString( (long long)this->value );
+            return decaf::lang::Long::toString( (long long)get() );
         }
 
     };
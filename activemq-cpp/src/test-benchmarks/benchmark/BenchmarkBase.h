@@ -24,6 +24,7 @@
 #include <benchmark/PerformanceTimer.h>
 #include <string>
 #include <iostream>
+#include <typeinfo>
 
 namespace benchmark{
 
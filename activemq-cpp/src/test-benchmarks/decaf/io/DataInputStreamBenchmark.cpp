@@ -17,6 +17,9 @@
 
 #include "DataInputStreamBenchmark.h"
 
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataOutputStream.h>
+
 using namespace std;
 using namespace decaf;
 using namespace decaf::io;
@@ -25,7 +28,10 @@ using namespace decaf::io;
 const int DataInputStreamBenchmark::bufferSize = 200000;
 
 ////////////////////////////////////////////////////////////////////////////////
-DataInputStreamBenchmark::DataInputStreamBenchmark() : buffer(), bis() {
+const int DataInputStreamBenchmark::utfCount = 5000;
+
+////////////////////////////////////////////////////////////////////////////////
+DataInputStreamBenchmark::DataInputStreamBenchmark() : buffer(), bis(), utfBuffer(), utfBis() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,12 +45,28 @@ void DataInputStreamBenchmark::setUp() {
     }
     buffer[bufferSize - 1] = 0;
     bis.setByteArray(buffer, bufferSize);
+
+    // Strings typical of what is found in a message, mostly plain ASCII with the
+    // occasional one that needs a multi-byte encoding.
+    ByteArrayOutputStream bos;
+    DataOutputStream dos(&bos);
+
+    for (int ix = 0; ix < utfCount; ++ix) {
+        dos.writeUTF("ID:hostname-55012-1375821428459-1:0:1:1:1");
+        dos.writeUTF("queue://TEST.FOO.BAR");
+        dos.writeUTF("JMSXGroupID");
+        dos.writeUTF("Caf\xE9 Cr\xE8me");
+    }
+
+    utfBuffer = bos.toByteArray();
+    utfBis.setByteArray(utfBuffer.first, utfBuffer.second);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void DataInputStreamBenchmark::tearDown() {
 
     delete[] buffer;
+    delete[] utfBuffer.first;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -112,4 +134,13 @@ void DataInputStreamBenchmark::run() {
         stringResult = dis.readString();
         bis.reset();
     }
+
+    DataInputStream utfDis(&utfBis);
+
+    for (int i = 0; i < 5; ++i) {
+        for (int iy = 0; iy < utfCount * 4; ++iy) {
+            stringResult = utfDis.readUTF();
+        }
+        utfBis.reset();
+    }
 }
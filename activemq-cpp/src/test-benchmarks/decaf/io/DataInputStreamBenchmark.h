@@ -35,6 +35,10 @@ namespace io{
         ByteArrayInputStream bis;
         static const int bufferSize;
 
+        std::pair<unsigned char*, int> utfBuffer;
+        ByteArrayInputStream utfBis;
+        static const int utfCount;
+
     private:
 
         DataInputStreamBenchmark( const DataInputStreamBenchmark& );
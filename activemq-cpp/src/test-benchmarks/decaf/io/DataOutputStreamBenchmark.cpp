@@ -78,6 +78,13 @@ void DataOutputStreamBenchmark::run() {
         dos.writeUTF(testString);
         bos.reset();
     }
+    for (int iy = 0; iy < numRuns * 40; ++iy) {
+        dos.writeUTF("ID:hostname-55012-1375821428459-1:0:1:1:1");
+        dos.writeUTF("queue://TEST.FOO.BAR");
+        dos.writeUTF("JMSXGroupID");
+        dos.writeUTF("Caf\xE9 Cr\xE8me");
+        bos.reset();
+    }
 
     bos.reset();
 }
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConcurrentStlMapBenchmark.h"
+
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+
+#include <vector>
+
+using namespace decaf;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int NUM_THREADS = 4;
+    const int NUM_KEYS = 1000;
+    const int NUM_OPERATIONS = 20000;
+
+    class MapWorker : public Runnable {
+    private:
+
+        ConcurrentStlMap<int, int>* map;
+        int seed;
+
+    private:
+
+        MapWorker(const MapWorker&);
+        MapWorker& operator= (const MapWorker&);
+
+    public:
+
+        MapWorker(ConcurrentStlMap<int, int>* map, int seed) : map(map), seed(seed) {}
+
+        virtual ~MapWorker() {}
+
+        virtual void run() {
+            int key = seed;
+            for (int i = 0; i < NUM_OPERATIONS; ++i) {
+                key = (key * 31 + 17) % NUM_KEYS;
+
+                // Mostly reads with the occasional update, as a connection's lookup tables see.
+                if (i % 10 == 0) {
+                    map->put(key, i);
+                } else if (i % 10 == 1) {
+                    map->remove(key);
+                } else {
+                    map->containsKey(key);
+                }
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ConcurrentStlMapBenchmark::ConcurrentStlMapBenchmark() : map() {
+    for (int i = 0; i < NUM_KEYS; ++i) {
+        map.put(i, i);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentStlMapBenchmark::run() {
+
+    std::vector<MapWorker*> workers;
+    std::vector<Thread*> threads;
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        workers.push_back(new MapWorker(&map, i + 1));
+        threads.push_back(new Thread(workers.back()));
+    }
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads[i]->start();
+    }
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads[i]->join();
+        delete threads[i];
+        delete workers[i];
+    }
+}
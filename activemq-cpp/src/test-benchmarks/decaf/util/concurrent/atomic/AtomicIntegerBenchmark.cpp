@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AtomicIntegerBenchmark.h"
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/util/concurrent/atomic/AtomicReference.h>
+
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+AtomicIntegerBenchmark::AtomicIntegerBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AtomicIntegerBenchmark::run() {
+
+    int numRuns = 500000;
+
+    AtomicInteger counter;
+    AtomicBoolean started(true);
+    AtomicReference<AtomicInteger> reference;
+    Pointer<AtomicInteger> shared(new AtomicInteger());
+    Pointer<AtomicInteger> owner(shared);
+
+    // Counters such as the delivered and ack counts of a consumer.
+    for (int i = 0; i < numRuns; ++i) {
+        counter.incrementAndGet();
+        counter.getAndAdd(2);
+        counter.decrementAndGet();
+    }
+
+    // Started and closed checks done before every send and read.
+    for (int i = 0; i < numRuns; ++i) {
+        if (started.get()) {
+            started.set(true);
+        }
+    }
+
+    for (int i = 0; i < numRuns; ++i) {
+        reference.set(shared.get());
+        reference.get()->get();
+    }
+
+    // Copying and dropping a shared Pointer, as done for each dispatched command.
+    for (int i = 0; i < numRuns; ++i) {
+        Pointer<AtomicInteger> copy(shared);
+        copy->set(i);
+    }
+}
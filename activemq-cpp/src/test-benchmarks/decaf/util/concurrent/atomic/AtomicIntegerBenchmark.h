@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_UTIL_CONCURRENT_ATOMIC_ATOMICINTEGERBENCHMARK_H_
+#define _DECAF_UTIL_CONCURRENT_ATOMIC_ATOMICINTEGERBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+namespace decaf {
+namespace util {
+namespace concurrent {
+namespace atomic {
+
+    /**
+     * Measures the atomic operations on the hot paths of the library, counter
+     * updates, flag reads and writes and the reference counting done on every
+     * copy of a shared Pointer.
+     */
+    class AtomicIntegerBenchmark :
+        public benchmark::BenchmarkBase<decaf::util::concurrent::atomic::AtomicIntegerBenchmark, AtomicInteger, 20> {
+    public:
+
+        AtomicIntegerBenchmark();
+        virtual ~AtomicIntegerBenchmark() {}
+
+        virtual void run();
+    };
+
+}}}}
+
+#endif /*_DECAF_UTIL_CONCURRENT_ATOMIC_ATOMICINTEGERBENCHMARK_H_*/
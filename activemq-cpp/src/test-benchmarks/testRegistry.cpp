@@ -15,6 +15,8 @@
  * limitations under the License.
  */
 
+#include <activemq/util/LongSequenceGeneratorBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::LongSequenceGeneratorBenchmark );
 #include <activemq/util/PrimitiveMapBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::PrimitiveMapBenchmark );
 
@@ -38,6 +40,13 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::StlListBenchmark );
 #include <decaf/util/LinkedListBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::LinkedListBenchmark );
 
+#include <decaf/util/concurrent/ConcurrentHashMapBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::ConcurrentHashMapBenchmark );
+#include <decaf/util/concurrent/ConcurrentStlMapBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::ConcurrentStlMapBenchmark );
+#include <decaf/util/concurrent/atomic/AtomicIntegerBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::atomic::AtomicIntegerBenchmark );
+
 #include <decaf/io/ByteArrayOutputStreamBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::io::ByteArrayOutputStreamBenchmark );
 #include <decaf/io/ByteArrayInputStreamBenchmark.h>
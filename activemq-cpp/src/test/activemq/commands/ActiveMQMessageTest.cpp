@@ -818,3 +818,107 @@ void ActiveMQMessageTest::testIsExpired() {
     msg.setCMSExpiration( System::currentTimeMillis() + 10000 );
     CPPUNIT_ASSERT( !msg.isExpired() );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMessageTest::testLazyPropertyUnmarshal() {
+
+    ActiveMQMessage sent;
+    sent.setIntProperty( "int", 42 );
+    sent.setStringProperty( "string", "value" );
+    sent.beforeMarshal( NULL );
+
+    std::vector<unsigned char> marshalled = sent.getMarshalledProperties();
+    CPPUNIT_ASSERT( !marshalled.empty() );
+
+    ActiveMQMessage received;
+    received.setMarshalledProperties( marshalled );
+    received.afterUnmarshal( NULL );
+
+    // Nothing is decoded yet but the size is still that of the marshaled form.
+    CPPUNIT_ASSERT_EQUAL( sent.getSize(), received.getSize() );
+
+    Pointer<ActiveMQMessage> copy( received.cloneDataStructure() );
+    CPPUNIT_ASSERT( marshalled == copy->getMarshalledProperties() );
+
+    CPPUNIT_ASSERT( received.propertyExists( "int" ) );
+    CPPUNIT_ASSERT_EQUAL( 42, received.getIntProperty( "int" ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "value" ), received.getStringProperty( "string" ) );
+    CPPUNIT_ASSERT_EQUAL( (std::size_t)2, received.getPropertyNames().size() );
+
+    CPPUNIT_ASSERT_EQUAL( 42, copy->getIntProperty( "int" ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "value" ), copy->getStringProperty( "string" ) );
+    CPPUNIT_ASSERT( received.getMessageProperties().equals( copy->getMessageProperties() ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMessageTest::testUnmodifiedPropertiesResentUnchanged() {
+
+    ActiveMQMessage sent;
+    sent.setIntProperty( "int", 42 );
+    sent.setBooleanProperty( "bool", true );
+    sent.beforeMarshal( NULL );
+
+    std::vector<unsigned char> marshalled = sent.getMarshalledProperties();
+
+    ActiveMQMessage received;
+    received.setMarshalledProperties( marshalled );
+    received.afterUnmarshal( NULL );
+
+    // Forwarding a message that was never looked at sends the same bytes.
+    received.beforeMarshal( NULL );
+    CPPUNIT_ASSERT( marshalled == received.getMarshalledProperties() );
+
+    // Reading the properties doesn't require them to be marshaled again.
+    CPPUNIT_ASSERT_EQUAL( true, received.getBooleanProperty( "bool" ) );
+    received.beforeMarshal( NULL );
+    CPPUNIT_ASSERT( marshalled == received.getMarshalledProperties() );
+
+    // A change is picked up the next time the message is sent.
+    received.setIntProperty( "int", 43 );
+    received.beforeMarshal( NULL );
+    CPPUNIT_ASSERT( marshalled != received.getMarshalledProperties() );
+
+    ActiveMQMessage resent;
+    resent.setMarshalledProperties( received.getMarshalledProperties() );
+    resent.afterUnmarshal( NULL );
+    CPPUNIT_ASSERT_EQUAL( 43, resent.getIntProperty( "int" ) );
+    CPPUNIT_ASSERT_EQUAL( true, resent.getBooleanProperty( "bool" ) );
+
+    // Clearing the properties of a received message also has to be sent.
+    resent.clearProperties();
+    resent.beforeMarshal( NULL );
+    CPPUNIT_ASSERT( resent.getMarshalledProperties().empty() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMessageTest::testCopySharesContent() {
+
+    std::vector<unsigned char> body( 64, 'a' );
+
+    ActiveMQMessage original;
+    original.setContent( body );
+
+    // A copy reads the same body without duplicating it.
+    Pointer<Message> copy = original.copy();
+    const Message* constOriginal = &original;
+    const Message* constCopy = copy.get();
+    CPPUNIT_ASSERT( &constOriginal->getContent() == &constCopy->getContent() );
+
+    // Replacing the body of the copy leaves the original alone.
+    copy->setContent( std::vector<unsigned char>( 8, 'b' ) );
+    CPPUNIT_ASSERT( body == original.getContent() );
+    CPPUNIT_ASSERT_EQUAL( (std::size_t) 8, constCopy->getContent().size() );
+
+    // Writing through the mutable accessor of either side takes a private copy first.
+    copy = original.copy();
+    constCopy = copy.get();
+    original.getContent()[0] = 'c';
+    CPPUNIT_ASSERT_EQUAL( (unsigned char) 'c', constOriginal->getContent()[0] );
+    CPPUNIT_ASSERT( body == constCopy->getContent() );
+
+    Pointer<Message> second = copy->copy();
+    const Message* constSecond = second.get();
+    copy->getContent().push_back( 'd' );
+    CPPUNIT_ASSERT( body == constSecond->getContent() );
+    CPPUNIT_ASSERT_EQUAL( body.size() + 1, constCopy->getContent().size() );
+}
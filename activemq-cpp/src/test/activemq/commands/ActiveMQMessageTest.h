@@ -75,6 +75,9 @@ namespace commands{
         CPPUNIT_TEST( testDoublePropertyConversion );
         CPPUNIT_TEST( testReadOnlyProperties );
         CPPUNIT_TEST( testIsExpired );
+        CPPUNIT_TEST( testLazyPropertyUnmarshal );
+        CPPUNIT_TEST( testUnmodifiedPropertiesResentUnchanged );
+        CPPUNIT_TEST( testCopySharesContent );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -142,6 +145,9 @@ namespace commands{
         void testStringPropertyConversion();
         void testReadOnlyProperties();
         void testIsExpired();
+        void testLazyPropertyUnmarshal();
+        void testUnmodifiedPropertiesResentUnchanged();
+        void testCopySharesContent();
 
     };
 
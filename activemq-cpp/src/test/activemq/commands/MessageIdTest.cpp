@@ -0,0 +1,140 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageIdTest.h"
+
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/SessionId.h>
+#include <activemq/commands/ConnectionId.h>
+#include <decaf/util/HashMap.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Integer.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageIdTest::testHashCode() {
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-host-54321-1234567890-1:1");
+    producerId->setSessionId(2);
+    producerId->setValue(3);
+
+    MessageId id1(producerId, 42);
+    MessageId id2("ID:test-host-54321-1234567890-1:1:2:3", 42);
+    MessageId id3(producerId, 43);
+
+    CPPUNIT_ASSERT(id1.equals(id2));
+    CPPUNIT_ASSERT_EQUAL(id1.getHashCode(), id2.getHashCode());
+    CPPUNIT_ASSERT(id1.getHashCode() != id3.getHashCode());
+
+    CPPUNIT_ASSERT_EQUAL(producerId->getHashCode(), id2.getProducerId()->getHashCode());
+
+    // A change to any field changes the hash, nothing is cached across it.
+    int hashCode = producerId->getHashCode();
+    producerId->setValue(4);
+    CPPUNIT_ASSERT(hashCode != producerId->getHashCode());
+    producerId->setValue(3);
+    CPPUNIT_ASSERT_EQUAL(hashCode, producerId->getHashCode());
+
+    MessageId empty;
+    CPPUNIT_ASSERT_EQUAL(empty.getHashCode(), MessageId().getHashCode());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageIdTest::testHashCodeOfParentIds() {
+
+    ConnectionId connectionId;
+    connectionId.setValue("ID:test-host-54321-1234567890-1:1");
+
+    SessionId sessionId(&connectionId, 7);
+    ConsumerId consumerId(sessionId, 9);
+    ProducerId producerId(sessionId, 9);
+
+    ConsumerId otherConsumerId;
+    otherConsumerId.setConnectionId(connectionId.getValue());
+    otherConsumerId.setSessionId(7);
+    otherConsumerId.setValue(9);
+
+    CPPUNIT_ASSERT(consumerId.equals(otherConsumerId));
+    CPPUNIT_ASSERT_EQUAL(consumerId.getHashCode(), otherConsumerId.getHashCode());
+
+    CPPUNIT_ASSERT_EQUAL(sessionId.getHashCode(), consumerId.getParentId()->getHashCode());
+    CPPUNIT_ASSERT_EQUAL(sessionId.getHashCode(), producerId.getParentId()->getHashCode());
+    CPPUNIT_ASSERT_EQUAL(connectionId.getHashCode(), sessionId.getParentId()->getHashCode());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageIdTest::testCompareTo() {
+
+    MessageId id1("ID:test-host-54321-1234567890-1:1:2:3", 42);
+    MessageId id2("ID:test-host-54321-1234567890-1:1:2:3", 42);
+    MessageId id3("ID:test-host-54321-1234567890-1:1:2:3", 43);
+    MessageId id4("ID:test-host-54321-1234567890-2:1:2:3", 1);
+
+    CPPUNIT_ASSERT_EQUAL(0, id1.compareTo(id2));
+    CPPUNIT_ASSERT(id1 == id2);
+    CPPUNIT_ASSERT(id1 < id3);
+    CPPUNIT_ASSERT(id3 < id4);
+    CPPUNIT_ASSERT(!(id4 < id1));
+
+    // The string compare still ignores case.
+    MessageId id5("id:TEST-HOST-54321-1234567890-1:1:2:3", 42);
+    CPPUNIT_ASSERT_EQUAL(0, id1.compareTo(id5));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageIdTest::testHashMapLookup() {
+
+    HashMap<ProducerId, int> producers;
+    HashMap<MessageId, int> messages;
+
+    for (int i = 0; i < 10; ++i) {
+        ProducerId producerId("ID:test-host-54321-1234567890-1:1:1:" + Integer::toString(i));
+        producers.put(producerId, i);
+
+        for (int j = 0; j < 10; ++j) {
+            messages.put(MessageId(producerId.toString(), j), i * 10 + j);
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(10, producers.size());
+    CPPUNIT_ASSERT_EQUAL(100, messages.size());
+
+    for (int i = 0; i < 10; ++i) {
+        ProducerId producerId;
+        producerId.setConnectionId("ID:test-host-54321-1234567890-1:1");
+        producerId.setSessionId(1);
+        producerId.setValue(i);
+
+        CPPUNIT_ASSERT(producers.containsKey(producerId));
+        CPPUNIT_ASSERT_EQUAL(i, producers.get(producerId));
+
+        for (int j = 0; j < 10; ++j) {
+            MessageId messageId(Pointer<ProducerId>(producerId.cloneDataStructure()), j);
+            CPPUNIT_ASSERT(messages.containsKey(messageId));
+            CPPUNIT_ASSERT_EQUAL(i * 10 + j, messages.get(messageId));
+        }
+    }
+}
@@ -0,0 +1,395 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AckCoalescerTest.h"
+
+#include <activemq/core/AckCoalescer.h>
+#include <activemq/core/ActiveMQConnectionFactory.h>
+#include <activemq/core/ActiveMQConsumer.h>
+#include <activemq/core/ActiveMQConstants.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ActiveMQTopic.h>
+#include <activemq/commands/LocalTransactionId.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/transport/DefaultTransportListener.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class CommandRecorder : public transport::DefaultTransportListener {
+    private:
+
+        Mutex mutex;
+        std::vector< Pointer<Command> > commands;
+
+    public:
+
+        CommandRecorder() : mutex(), commands() {}
+        virtual ~CommandRecorder() {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            synchronized(&mutex) {
+                commands.push_back(command);
+            }
+        }
+
+        std::vector< Pointer<MessageAck> > getAcks() {
+            std::vector< Pointer<MessageAck> > acks;
+            synchronized(&mutex) {
+                for (std::size_t i = 0; i < commands.size(); ++i) {
+                    if (commands[i]->isMessageAck()) {
+                        acks.push_back(commands[i].dynamicCast<MessageAck>());
+                    }
+                }
+            }
+            return acks;
+        }
+
+        std::vector< Pointer<Command> > getCommands() {
+            std::vector< Pointer<Command> > copy;
+            synchronized(&mutex) {
+                copy = commands;
+            }
+            return copy;
+        }
+    };
+
+    Pointer<ConsumerId> createConsumerId(long long value) {
+        Pointer<ConsumerId> id(new ConsumerId());
+        id->setConnectionId("ID:AckCoalescerTest");
+        id->setSessionId(1);
+        id->setValue(value);
+        return id;
+    }
+
+    Pointer<MessageId> createMessageId(long long sequence) {
+        return Pointer<MessageId>(new MessageId("ID:AckCoalescerTest:1:1", sequence));
+    }
+
+    Pointer<MessageAck> createAck(const Pointer<ConsumerId>& consumer, int type,
+                                  long long first, long long last) {
+
+        Pointer<MessageAck> ack(new MessageAck());
+        ack->setConsumerId(consumer);
+        ack->setDestination(Pointer<ActiveMQDestination>(new ActiveMQTopic("TestTopic")));
+        ack->setAckType((unsigned char) type);
+        ack->setFirstMessageId(createMessageId(first));
+        ack->setLastMessageId(createMessageId(last));
+        ack->setMessageCount((int) (last - first + 1));
+        return ack;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescerTest::setUp() {
+
+    ActiveMQConnectionFactory factory("mock://127.0.0.1:12345?wireFormat=openwire");
+
+    connection.reset(dynamic_cast<ActiveMQConnection*>(factory.createConnection()));
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    dTransport = dynamic_cast<transport::mock::MockTransport*>(
+        connection->getTransport().narrow(typeid(transport::mock::MockTransport)));
+    CPPUNIT_ASSERT(dTransport != NULL);
+
+    connection->start();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescerTest::tearDown() {
+    dTransport = NULL;
+    connection.reset(NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescerTest::testInvalidArguments() {
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        AckCoalescer(NULL, 10),
+        NullPointerException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        AckCoalescer(connection.get(), 0),
+        IllegalArgumentException);
+
+    AckCoalescer coalescer(connection.get(), 10);
+    CPPUNIT_ASSERT_EQUAL(10, coalescer.getMaxPending());
+    CPPUNIT_ASSERT_EQUAL(0, coalescer.getPendingCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescerTest::testMergesRangeAcks() {
+
+    CommandRecorder recorder;
+    dTransport->setOutgoingListener(&recorder);
+
+    AckCoalescer coalescer(connection.get(), 100);
+
+    Pointer<ConsumerId> consumer1 = createConsumerId(1);
+    Pointer<ConsumerId> consumer2 = createConsumerId(2);
+
+    Pointer<MessageAck> first = createAck(consumer1, ActiveMQConstants::ACK_TYPE_CONSUMED, 1, 1);
+
+    CPPUNIT_ASSERT(coalescer.add(first));
+    CPPUNIT_ASSERT(coalescer.add(createAck(consumer2, ActiveMQConstants::ACK_TYPE_CONSUMED, 10, 10)));
+    CPPUNIT_ASSERT(coalescer.add(createAck(consumer1, ActiveMQConstants::ACK_TYPE_CONSUMED, 2, 3)));
+    CPPUNIT_ASSERT(coalescer.add(createAck(consumer1, ActiveMQConstants::ACK_TYPE_CONSUMED, 4, 4)));
+    CPPUNIT_ASSERT(coalescer.add(createAck(consumer2, ActiveMQConstants::ACK_TYPE_CONSUMED, 11, 12)));
+
+    CPPUNIT_ASSERT_EQUAL(2, coalescer.getPendingCount());
+    CPPUNIT_ASSERT(recorder.getAcks().empty());
+
+    coalescer.flush();
+    dTransport->setOutgoingListener(NULL);
+
+    CPPUNIT_ASSERT_EQUAL(0, coalescer.getPendingCount());
+
+    std::vector< Pointer<MessageAck> > acks = recorder.getAcks();
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 2, acks.size());
+
+    CPPUNIT_ASSERT(acks[0]->getConsumerId()->equals(*consumer1));
+    CPPUNIT_ASSERT_EQUAL(1LL, acks[0]->getFirstMessageId()->getProducerSequenceId());
+    CPPUNIT_ASSERT_EQUAL(4LL, acks[0]->getLastMessageId()->getProducerSequenceId());
+    CPPUNIT_ASSERT_EQUAL(4, acks[0]->getMessageCount());
+
+    CPPUNIT_ASSERT(acks[1]->getConsumerId()->equals(*consumer2));
+    CPPUNIT_ASSERT_EQUAL(10LL, acks[1]->getFirstMessageId()->getProducerSequenceId());
+    CPPUNIT_ASSERT_EQUAL(12LL, acks[1]->getLastMessageId()->getProducerSequenceId());
+    CPPUNIT_ASSERT_EQUAL(3, acks[1]->getMessageCount());
+
+    // The ack that was merged into is left as the consumer made it.
+    CPPUNIT_ASSERT_EQUAL(1LL, first->getLastMessageId()->getProducerSequenceId());
+    CPPUNIT_ASSERT_EQUAL(1, first->getMessageCount());
+
+    // After a flush merging starts again from the consumer's next ack, the copy
+    // that was already sent is not touched.
+    dTransport->setOutgoingListener(&recorder);
+
+    Pointer<MessageAck> fifth = createAck(consumer1, ActiveMQConstants::ACK_TYPE_CONSUMED, 5, 5);
+    CPPUNIT_ASSERT(coalescer.add(fifth));
+    CPPUNIT_ASSERT(coalescer.add(createAck(consumer1, ActiveMQConstants::ACK_TYPE_CONSUMED, 6, 6)));
+
+    coalescer.flush();
+    dTransport->setOutgoingListener(NULL);
+
+    acks = recorder.getAcks();
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 3, acks.size());
+    CPPUNIT_ASSERT_EQUAL(5LL, acks[2]->getFirstMessageId()->getProducerSequenceId());
+    CPPUNIT_ASSERT_EQUAL(6LL, acks[2]->getLastMessageId()->getProducerSequenceId());
+    CPPUNIT_ASSERT_EQUAL(2, acks[2]->getMessageCount());
+    CPPUNIT_ASSERT_EQUAL(4, acks[0]->getMessageCount());
+    CPPUNIT_ASSERT_EQUAL(1, fifth->getMessageCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescerTest::testKeepsOrderOfOtherAcks() {
+
+    CommandRecorder recorder;
+    dTransport->setOutgoingListener(&recorder);
+
+    AckCoalescer coalescer(connection.get(), 100);
+
+    Pointer<ConsumerId> consumer = createConsumerId(1);
+
+    Pointer<MessageAck> transacted = createAck(consumer, ActiveMQConstants::ACK_TYPE_CONSUMED, 7, 7);
+    Pointer<LocalTransactionId> txId(new LocalTransactionId());
+    txId->setValue(1);
+    transacted->setTransactionId(txId);
+
+    // A delivered ack sits between two consumed acks, and individual and transacted
+    // acks are never merged.
+    coalescer.add(createAck(consumer, ActiveMQConstants::ACK_TYPE_CONSUMED, 1, 1));
+    coalescer.add(createAck(consumer, ActiveMQConstants::ACK_TYPE_DELIVERED, 2, 2));
+    coalescer.add(createAck(consumer, ActiveMQConstants::ACK_TYPE_CONSUMED, 2, 2));
+    coalescer.add(createAck(consumer, ActiveMQConstants::ACK_TYPE_INDIVIDUAL, 3, 3));
+    coalescer.add(createAck(consumer, ActiveMQConstants::ACK_TYPE_INDIVIDUAL, 4, 4));
+    coalescer.add(createAck(consumer, ActiveMQConstants::ACK_TYPE_CONSUMED, 5, 6));
+    coalescer.add(transacted);
+
+    CPPUNIT_ASSERT_EQUAL(7, coalescer.getPendingCount());
+
+    coalescer.flush();
+    dTransport->setOutgoingListener(NULL);
+
+    std::vector< Pointer<MessageAck> > acks = recorder.getAcks();
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 7, acks.size());
+
+    const int types[] = { ActiveMQConstants::ACK_TYPE_CONSUMED, ActiveMQConstants::ACK_TYPE_DELIVERED,
+                          ActiveMQConstants::ACK_TYPE_CONSUMED, ActiveMQConstants::ACK_TYPE_INDIVIDUAL,
+                          ActiveMQConstants::ACK_TYPE_INDIVIDUAL, ActiveMQConstants::ACK_TYPE_CONSUMED,
+                          ActiveMQConstants::ACK_TYPE_CONSUMED };
+    const long long last[] = { 1, 2, 2, 3, 4, 6, 7 };
+
+    for (std::size_t i = 0; i < acks.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(types[i], (int) acks[i]->getAckType());
+        CPPUNIT_ASSERT_EQUAL(last[i], acks[i]->getLastMessageId()->getProducerSequenceId());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescerTest::testFlushWhenFull() {
+
+    CommandRecorder recorder;
+    dTransport->setOutgoingListener(&recorder);
+
+    AckCoalescer coalescer(connection.get(), 2);
+
+    coalescer.add(createAck(createConsumerId(1), ActiveMQConstants::ACK_TYPE_CONSUMED, 1, 1));
+    coalescer.add(createAck(createConsumerId(1), ActiveMQConstants::ACK_TYPE_CONSUMED, 2, 2));
+    CPPUNIT_ASSERT_EQUAL(1, coalescer.getPendingCount());
+    CPPUNIT_ASSERT(recorder.getAcks().empty());
+
+    coalescer.add(createAck(createConsumerId(2), ActiveMQConstants::ACK_TYPE_CONSUMED, 3, 3));
+    CPPUNIT_ASSERT_EQUAL(0, coalescer.getPendingCount());
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 2, recorder.getAcks().size());
+
+    dTransport->setOutgoingListener(NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescerTest::testClearAndClose() {
+
+    CommandRecorder recorder;
+    dTransport->setOutgoingListener(&recorder);
+
+    AckCoalescer coalescer(connection.get(), 100);
+
+    CPPUNIT_ASSERT(coalescer.add(createAck(createConsumerId(1), ActiveMQConstants::ACK_TYPE_CONSUMED, 1, 1)));
+    coalescer.clear();
+    CPPUNIT_ASSERT_EQUAL(0, coalescer.getPendingCount());
+
+    CPPUNIT_ASSERT(coalescer.add(createAck(createConsumerId(1), ActiveMQConstants::ACK_TYPE_CONSUMED, 2, 2)));
+    coalescer.close();
+    CPPUNIT_ASSERT_EQUAL(0, coalescer.getPendingCount());
+    CPPUNIT_ASSERT(!coalescer.add(createAck(createConsumerId(1), ActiveMQConstants::ACK_TYPE_CONSUMED, 3, 3)));
+
+    coalescer.flush();
+    dTransport->setOutgoingListener(NULL);
+
+    CPPUNIT_ASSERT(recorder.getAcks().empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescerTest::testSessionFlushesBeforeConsumerClose() {
+
+    CommandRecorder recorder;
+
+    // No timer, the held ack can only go out when the session runs dry or the
+    // consumer is closed.
+    connection->setCoalesceAcks(true);
+    connection->setCoalesceAcksMaxDelay(0);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestTopic"));
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+
+    dTransport->setOutgoingListener(&recorder);
+
+    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+    message->setText("Coalesced");
+    message->setMessageId(createMessageId(1));
+    message->setCMSDestination(topic.get());
+
+    Pointer<MessageDispatch> dispatch(new MessageDispatch());
+    dispatch->setMessage(message);
+    dispatch->setConsumerId(Pointer<ConsumerId>(consumer->getConsumerId()->cloneDataStructure()));
+    dTransport->fireCommand(dispatch);
+
+    std::auto_ptr<cms::Message> received(consumer->receive(2000));
+    CPPUNIT_ASSERT(received.get() != NULL);
+
+    consumer->close();
+    dTransport->setOutgoingListener(NULL);
+
+    std::vector< Pointer<Command> > commands = recorder.getCommands();
+
+    int acks = 0;
+    bool removed = false;
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        if (commands[i]->isMessageAck()) {
+            CPPUNIT_ASSERT_MESSAGE("Ack was sent after the consumer was removed", !removed);
+            acks++;
+        } else if (commands[i]->isRemoveInfo()) {
+            removed = true;
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(1, acks);
+    CPPUNIT_ASSERT(removed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AckCoalescerTest::testTimerFlushesPendingAcks() {
+
+    CommandRecorder recorder;
+
+    connection->setCoalesceAcks(true);
+    connection->setCoalesceAcksMaxDelay(20);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestTopic"));
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+
+    dTransport->setOutgoingListener(&recorder);
+
+    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+    message->setText("Coalesced");
+    message->setMessageId(createMessageId(1));
+    message->setCMSDestination(topic.get());
+
+    Pointer<MessageDispatch> dispatch(new MessageDispatch());
+    dispatch->setMessage(message);
+    dispatch->setConsumerId(Pointer<ConsumerId>(consumer->getConsumerId()->cloneDataStructure()));
+    dTransport->fireCommand(dispatch);
+
+    std::auto_ptr<cms::Message> received(consumer->receive(2000));
+    CPPUNIT_ASSERT(received.get() != NULL);
+
+    // The ack is made after the consumer has run dry, only the timer sends it.
+    for (int i = 0; i < 100 && recorder.getAcks().empty(); ++i) {
+        Thread::sleep(20);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(1, (int) recorder.getAcks().size());
+
+    session->close();
+    dTransport->setOutgoingListener(NULL);
+
+    CPPUNIT_ASSERT_EQUAL(1, (int) recorder.getAcks().size());
+}
@@ -0,0 +1,74 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_ACKCOALESCERTEST_H_
+#define _ACTIVEMQ_CORE_ACKCOALESCERTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <activemq/core/ActiveMQConnection.h>
+#include <activemq/transport/mock/MockTransport.h>
+
+#include <memory>
+
+namespace activemq {
+namespace core {
+
+    class AckCoalescerTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( AckCoalescerTest );
+        CPPUNIT_TEST( testInvalidArguments );
+        CPPUNIT_TEST( testMergesRangeAcks );
+        CPPUNIT_TEST( testKeepsOrderOfOtherAcks );
+        CPPUNIT_TEST( testFlushWhenFull );
+        CPPUNIT_TEST( testClearAndClose );
+        CPPUNIT_TEST( testSessionFlushesBeforeConsumerClose );
+        CPPUNIT_TEST( testTimerFlushesPendingAcks );
+        CPPUNIT_TEST_SUITE_END();
+
+    private:
+
+        std::auto_ptr<ActiveMQConnection> connection;
+        transport::mock::MockTransport* dTransport;
+
+    private:
+
+        AckCoalescerTest(const AckCoalescerTest&);
+        AckCoalescerTest& operator=(const AckCoalescerTest&);
+
+    public:
+
+        AckCoalescerTest() : connection(), dTransport() {}
+        virtual ~AckCoalescerTest() {}
+
+        virtual void setUp();
+        virtual void tearDown();
+
+        void testInvalidArguments();
+        void testMergesRangeAcks();
+        void testKeepsOrderOfOtherAcks();
+        void testFlushWhenFull();
+        void testClearAndClose();
+        void testSessionFlushesBeforeConsumerClose();
+        void testTimerFlushesPendingAcks();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_ACKCOALESCERTEST_H_ */
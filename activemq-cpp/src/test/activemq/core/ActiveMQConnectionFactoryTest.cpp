@@ -307,7 +307,9 @@ void ActiveMQConnectionFactoryTest::testURIOptionsProcessing() {
             "connection.alwaysSyncSend=true&connection.useAsyncSend=true&"
             "connection.useCompression=true&connection.compressionLevel=7&"
             "connection.closeTimeout=10000&"
-            "connection.connectResponseTimeout=2000";
+            "connection.connectResponseTimeout=2000&"
+            "connection.useDedicatedTaskRunner=false&connection.maxThreadPoolSize=4&"
+            "connection.copyMessageOnSend=false";
 
         ActiveMQConnectionFactory connectionFactory( URI );
 
@@ -318,6 +320,9 @@ void ActiveMQConnectionFactoryTest::testURIOptionsProcessing() {
         CPPUNIT_ASSERT( connectionFactory.getCloseTimeout() == 10000 );
         CPPUNIT_ASSERT( connectionFactory.getCompressionLevel() == 7 );
         CPPUNIT_ASSERT( connectionFactory.getConnectResponseTimeout() == 2000 );
+        CPPUNIT_ASSERT( connectionFactory.isUseDedicatedTaskRunner() == false );
+        CPPUNIT_ASSERT( connectionFactory.getMaxThreadPoolSize() == 4 );
+        CPPUNIT_ASSERT( connectionFactory.isCopyMessageOnSend() == false );
 
         cms::Connection* connection =
             connectionFactory.createConnection();
@@ -333,6 +338,9 @@ void ActiveMQConnectionFactoryTest::testURIOptionsProcessing() {
         CPPUNIT_ASSERT( amqConnection->getCloseTimeout() == 10000 );
         CPPUNIT_ASSERT( amqConnection->getCompressionLevel() == 7 );
         CPPUNIT_ASSERT( amqConnection->getConnectResponseTimeout() == 2000 );
+        CPPUNIT_ASSERT( amqConnection->isUseDedicatedTaskRunner() == false );
+        CPPUNIT_ASSERT( amqConnection->getMaxThreadPoolSize() == 4 );
+        CPPUNIT_ASSERT( amqConnection->isCopyMessageOnSend() == false );
 
         delete connection;
 
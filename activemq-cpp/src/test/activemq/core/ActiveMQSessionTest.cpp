@@ -18,11 +18,15 @@
 #include "ActiveMQSessionTest.h"
 
 #include <cms/ExceptionListener.h>
+#include <cms/MessageNotWriteableException.h>
 #include <activemq/transport/mock/MockTransportFactory.h>
 #include <activemq/transport/TransportRegistry.h>
+#include <activemq/transport/DefaultTransportListener.h>
 #include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ConsumerControl.h>
 #include <activemq/commands/ConsumerId.h>
 #include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/ProducerAck.h>
 #include <activemq/core/ActiveMQConnectionFactory.h>
 #include <activemq/core/ActiveMQSession.h>
 #include <activemq/core/ActiveMQConsumer.h>
@@ -31,6 +35,8 @@
 #include <decaf/lang/System.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/Thread.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
 #include <decaf/net/Socket.h>
 #include <decaf/net/ServerSocket.h>
 
@@ -101,6 +107,101 @@ namespace core {
             AMQ_CATCHALL_THROW( activemq::exceptions::ActiveMQException )
         }
     };
+
+    class ConsumerControlRecorder : public transport::DefaultTransportListener {
+    public:
+
+        std::vector< Pointer<commands::ConsumerControl> > controls;
+
+    public:
+
+        ConsumerControlRecorder() : controls() {}
+        virtual ~ConsumerControlRecorder() {}
+
+        virtual void onCommand(const Pointer<commands::Command> command) {
+            if (command->isConsumerControl()) {
+                controls.push_back(command.dynamicCast<commands::ConsumerControl>());
+            }
+        }
+    };
+
+    class ClosingMessageListener : public MyCMSMessageListener {
+    public:
+
+        cms::MessageConsumer* toClose;
+
+    public:
+
+        ClosingMessageListener(cms::MessageConsumer* toClose) : MyCMSMessageListener(), toClose(toClose) {
+        }
+
+        virtual ~ClosingMessageListener() {}
+
+        virtual void onMessage( const cms::Message* message ) {
+            toClose->close();
+            MyCMSMessageListener::onMessage( message );
+        }
+    };
+
+    class BlockingMessageListener : public MyCMSMessageListener {
+    public:
+
+        decaf::util::concurrent::CountDownLatch entered;
+        decaf::util::concurrent::CountDownLatch release;
+
+    public:
+
+        BlockingMessageListener() : MyCMSMessageListener(), entered( 1 ), release( 1 ) {
+        }
+
+        virtual ~BlockingMessageListener() {}
+
+        virtual void onMessage( const cms::Message* message ) {
+            entered.countDown();
+            release.await();
+            MyCMSMessageListener::onMessage( message );
+        }
+    };
+
+    class InjectingRunnable : public decaf::lang::Runnable {
+    private:
+
+        ActiveMQSessionTest* test;
+        const cms::Destination* destination;
+        const commands::ConsumerId* id;
+
+    public:
+
+        InjectingRunnable( ActiveMQSessionTest* test, const cms::Destination* destination,
+                           const commands::ConsumerId* id ) :
+            Runnable(), test( test ), destination( destination ), id( id ) {
+        }
+
+        virtual ~InjectingRunnable() {}
+
+        virtual void run() {
+            test->injectTextMessage( "This is a Test", *destination, *id );
+        }
+    };
+
+    class ClosingRunnable : public decaf::lang::Runnable {
+    public:
+
+        cms::MessageConsumer* toClose;
+        decaf::util::concurrent::CountDownLatch closed;
+
+    public:
+
+        ClosingRunnable( cms::MessageConsumer* toClose ) : Runnable(), toClose( toClose ), closed( 1 ) {
+        }
+
+        virtual ~ClosingRunnable() {}
+
+        virtual void run() {
+            toClose->close();
+            closed.countDown();
+        }
+    };
 }}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -142,6 +243,168 @@ void ActiveMQSessionTest::testCreateManyConsumersAndSetListeners() {
     consumers.clear();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testDispatchToManyConsumers() {
+
+    static const int CONSUMER_COUNT = 100;
+
+    CPPUNIT_ASSERT( connection.get() != NULL );
+
+    // Create an Auto Ack Session
+    std::auto_ptr<cms::Session> session( connection->createSession() );
+    std::auto_ptr<cms::Topic> topic1( session->createTopic( "TestTopic1" ) );
+
+    std::vector< Pointer<MyCMSMessageListener> > listeners;
+    std::vector< Pointer<ActiveMQConsumer> > consumers;
+    for( int ix = 0; ix < CONSUMER_COUNT; ++ix ) {
+        Pointer<ActiveMQConsumer> consumer(
+            dynamic_cast<ActiveMQConsumer*>( session->createConsumer( topic1.get() ) ) );
+        Pointer<MyCMSMessageListener> listener( new MyCMSMessageListener() );
+        consumer->setMessageListener( listener.get() );
+        consumers.push_back( consumer );
+        listeners.push_back( listener );
+    }
+
+    // Each message must only reach the consumer its dispatch is addressed to.
+    injectTextMessage( "First", *topic1, *( consumers[CONSUMER_COUNT - 1]->getConsumerId() ) );
+    injectTextMessage( "Middle", *topic1, *( consumers[CONSUMER_COUNT / 2]->getConsumerId() ) );
+    injectTextMessage( "Last", *topic1, *( consumers[0]->getConsumerId() ) );
+
+    listeners[CONSUMER_COUNT - 1]->asyncWaitForMessages( 1 );
+    listeners[CONSUMER_COUNT / 2]->asyncWaitForMessages( 1 );
+    listeners[0]->asyncWaitForMessages( 1 );
+
+    for( int ix = 0; ix < CONSUMER_COUNT; ++ix ) {
+        bool expected = ix == 0 || ix == CONSUMER_COUNT / 2 || ix == CONSUMER_COUNT - 1;
+        CPPUNIT_ASSERT_EQUAL( expected ? 1 : 0, (int)listeners[ix]->messages.size() );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "Middle" ),
+        listeners[CONSUMER_COUNT / 2]->messages[0].dynamicCast<cms::TextMessage>()->getText() );
+
+    // A dispatch for a closed consumer is dropped.
+    consumers[0]->close();
+    injectTextMessage( "Closed", *topic1, *( consumers[0]->getConsumerId() ) );
+    CPPUNIT_ASSERT_EQUAL( 1, (int)listeners[0]->messages.size() );
+
+    for( int ix = 0; ix < CONSUMER_COUNT; ++ix ) {
+        consumers[ix]->close();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testCloseConsumerFromDispatch() {
+
+    CPPUNIT_ASSERT( connection.get() != NULL );
+
+    // Dispatch on the thread delivering the message so that the consumer
+    // is removed while the connection is still dispatching.
+    connection->setAlwaysSessionAsync( false );
+
+    std::auto_ptr<cms::Session> session( connection->createSession() );
+    std::auto_ptr<cms::Topic> topic1( session->createTopic( "TestTopic1" ) );
+
+    std::auto_ptr<ActiveMQConsumer> consumer1(
+        dynamic_cast<ActiveMQConsumer*>( session->createConsumer( topic1.get() ) ) );
+    std::auto_ptr<ActiveMQConsumer> consumer2(
+        dynamic_cast<ActiveMQConsumer*>( session->createConsumer( topic1.get() ) ) );
+
+    ClosingMessageListener msgListener1( consumer2.get() );
+    MyCMSMessageListener msgListener2;
+    consumer1->setMessageListener( &msgListener1 );
+    consumer2->setMessageListener( &msgListener2 );
+
+    injectTextMessage( "This is a Test 1", *topic1, *( consumer1->getConsumerId() ) );
+    msgListener1.asyncWaitForMessages( 1 );
+    CPPUNIT_ASSERT_EQUAL( 1, (int)msgListener1.messages.size() );
+
+    injectTextMessage( "This is a Test 2", *topic1, *( consumer2->getConsumerId() ) );
+    CPPUNIT_ASSERT_EQUAL( 0, (int)msgListener2.messages.size() );
+
+    consumer1->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testCloseConsumerWaitsForDispatch() {
+
+    CPPUNIT_ASSERT( connection.get() != NULL );
+
+    // Dispatch on the thread delivering the message so that the listener is
+    // still running inside the connection's dispatch.
+    connection->setAlwaysSessionAsync( false );
+
+    std::auto_ptr<cms::Session> session( connection->createSession() );
+    std::auto_ptr<cms::Topic> topic1( session->createTopic( "TestTopic1" ) );
+
+    std::auto_ptr<ActiveMQConsumer> consumer1(
+        dynamic_cast<ActiveMQConsumer*>( session->createConsumer( topic1.get() ) ) );
+
+    BlockingMessageListener msgListener1;
+    consumer1->setMessageListener( &msgListener1 );
+
+    InjectingRunnable injector( this, topic1.get(), consumer1->getConsumerId().get() );
+    Thread injectorThread( &injector );
+    injectorThread.start();
+    CPPUNIT_ASSERT( msgListener1.entered.await( 5000 ) );
+
+    // Closing from another thread must wait for the dispatch to finish.
+    ClosingRunnable closer( consumer1.get() );
+    Thread closerThread( &closer );
+    closerThread.start();
+    CPPUNIT_ASSERT( !closer.closed.await( 200 ) );
+
+    msgListener1.release.countDown();
+    CPPUNIT_ASSERT( closer.closed.await( 5000 ) );
+    CPPUNIT_ASSERT_EQUAL( 1, (int)msgListener1.messages.size() );
+
+    injectorThread.join();
+    closerThread.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testPooledSessionDispatch() {
+
+    static const int SESSION_COUNT = 6;
+
+    CPPUNIT_ASSERT( connection.get() != NULL );
+
+    // More sessions than pooled threads, each must still get its messages.
+    connection->setUseDedicatedTaskRunner( false );
+    connection->setMaxThreadPoolSize( 2 );
+
+    std::vector<cms::Session*> sessions;
+    std::vector<cms::Topic*> topics;
+    std::vector<ActiveMQConsumer*> consumers;
+    std::vector<MyCMSMessageListener*> listeners;
+
+    for( int ix = 0; ix < SESSION_COUNT; ++ix ) {
+        sessions.push_back( connection->createSession() );
+        topics.push_back( sessions[ix]->createTopic( "TestTopic" + Integer::toString( ix ) ) );
+        consumers.push_back(
+            dynamic_cast<ActiveMQConsumer*>( sessions[ix]->createConsumer( topics[ix] ) ) );
+        listeners.push_back( new MyCMSMessageListener() );
+        consumers[ix]->setMessageListener( listeners[ix] );
+    }
+
+    for( int ix = 0; ix < SESSION_COUNT; ++ix ) {
+        injectTextMessage( "Pooled 1", *topics[ix], *( consumers[ix]->getConsumerId() ) );
+        injectTextMessage( "Pooled 2", *topics[ix], *( consumers[ix]->getConsumerId() ) );
+    }
+
+    for( int ix = 0; ix < SESSION_COUNT; ++ix ) {
+        listeners[ix]->asyncWaitForMessages( 2 );
+        CPPUNIT_ASSERT_EQUAL( 2, (int)listeners[ix]->messages.size() );
+    }
+
+    for( int ix = 0; ix < SESSION_COUNT; ++ix ) {
+        sessions[ix]->close();
+        delete consumers[ix];
+        delete topics[ix];
+        delete sessions[ix];
+        delete listeners[ix];
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionTest::testAutoAcking() {
 
@@ -694,6 +957,239 @@ void ActiveMQSessionTest::testCreateTempTopicByName() {
     CPPUNIT_ASSERT(topic->getDestinationType() == cms::Destination::TEMPORARY_TOPIC);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testSendSetsMessageId() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestTopic"));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(topic.get()));
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("test"));
+
+    ActiveMQProducer* amqProducer = dynamic_cast<ActiveMQProducer*>(producer.get());
+    CPPUNIT_ASSERT(amqProducer != NULL);
+
+    std::string prefix = amqProducer->getProducerId()->toString();
+
+    producer->send(message.get());
+    CPPUNIT_ASSERT_EQUAL(prefix + ":1", message->getCMSMessageID());
+
+    producer->send(message.get());
+    CPPUNIT_ASSERT_EQUAL(prefix + ":2", message->getCMSMessageID());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testSendWithoutCopy() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestTopic"));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(topic.get()));
+    producer->setDeliveryMode(cms::DeliveryMode::NON_PERSISTENT);
+
+    // The default sends a copy and leaves the original writable.
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("test"));
+    producer->send(message.get());
+    message->setText("reused");
+
+    // Without the copy the original is sent and left read-only.
+    connection->setCopyMessageOnSend(false);
+
+    producer->send(message.get());
+    CPPUNIT_ASSERT_EQUAL(std::string("reused"), message->getText());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a MessageNotWriteableException",
+        message->setText("again"),
+        cms::MessageNotWriteableException);
+
+    ActiveMQProducer* amqProducer = dynamic_cast<ActiveMQProducer*>(producer.get());
+    CPPUNIT_ASSERT_EQUAL(amqProducer->getProducerId()->toString() + ":2", message->getCMSMessageID());
+
+    // Sends that need a response still go out as a copy.
+    std::auto_ptr<cms::TextMessage> persistent(session->createTextMessage("persistent"));
+    producer->send(persistent.get(), cms::DeliveryMode::PERSISTENT, 4, 0);
+    persistent->setText("reused");
+
+    // A send that fails leaves the application's message with the application.
+    std::auto_ptr<cms::TextMessage> failed(session->createTextMessage("failed"));
+    dTransport->setFailOnSendMessage(true);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException",
+        producer->send(failed.get()),
+        cms::CMSException);
+    dTransport->setFailOnSendMessage(false);
+    CPPUNIT_ASSERT_EQUAL(std::string("failed"), failed->getText());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testTrySendWithProducerWindow() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestTopic"));
+
+    // No window is configured by default so there's nothing to run out of.
+    std::auto_ptr<cms::MessageProducer> unlimited(session->createProducer(topic.get()));
+    ActiveMQProducer* amqUnlimited = dynamic_cast<ActiveMQProducer*>(unlimited.get());
+    CPPUNIT_ASSERT_EQUAL(-1LL, amqUnlimited->getProducerWindowCredit());
+
+    connection->setProducerWindowSize(16);
+
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(NULL));
+    producer->setDeliveryMode(cms::DeliveryMode::NON_PERSISTENT);
+    ActiveMQProducer* amqProducer = dynamic_cast<ActiveMQProducer*>(producer.get());
+    CPPUNIT_ASSERT_EQUAL(16LL, amqProducer->getProducerWindowCredit());
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("a message bigger than the window"));
+
+    CPPUNIT_ASSERT(amqProducer->trySend(topic.get(), message.get()));
+    CPPUNIT_ASSERT_EQUAL(0LL, amqProducer->getProducerWindowCredit());
+
+    // The window is full so the send is refused rather than blocking.
+    CPPUNIT_ASSERT(!amqProducer->trySend(topic.get(), message.get()));
+
+    // Once the Broker acknowledges the first send there's credit again.
+    Pointer<ProducerAck> ack(new ProducerAck());
+    ack->setProducerId(amqProducer->getProducerId());
+    ack->setSize(1024 * 1024);
+    dTransport->fireCommand(ack);
+
+    CPPUNIT_ASSERT_EQUAL(16LL, amqProducer->getProducerWindowCredit());
+    CPPUNIT_ASSERT(amqProducer->trySend(topic.get(), message.get(), cms::DeliveryMode::NON_PERSISTENT, 4, 0, NULL));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testTrySendPersistent() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    connection->setProducerWindowSize(1024);
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestTopic"));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(topic.get()));
+    ActiveMQProducer* amqProducer = dynamic_cast<ActiveMQProducer*>(producer.get());
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("persistent"));
+
+    // A persistent send outside a transaction waits for the Broker, trySend refuses it
+    // without using any of the window.
+    CPPUNIT_ASSERT_EQUAL((int) cms::DeliveryMode::PERSISTENT, producer->getDeliveryMode());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        amqProducer->trySend(message.get()),
+        cms::UnsupportedOperationException);
+    CPPUNIT_ASSERT_EQUAL(1024LL, amqProducer->getProducerWindowCredit());
+
+    // With async sends the persistent message goes out as a oneway.
+    connection->setUseAsyncSend(true);
+    CPPUNIT_ASSERT(amqProducer->trySend(message.get()));
+    CPPUNIT_ASSERT(amqProducer->getProducerWindowCredit() < 1024LL);
+
+    // A send timeout makes any send a request.
+    connection->setUseAsyncSend(false);
+    amqProducer->setSendTimeout(1000);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        amqProducer->trySend(topic.get(), message.get(), cms::DeliveryMode::NON_PERSISTENT, 4, 0, NULL),
+        cms::UnsupportedOperationException);
+
+    // So does a message that asks for a response itself.
+    amqProducer->setSendTimeout(0);
+    dynamic_cast<commands::Message*>(message.get())->setResponseRequired(true);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        amqProducer->trySend(topic.get(), message.get(), cms::DeliveryMode::NON_PERSISTENT, 4, 0, NULL),
+        cms::UnsupportedOperationException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testAdaptivePrefetch() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    ConsumerControlRecorder recorder;
+    dTransport->setOutgoingListener(&recorder);
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Topic> topic(session->createTopic(
+        "TestTopic?consumer.prefetchSize=500&consumer.adaptivePrefetch=true&consumer.adaptivePrefetchTarget=10"));
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+
+    CPPUNIT_ASSERT_EQUAL(500, consumer->getConsumerInfo()->getCurrentPrefetchSize());
+
+    injectTextMessage("Message 1", *topic, *(consumer->getConsumerId()));
+    injectTextMessage("Message 2", *topic, *(consumer->getConsumerId()));
+
+    std::auto_ptr<cms::Message> message(consumer->receive(1000));
+    CPPUNIT_ASSERT(message.get() != NULL);
+    CPPUNIT_ASSERT(recorder.controls.empty());
+
+    // Spending longer than the target on a message shrinks the prefetch to one.
+    Thread::sleep(30);
+
+    message.reset(consumer->receive(1000));
+    CPPUNIT_ASSERT(message.get() != NULL);
+
+    dTransport->setOutgoingListener(NULL);
+
+    CPPUNIT_ASSERT_EQUAL(1, consumer->getConsumerInfo()->getCurrentPrefetchSize());
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, recorder.controls.size());
+    CPPUNIT_ASSERT_EQUAL(1, recorder.controls[0]->getPrefetch());
+    CPPUNIT_ASSERT(recorder.controls[0]->getConsumerId()->equals(*consumer->getConsumerId()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testAdaptivePrefetchFollowsBroker() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    ConsumerControlRecorder recorder;
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Topic> topic(session->createTopic(
+        "TestTopic?consumer.prefetchSize=500&consumer.adaptivePrefetch=true&"
+        "consumer.adaptivePrefetchTarget=10&consumer.adaptivePrefetchMaximum=5000"));
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+
+    // The maximum is clamped to the configured prefetch.
+    CPPUNIT_ASSERT_EQUAL(500, consumer->getConsumerInfo()->getPrefetchSize());
+
+    Pointer<commands::ConsumerControl> control(new commands::ConsumerControl());
+    control->setConsumerId(Pointer<ConsumerId>(consumer->getConsumerId()->cloneDataStructure()));
+    control->setPrefetch(1);
+    dTransport->fireCommand(control);
+
+    for (int i = 0; i < 100 && consumer->getConsumerInfo()->getCurrentPrefetchSize() != 1; ++i) {
+        Thread::sleep(10);
+    }
+    CPPUNIT_ASSERT_EQUAL(1, consumer->getConsumerInfo()->getCurrentPrefetchSize());
+
+    dTransport->setOutgoingListener(&recorder);
+
+    injectTextMessage("Message 1", *topic, *(consumer->getConsumerId()));
+    injectTextMessage("Message 2", *topic, *(consumer->getConsumerId()));
+
+    std::auto_ptr<cms::Message> message(consumer->receive(1000));
+    CPPUNIT_ASSERT(message.get() != NULL);
+
+    // A slow message wants a prefetch of one, which the Broker already set.
+    Thread::sleep(30);
+
+    message.reset(consumer->receive(1000));
+    CPPUNIT_ASSERT(message.get() != NULL);
+
+    dTransport->setOutgoingListener(NULL);
+
+    CPPUNIT_ASSERT(recorder.controls.empty());
+    CPPUNIT_ASSERT_EQUAL(1, consumer->getConsumerInfo()->getCurrentPrefetchSize());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionTest::setUp() {
 
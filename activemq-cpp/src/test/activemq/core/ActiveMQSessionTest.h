@@ -49,8 +49,18 @@ namespace core{
         CPPUNIT_TEST( testTransactionCloseWithoutCommit );
         CPPUNIT_TEST( testExpiration );
         CPPUNIT_TEST( testCreateManyConsumersAndSetListeners );
+        CPPUNIT_TEST( testDispatchToManyConsumers );
+        CPPUNIT_TEST( testCloseConsumerFromDispatch );
+        CPPUNIT_TEST( testCloseConsumerWaitsForDispatch );
+        CPPUNIT_TEST( testPooledSessionDispatch );
         CPPUNIT_TEST( testCreateTempQueueByName );
         CPPUNIT_TEST( testCreateTempTopicByName );
+        CPPUNIT_TEST( testSendSetsMessageId );
+        CPPUNIT_TEST( testSendWithoutCopy );
+        CPPUNIT_TEST( testTrySendWithProducerWindow );
+        CPPUNIT_TEST( testTrySendPersistent );
+        CPPUNIT_TEST( testAdaptivePrefetch );
+        CPPUNIT_TEST( testAdaptivePrefetchFollowsBroker );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -98,6 +108,10 @@ namespace core{
         void testAutoAcking();
         void testClientAck();
         void testCreateManyConsumersAndSetListeners();
+        void testDispatchToManyConsumers();
+        void testCloseConsumerFromDispatch();
+        void testCloseConsumerWaitsForDispatch();
+        void testPooledSessionDispatch();
         void testTransactionCommitOneConsumer();
         void testTransactionCommitTwoConsumer();
         void testTransactionRollbackOneConsumer();
@@ -107,6 +121,12 @@ namespace core{
         void testExpiration();
         void testCreateTempQueueByName();
         void testCreateTempTopicByName();
+        void testSendSetsMessageId();
+        void testSendWithoutCopy();
+        void testTrySendWithProducerWindow();
+        void testTrySendPersistent();
+        void testAdaptivePrefetch();
+        void testAdaptivePrefetchFollowsBroker();
 
     };
 
@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AdaptivePrefetchControllerTest.h"
+
+#include <activemq/core/AdaptivePrefetchController.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const long long MILLIS = 1000000LL;
+
+    // Feeds samples until a change is proposed, returns -1 if none is within the limit.
+    int consumeUntilChanged(AdaptivePrefetchController& controller, long long serviceNanos, int limit) {
+        for (int i = 0; i < limit; ++i) {
+            int prefetch = controller.onMessageConsumed(serviceNanos);
+            if (prefetch != -1) {
+                return prefetch;
+            }
+        }
+
+        return -1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchControllerTest::testCtor() {
+
+    AdaptivePrefetchController controller(1000, 1, 5000, 100);
+
+    CPPUNIT_ASSERT_EQUAL(1000, controller.getPrefetch());
+    CPPUNIT_ASSERT_EQUAL(1, controller.getMinimum());
+    CPPUNIT_ASSERT_EQUAL(5000, controller.getMaximum());
+    CPPUNIT_ASSERT_EQUAL(100LL, controller.getTargetMillis());
+    CPPUNIT_ASSERT_EQUAL(0LL, controller.getAverageServiceNanos());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchControllerTest::testInvalidArguments() {
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException for a zero minimum",
+        AdaptivePrefetchController(10, 0, 100, 100),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException for a maximum below the minimum",
+        AdaptivePrefetchController(10, 20, 10, 100),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException for a zero target",
+        AdaptivePrefetchController(10, 1, 100, 0),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchControllerTest::testSlowConsumerShrinks() {
+
+    AdaptivePrefetchController controller(1000, 1, 1000, 100);
+
+    // 10ms per message only needs 10 messages to cover 100ms of work.
+    CPPUNIT_ASSERT_EQUAL(10, consumeUntilChanged(controller, 10 * MILLIS, 100));
+    CPPUNIT_ASSERT_EQUAL(10, controller.getPrefetch());
+    CPPUNIT_ASSERT_EQUAL(10 * MILLIS, controller.getAverageServiceNanos());
+
+    // Never below the minimum no matter how slow.
+    AdaptivePrefetchController bounded(1000, 5, 1000, 100);
+    CPPUNIT_ASSERT_EQUAL(5, consumeUntilChanged(bounded, 1000 * MILLIS, 100));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchControllerTest::testFastConsumerGrows() {
+
+    AdaptivePrefetchController controller(10, 1, 500, 100);
+
+    // 0.5ms per message wants 200 messages buffered.
+    CPPUNIT_ASSERT_EQUAL(200, consumeUntilChanged(controller, MILLIS / 2, 100));
+
+    // Never above the maximum no matter how fast.
+    CPPUNIT_ASSERT_EQUAL(500, consumeUntilChanged(controller, 1000, 100));
+    CPPUNIT_ASSERT_EQUAL(-1, consumeUntilChanged(controller, 1000, 100));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchControllerTest::testSmallChangesIgnored() {
+
+    AdaptivePrefetchController controller(100, 1, 1000, 100);
+
+    // Wants 80 which isn't far enough from 100 to be worth a change.
+    CPPUNIT_ASSERT_EQUAL(-1, consumeUntilChanged(controller, 1250000LL, 100));
+    CPPUNIT_ASSERT_EQUAL(100, controller.getPrefetch());
+
+    // After the Broker sets a prefetch the controller works from that one.
+    controller.setPrefetch(50);
+    CPPUNIT_ASSERT_EQUAL(80, consumeUntilChanged(controller, 1250000LL, 100));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchControllerTest::testSlowMessageAdjustsAtOnce() {
+
+    AdaptivePrefetchController controller(1000, 1, 1000, 100);
+
+    // One message that takes longer than the target is enough to act on.
+    CPPUNIT_ASSERT_EQUAL(1, controller.onMessageConsumed(250 * MILLIS));
+}
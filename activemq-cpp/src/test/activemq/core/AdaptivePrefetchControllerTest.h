@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_ADAPTIVEPREFETCHCONTROLLERTEST_H_
+#define _ACTIVEMQ_CORE_ADAPTIVEPREFETCHCONTROLLERTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace activemq {
+namespace core {
+
+    class AdaptivePrefetchControllerTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( AdaptivePrefetchControllerTest );
+        CPPUNIT_TEST( testCtor );
+        CPPUNIT_TEST( testInvalidArguments );
+        CPPUNIT_TEST( testSlowConsumerShrinks );
+        CPPUNIT_TEST( testFastConsumerGrows );
+        CPPUNIT_TEST( testSmallChangesIgnored );
+        CPPUNIT_TEST( testSlowMessageAdjustsAtOnce );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        AdaptivePrefetchControllerTest() {}
+        virtual ~AdaptivePrefetchControllerTest() {}
+
+        void testCtor();
+        void testInvalidArguments();
+        void testSlowConsumerShrinks();
+        void testFastConsumerGrows();
+        void testSmallChangesIgnored();
+        void testSlowMessageAdjustsAtOnce();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_ADAPTIVEPREFETCHCONTROLLERTEST_H_ */
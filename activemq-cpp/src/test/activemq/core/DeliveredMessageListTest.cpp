@@ -0,0 +1,332 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DeliveredMessageListTest.h"
+
+#include <activemq/core/DeliveredMessageList.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/ArrayList.h>
+#include <decaf/util/NoSuchElementException.h>
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::vector< Pointer<MessageDispatch> > createDispatches(int count) {
+        std::vector< Pointer<MessageDispatch> > dispatches;
+        for (int i = 0; i < count; ++i) {
+            dispatches.push_back(Pointer<MessageDispatch>(new MessageDispatch()));
+        }
+        return dispatches;
+    }
+
+    std::vector< Pointer<MessageDispatch> > iterate(const DeliveredMessageList& list) {
+        std::vector< Pointer<MessageDispatch> > result;
+        std::auto_ptr<Iterator< Pointer<MessageDispatch> > > iter(list.iterator());
+        while (iter->hasNext()) {
+            result.push_back(iter->next());
+        }
+        return result;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testCtor() {
+
+    DeliveredMessageList list;
+    CPPUNIT_ASSERT( list.isEmpty() );
+    CPPUNIT_ASSERT_EQUAL( 0, list.size() );
+    CPPUNIT_ASSERT( iterate(list).empty() );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NoSuchElementException",
+        list.getFirst(),
+        NoSuchElementException );
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NoSuchElementException",
+        list.getLast(),
+        NoSuchElementException );
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NoSuchElementException",
+        list.removeLast(),
+        NoSuchElementException );
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        list.addFirst(Pointer<MessageDispatch>()),
+        NullPointerException );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testAddFirst() {
+
+    std::vector< Pointer<MessageDispatch> > dispatches = createDispatches(3);
+
+    DeliveredMessageList list;
+    for (std::size_t i = 0; i < dispatches.size(); ++i) {
+        list.addFirst(dispatches[i]);
+    }
+
+    CPPUNIT_ASSERT( !list.isEmpty() );
+    CPPUNIT_ASSERT_EQUAL( 3, list.size() );
+    CPPUNIT_ASSERT( list.getFirst() == dispatches[2] );
+    CPPUNIT_ASSERT( list.getLast() == dispatches[0] );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testAddLast() {
+
+    std::vector< Pointer<MessageDispatch> > dispatches = createDispatches(3);
+
+    DeliveredMessageList list;
+    list.addFirst(dispatches[1]);
+    list.addLast(dispatches[0]);
+    list.addFirst(dispatches[2]);
+
+    CPPUNIT_ASSERT_EQUAL( 3, list.size() );
+    CPPUNIT_ASSERT( list.getFirst() == dispatches[2] );
+    CPPUNIT_ASSERT( list.getLast() == dispatches[0] );
+
+    std::vector< Pointer<MessageDispatch> > order = iterate(list);
+    CPPUNIT_ASSERT_EQUAL( (std::size_t) 3, order.size() );
+    CPPUNIT_ASSERT( order[0] == dispatches[2] );
+    CPPUNIT_ASSERT( order[1] == dispatches[1] );
+    CPPUNIT_ASSERT( order[2] == dispatches[0] );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testRemoveLast() {
+
+    std::vector< Pointer<MessageDispatch> > dispatches = createDispatches(4);
+
+    DeliveredMessageList list;
+    for (std::size_t i = 0; i < dispatches.size(); ++i) {
+        list.addFirst(dispatches[i]);
+    }
+
+    // A gap next to the oldest entry must be skipped once it is removed.
+    list.remove(dispatches[1]);
+
+    CPPUNIT_ASSERT( list.removeLast() == dispatches[0] );
+    CPPUNIT_ASSERT( list.getLast() == dispatches[2] );
+    CPPUNIT_ASSERT( list.removeLast() == dispatches[2] );
+    CPPUNIT_ASSERT( list.removeLast() == dispatches[3] );
+    CPPUNIT_ASSERT( list.isEmpty() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testContainsAndRemove() {
+
+    std::vector< Pointer<MessageDispatch> > dispatches = createDispatches(5);
+
+    DeliveredMessageList list;
+    for (std::size_t i = 0; i < dispatches.size(); ++i) {
+        list.addFirst(dispatches[i]);
+    }
+
+    Pointer<MessageDispatch> other(new MessageDispatch());
+    CPPUNIT_ASSERT( !list.contains(other) );
+    CPPUNIT_ASSERT( !list.remove(other) );
+
+    CPPUNIT_ASSERT( list.contains(dispatches[2]) );
+    CPPUNIT_ASSERT( list.remove(dispatches[2]) );
+    CPPUNIT_ASSERT( !list.contains(dispatches[2]) );
+    CPPUNIT_ASSERT( !list.remove(dispatches[2]) );
+    CPPUNIT_ASSERT_EQUAL( 4, list.size() );
+
+    CPPUNIT_ASSERT( list.remove(dispatches[4]) );
+    CPPUNIT_ASSERT( list.getFirst() == dispatches[3] );
+    CPPUNIT_ASSERT( list.remove(dispatches[0]) );
+    CPPUNIT_ASSERT( list.getLast() == dispatches[1] );
+
+    std::vector< Pointer<MessageDispatch> > order = iterate(list);
+    CPPUNIT_ASSERT_EQUAL( (std::size_t) 2, order.size() );
+    CPPUNIT_ASSERT( order[0] == dispatches[3] );
+    CPPUNIT_ASSERT( order[1] == dispatches[1] );
+
+    list.clear();
+    CPPUNIT_ASSERT( list.isEmpty() );
+    CPPUNIT_ASSERT( !list.contains(dispatches[1]) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testAddExisting() {
+
+    std::vector< Pointer<MessageDispatch> > dispatches = createDispatches(3);
+
+    DeliveredMessageList list;
+    for (std::size_t i = 0; i < dispatches.size(); ++i) {
+        list.addFirst(dispatches[i]);
+    }
+
+    list.addFirst(dispatches[0]);
+
+    CPPUNIT_ASSERT_EQUAL( 3, list.size() );
+    CPPUNIT_ASSERT( list.getFirst() == dispatches[0] );
+    CPPUNIT_ASSERT( list.getLast() == dispatches[1] );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testIterator() {
+
+    std::vector< Pointer<MessageDispatch> > dispatches = createDispatches(3);
+
+    DeliveredMessageList list;
+    for (std::size_t i = 0; i < dispatches.size(); ++i) {
+        list.addFirst(dispatches[i]);
+    }
+
+    std::auto_ptr<Iterator< Pointer<MessageDispatch> > > iter(list.iterator());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalStateException",
+        iter->remove(),
+        IllegalStateException );
+
+    CPPUNIT_ASSERT( iter->next() == dispatches[2] );
+    CPPUNIT_ASSERT( iter->next() == dispatches[1] );
+    CPPUNIT_ASSERT( iter->next() == dispatches[0] );
+    CPPUNIT_ASSERT( !iter->hasNext() );
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NoSuchElementException",
+        iter->next(),
+        NoSuchElementException );
+
+    const DeliveredMessageList& constList = list;
+    std::auto_ptr<Iterator< Pointer<MessageDispatch> > > constIter(constList.iterator());
+    constIter->next();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        constIter->remove(),
+        UnsupportedOperationException );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testIteratorRemove() {
+
+    std::vector< Pointer<MessageDispatch> > dispatches = createDispatches(6);
+
+    DeliveredMessageList list;
+    for (std::size_t i = 0; i < dispatches.size(); ++i) {
+        list.addFirst(dispatches[i]);
+    }
+
+    // Remove every other entry including both ends while walking the list.
+    std::auto_ptr<Iterator< Pointer<MessageDispatch> > > iter(list.iterator());
+    int index = 0;
+    while (iter->hasNext()) {
+        iter->next();
+        if (index++ % 2 == 0) {
+            iter->remove();
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 3, list.size() );
+    CPPUNIT_ASSERT( list.getFirst() == dispatches[4] );
+    CPPUNIT_ASSERT( list.getLast() == dispatches[0] );
+
+    std::vector< Pointer<MessageDispatch> > order = iterate(list);
+    CPPUNIT_ASSERT_EQUAL( (std::size_t) 3, order.size() );
+    CPPUNIT_ASSERT( order[0] == dispatches[4] );
+    CPPUNIT_ASSERT( order[1] == dispatches[2] );
+    CPPUNIT_ASSERT( order[2] == dispatches[0] );
+
+    // Removing everything from the oldest end leaves the list usable.
+    iter.reset(list.iterator());
+    while (iter->hasNext()) {
+        iter->next();
+        iter->remove();
+    }
+
+    CPPUNIT_ASSERT( list.isEmpty() );
+    list.addFirst(dispatches[5]);
+    CPPUNIT_ASSERT( list.getFirst() == dispatches[5] );
+    CPPUNIT_ASSERT( list.getLast() == dispatches[5] );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testCompaction() {
+
+    const int COUNT = 500;
+    std::vector< Pointer<MessageDispatch> > dispatches = createDispatches(COUNT);
+
+    DeliveredMessageList list;
+    list.addFirst(dispatches[0]);
+
+    // Keep the oldest entry around so that the removed ones leave gaps behind
+    // that can only be reclaimed by compacting the list.
+    for (int i = 1; i < COUNT - 1; ++i) {
+        list.addFirst(dispatches[i]);
+        if (i > 1) {
+            CPPUNIT_ASSERT( list.remove(dispatches[i - 1]) );
+        }
+    }
+
+    list.addFirst(dispatches[COUNT - 1]);
+
+    CPPUNIT_ASSERT_EQUAL( 3, list.size() );
+    CPPUNIT_ASSERT( list.getFirst() == dispatches[COUNT - 1] );
+    CPPUNIT_ASSERT( list.getLast() == dispatches[0] );
+
+    std::vector< Pointer<MessageDispatch> > order = iterate(list);
+    CPPUNIT_ASSERT_EQUAL( (std::size_t) 3, order.size() );
+    CPPUNIT_ASSERT( order[0] == dispatches[COUNT - 1] );
+    CPPUNIT_ASSERT( order[1] == dispatches[COUNT - 2] );
+    CPPUNIT_ASSERT( order[2] == dispatches[0] );
+
+    CPPUNIT_ASSERT( list.remove(dispatches[COUNT - 2]) );
+    CPPUNIT_ASSERT( list.removeLast() == dispatches[0] );
+    CPPUNIT_ASSERT( list.removeLast() == dispatches[COUNT - 1] );
+    CPPUNIT_ASSERT( list.isEmpty() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testCopy() {
+
+    std::vector< Pointer<MessageDispatch> > dispatches = createDispatches(4);
+
+    DeliveredMessageList list;
+    for (std::size_t i = 0; i < dispatches.size(); ++i) {
+        list.addFirst(dispatches[i]);
+    }
+
+    ArrayList< Pointer<MessageDispatch> > copy;
+    copy.copy(list);
+
+    CPPUNIT_ASSERT_EQUAL( 4, copy.size() );
+    CPPUNIT_ASSERT( copy.get(0) == dispatches[3] );
+    CPPUNIT_ASSERT( copy.get(3) == dispatches[0] );
+
+    DeliveredMessageList other;
+    other.copy(list);
+
+    CPPUNIT_ASSERT_EQUAL( 4, other.size() );
+    CPPUNIT_ASSERT( other.getFirst() == dispatches[3] );
+    CPPUNIT_ASSERT( other.getLast() == dispatches[0] );
+}
@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _ACTIVEMQ_CORE_DELIVEREDMESSAGELISTTEST_H_
+#define _ACTIVEMQ_CORE_DELIVEREDMESSAGELISTTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace activemq {
+namespace core {
+
+    class DeliveredMessageListTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( DeliveredMessageListTest );
+        CPPUNIT_TEST( testCtor );
+        CPPUNIT_TEST( testAddFirst );
+        CPPUNIT_TEST( testAddLast );
+        CPPUNIT_TEST( testRemoveLast );
+        CPPUNIT_TEST( testContainsAndRemove );
+        CPPUNIT_TEST( testAddExisting );
+        CPPUNIT_TEST( testIterator );
+        CPPUNIT_TEST( testIteratorRemove );
+        CPPUNIT_TEST( testCompaction );
+        CPPUNIT_TEST( testCopy );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        DeliveredMessageListTest() {}
+        virtual ~DeliveredMessageListTest() {}
+
+        void testCtor();
+        void testAddFirst();
+        void testAddLast();
+        void testRemoveLast();
+        void testContainsAndRemove();
+        void testAddExisting();
+        void testIterator();
+        void testIteratorRemove();
+        void testCompaction();
+        void testCopy();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_DELIVEREDMESSAGELISTTEST_H_ */
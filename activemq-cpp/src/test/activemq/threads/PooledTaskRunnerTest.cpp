@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PooledTaskRunnerTest.h"
+
+#include <memory>
+#include <vector>
+
+#include <activemq/threads/Task.h>
+#include <activemq/threads/DedicatedTaskRunner.h>
+#include <activemq/threads/PooledTaskRunner.h>
+#include <activemq/threads/TaskRunnerFactory.h>
+
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+using namespace activemq;
+using namespace activemq::threads;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class SimpleCountingTask : public Task {
+    private:
+
+        AtomicInteger count;
+
+    public:
+
+        SimpleCountingTask() : count(0) {}
+        virtual ~SimpleCountingTask() {}
+
+        virtual bool iterate() {
+
+            count.incrementAndGet();
+            return false;
+        }
+
+        int getCount() const { return count.get(); }
+    };
+
+    class InfiniteCountingTask : public Task {
+    private:
+
+        AtomicInteger count;
+
+    public:
+
+        InfiniteCountingTask() : count(0) {}
+        virtual ~InfiniteCountingTask() {}
+
+        virtual bool iterate() {
+
+            count.incrementAndGet();
+            return true;
+        }
+
+        int getCount() const { return count.get(); }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledTaskRunnerTest::testSimple() {
+
+    TaskRunnerFactory factory("PooledTaskRunnerTest");
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        std::auto_ptr<TaskRunner>( factory.createTaskRunner( NULL ) ),
+        NullPointerException );
+
+    SimpleCountingTask simpleTask;
+    CPPUNIT_ASSERT( simpleTask.getCount() == 0 );
+    std::auto_ptr<TaskRunner> simpleTaskRunner( factory.createTaskRunner( &simpleTask ) );
+    CPPUNIT_ASSERT( dynamic_cast<PooledTaskRunner*>( simpleTaskRunner.get() ) != NULL );
+
+    simpleTaskRunner->start();
+
+    simpleTaskRunner->wakeup();
+    Thread::sleep( 250 );
+    CPPUNIT_ASSERT( simpleTask.getCount() >= 1 );
+    simpleTaskRunner->wakeup();
+    Thread::sleep( 250 );
+    CPPUNIT_ASSERT( simpleTask.getCount() >= 2 );
+
+    InfiniteCountingTask infiniteTask;
+    CPPUNIT_ASSERT( infiniteTask.getCount() == 0 );
+    std::auto_ptr<TaskRunner> infiniteTaskRunner( factory.createTaskRunner( &infiniteTask ) );
+    infiniteTaskRunner->start();
+    Thread::sleep( 500 );
+    CPPUNIT_ASSERT( infiniteTask.getCount() != 0 );
+    infiniteTaskRunner->shutdown();
+    int count = infiniteTask.getCount();
+    Thread::sleep( 250 );
+    CPPUNIT_ASSERT( infiniteTask.getCount() == count );
+
+    simpleTaskRunner->shutdown();
+    factory.shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledTaskRunnerTest::testManyTasksShareSmallPool() {
+
+    static const int NUM_TASKS = 20;
+
+    // Two threads for more tasks than that, one of which never finishes, every
+    // task must still get its turn since the busy one yields the thread.
+    TaskRunnerFactory factory("PooledTaskRunnerTest", 10, false, 2);
+
+    InfiniteCountingTask busyTask;
+    std::auto_ptr<TaskRunner> busyRunner( factory.createTaskRunner( &busyTask ) );
+    busyRunner->start();
+
+    std::vector<SimpleCountingTask*> tasks;
+    std::vector<TaskRunner*> runners;
+    for( int i = 0; i < NUM_TASKS; ++i ) {
+        tasks.push_back( new SimpleCountingTask() );
+        runners.push_back( factory.createTaskRunner( tasks[i] ) );
+        runners[i]->start();
+    }
+
+    for( int i = 0; i < NUM_TASKS; ++i ) {
+        runners[i]->wakeup();
+    }
+
+    for( int i = 0; i < 100; ++i ) {
+        bool allRun = true;
+        for( int j = 0; j < NUM_TASKS; ++j ) {
+            if( tasks[j]->getCount() < 1 ) {
+                allRun = false;
+                break;
+            }
+        }
+
+        if( allRun ) {
+            break;
+        }
+
+        Thread::sleep( 50 );
+    }
+
+    for( int i = 0; i < NUM_TASKS; ++i ) {
+        CPPUNIT_ASSERT_MESSAGE( "Every task should have been run", tasks[i]->getCount() >= 1 );
+    }
+
+    busyRunner->shutdown();
+    for( int i = 0; i < NUM_TASKS; ++i ) {
+        runners[i]->shutdown();
+        delete runners[i];
+        delete tasks[i];
+    }
+
+    factory.shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledTaskRunnerTest::testFactoryCreatesDedicatedRunners() {
+
+    TaskRunnerFactory factory("PooledTaskRunnerTest");
+    factory.setDedicatedTaskRunner( true );
+
+    SimpleCountingTask task;
+    std::auto_ptr<TaskRunner> runner( factory.createTaskRunner( &task ) );
+    CPPUNIT_ASSERT( dynamic_cast<DedicatedTaskRunner*>( runner.get() ) != NULL );
+    runner->shutdown();
+
+    factory.shutdown();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalStateException",
+        factory.createTaskRunner( &task ),
+        decaf::lang::exceptions::IllegalStateException );
+}
@@ -21,12 +21,19 @@
 #include <decaf/lang/Runnable.h>
 #include <decaf/lang/Thread.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <memory>
+#include <set>
+#include <vector>
 
 using namespace std;
 using namespace decaf;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::util;
+using namespace decaf::util::concurrent;
 using namespace activemq;
 using namespace activemq::threads;
 
@@ -55,6 +62,63 @@ namespace {
         }
 
     };
+
+    class ThreadRecordingTask : public Runnable {
+    private:
+
+        Mutex* mutex;
+        std::set<long long>* threads;
+        CountDownLatch* latch;
+
+    private:
+
+        ThreadRecordingTask(const ThreadRecordingTask&);
+        ThreadRecordingTask& operator= (const ThreadRecordingTask&);
+
+    public:
+
+        ThreadRecordingTask(Mutex* mutex, std::set<long long>* threads, CountDownLatch* latch) :
+            mutex(mutex), threads(threads), latch(latch) {
+        }
+
+        virtual ~ThreadRecordingTask() {}
+
+        virtual void run() {
+            synchronized(mutex) {
+                threads->insert(Thread::currentThread()->getId());
+            }
+            latch->countDown();
+        }
+
+    };
+
+    class BlockingTask : public Runnable {
+    private:
+
+        CountDownLatch started;
+        CountDownLatch release;
+
+    public:
+
+        BlockingTask() : started(1), release(1) {
+        }
+
+        virtual ~BlockingTask() {}
+
+        bool awaitStarted(long long timeout) {
+            return started.await(timeout);
+        }
+
+        void unblock() {
+            release.countDown();
+        }
+
+        virtual void run() {
+            started.countDown();
+            release.await();
+        }
+
+    };
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -261,3 +325,59 @@ void SchedulerTest::testShutdown() {
         CPPUNIT_ASSERT(scheduler.isStopped());
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void SchedulerTest::testBlockedTaskDoesNotDelayOthers() {
+
+    Scheduler blocked("testBlockedTaskDoesNotDelayOthers-1");
+    blocked.start();
+    Scheduler other("testBlockedTaskDoesNotDelayOthers-2");
+    other.start();
+
+    BlockingTask blocking;
+    blocked.executePeriodically(&blocking, 50, false);
+    CPPUNIT_ASSERT(blocking.awaitStarted(2000));
+
+    CounterTask counter;
+    other.executeAfterDelay(&counter, 50, false);
+    Thread::sleep(500);
+    CPPUNIT_ASSERT_EQUAL(1, counter.getCount());
+
+    // Cancelling must not wait for the run that is still blocked.
+    blocked.cancel(&blocking);
+    blocking.unblock();
+
+    blocked.shutdown();
+    other.shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SchedulerTest::testSchedulersShareThreads() {
+
+    static const int SCHEDULERS = 20;
+
+    Mutex mutex;
+    std::set<long long> threads;
+    CountDownLatch latch(SCHEDULERS);
+
+    std::vector<Scheduler*> schedulers;
+    for (int i = 0; i < SCHEDULERS; ++i) {
+        schedulers.push_back(new Scheduler("testSchedulersShareThreads"));
+        schedulers.back()->start();
+        schedulers.back()->executeAfterDelay(new ThreadRecordingTask(&mutex, &threads, &latch), 10);
+    }
+
+    CPPUNIT_ASSERT(latch.await(5000));
+
+    // The tasks of all the Schedulers ran on the few threads of the shared pool.
+    synchronized(&mutex) {
+        CPPUNIT_ASSERT(!threads.empty());
+        CPPUNIT_ASSERT((int) threads.size() < SCHEDULERS);
+        CPPUNIT_ASSERT(threads.size() <= 4);
+    }
+
+    for (int i = 0; i < SCHEDULERS; ++i) {
+        schedulers[i]->shutdown();
+        delete schedulers[i];
+    }
+}
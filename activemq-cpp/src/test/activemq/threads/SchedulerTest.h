@@ -34,6 +34,8 @@ namespace threads {
         CPPUNIT_TEST( testExecuteAfterDelay );
         CPPUNIT_TEST( testCancel );
         CPPUNIT_TEST( testShutdown );
+        CPPUNIT_TEST( testBlockedTaskDoesNotDelayOthers );
+        CPPUNIT_TEST( testSchedulersShareThreads );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -48,6 +50,8 @@ namespace threads {
         void testExecuteAfterDelay();
         void testCancel();
         void testShutdown();
+        void testBlockedTaskDoesNotDelayOthers();
+        void testSchedulersShareThreads();
 
     };
 
@@ -0,0 +1,369 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TimerWheelTest.h"
+
+#include <activemq/threads/TimerWheel.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent::atomic;
+using namespace activemq;
+using namespace activemq::threads;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class CounterTask : public Runnable {
+    private:
+
+        AtomicInteger count;
+
+    public:
+
+        CounterTask() : count(0) {}
+
+        virtual ~CounterTask() {}
+
+        int getCount() const {
+            return count.get();
+        }
+
+        virtual void run() {
+            count.incrementAndGet();
+        }
+    };
+
+    class DestructionTrackingTask : public CounterTask {
+    private:
+
+        AtomicInteger* destroyed;
+
+    private:
+
+        DestructionTrackingTask(const DestructionTrackingTask&);
+        DestructionTrackingTask& operator= (const DestructionTrackingTask&);
+
+    public:
+
+        DestructionTrackingTask(AtomicInteger* destroyed) : CounterTask(), destroyed(destroyed) {}
+
+        virtual ~DestructionTrackingTask() {
+            destroyed->incrementAndGet();
+        }
+    };
+
+    class SelfCancellingTask : public Runnable {
+    private:
+
+        AtomicInteger count;
+
+    public:
+
+        Pointer<TimerWheelTimeout> timeout;
+
+        SelfCancellingTask() : count(0), timeout() {}
+
+        virtual ~SelfCancellingTask() {}
+
+        int getCount() const {
+            return count.get();
+        }
+
+        virtual void run() {
+            if (count.incrementAndGet() == 2) {
+                timeout->cancel();
+            }
+        }
+    };
+
+    class TimedTask : public Runnable {
+    public:
+
+        long long ranAt;
+
+        TimedTask() : ranAt(0) {}
+
+        virtual ~TimedTask() {}
+
+        virtual void run() {
+            ranAt = System::currentTimeMillis();
+        }
+    };
+
+    bool waitForCount(const CounterTask& task, int count, long long timeout) {
+        long long end = System::currentTimeMillis() + timeout;
+        while (task.getCount() < count && System::currentTimeMillis() < end) {
+            Thread::sleep(10);
+        }
+        return task.getCount() >= count;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheelTest::testConstructor() {
+
+    TimerWheel wheel("testConstructor", 20, 100);
+    CPPUNIT_ASSERT_EQUAL(20LL, wheel.getTickDuration());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        TimerWheel("testConstructor", 0, 100),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        TimerWheel("testConstructor", 10, 0),
+        IllegalArgumentException);
+
+    // The shared instance is created when the library is initialized.
+    CPPUNIT_ASSERT(TimerWheel::getInstance().getTickDuration() > 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheelTest::testScheduleInvalidArgs() {
+
+    TimerWheel wheel("testScheduleInvalidArgs");
+    CounterTask task;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a NullPointerException",
+        wheel.schedule(NULL, 10),
+        NullPointerException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        wheel.schedule(&task, -1, false),
+        IllegalArgumentException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        wheel.scheduleAtFixedRate(&task, 10, 0, false),
+        IllegalArgumentException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        wheel.scheduleWithFixedDelay(&task, 10, -5, false),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheelTest::testSchedule() {
+
+    TimerWheel wheel("testSchedule");
+    CounterTask task;
+
+    Pointer<TimerWheelTimeout> timeout = wheel.schedule(&task, 200, false);
+    CPPUNIT_ASSERT_EQUAL(1, wheel.getPendingCount());
+    CPPUNIT_ASSERT_EQUAL(false, timeout->isDone());
+    Thread::sleep(100);
+    CPPUNIT_ASSERT_EQUAL(0, task.getCount());
+
+    CPPUNIT_ASSERT(waitForCount(task, 1, 2000));
+    Thread::sleep(200);
+    CPPUNIT_ASSERT_EQUAL(1, task.getCount());
+    CPPUNIT_ASSERT_EQUAL(true, timeout->isDone());
+    CPPUNIT_ASSERT_EQUAL(false, timeout->isCancelled());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+    // Nothing left to cancel once a one time task has run.
+    CPPUNIT_ASSERT_EQUAL(false, timeout->cancel());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheelTest::testScheduleAtFixedRate() {
+
+    TimerWheel wheel("testScheduleAtFixedRate");
+    CounterTask task;
+
+    Pointer<TimerWheelTimeout> timeout = wheel.scheduleAtFixedRate(&task, 0, 100, false);
+    Thread::sleep(550);
+    CPPUNIT_ASSERT(task.getCount() >= 3);
+    CPPUNIT_ASSERT(task.getCount() <= 7);
+
+    CPPUNIT_ASSERT_EQUAL(true, timeout->cancel());
+    int count = task.getCount();
+    Thread::sleep(250);
+    CPPUNIT_ASSERT_EQUAL(count, task.getCount());
+    CPPUNIT_ASSERT_EQUAL(true, timeout->isDone());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheelTest::testScheduleWithFixedDelay() {
+
+    TimerWheel wheel("testScheduleWithFixedDelay");
+    CounterTask task;
+
+    Pointer<TimerWheelTimeout> timeout = wheel.scheduleWithFixedDelay(&task, 50, 100, false);
+    CPPUNIT_ASSERT(waitForCount(task, 3, 2000));
+    timeout->cancel();
+    int count = task.getCount();
+    Thread::sleep(250);
+    CPPUNIT_ASSERT_EQUAL(count, task.getCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheelTest::testCancel() {
+
+    TimerWheel wheel("testCancel");
+    AtomicInteger destroyed;
+
+    DestructionTrackingTask* task = new DestructionTrackingTask(&destroyed);
+    Pointer<TimerWheelTimeout> timeout = wheel.schedule(task, 200);
+    CPPUNIT_ASSERT_EQUAL(1, wheel.getPendingCount());
+
+    CPPUNIT_ASSERT_EQUAL(true, timeout->cancel());
+    CPPUNIT_ASSERT_EQUAL(false, timeout->cancel());
+    CPPUNIT_ASSERT_EQUAL(true, timeout->isCancelled());
+    CPPUNIT_ASSERT_EQUAL(true, timeout->isDone());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+    // An owned task is deleted as soon as it is cancelled.
+    CPPUNIT_ASSERT_EQUAL(1, destroyed.get());
+
+    CounterTask counter;
+    timeout = wheel.schedule(&counter, 100, false);
+    timeout->cancel();
+    Thread::sleep(250);
+    CPPUNIT_ASSERT_EQUAL(0, counter.getCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheelTest::testCancelFromTask() {
+
+    TimerWheel wheel("testCancelFromTask");
+    SelfCancellingTask task;
+
+    task.timeout = wheel.scheduleAtFixedRate(&task, 0, 20, false);
+    Thread::sleep(300);
+    CPPUNIT_ASSERT_EQUAL(2, task.getCount());
+    CPPUNIT_ASSERT_EQUAL(true, task.timeout->isDone());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheelTest::testDelayLongerThanOneTurn() {
+
+    // One turn of this wheel lasts 80ms, so the timeout goes around several times.
+    TimerWheel wheel("testDelayLongerThanOneTurn", 10, 8);
+    TimedTask task;
+
+    long long start = System::currentTimeMillis();
+    Pointer<TimerWheelTimeout> timeout = wheel.schedule(&task, 300, false);
+
+    Thread::sleep(200);
+    CPPUNIT_ASSERT_EQUAL(0LL, task.ranAt);
+
+    long long end = System::currentTimeMillis() + 2000;
+    while (task.ranAt == 0 && System::currentTimeMillis() < end) {
+        Thread::sleep(10);
+    }
+
+    CPPUNIT_ASSERT(task.ranAt != 0);
+    CPPUNIT_ASSERT(task.ranAt - start >= 290);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheelTest::testManyTimeouts() {
+
+    static const int COUNT = 2000;
+
+    TimerWheel wheel("testManyTimeouts");
+
+    std::vector<CounterTask*> tasks;
+    std::vector< Pointer<TimerWheelTimeout> > timeouts;
+
+    for (int i = 0; i < COUNT; ++i) {
+        tasks.push_back(new CounterTask());
+        timeouts.push_back(wheel.schedule(tasks[i], 100 + (i % 200), false));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(COUNT, wheel.getPendingCount());
+
+    for (int i = 0; i < COUNT; i += 2) {
+        timeouts[i]->cancel();
+    }
+
+    CPPUNIT_ASSERT_EQUAL(COUNT / 2, wheel.getPendingCount());
+
+    long long end = System::currentTimeMillis() + 5000;
+    while (wheel.getPendingCount() > 0 && System::currentTimeMillis() < end) {
+        Thread::sleep(20);
+    }
+
+    for (int i = 0; i < COUNT; ++i) {
+        timeouts[i]->cancel();
+        CPPUNIT_ASSERT_EQUAL(i % 2 == 0 ? 0 : 1, tasks[i]->getCount());
+        delete tasks[i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheelTest::testDestroyWithPendingTimeouts() {
+
+    AtomicInteger destroyed;
+    Pointer<TimerWheelTimeout> timeout;
+
+    {
+        TimerWheel wheel("testDestroyWithPendingTimeouts");
+        timeout = wheel.scheduleAtFixedRate(new DestructionTrackingTask(&destroyed), 1000, 1000);
+        wheel.schedule(new DestructionTrackingTask(&destroyed), 1000);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(2, destroyed.get());
+    CPPUNIT_ASSERT_EQUAL(true, timeout->isDone());
+    CPPUNIT_ASSERT_EQUAL(false, timeout->cancel());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimerWheelTest::testCompletedTimeoutOutlivesWheel() {
+
+    CounterTask task;
+    Pointer<TimerWheelTimeout> ran;
+    Pointer<TimerWheelTimeout> cancelled;
+
+    {
+        TimerWheel wheel("testCompletedTimeoutOutlivesWheel");
+        ran = wheel.schedule(&task, 10, false);
+        cancelled = wheel.schedule(&task, 10000, false);
+
+        CPPUNIT_ASSERT(waitForCount(task, 1, 2000));
+        CPPUNIT_ASSERT(cancelled->cancel());
+    }
+
+    // Both handles were finished before the wheel went away and must not touch it.
+    CPPUNIT_ASSERT_EQUAL(true, ran->isDone());
+    CPPUNIT_ASSERT_EQUAL(false, ran->isCancelled());
+    CPPUNIT_ASSERT_EQUAL(false, ran->cancel());
+    CPPUNIT_ASSERT_EQUAL(true, cancelled->isDone());
+    CPPUNIT_ASSERT_EQUAL(true, cancelled->isCancelled());
+    CPPUNIT_ASSERT_EQUAL(false, cancelled->cancel());
+}
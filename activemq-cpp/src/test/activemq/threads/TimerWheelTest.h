@@ -0,0 +1,64 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_THREADS_TIMERWHEELTEST_H_
+#define _ACTIVEMQ_THREADS_TIMERWHEELTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace activemq {
+namespace threads {
+
+    class TimerWheelTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( TimerWheelTest );
+        CPPUNIT_TEST( testConstructor );
+        CPPUNIT_TEST( testScheduleInvalidArgs );
+        CPPUNIT_TEST( testSchedule );
+        CPPUNIT_TEST( testScheduleAtFixedRate );
+        CPPUNIT_TEST( testScheduleWithFixedDelay );
+        CPPUNIT_TEST( testCancel );
+        CPPUNIT_TEST( testCancelFromTask );
+        CPPUNIT_TEST( testDelayLongerThanOneTurn );
+        CPPUNIT_TEST( testManyTimeouts );
+        CPPUNIT_TEST( testDestroyWithPendingTimeouts );
+        CPPUNIT_TEST( testCompletedTimeoutOutlivesWheel );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        TimerWheelTest() {}
+        virtual ~TimerWheelTest() {}
+
+        void testConstructor();
+        void testScheduleInvalidArgs();
+        void testSchedule();
+        void testScheduleAtFixedRate();
+        void testScheduleWithFixedDelay();
+        void testCancel();
+        void testCancelFromTask();
+        void testDelayLongerThanOneTurn();
+        void testManyTimeouts();
+        void testDestroyWithPendingTimeouts();
+        void testCompletedTimeoutOutlivesWheel();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_THREADS_TIMERWHEELTEST_H_ */
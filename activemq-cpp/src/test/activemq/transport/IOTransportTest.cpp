@@ -33,10 +33,13 @@
 #include <decaf/lang/Exception.h>
 #include <decaf/util/Random.h>
 
+#include <vector>
+
 using namespace activemq;
 using namespace activemq::transport;
 using namespace activemq::exceptions;
 using namespace decaf::io;
+using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -62,14 +65,52 @@ public:
     }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+class MyFrameDecoder : public wireformat::FrameDecoder {
+public:
+
+    std::string pending;
+
+    MyFrameDecoder() : pending() {}
+    virtual ~MyFrameDecoder(){}
+
+    virtual void receive( const unsigned char* buffer, int size AMQCPP_UNUSED, int offset, int length ) {
+        pending.append( (const char*)buffer + offset, length );
+    }
+
+    virtual Pointer<commands::Command> next( const activemq::transport::Transport* transport AMQCPP_UNUSED ) {
+
+        if( pending.empty() ) {
+            return Pointer<commands::Command>();
+        }
+
+        Pointer<MyCommand> command( new MyCommand() );
+        command->c = pending[0];
+        pending.erase( 0, 1 );
+        return command;
+    }
+
+    virtual int getPendingBytes() const {
+        return (int)pending.size();
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 class MyWireFormat : public wireformat::WireFormat {
 public:
 
-    MyWireFormat() : throwException(false) {}
+    MyWireFormat() : throwException(false), throwOnMarshal(false), frameDecoder(false) {}
     virtual ~MyWireFormat(){}
 
     bool throwException;
+    bool throwOnMarshal;
+    bool frameDecoder;
+
+    virtual bool hasFrameDecoder() const { return frameDecoder; }
+
+    virtual Pointer<wireformat::FrameDecoder> createFrameDecoder() {
+        return Pointer<wireformat::FrameDecoder>( new MyFrameDecoder() );
+    }
 
     virtual void setVersion( int version ) {}
 
@@ -142,6 +183,10 @@ public:
     {
         try{
 
+            if( throwOnMarshal ){
+                throw IOException();
+            }
+
             synchronized( outputStream ){
 
                 const MyCommand* m =
@@ -205,6 +250,54 @@ public:
     virtual void transportResumed() {}
 };
 
+////////////////////////////////////////////////////////////////////////////////
+class FlushCountingOutputStream : public decaf::io::ByteArrayOutputStream {
+public:
+
+    int flushes;
+
+    FlushCountingOutputStream() : decaf::io::ByteArrayOutputStream(), flushes(0) {}
+    virtual ~FlushCountingOutputStream(){}
+
+    virtual void flush() {
+        flushes++;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class CommandSender : public decaf::lang::Runnable {
+private:
+
+    IOTransport* transport;
+    char c;
+    int count;
+
+private:
+
+    CommandSender( const CommandSender& );
+    CommandSender& operator= ( const CommandSender& );
+
+public:
+
+    bool failed;
+
+    CommandSender( IOTransport* transport, char c, int count ) :
+        transport( transport ), c( c ), count( count ), failed( false ) {}
+    virtual ~CommandSender(){}
+
+    virtual void run() {
+        try{
+            for( int i = 0; i < count; ++i ) {
+                Pointer<MyCommand> cmd( new MyCommand() );
+                cmd->c = c;
+                transport->oneway( cmd );
+            }
+        }catch( decaf::lang::Exception& ){
+            failed = true;
+        }
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // This will just test that we can start and stop the
 // transport without any exceptions.
@@ -342,6 +435,160 @@ void IOTransportTest::testWrite(){
     transport.close();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testWriteCoalescing(){
+
+    decaf::io::BlockingByteArrayInputStream is;
+    FlushCountingOutputStream os;
+    decaf::io::DataInputStream input( &is );
+    decaf::io::DataOutputStream output( &os );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    MyTransportListener listener;
+    IOTransport transport;
+    transport.setInputStream( &input );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setWireFormat( wireFormat );
+
+    CPPUNIT_ASSERT( !transport.isWriteCoalescing() );
+    transport.setWriteCoalescing( true );
+    transport.setWriteCoalescingMaxDelay( 100 );
+    CPPUNIT_ASSERT( transport.isWriteCoalescing() );
+    CPPUNIT_ASSERT_EQUAL( 100, transport.getWriteCoalescingMaxDelay() );
+
+    transport.start();
+
+    Pointer<MyCommand> cmd( new MyCommand() );
+    cmd->c = '1';
+    transport.oneway( cmd );
+    cmd->c = '2';
+    transport.oneway( cmd );
+    cmd->c = '3';
+    transport.oneway( cmd );
+
+    // Each oneway only returns once its command has been written and flushed.
+    CPPUNIT_ASSERT_EQUAL( 3, os.flushes );
+
+    std::pair<const unsigned char*, int> array = os.toByteArray();
+    CPPUNIT_ASSERT_EQUAL( 3, array.second );
+    CPPUNIT_ASSERT( array.first[0] == '1' );
+    CPPUNIT_ASSERT( array.first[1] == '2' );
+    CPPUNIT_ASSERT( array.first[2] == '3' );
+    delete [] array.first;
+
+    transport.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testWriteCoalescingManyThreads(){
+
+    static const int NUM_THREADS = 8;
+    static const int NUM_COMMANDS = 500;
+
+    decaf::io::BlockingByteArrayInputStream is;
+    FlushCountingOutputStream os;
+    decaf::io::DataInputStream input( &is );
+    decaf::io::DataOutputStream output( &os );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    MyTransportListener listener;
+    IOTransport transport;
+    transport.setInputStream( &input );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setWireFormat( wireFormat );
+    transport.setWriteCoalescing( true );
+    transport.setWriteCoalescingMaxBytes( 64 );
+    transport.setWriteCoalescingMaxDelay( 200 );
+
+    transport.start();
+
+    std::vector<CommandSender*> senders;
+    std::vector<Thread*> threads;
+
+    for( int i = 0; i < NUM_THREADS; ++i ) {
+        senders.push_back( new CommandSender( &transport, (char)( 'a' + i ), NUM_COMMANDS ) );
+        threads.push_back( new Thread( senders[i] ) );
+    }
+
+    for( int i = 0; i < NUM_THREADS; ++i ) {
+        threads[i]->start();
+    }
+
+    for( int i = 0; i < NUM_THREADS; ++i ) {
+        threads[i]->join();
+        CPPUNIT_ASSERT( !senders[i]->failed );
+        delete threads[i];
+        delete senders[i];
+    }
+
+    std::pair<const unsigned char*, int> array = os.toByteArray();
+    CPPUNIT_ASSERT_EQUAL( NUM_THREADS * NUM_COMMANDS, array.second );
+
+    int counts[NUM_THREADS] = { 0 };
+    for( int i = 0; i < array.second; ++i ) {
+        int sender = array.first[i] - 'a';
+        CPPUNIT_ASSERT( sender >= 0 && sender < NUM_THREADS );
+        counts[sender]++;
+    }
+    delete [] array.first;
+
+    for( int i = 0; i < NUM_THREADS; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( NUM_COMMANDS, counts[i] );
+    }
+
+    // Never more than one flush per command, and a batch is never larger than
+    // the configured maximum.
+    CPPUNIT_ASSERT( os.flushes <= NUM_THREADS * NUM_COMMANDS );
+    CPPUNIT_ASSERT( os.flushes >= ( NUM_THREADS * NUM_COMMANDS ) / 64 );
+
+    transport.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testWriteCoalescingFailure(){
+
+    decaf::io::BlockingByteArrayInputStream is;
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::DataInputStream input( &is );
+    decaf::io::DataOutputStream output( &os );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    MyTransportListener listener;
+    IOTransport transport;
+    transport.setInputStream( &input );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setWireFormat( wireFormat );
+    transport.setWriteCoalescing( true );
+
+    transport.start();
+
+    Pointer<MyCommand> cmd( new MyCommand() );
+    cmd->c = '1';
+    transport.oneway( cmd );
+
+    wireFormat->throwOnMarshal = true;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException",
+        transport.oneway( cmd ),
+        IOException );
+
+    // A failed batch must not leave the writer role taken.
+    wireFormat->throwOnMarshal = false;
+    cmd->c = '2';
+    transport.oneway( cmd );
+
+    std::pair<const unsigned char*, int> array = os.toByteArray();
+    CPPUNIT_ASSERT_EQUAL( 2, array.second );
+    CPPUNIT_ASSERT( array.first[1] == '2' );
+    delete [] array.first;
+
+    transport.close();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void IOTransportTest::testException(){
 
@@ -379,6 +626,61 @@ void IOTransportTest::testException(){
     transport.close();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testReceiveWithoutReaderThread(){
+
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::DataOutputStream output( &os );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    MyTransportListener listener(10);
+    IOTransport transport;
+    transport.setUseReaderThread( false );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setWireFormat( wireFormat );
+
+    CPPUNIT_ASSERT( !transport.isUseReaderThread() );
+
+    wireFormat->frameDecoder = true;
+    transport.start();
+
+    unsigned char buffer[12] = { 'x', '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', 'x' };
+    transport.receive( buffer, 12, 1, 4 );
+    transport.receive( buffer, 12, 5, 6 );
+
+    listener.await();
+
+    CPPUNIT_ASSERT( listener.str == "1234567890" );
+
+    transport.receiveFailed( IOException( __FILE__, __LINE__, "Connection lost" ) );
+    CPPUNIT_ASSERT( listener.caughtOne );
+
+    transport.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testReceiveWithoutFrameDecoder(){
+
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::DataOutputStream output( &os );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    MyTransportListener listener;
+    IOTransport transport;
+    transport.setUseReaderThread( false );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setWireFormat( wireFormat );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException when the WireFormat can't decode pushed data",
+        transport.start(),
+        IOException );
+
+    transport.close();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void IOTransportTest::testNarrow(){
 
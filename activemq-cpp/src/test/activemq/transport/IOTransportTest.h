@@ -32,7 +32,12 @@ namespace transport{
         CPPUNIT_TEST( testStressTransportStartClose );
         CPPUNIT_TEST( testRead );
         CPPUNIT_TEST( testWrite );
+        CPPUNIT_TEST( testWriteCoalescing );
+        CPPUNIT_TEST( testWriteCoalescingManyThreads );
+        CPPUNIT_TEST( testWriteCoalescingFailure );
         CPPUNIT_TEST( testException );
+        CPPUNIT_TEST( testReceiveWithoutReaderThread );
+        CPPUNIT_TEST( testReceiveWithoutFrameDecoder );
         CPPUNIT_TEST( testNarrow );
         CPPUNIT_TEST_SUITE_END();
 
@@ -42,9 +47,14 @@ namespace transport{
 
         void testException();
         void testWrite();
+        void testWriteCoalescing();
+        void testWriteCoalescingManyThreads();
+        void testWriteCoalescingFailure();
         void testRead();
         void testStartClose();
         void testStressTransportStartClose();
+        void testReceiveWithoutReaderThread();
+        void testReceiveWithoutFrameDecoder();
         void testNarrow();
 
     };
@@ -19,6 +19,7 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/commands/BaseCommand.h>
+#include <activemq/commands/ExceptionResponse.h>
 #include <activemq/wireformat/WireFormat.h>
 #include <activemq/transport/DefaultTransportListener.h>
 #include <activemq/transport/correlator/ResponseCorrelator.h>
@@ -26,6 +27,7 @@
 #include <decaf/util/concurrent/Concurrent.h>
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <queue>
+#include <vector>
 
 using namespace activemq;
 using namespace activemq::transport;
@@ -264,6 +266,42 @@ namespace correlator {
         }
     };
 
+    class MyHoldingTransport : public MyTransport {
+    public:
+
+        std::vector< Pointer<Command> > held;
+
+    public:
+
+        MyHoldingTransport() : MyTransport(), held() {}
+        virtual ~MyHoldingTransport() {}
+
+        // Requests are held until the test responds to them, oneways are dropped.
+        virtual void oneway(const Pointer<Command> command) {
+            if (command->isResponseRequired()) {
+                synchronized(&mutex) {
+                    held.push_back(command);
+                    mutex.notifyAll();
+                }
+            }
+        }
+
+        Pointer<Command> awaitRequest(std::size_t index) {
+            synchronized(&mutex) {
+                while (held.size() <= index) {
+                    mutex.wait();
+                }
+                return held[index];
+            }
+
+            return Pointer<Command>();
+        }
+
+        void respond(const Pointer<Command> command) {
+            listener->onCommand(createResponse(command));
+        }
+    };
+
     class MyListener : public DefaultTransportListener {
     public:
 
@@ -514,3 +552,104 @@ void ResponseCorrelatorTest::testNarrow(){
     narrowed = correlator.narrow(typeid( correlator ));
     CPPUNIT_ASSERT(narrowed == &correlator);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ResponseCorrelatorTest::testRequestTimeout() {
+
+    MyListener listener;
+    Pointer<MyHoldingTransport> transport(new MyHoldingTransport());
+    ResponseCorrelator correlator(transport);
+    correlator.setTransportListener(&listener);
+    correlator.start();
+
+    Pointer<MyCommand> cmd(new MyCommand);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException when no response arrives in time",
+        correlator.request(cmd, 100),
+        IOException);
+
+    // A late response to the abandoned request is dropped.
+    transport->respond(transport->awaitRequest(0));
+    CPPUNIT_ASSERT(listener.commands.size() == 0);
+
+    // The next request can still get its response.
+    RequestThread requestor;
+    requestor.setTransport(&correlator);
+    requestor.start();
+
+    transport->respond(transport->awaitRequest(1));
+    requestor.join();
+
+    CPPUNIT_ASSERT(requestor.resp != NULL);
+    CPPUNIT_ASSERT_EQUAL(requestor.cmd->getCommandId(), requestor.resp->getCorrelationId());
+
+    correlator.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ResponseCorrelatorTest::testCloseFailsPendingRequest() {
+
+    MyListener listener;
+    Pointer<MyHoldingTransport> transport(new MyHoldingTransport());
+    ResponseCorrelator correlator(transport);
+    correlator.setTransportListener(&listener);
+    correlator.start();
+
+    RequestThread requestor;
+    requestor.setTransport(&correlator);
+    requestor.start();
+
+    transport->awaitRequest(0);
+    correlator.close();
+    requestor.join();
+
+    CPPUNIT_ASSERT(requestor.resp != NULL);
+    CPPUNIT_ASSERT(requestor.resp.dynamicCast<commands::ExceptionResponse>() != NULL);
+
+    // Requests made after the close fail right away.
+    Pointer<MyCommand> cmd(new MyCommand);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException after close",
+        correlator.request(cmd),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ResponseCorrelatorTest::testManyOutstandingRequests() {
+
+    MyListener listener;
+    Pointer<MyHoldingTransport> transport(new MyHoldingTransport());
+    ResponseCorrelator correlator(transport);
+    correlator.setTransportListener(&listener);
+    correlator.start();
+
+    RequestThread first;
+    first.setTransport(&correlator);
+    first.start();
+    transport->awaitRequest(0);
+
+    // Push the command ids along far enough that the next request shares its
+    // response slot with the first one while it is still outstanding.
+    for (int i = 0; i < 1023; ++i) {
+        correlator.oneway(Pointer<Command>(new MyCommand));
+    }
+
+    RequestThread second;
+    second.setTransport(&correlator);
+    second.start();
+    transport->awaitRequest(1);
+
+    CPPUNIT_ASSERT_EQUAL(first.cmd->getCommandId() + 1024, second.cmd->getCommandId());
+
+    transport->respond(transport->awaitRequest(1));
+    second.join();
+    transport->respond(transport->awaitRequest(0));
+    first.join();
+
+    CPPUNIT_ASSERT(first.resp != NULL);
+    CPPUNIT_ASSERT_EQUAL(first.cmd->getCommandId(), first.resp->getCorrelationId());
+    CPPUNIT_ASSERT(second.resp != NULL);
+    CPPUNIT_ASSERT_EQUAL(second.cmd->getCommandId(), second.resp->getCorrelationId());
+
+    correlator.close();
+}
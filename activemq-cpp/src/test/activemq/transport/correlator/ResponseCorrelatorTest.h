@@ -33,6 +33,9 @@ namespace correlator{
         CPPUNIT_TEST( testTransportException );
         CPPUNIT_TEST( testMultiRequests );
         CPPUNIT_TEST( testNarrow );
+        CPPUNIT_TEST( testRequestTimeout );
+        CPPUNIT_TEST( testCloseFailsPendingRequest );
+        CPPUNIT_TEST( testManyOutstandingRequests );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -44,6 +47,9 @@ namespace correlator{
         void testTransportException();
         void testMultiRequests();
         void testNarrow();
+        void testRequestTimeout();
+        void testCloseFailsPendingRequest();
+        void testManyOutstandingRequests();
 
     };
 
@@ -26,10 +26,13 @@
 #include <activemq/mock/MockBrokerService.h>
 #include <decaf/util/concurrent/CountDownLatch.h>
 #include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/Thread.h>
 #include <decaf/util/UUID.h>
 
+#include <vector>
+
 using namespace activemq;
 using namespace activemq::mock;
 using namespace activemq::commands;
@@ -41,6 +44,7 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
 
 ////////////////////////////////////////////////////////////////////////////////
 FailoverTransportTest::FailoverTransportTest() {
@@ -260,6 +264,112 @@ void FailoverTransportTest::testSendOnewayMessage() {
     transport->close();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class AtomicMessageCountingListener : public DefaultTransportListener {
+    public:
+
+        AtomicInteger numMessages;
+
+        AtomicMessageCountingListener() : numMessages(0) {}
+
+        virtual void onCommand(const Pointer<Command> command AMQCPP_UNUSED) {
+            numMessages.incrementAndGet();
+        }
+    };
+
+    class OnewaySender : public Runnable {
+    private:
+
+        Transport* transport;
+        int numMessages;
+
+    public:
+
+        bool failed;
+
+    private:
+
+        OnewaySender(const OnewaySender&);
+        OnewaySender& operator= (const OnewaySender&);
+
+    public:
+
+        OnewaySender(Transport* transport, int numMessages) :
+            transport(transport), numMessages(numMessages), failed(false) {}
+
+        virtual ~OnewaySender() {}
+
+        virtual void run() {
+            try {
+                Pointer<ActiveMQMessage> message(new ActiveMQMessage());
+                for (int i = 0; i < numMessages; ++i) {
+                    transport->oneway(message);
+                }
+            } catch (Exception&) {
+                failed = true;
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransportTest::testSendOnewayMessageFromManyThreads() {
+
+    std::string uri = "failover://(mock://localhost:61616)?randomize=false";
+
+    const int numThreads = 8;
+    const int numMessages = 500;
+
+    AtomicMessageCountingListener messageCounter;
+    DefaultTransportListener listener;
+    FailoverTransportFactory factory;
+
+    Pointer<Transport> transport(factory.create(uri));
+    CPPUNIT_ASSERT(transport != NULL);
+    transport->setTransportListener(&listener);
+
+    FailoverTransport* failover =
+        dynamic_cast<FailoverTransport*>(transport->narrow(typeid(FailoverTransport)));
+
+    CPPUNIT_ASSERT(failover != NULL);
+
+    transport->start();
+
+    Thread::sleep(1000);
+    CPPUNIT_ASSERT(failover->isConnected() == true);
+
+    MockTransport* mock = NULL;
+    while (mock == NULL) {
+        mock = dynamic_cast<MockTransport*>(transport->narrow(typeid(MockTransport)));
+    }
+    mock->setOutgoingListener(&messageCounter);
+
+    std::vector<OnewaySender*> senders;
+    std::vector<Thread*> threads;
+
+    for (int i = 0; i < numThreads; ++i) {
+        senders.push_back(new OnewaySender(transport.get(), numMessages));
+        threads.push_back(new Thread(senders[i]));
+    }
+
+    for (int i = 0; i < numThreads; ++i) {
+        threads[i]->start();
+    }
+
+    for (int i = 0; i < numThreads; ++i) {
+        threads[i]->join(10000);
+        CPPUNIT_ASSERT_MESSAGE("Sender should not have failed", !senders[i]->failed);
+        delete threads[i];
+        delete senders[i];
+    }
+
+    CPPUNIT_ASSERT_EQUAL(numThreads * numMessages, messageCounter.numMessages.get());
+
+    transport->close();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void FailoverTransportTest::testSendRequestMessage() {
 
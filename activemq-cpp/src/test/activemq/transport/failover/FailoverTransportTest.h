@@ -46,6 +46,7 @@ namespace failover {
         CPPUNIT_TEST( testTransportCreateFailOnCreateSendMessage );
         CPPUNIT_TEST( testFailingBackupCreation );
         CPPUNIT_TEST( testSendOnewayMessage );
+        CPPUNIT_TEST( testSendOnewayMessageFromManyThreads );
         CPPUNIT_TEST( testSendRequestMessage );
         CPPUNIT_TEST( testSendOnewayMessageFail );
         CPPUNIT_TEST( testSendRequestMessageFail );
@@ -73,6 +74,7 @@ namespace failover {
         void testTransportCreateFailOnCreateSendMessage();
         void testFailingBackupCreation();
         void testSendOnewayMessage();
+        void testSendOnewayMessageFromManyThreads();
         void testSendRequestMessage();
         void testSendOnewayMessageFail();
         void testSendRequestMessageFail();
@@ -20,7 +20,12 @@
 #include <activemq/transport/tcp/TcpTransportFactory.h>
 #include <activemq/transport/tcp/TcpTransport.h>
 
+#include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/WireFormatInfo.h>
 #include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
 
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/Integer.h>
@@ -29,7 +34,12 @@
 #include <decaf/net/ServerSocket.h>
 #include <decaf/io/InputStream.h>
 #include <decaf/io/OutputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/internal/net/tcp/EpollSelector.h>
 #include <decaf/util/Random.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <vector>
 
 using namespace decaf;
 using namespace decaf::lang;
@@ -38,6 +48,7 @@ using namespace decaf::io;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
 using namespace activemq;
+using namespace activemq::commands;
 using namespace activemq::wireformat;
 using namespace activemq::wireformat::openwire;
 using namespace activemq::transport;
@@ -139,6 +150,118 @@ namespace {
     };
 
     TestServer* server;
+
+    const int MESSAGES = 50;
+
+    // Sends a WireFormatInfo followed by text messages of growing size to the first
+    // client, split into writes that don't line up with the frames, then closes the
+    // connection once told to.
+    class ChunkedServer : public lang::Thread {
+    private:
+
+        ServerSocket server;
+        Random rand;
+
+    public:
+
+        CountDownLatch done;
+        bool error;
+
+        ChunkedServer() : Thread(), server(0), rand(), done(1), error(false) {
+            this->rand.setSeed(System::currentTimeMillis());
+        }
+
+        virtual ~ChunkedServer() {
+            try {
+                server.close();
+            } catch (...) {}
+        }
+
+        int getLocalPort() {
+            return server.getLocalPort();
+        }
+
+        virtual void run() {
+            try {
+
+                std::auto_ptr<Socket> socket(server.accept());
+
+                Properties properties;
+                OpenWireFormatFactory factory;
+                Pointer<OpenWireFormat> wireFormat =
+                    factory.createWireFormat(properties).dynamicCast<OpenWireFormat>();
+
+                // Marshal only needs a transport to be given, it isn't used.
+                IOTransport transport;
+                ByteArrayOutputStream baos;
+                DataOutputStream dos(&baos);
+
+                wireFormat->marshal(wireFormat->getPreferedWireFormatInfo(), &transport, &dos);
+
+                // The client settles on the same settings when it gets the info above.
+                wireFormat->renegotiateWireFormat(*wireFormat->getPreferedWireFormatInfo());
+
+                for (int i = 0; i < MESSAGES; ++i) {
+                    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+                    message->setText(std::string(i * 997, 'a' + (char) (i % 26)));
+                    wireFormat->marshal(message, &transport, &dos);
+                }
+
+                std::pair<unsigned char*, int> bytes = baos.toByteArray();
+                std::vector<unsigned char> data(bytes.first, bytes.first + bytes.second);
+                delete [] bytes.first;
+
+                OutputStream* os = socket->getOutputStream();
+                int offset = 0;
+                while (offset < (int) data.size()) {
+                    int length = std::min((int) data.size() - offset, 1 + rand.nextInt(4096));
+                    os->write(&data[0], (int) data.size(), offset, length);
+                    os->flush();
+                    offset += length;
+
+                    if (rand.nextBoolean()) {
+                        Thread::sleep(1);
+                    }
+                }
+
+                done.await(5000);
+                socket->close();
+
+            } catch (...) {
+                error = true;
+            }
+        }
+    };
+
+    class MessageListener : public DefaultTransportListener {
+    public:
+
+        Mutex mutex;
+        std::vector<std::string> texts;
+        bool failed;
+
+        MessageListener() : mutex(), texts(), failed(false) {}
+        virtual ~MessageListener() {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            if (command->isWireFormatInfo()) {
+                return;
+            }
+
+            synchronized(&mutex) {
+                Pointer<ActiveMQTextMessage> message = command.dynamicCast<ActiveMQTextMessage>();
+                texts.push_back(message->getText());
+                mutex.notifyAll();
+            }
+        }
+
+        virtual void onException(const decaf::lang::Exception& ex AMQCPP_UNUSED) {
+            synchronized(&mutex) {
+                failed = true;
+                mutex.notifyAll();
+            }
+        }
+    };
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -192,3 +315,57 @@ void TcpTransportTest::testTransportCreateWithRadomFailures() {
         } catch (Exception& ex) {}
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransportTest::testIOReactor() {
+
+    if (!decaf::internal::net::tcp::EpollSelector::isSupported()) {
+        return;
+    }
+
+    ChunkedServer chunkedServer;
+    chunkedServer.start();
+
+    TcpTransportFactory factory;
+    URI connectUri("tcp://localhost:" + Integer::toString(chunkedServer.getLocalPort()) +
+                   "?ioReactor=true&transport.useInactivityMonitor=false");
+
+    int registered = decaf::internal::net::tcp::EpollSelector::getDefault()->getSocketCount();
+
+    MessageListener listener;
+    Pointer<Transport> transport = factory.createComposite(connectUri);
+    transport->setTransportListener(&listener);
+    transport->start();
+
+    long long end = System::currentTimeMillis() + 10000;
+    synchronized(&listener.mutex) {
+        while ((int) listener.texts.size() < MESSAGES && !listener.failed &&
+               System::currentTimeMillis() < end) {
+            listener.mutex.wait(100);
+        }
+    }
+
+    CPPUNIT_ASSERT(!listener.failed);
+    CPPUNIT_ASSERT_EQUAL(MESSAGES, (int) listener.texts.size());
+    for (int i = 0; i < MESSAGES; ++i) {
+        CPPUNIT_ASSERT(listener.texts[i] == std::string(i * 997, 'a' + (char) (i % 26)));
+    }
+
+    // Losing the connection is reported from the selector thread.
+    chunkedServer.done.countDown();
+
+    end = System::currentTimeMillis() + 5000;
+    synchronized(&listener.mutex) {
+        while (!listener.failed && System::currentTimeMillis() < end) {
+            listener.mutex.wait(100);
+        }
+    }
+
+    CPPUNIT_ASSERT(listener.failed);
+
+    transport->close();
+    chunkedServer.join();
+
+    CPPUNIT_ASSERT(!chunkedServer.error);
+    CPPUNIT_ASSERT_EQUAL(registered, decaf::internal::net::tcp::EpollSelector::getDefault()->getSocketCount());
+}
@@ -57,6 +57,21 @@ void MarshallingSupportTest::writeTestHelper( unsigned char* input, int inputLen
 ////////////////////////////////////////////////////////////////////////////////
 void MarshallingSupportTest::testAsciiToModifiedUtf8() {
 
+    // Test data with a run of plain ASCII longer than a machine word.
+    {
+        std::string input( "Hello World, Hello World" );
+        CPPUNIT_ASSERT_EQUAL( input, MarshallingSupport::asciiToModifiedUtf8( input ) );
+    }
+
+    // Test data with plain ASCII followed by 2-byte UTF8 encoding and an embedded NULL.
+    {
+        unsigned char input[] = {0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64, 0xC2, 0x21, 0x00, 0x21};
+        unsigned char expect[] = {0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64, 0xC3, 0x82, 0x21, 0xC0, 0x80, 0x21};
+
+        CPPUNIT_ASSERT_EQUAL( std::string( (char*) expect, sizeof(expect) ),
+                              MarshallingSupport::asciiToModifiedUtf8( std::string( (char*) input, sizeof(input) ) ) );
+    }
+
     // Test data with 1-byte UTF8 encoding.
     {
         unsigned char input[] = {0x00, 0x0B, 0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64};
@@ -100,6 +115,21 @@ void MarshallingSupportTest::readTestHelper( unsigned char* input, int inputLeng
 ////////////////////////////////////////////////////////////////////////////////
 void MarshallingSupportTest::testModifiedUtf8ToAscii() {
 
+    // Test data with a run of plain ASCII longer than a machine word.
+    {
+        std::string input( "Hello World, Hello World" );
+        CPPUNIT_ASSERT_EQUAL( input, MarshallingSupport::modifiedUtf8ToAscii( input ) );
+    }
+
+    // Test data with plain ASCII followed by 2-byte UTF8 encoding and an embedded NULL.
+    {
+        unsigned char expect[] = {0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64, 0xC2, 0x21, 0x00, 0x21};
+        unsigned char input[] = {0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64, 0xC3, 0x82, 0x21, 0xC0, 0x80, 0x21};
+
+        CPPUNIT_ASSERT_EQUAL( std::string( (char*) expect, sizeof(expect) ),
+                              MarshallingSupport::modifiedUtf8ToAscii( std::string( (char*) input, sizeof(input) ) ) );
+    }
+
     // Test data with 1-byte UTF8 encoding.
     {
         unsigned char expect[] = { 0x00, 0x0B, 0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64 };
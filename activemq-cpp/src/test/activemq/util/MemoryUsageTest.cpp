@@ -48,6 +48,26 @@ namespace {
             this->usage->decreaseUsage(this->usage->getUsage());
         }
     };
+
+    class LimitRunner : public decaf::lang::Runnable {
+    private:
+
+        LimitRunner(const LimitRunner&);
+        LimitRunner& operator= (const LimitRunner&);
+
+    private:
+
+        MemoryUsage* usage;
+
+    public:
+
+        LimitRunner(MemoryUsage* usage) : usage(usage) {}
+
+        virtual void run() {
+            Thread::sleep(50);
+            this->usage->setLimit(this->usage->getUsage() * 2);
+        }
+    };
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -121,3 +141,41 @@ void MemoryUsageTest::testWait() {
 
     myThread.join();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsageTest::testAvailableSpace() {
+
+    MemoryUsage usage( 2048 );
+    CPPUNIT_ASSERT( usage.getAvailableSpace() == 2048 );
+
+    usage.increaseUsage( 1536 );
+    CPPUNIT_ASSERT( usage.getAvailableSpace() == 512 );
+
+    usage.increaseUsage( 1024 );
+    CPPUNIT_ASSERT( usage.isFull() );
+    CPPUNIT_ASSERT( usage.getAvailableSpace() == 0 );
+
+    // Returning more than is used empties the usage but doesn't go below zero.
+    usage.decreaseUsage( 4096 );
+    CPPUNIT_ASSERT( usage.getUsage() == 0 );
+    CPPUNIT_ASSERT( usage.getAvailableSpace() == 2048 );
+
+    usage.setLimit( 4096 );
+    CPPUNIT_ASSERT( usage.getAvailableSpace() == 4096 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsageTest::testWaitWokenByLimitChange() {
+
+    MemoryUsage usage( 2048 );
+    usage.increaseUsage( 5072 );
+    LimitRunner runner( &usage );
+
+    Thread myThread( &runner );
+    myThread.start();
+
+    usage.waitForSpace();
+    CPPUNIT_ASSERT( !usage.isFull() );
+
+    myThread.join();
+}
@@ -17,19 +17,38 @@
 
 #include "OpenWireFormatTest.h"
 
+#include <vector>
+
 #include <decaf/util/Properties.h>
 #include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
 #include <activemq/wireformat/openwire/OpenWireFormat.h>
 
 #include <activemq/core/ActiveMQConnectionMetaData.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/KeepAliveInfo.h>
+#include <activemq/commands/ShutdownInfo.h>
+#include <activemq/transport/IOTransport.h>
+
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataOutputStream.h>
+
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/InputStream.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Long.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
 
 using namespace std;
 using namespace activemq;
 using namespace activemq::util;
 using namespace activemq::core;
+using namespace activemq::commands;
 using namespace decaf::io;
 using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
 using namespace decaf::util;
+using namespace activemq::transport;
 using namespace activemq::exceptions;
 using namespace activemq::wireformat;
 using namespace activemq::wireformat::openwire;
@@ -50,3 +69,198 @@ void OpenWireFormatTest::testProviderInfoInWireFormat() {
             myWireFormat->getPreferedWireFormatInfo()->getProperties().getString("ProviderVersion"));
     CPPUNIT_ASSERT(!myWireFormat->getPreferedWireFormatInfo()->getProperties().getString("PlatformDetails").empty());
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testMaxFrameSize() {
+
+    OpenWireFormatFactory factory;
+    Properties properties;
+
+    Pointer<OpenWireFormat> wireFormat =
+            factory.createWireFormat(properties).dynamicCast<OpenWireFormat>();
+    CPPUNIT_ASSERT_EQUAL(Long::MAX_VALUE, wireFormat->getMaxFrameSize());
+
+    properties.setProperty("wireFormat.maxFrameSize", "16");
+    wireFormat = factory.createWireFormat(properties).dynamicCast<OpenWireFormat>();
+    CPPUNIT_ASSERT_EQUAL(16LL, wireFormat->getMaxFrameSize());
+
+    // Only the size prefix is present, the frame must be refused before it is read.
+    unsigned char bytes[] = { 0x7F, 0xFF, 0xFF, 0xFF };
+    ByteArrayInputStream bais(bytes, (int) sizeof(bytes));
+    DataInputStream dis(&bais);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException for a frame larger than the max frame size",
+        wireFormat->unmarshal(NULL, &dis),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testFrameDecoder() {
+
+    OpenWireFormatFactory factory;
+    Properties properties;
+
+    Pointer<OpenWireFormat> wireFormat =
+            factory.createWireFormat(properties).dynamicCast<OpenWireFormat>();
+    CPPUNIT_ASSERT(wireFormat->hasFrameDecoder());
+
+    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+    message->setText(std::string(5000, 'x'));
+
+    // Marshal only needs a transport to be given, it isn't used.
+    IOTransport transport;
+    ByteArrayOutputStream baos;
+    DataOutputStream dos(&baos);
+    wireFormat->marshal(Pointer<Command>(new KeepAliveInfo()), &transport, &dos);
+    wireFormat->marshal(message, &transport, &dos);
+    wireFormat->marshal(Pointer<Command>(new ShutdownInfo()), &transport, &dos);
+
+    std::pair<unsigned char*, int> bytes = baos.toByteArray();
+    std::vector<unsigned char> data(bytes.first, bytes.first + bytes.second);
+    delete [] bytes.first;
+
+    // Pushed a byte at a time each command comes out once its last byte arrives.
+    Pointer<FrameDecoder> decoder = wireFormat->createFrameDecoder();
+    std::vector< Pointer<Command> > commands;
+    bool receivingSeen = false;
+
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        decoder->receive(&data[0], (int) data.size(), (int) i, 1);
+
+        Pointer<Command> command = decoder->next(NULL);
+        if (command != NULL) {
+            commands.push_back(command);
+            CPPUNIT_ASSERT(decoder->next(NULL) == NULL);
+        } else {
+            receivingSeen = receivingSeen || wireFormat->inReceive();
+        }
+    }
+
+    CPPUNIT_ASSERT(receivingSeen);
+    CPPUNIT_ASSERT(!wireFormat->inReceive());
+    CPPUNIT_ASSERT_EQUAL(0, decoder->getPendingBytes());
+    CPPUNIT_ASSERT_EQUAL(3, (int) commands.size());
+    CPPUNIT_ASSERT(commands[0].dynamicCast<KeepAliveInfo>() != NULL);
+    CPPUNIT_ASSERT_EQUAL(std::string(5000, 'x'), commands[1].dynamicCast<ActiveMQTextMessage>()->getText());
+    CPPUNIT_ASSERT(commands[2].dynamicCast<ShutdownInfo>() != NULL);
+
+    // Pushed all at once every command comes out of the one buffer, and a partial
+    // frame is kept for the next push.
+    commands.clear();
+    decoder->receive(&data[0], (int) data.size(), 0, (int) data.size() - 1);
+
+    Pointer<Command> command;
+    while ((command = decoder->next(NULL)) != NULL) {
+        commands.push_back(command);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(2, (int) commands.size());
+    CPPUNIT_ASSERT(decoder->getPendingBytes() > 0);
+
+    decoder->receive(&data[0], (int) data.size(), (int) data.size() - 1, 1);
+    command = decoder->next(NULL);
+    CPPUNIT_ASSERT(command.dynamicCast<ShutdownInfo>() != NULL);
+    CPPUNIT_ASSERT_EQUAL(0, decoder->getPendingBytes());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testFrameDecoderMaxFrameSize() {
+
+    OpenWireFormatFactory factory;
+    Properties properties;
+    properties.setProperty("wireFormat.maxFrameSize", "16");
+
+    Pointer<OpenWireFormat> wireFormat =
+            factory.createWireFormat(properties).dynamicCast<OpenWireFormat>();
+
+    // The frame is refused as soon as its size prefix arrives.
+    Pointer<FrameDecoder> decoder = wireFormat->createFrameDecoder();
+    unsigned char bytes[] = { 0x00, 0x00, 0x10, 0x00 };
+
+    decoder->receive(bytes, (int) sizeof(bytes), 0, 3);
+    CPPUNIT_ASSERT(decoder->next(NULL) == NULL);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException for a frame larger than the max frame size",
+        decoder->receive(bytes, (int) sizeof(bytes), 3, 1),
+        IOException);
+
+    // Without the size prefix the frames can't be found.
+    properties.setProperty("wireFormat.sizePrefixDisabled", "true");
+    wireFormat = factory.createWireFormat(properties).dynamicCast<OpenWireFormat>();
+
+    CPPUNIT_ASSERT(!wireFormat->hasFrameDecoder());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException when the size prefix is disabled",
+        wireFormat->createFrameDecoder(),
+        UnsupportedOperationException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class RecordingInputStream : public InputStream {
+    private:
+
+        const std::vector<unsigned char>& data;
+        std::size_t position;
+        OpenWireFormat* wireFormat;
+
+    public:
+
+        std::vector<bool> receiving;
+
+        RecordingInputStream(const std::vector<unsigned char>& data, OpenWireFormat* wireFormat) :
+            InputStream(), data(data), position(0), wireFormat(wireFormat), receiving() {
+        }
+
+    protected:
+
+        virtual int doReadByte() {
+
+            if (this->position == this->data.size()) {
+                return -1;
+            }
+
+            this->receiving.push_back(this->wireFormat->inReceive());
+            return this->data[this->position++];
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testReceivingWhileReadingFrame() {
+
+    OpenWireFormatFactory factory;
+    Properties properties;
+
+    Pointer<OpenWireFormat> wireFormat =
+            factory.createWireFormat(properties).dynamicCast<OpenWireFormat>();
+
+    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+    message->setText(std::string(1000, 'x'));
+
+    IOTransport transport;
+    ByteArrayOutputStream baos;
+    DataOutputStream dos(&baos);
+    wireFormat->marshal(message, &transport, &dos);
+
+    std::pair<unsigned char*, int> bytes = baos.toByteArray();
+    std::vector<unsigned char> data(bytes.first, bytes.first + bytes.second);
+    delete [] bytes.first;
+
+    RecordingInputStream recorder(data, wireFormat.get());
+    DataInputStream dis(&recorder);
+
+    Pointer<Command> command = wireFormat->unmarshal(&transport, &dis);
+    CPPUNIT_ASSERT_EQUAL(std::string(1000, 'x'), command.dynamicCast<ActiveMQTextMessage>()->getText());
+    CPPUNIT_ASSERT(!wireFormat->inReceive());
+
+    // Waiting on the size prefix is idle, every byte of the body after it is
+    // read while the frame counts as being received.
+    CPPUNIT_ASSERT_EQUAL(data.size(), recorder.receiving.size());
+    for (std::size_t i = 0; i < recorder.receiving.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(i >= 4, (bool) recorder.receiving[i]);
+    }
+}
@@ -29,6 +29,10 @@ namespace openwire {
 
         CPPUNIT_TEST_SUITE( OpenWireFormatTest );
         CPPUNIT_TEST( testProviderInfoInWireFormat );
+        CPPUNIT_TEST( testMaxFrameSize );
+        CPPUNIT_TEST( testFrameDecoder );
+        CPPUNIT_TEST( testFrameDecoderMaxFrameSize );
+        CPPUNIT_TEST( testReceivingWhileReadingFrame );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -37,6 +41,10 @@ namespace openwire {
         virtual ~OpenWireFormatTest() {}
 
         virtual void testProviderInfoInWireFormat();
+        virtual void testMaxFrameSize();
+        virtual void testFrameDecoder();
+        virtual void testFrameDecoderMaxFrameSize();
+        virtual void testReceivingWhileReadingFrame();
 
     };
 
@@ -167,3 +167,93 @@ void BaseDataStreamMarshallerTest::testTightMarshal()
 
     delete [] array.first;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void BaseDataStreamMarshallerTest::testLooseMarshalCached()
+{
+    SimpleDataStructureMarshaller* simpleMarshaller = new SimpleDataStructureMarshaller();
+    ComplexDataStructureMarshaller* complexMarshaller = new ComplexDataStructureMarshaller();
+    Properties props;
+    OpenWireFormat openWireFormat(props);
+    openWireFormat.addMarshaller( simpleMarshaller );
+    openWireFormat.addMarshaller( complexMarshaller );
+    openWireFormat.setCacheEnabled( true );
+
+    // Marshal the same dataStructure twice, the second time the child is sent
+    // as a cache index.
+    ByteArrayOutputStream baos;
+    DataOutputStream looseOut( &baos );
+    complexMarshaller->looseMarshal( &openWireFormat, dataStructure, &looseOut );
+    int firstSize = (int) baos.size();
+    complexMarshaller->looseMarshal( &openWireFormat, dataStructure, &looseOut );
+    int secondSize = (int) baos.size() - firstSize;
+
+    CPPUNIT_ASSERT( secondSize < firstSize );
+
+    std::pair<const unsigned char*, int> array = baos.toByteArray();
+    ByteArrayInputStream bais( array.first, array.second );
+    DataInputStream looseIn( &bais );
+
+    ComplexDataStructure ds1;
+    complexMarshaller->looseUnmarshal( &openWireFormat, &ds1, &looseIn );
+    ComplexDataStructure ds2;
+    complexMarshaller->looseUnmarshal( &openWireFormat, &ds2, &looseIn );
+
+    CPPUNIT_ASSERT( ds1.cachedChild != NULL );
+    CPPUNIT_ASSERT( ds2.cachedChild != NULL );
+    CPPUNIT_ASSERT( ds1.cachedChild != ds2.cachedChild );
+    CPPUNIT_ASSERT_EQUAL( dataStructure->cachedChild->intValue, ds2.cachedChild->intValue );
+    CPPUNIT_ASSERT_EQUAL( dataStructure->cachedChild->longValue1, ds2.cachedChild->longValue1 );
+    CPPUNIT_ASSERT_EQUAL( dataStructure->cachedChild->doubleValue, ds2.cachedChild->doubleValue );
+    CPPUNIT_ASSERT_EQUAL( dataStructure->cachedChild->stringValue, ds2.cachedChild->stringValue );
+
+    delete [] array.first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BaseDataStreamMarshallerTest::testTightMarshalCached()
+{
+    SimpleDataStructureMarshaller* simpleMarshaller = new SimpleDataStructureMarshaller();
+    ComplexDataStructureMarshaller* complexMarshaller = new ComplexDataStructureMarshaller();
+    Properties props;
+    OpenWireFormat openWireFormat(props);
+    openWireFormat.addMarshaller( simpleMarshaller );
+    openWireFormat.addMarshaller( complexMarshaller );
+    openWireFormat.setCacheEnabled( true );
+
+    ByteArrayOutputStream baos;
+    DataOutputStream dataOut( &baos );
+
+    int sizes[2] = { 0, 0 };
+    for( int i = 0; i < 2; ++i ) {
+        BooleanStream bs;
+        sizes[i] = complexMarshaller->tightMarshal1( &openWireFormat, dataStructure, &bs );
+        bs.marshal( &dataOut );
+        complexMarshaller->tightMarshal2( &openWireFormat, dataStructure, &dataOut, &bs );
+    }
+
+    CPPUNIT_ASSERT( sizes[1] < sizes[0] );
+
+    std::pair<const unsigned char*, int> array = baos.toByteArray();
+    ByteArrayInputStream bais( array.first, array.second );
+    DataInputStream dataIn( &bais );
+
+    ComplexDataStructure ds1;
+    BooleanStream bs1;
+    bs1.unmarshal( &dataIn );
+    complexMarshaller->tightUnmarshal( &openWireFormat, &ds1, &dataIn, &bs1 );
+
+    ComplexDataStructure ds2;
+    BooleanStream bs2;
+    bs2.unmarshal( &dataIn );
+    complexMarshaller->tightUnmarshal( &openWireFormat, &ds2, &dataIn, &bs2 );
+
+    CPPUNIT_ASSERT( ds1.cachedChild != NULL );
+    CPPUNIT_ASSERT( ds2.cachedChild != NULL );
+    CPPUNIT_ASSERT_EQUAL( dataStructure->cachedChild->intValue, ds2.cachedChild->intValue );
+    CPPUNIT_ASSERT_EQUAL( dataStructure->cachedChild->longValue1, ds2.cachedChild->longValue1 );
+    CPPUNIT_ASSERT_EQUAL( dataStructure->cachedChild->doubleValue, ds2.cachedChild->doubleValue );
+    CPPUNIT_ASSERT_EQUAL( dataStructure->cachedChild->stringValue, ds2.cachedChild->stringValue );
+
+    delete [] array.first;
+}
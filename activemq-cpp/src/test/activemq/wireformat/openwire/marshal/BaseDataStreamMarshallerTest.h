@@ -34,6 +34,8 @@ namespace marshal{
         CPPUNIT_TEST_SUITE( BaseDataStreamMarshallerTest );
         CPPUNIT_TEST( testLooseMarshal );
         CPPUNIT_TEST( testTightMarshal );
+        CPPUNIT_TEST( testLooseMarshalCached );
+        CPPUNIT_TEST( testTightMarshalCached );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -382,6 +384,8 @@ namespace marshal{
 
         void testLooseMarshal();
         void testTightMarshal();
+        void testLooseMarshalCached();
+        void testTightMarshalCached();
 
     };
 
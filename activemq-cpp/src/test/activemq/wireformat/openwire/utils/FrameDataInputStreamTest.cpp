@@ -0,0 +1,293 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameDataInputStreamTest.h"
+
+#include <activemq/wireformat/openwire/utils/FrameDataInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/EOFException.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
+
+using namespace std;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameDataInputStreamTest::testReadPrimitives() {
+
+    ByteArrayOutputStream baos;
+    DataOutputStream dos(&baos);
+
+    dos.writeBoolean(true);
+    dos.writeBoolean(false);
+    dos.writeByte((unsigned char) 0xF0);
+    dos.writeChar('z');
+    dos.writeShort(-2);
+    dos.writeUnsignedShort(65000);
+    dos.writeInt(Integer::MIN_VALUE);
+    dos.writeInt(0x01020304);
+    dos.writeLong(Long::MIN_VALUE);
+    dos.writeLong(0x0102030405060708LL);
+    dos.writeFloat(3.5f);
+    dos.writeDouble(-1234.5678);
+    dos.write((const unsigned char*) "ABCDE", 5);
+    dos.flush();
+
+    std::pair<unsigned char*, int> bytes = baos.toByteArray();
+    ByteArrayInputStream bais(bytes.first, bytes.second, true);
+    DataInputStream source(&bais);
+
+    FrameDataInputStream frame;
+    frame.readFrame(&source, bytes.second);
+
+    CPPUNIT_ASSERT_EQUAL(bytes.second, frame.getRemaining());
+    CPPUNIT_ASSERT_EQUAL(0, bais.available());
+
+    CPPUNIT_ASSERT(frame.readBoolean() == true);
+    CPPUNIT_ASSERT(frame.readBoolean() == false);
+    CPPUNIT_ASSERT_EQUAL((unsigned char) 0xF0, frame.readUnsignedByte());
+    CPPUNIT_ASSERT_EQUAL('z', frame.readChar());
+    CPPUNIT_ASSERT_EQUAL((short) -2, frame.readShort());
+    CPPUNIT_ASSERT_EQUAL((unsigned short) 65000, frame.readUnsignedShort());
+    CPPUNIT_ASSERT_EQUAL(Integer::MIN_VALUE, frame.readInt());
+    CPPUNIT_ASSERT_EQUAL(0x01020304, frame.readInt());
+    CPPUNIT_ASSERT_EQUAL(Long::MIN_VALUE, frame.readLong());
+    CPPUNIT_ASSERT_EQUAL(0x0102030405060708LL, frame.readLong());
+    CPPUNIT_ASSERT_EQUAL(3.5f, frame.readFloat());
+    CPPUNIT_ASSERT_EQUAL(-1234.5678, frame.readDouble());
+
+    unsigned char buffer[5] = { 0 };
+    CPPUNIT_ASSERT_EQUAL(2LL, frame.skipBytes(2));
+    frame.readFully(buffer, 5, 1, 2);
+    CPPUNIT_ASSERT_EQUAL((unsigned char) 'C', buffer[1]);
+    CPPUNIT_ASSERT_EQUAL((unsigned char) 'D', buffer[2]);
+
+    // Reads that go through the base stream share the same position.
+    CPPUNIT_ASSERT_EQUAL(1, frame.available());
+    CPPUNIT_ASSERT_EQUAL((int) 'E', frame.read());
+    CPPUNIT_ASSERT_EQUAL(0, frame.getRemaining());
+    CPPUNIT_ASSERT_EQUAL(-1, frame.read());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameDataInputStreamTest::testReadStrings() {
+
+    ByteArrayOutputStream baos;
+    DataOutputStream dos(&baos);
+
+    dos.writeUTF("Hello World");
+    dos.writeChars("Null Terminated");
+    dos.writeUTF("");
+    dos.writeUTF(std::string("Encoded \xC2\0 Value", 16));
+    dos.writeByte(0);
+    dos.flush();
+
+    std::pair<unsigned char*, int> bytes = baos.toByteArray();
+    ByteArrayInputStream bais(bytes.first, bytes.second, true);
+    DataInputStream source(&bais);
+
+    FrameDataInputStream frame;
+    frame.readFrame(&source, bytes.second);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("Hello World"), frame.readUTF());
+    CPPUNIT_ASSERT_EQUAL(std::string("Null Terminated"), frame.readString());
+    CPPUNIT_ASSERT_EQUAL(std::string(""), frame.readUTF());
+    CPPUNIT_ASSERT_EQUAL(std::string("Encoded \xC2\0 Value", 16), frame.readUTF());
+    CPPUNIT_ASSERT_EQUAL(std::string(""), frame.readString());
+    CPPUNIT_ASSERT_EQUAL(0, frame.getRemaining());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameDataInputStreamTest::testReadPastEndOfFrame() {
+
+    unsigned char bytes[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 'a', 'b' };
+    ByteArrayInputStream bais(bytes, (int) sizeof(bytes));
+    DataInputStream source(&bais);
+
+    FrameDataInputStream frame;
+
+    // Only the first three bytes belong to the frame, the rest of the source
+    // must not be consumed by reads from it.
+    frame.readFrame(&source, 3);
+    CPPUNIT_ASSERT_EQUAL(5, bais.available());
+
+    CPPUNIT_ASSERT_EQUAL((short) 0x0102, frame.readShort());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an EOFException when reading past the end of the frame",
+        frame.readInt(),
+        EOFException);
+    CPPUNIT_ASSERT_EQUAL(0, frame.getRemaining());
+
+    frame.readFrame(&source, 3);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an EOFException when reading past the end of the frame",
+        frame.readLong(),
+        EOFException);
+
+    frame.readFrame(&source, 2);
+    unsigned char buffer[3] = { 0 };
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an EOFException when reading past the end of the frame",
+        frame.readFully(buffer, 3),
+        EOFException);
+
+    // The encoded string is longer than what is left of the frame.
+    unsigned char truncated[] = { 0x00, 0x05, 'a', 'b' };
+    ByteArrayInputStream truncatedBais(truncated, (int) sizeof(truncated));
+    DataInputStream truncatedSource(&truncatedBais);
+    frame.readFrame(&truncatedSource, (int) sizeof(truncated));
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an EOFException when the string runs past the end of the frame",
+        frame.readUTF(),
+        EOFException);
+
+    frame.readFrame(&source, 0);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an EOFException when no null terminator is in the frame",
+        frame.readString(),
+        EOFException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an EOFException when the frame is empty",
+        frame.readUTF(),
+        EOFException);
+
+    // A frame that never held any data has no storage behind it at all.
+    FrameDataInputStream empty;
+    empty.readFrame(&source, 0);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an EOFException when the frame has no storage",
+        empty.readString(),
+        EOFException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameDataInputStreamTest::testReadFrameReplacesPreviousFrame() {
+
+    ByteArrayOutputStream baos;
+    DataOutputStream dos(&baos);
+
+    dos.writeInt(1);
+    dos.writeInt(2);
+    for (int i = 0; i < 1024; ++i) {
+        dos.writeInt(i);
+    }
+    dos.writeInt(3);
+    dos.flush();
+
+    std::pair<unsigned char*, int> bytes = baos.toByteArray();
+    ByteArrayInputStream bais(bytes.first, bytes.second, true);
+    DataInputStream source(&bais);
+
+    FrameDataInputStream frame;
+
+    // Unread data from a frame is dropped when the next one is read.
+    frame.readFrame(&source, 8);
+    CPPUNIT_ASSERT_EQUAL(1, frame.readInt());
+
+    // The frame grows to fit a larger one.
+    frame.readFrame(&source, 1024 * 4);
+    for (int i = 0; i < 1024; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, frame.readInt());
+    }
+
+    frame.readFrame(&source, 4);
+    CPPUNIT_ASSERT_EQUAL(3, frame.readInt());
+    CPPUNIT_ASSERT_EQUAL(0, frame.getRemaining());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameDataInputStreamTest::testReadFrameFromShortSource() {
+
+    unsigned char bytes[] = { 0x01, 0x02, 0x03 };
+    ByteArrayInputStream bais(bytes, (int) sizeof(bytes));
+    DataInputStream source(&bais);
+
+    FrameDataInputStream frame;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an EOFException when the source ends before the frame",
+        frame.readFrame(&source, 4),
+        EOFException);
+
+    CPPUNIT_ASSERT_EQUAL(0, frame.getRemaining());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameDataInputStreamTest::testReadFrameWithInvalidSize() {
+
+    unsigned char bytes[] = { 0x01, 0x02, 0x03 };
+    ByteArrayInputStream bais(bytes, (int) sizeof(bytes));
+    DataInputStream source(&bais);
+
+    FrameDataInputStream frame;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException for a negative frame size",
+        frame.readFrame(&source, -1),
+        IOException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException for a NULL source",
+        frame.readFrame(NULL, 1),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameDataInputStreamTest::testReleaseFrame() {
+
+    const int largeSize = FrameDataInputStream::MAX_RETAINED_SIZE + 4;
+
+    ByteArrayOutputStream baos;
+    DataOutputStream dos(&baos);
+
+    for (int i = 0; i < largeSize / 4; ++i) {
+        dos.writeInt(i);
+    }
+    dos.writeInt(42);
+    dos.flush();
+
+    std::pair<unsigned char*, int> bytes = baos.toByteArray();
+    ByteArrayInputStream bais(bytes.first, bytes.second, true);
+    DataInputStream source(&bais);
+
+    FrameDataInputStream frame;
+
+    frame.readFrame(&source, largeSize);
+    CPPUNIT_ASSERT_EQUAL(0, frame.readInt());
+    CPPUNIT_ASSERT_EQUAL(largeSize - 4, frame.getRemaining());
+
+    // Releasing drops the unread data along with the oversized buffer.
+    frame.releaseFrame();
+    CPPUNIT_ASSERT_EQUAL(0, frame.getRemaining());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an EOFException once the frame is released",
+        frame.readInt(),
+        EOFException);
+
+    frame.readFrame(&source, 4);
+    CPPUNIT_ASSERT_EQUAL(42, frame.readInt());
+}
@@ -0,0 +1,205 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StompFrameReaderTest.h"
+
+#include <activemq/wireformat/stomp/StompFrame.h>
+#include <activemq/wireformat/stomp/StompFrameReader.h>
+
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/EOFException.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::stomp;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Three frames, the first ends at its null, the second has a content-length and
+    // a null inside its body and the third has no body at all.
+    const char FRAME_DATA[] =
+        "\nMESSAGE\n"
+        "destination:/queue/test\n"
+        "repeated:first\n"
+        "repeated:second\n"
+        "no-separator\n"
+        "\n"
+        "hello\0\n"
+        "MESSAGE\n"
+        "content-length:5\n"
+        "\n"
+        "ab\0cd\0\n"
+        "RECEIPT\n"
+        "receipt-id:7\n"
+        "\n"
+        "\0\n";
+
+    const std::string FRAMES(FRAME_DATA, sizeof(FRAME_DATA) - 1);
+
+    void checkFrames(StompFrameReader& reader, DataInputStream* in) {
+
+        StompFrame first;
+        reader.readFrame(first, in);
+        CPPUNIT_ASSERT_EQUAL(std::string("MESSAGE"), first.getCommand());
+        CPPUNIT_ASSERT_EQUAL(std::string("/queue/test"), first.getProperty("destination"));
+        CPPUNIT_ASSERT_EQUAL(std::string("first"), first.getProperty("repeated"));
+        CPPUNIT_ASSERT(!first.hasProperty("no-separator"));
+        CPPUNIT_ASSERT_EQUAL(std::string("hello", 6), std::string(first.getBody().begin(), first.getBody().end()));
+
+        StompFrame second;
+        reader.readFrame(second, in);
+        CPPUNIT_ASSERT_EQUAL(std::string("MESSAGE"), second.getCommand());
+        CPPUNIT_ASSERT_EQUAL(std::string("ab\0cd", 5), std::string(second.getBody().begin(), second.getBody().end()));
+
+        StompFrame third;
+        reader.readFrame(third, in);
+        CPPUNIT_ASSERT_EQUAL(std::string("RECEIPT"), third.getCommand());
+        CPPUNIT_ASSERT_EQUAL(std::string("7"), third.getProperty("receipt-id"));
+        CPPUNIT_ASSERT_EQUAL((std::size_t) 1, third.getBodyLength());
+
+        StompFrame next;
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Should have thrown an EOFException",
+            reader.readFrame(next, in),
+            EOFException);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameReaderTest::StompFrameReaderTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameReaderTest::~StompFrameReaderTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReaderTest::testConstructor() {
+
+    StompFrameReader reader;
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 0, reader.getBufferedCount());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        StompFrameReader(true, 0),
+        IllegalArgumentException);
+
+    StompFrame frame;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException",
+        reader.readFrame(frame, NULL),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReaderTest::testReadFrames() {
+
+    ByteArrayInputStream bytesIn((const unsigned char*) FRAMES.c_str(), (int) FRAMES.size());
+    DataInputStream in(&bytesIn);
+
+    StompFrameReader reader;
+    checkFrames(reader, &in);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReaderTest::testReadFramesSmallBuffer() {
+
+    ByteArrayInputStream bytesIn((const unsigned char*) FRAMES.c_str(), (int) FRAMES.size());
+    DataInputStream in(&bytesIn);
+
+    // Lines and bodies span many reads and the buffer has to grow.
+    StompFrameReader reader(true, 2);
+    checkFrames(reader, &in);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReaderTest::testReadWithoutReadAhead() {
+
+    ByteArrayInputStream bytesIn((const unsigned char*) FRAMES.c_str(), (int) FRAMES.size());
+    DataInputStream in(&bytesIn);
+
+    StompFrameReader reader(false, 4);
+
+    StompFrame frame;
+    reader.readFrame(frame, &in);
+    CPPUNIT_ASSERT_EQUAL(std::string("MESSAGE"), frame.getCommand());
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 0, reader.getBufferedCount());
+
+    // Only the first frame was taken from the stream.
+    std::size_t firstLength = FRAMES.find("hello") + 6;
+    CPPUNIT_ASSERT_EQUAL((int) (FRAMES.size() - firstLength), in.available());
+
+    StompFrame second;
+    second.fromStream(&in);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 5, second.getBodyLength());
+
+    StompFrame third;
+    third.fromStream(&in);
+    CPPUNIT_ASSERT_EQUAL(std::string("RECEIPT"), third.getCommand());
+    CPPUNIT_ASSERT_EQUAL(1, in.available());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReaderTest::testReadLargeContentLength() {
+
+    std::string body(100000, 'x');
+    body[50000] = '\0';
+
+    std::string frames = "MESSAGE\ncontent-length:100000\n\n" + body + std::string("\0\n", 2) +
+                         "MESSAGE\n\nlast" + std::string("\0", 1);
+
+    ByteArrayInputStream bytesIn((const unsigned char*) frames.c_str(), (int) frames.size());
+    DataInputStream in(&bytesIn);
+
+    StompFrameReader reader(true, 64);
+
+    StompFrame frame;
+    reader.readFrame(frame, &in);
+    CPPUNIT_ASSERT_EQUAL(body.size(), frame.getBodyLength());
+    CPPUNIT_ASSERT(body == std::string(frame.getBody().begin(), frame.getBody().end()));
+
+    StompFrame last;
+    reader.readFrame(last, &in);
+    CPPUNIT_ASSERT_EQUAL(std::string("last", 5), std::string(last.getBody().begin(), last.getBody().end()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameReaderTest::testMissingTrailingNull() {
+
+    const char data[] = "MESSAGE\ncontent-length:2\n\nabc\0\n";
+    std::string frames(data, sizeof(data) - 1);
+
+    ByteArrayInputStream bytesIn((const unsigned char*) frames.c_str(), (int) frames.size());
+    DataInputStream in(&bytesIn);
+
+    StompFrameReader reader;
+    StompFrame frame;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException",
+        reader.readFrame(frame, &in),
+        IOException);
+}
@@ -0,0 +1,306 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EpollSelectorTest.h"
+
+#include <decaf/internal/net/tcp/EpollSelector.h>
+#include <decaf/internal/net/tcp/EpollSocket.h>
+#include <decaf/internal/net/tcp/EpollSocketImplFactory.h>
+#include <decaf/net/SocketImpl.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <memory>
+#include <string>
+
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::net;
+using namespace decaf::util::concurrent;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::internal::net::tcp;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // A connected client socket and the socket the server accepted for it.
+    class SocketPair {
+    private:
+
+        SocketPair(const SocketPair&);
+        SocketPair& operator= (const SocketPair&);
+
+    public:
+
+        EpollSocketImplFactory factory;
+        std::auto_ptr<SocketImpl> server;
+        std::auto_ptr<SocketImpl> client;
+        std::auto_ptr<SocketImpl> accepted;
+
+        SocketPair() : factory(),
+                       server(factory.createSocketImpl()),
+                       client(factory.createSocketImpl()),
+                       accepted(factory.createSocketImpl()) {
+
+            server->create();
+            server->bind("127.0.0.1", 0);
+            server->listen(5);
+
+            client->create();
+            client->connect("127.0.0.1", server->getLocalPort(), 2000);
+
+            server->accept(accepted.get());
+        }
+    };
+
+    // Collects what arrives on the accepted socket, unregisters itself at the end
+    // of the stream so the selector doesn't keep reporting the closed socket.
+    class ReadingListener : public SelectionListener {
+    private:
+
+        EpollSelector* selector;
+        EpollSocket* socket;
+        std::string data;
+        bool endOfStream;
+
+    private:
+
+        ReadingListener(const ReadingListener&);
+        ReadingListener& operator= (const ReadingListener&);
+
+    public:
+
+        Mutex mutex;
+
+        ReadingListener(EpollSelector* selector, SocketImpl* socket) :
+            selector(selector), socket(dynamic_cast<EpollSocket*>(socket)), data(), endOfStream(false), mutex() {}
+        virtual ~ReadingListener() {}
+
+        virtual void onReadable() {
+
+            unsigned char buffer[64];
+            int result = socket->readAvailable(buffer, 64, 0, 64);
+
+            synchronized(&mutex) {
+                if (result == -1) {
+                    endOfStream = true;
+                    selector->remove(this);
+                } else {
+                    data.append((const char*) buffer, result);
+                }
+                mutex.notifyAll();
+            }
+        }
+
+        std::string getData() {
+            synchronized(&mutex) {
+                return data;
+            }
+            return "";
+        }
+
+        bool awaitData(const std::string& expected) {
+            long long end = System::currentTimeMillis() + 2000;
+            synchronized(&mutex) {
+                while (data != expected && System::currentTimeMillis() < end) {
+                    mutex.wait(100);
+                }
+                return data == expected;
+            }
+            return false;
+        }
+
+        bool awaitEndOfStream() {
+            long long end = System::currentTimeMillis() + 2000;
+            synchronized(&mutex) {
+                while (!endOfStream && System::currentTimeMillis() < end) {
+                    mutex.wait(100);
+                }
+                return endOfStream;
+            }
+            return false;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSelectorTest::testConstructor() {
+
+    if (!EpollSelector::isSupported()) {
+        return;
+    }
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        EpollSelector(0),
+        IllegalArgumentException);
+
+    EpollSelector selector(2);
+    CPPUNIT_ASSERT_EQUAL(2, selector.getThreadCount());
+    CPPUNIT_ASSERT_EQUAL(0, selector.getSocketCount());
+
+    CPPUNIT_ASSERT(EpollSelector::getDefault() != NULL);
+    CPPUNIT_ASSERT(EpollSelector::getDefault() == EpollSelector::getDefault());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSelectorTest::testReadable() {
+
+    if (!EpollSelector::isSupported()) {
+        return;
+    }
+
+    static const int COUNT = 5;
+
+    EpollSelector selector(2);
+
+    std::auto_ptr<SocketPair> pairs[COUNT];
+    std::auto_ptr<ReadingListener> listeners[COUNT];
+
+    for (int i = 0; i < COUNT; ++i) {
+        pairs[i].reset(new SocketPair());
+        listeners[i].reset(new ReadingListener(&selector, pairs[i]->accepted.get()));
+        selector.add(pairs[i]->accepted.get(), listeners[i].get());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(COUNT, selector.getSocketCount());
+
+    for (int i = 0; i < COUNT; ++i) {
+        std::string message = std::string("message-") + (char) ('0' + i);
+        pairs[i]->client->getOutputStream()->write((const unsigned char*) message.c_str(),
+                                                   (int) message.size(), 0, (int) message.size());
+    }
+
+    for (int i = 0; i < COUNT; ++i) {
+        std::string expected = std::string("message-") + (char) ('0' + i);
+        CPPUNIT_ASSERT_MESSAGE("Listener didn't receive its data", listeners[i]->awaitData(expected));
+    }
+
+    // The end of the stream is reported as readable, the listeners remove themselves.
+    for (int i = 0; i < COUNT; ++i) {
+        pairs[i]->client->close();
+        CPPUNIT_ASSERT(listeners[i]->awaitEndOfStream());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, selector.getSocketCount());
+
+    selector.shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSelectorTest::testRemove() {
+
+    if (!EpollSelector::isSupported()) {
+        return;
+    }
+
+    EpollSelector selector(1);
+    SocketPair pair;
+    ReadingListener listener(&selector, pair.accepted.get());
+
+    selector.add(pair.accepted.get(), &listener);
+    pair.client->getOutputStream()->write('a');
+    CPPUNIT_ASSERT(listener.awaitData("a"));
+
+    selector.remove(&listener);
+    CPPUNIT_ASSERT_EQUAL(0, selector.getSocketCount());
+
+    // Removing twice does nothing.
+    selector.remove(&listener);
+
+    pair.client->getOutputStream()->write('b');
+    Thread::sleep(100);
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), listener.getData());
+
+    // Once added again the data waiting on the socket is reported.
+    selector.add(pair.accepted.get(), &listener);
+    CPPUNIT_ASSERT(listener.awaitData("ab"));
+
+    selector.remove(&listener);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSelectorTest::testInvalidAdd() {
+
+    if (!EpollSelector::isSupported()) {
+        return;
+    }
+
+    EpollSelector selector(1);
+    SocketPair pair;
+    ReadingListener listener(&selector, pair.accepted.get());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        selector.add(NULL, &listener),
+        NullPointerException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        selector.add(pair.accepted.get(), NULL),
+        NullPointerException);
+
+    std::auto_ptr<SocketImpl> unconnected(pair.factory.createSocketImpl());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        selector.add(unconnected.get(), &listener),
+        IOException);
+
+    selector.add(pair.accepted.get(), &listener);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalStateException",
+        selector.add(pair.accepted.get(), &listener),
+        IllegalStateException);
+
+    selector.remove(&listener);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSelectorTest::testShutdown() {
+
+    if (!EpollSelector::isSupported()) {
+        return;
+    }
+
+    EpollSelector selector(2);
+    SocketPair pair;
+    ReadingListener listener(&selector, pair.accepted.get());
+
+    selector.add(pair.accepted.get(), &listener);
+    selector.shutdown();
+
+    pair.client->getOutputStream()->write('a');
+    Thread::sleep(100);
+    CPPUNIT_ASSERT_EQUAL(std::string(""), listener.getData());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalStateException",
+        selector.add(pair.accepted.get(), &listener),
+        IllegalStateException);
+
+    // Safe to call more than once.
+    selector.shutdown();
+}
@@ -0,0 +1,406 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EpollSocketTest.h"
+
+#include <decaf/internal/net/tcp/EpollSocket.h>
+#include <decaf/internal/net/tcp/EpollSocketImplFactory.h>
+#include <decaf/net/SocketImpl.h>
+#include <decaf/net/SocketOptions.h>
+#include <decaf/net/SocketTimeoutException.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+
+#include <memory>
+#include <vector>
+
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::net;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::internal::net::tcp;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // A connected client socket and the socket the server accepted for it.
+    class SocketPair {
+    private:
+
+        SocketPair(const SocketPair&);
+        SocketPair& operator= (const SocketPair&);
+
+    public:
+
+        EpollSocketImplFactory factory;
+        std::auto_ptr<SocketImpl> server;
+        std::auto_ptr<SocketImpl> client;
+        std::auto_ptr<SocketImpl> accepted;
+
+        SocketPair() : factory(),
+                       server(factory.createSocketImpl()),
+                       client(factory.createSocketImpl()),
+                       accepted(factory.createSocketImpl()) {
+
+            server->create();
+            server->bind("127.0.0.1", 0);
+            server->listen(5);
+
+            client->create();
+            client->connect("127.0.0.1", server->getLocalPort(), 2000);
+
+            server->accept(accepted.get());
+        }
+    };
+
+    void readFully(InputStream* stream, unsigned char* buffer, int length) {
+        int total = 0;
+        while (total < length) {
+            int result = stream->read(buffer, length, total, length - total);
+            CPPUNIT_ASSERT_MESSAGE("Unexpected end of stream", result != -1);
+            total += result;
+        }
+    }
+
+    class StreamReader : public Runnable {
+    private:
+
+        SocketImpl* socket;
+
+    private:
+
+        StreamReader(const StreamReader&);
+        StreamReader& operator= (const StreamReader&);
+
+    public:
+
+        std::vector<unsigned char> data;
+        bool failed;
+
+        StreamReader(SocketImpl* socket, int length) : socket(socket), data(length), failed(false) {}
+        virtual ~StreamReader() {}
+
+        virtual void run() {
+            try {
+                InputStream* stream = socket->getInputStream();
+                int total = 0;
+                while (total < (int) data.size()) {
+                    int result = stream->read(&data[0], (int) data.size(), total, (int) data.size() - total);
+                    if (result == -1) {
+                        failed = true;
+                        return;
+                    }
+                    total += result;
+                }
+            } catch (Exception&) {
+                failed = true;
+            }
+        }
+    };
+
+    class BlockedStreamReader : public Runnable {
+    private:
+
+        SocketImpl* socket;
+
+    private:
+
+        BlockedStreamReader(const BlockedStreamReader&);
+        BlockedStreamReader& operator= (const BlockedStreamReader&);
+
+    public:
+
+        bool caughtIOException;
+
+        BlockedStreamReader(SocketImpl* socket) : socket(socket), caughtIOException(false) {}
+        virtual ~BlockedStreamReader() {}
+
+        virtual void run() {
+            try {
+                socket->getInputStream()->read();
+            } catch (IOException&) {
+                caughtIOException = true;
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocketTest::testConnectAndExchange() {
+
+    if (!EpollSocketImplFactory::isSupported()) {
+        return;
+    }
+
+    SocketPair pair;
+
+    CPPUNIT_ASSERT(pair.client->getLocalPort() == 0);
+    CPPUNIT_ASSERT(pair.client->getPort() == pair.server->getLocalPort());
+    CPPUNIT_ASSERT_EQUAL(std::string("127.0.0.1"), pair.client->getLocalAddress());
+
+    unsigned char request[5] = { 'h', 'e', 'l', 'l', 'o' };
+    pair.client->getOutputStream()->write(request, 5, 0, 5);
+
+    unsigned char buffer[5] = { 0 };
+    readFully(pair.accepted->getInputStream(), buffer, 5);
+    CPPUNIT_ASSERT(std::equal(request, request + 5, buffer));
+
+    unsigned char reply[3] = { 'a', 'c', 'k' };
+    pair.accepted->getOutputStream()->write(reply, 3, 0, 3);
+
+    // Give the reply time to arrive so available can see it.
+    long long end = System::currentTimeMillis() + 2000;
+    while (pair.client->available() < 3 && System::currentTimeMillis() < end) {
+        Thread::sleep(10);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(3, pair.client->available());
+    readFully(pair.client->getInputStream(), buffer, 3);
+    CPPUNIT_ASSERT(std::equal(reply, reply + 3, buffer));
+    CPPUNIT_ASSERT_EQUAL(0, pair.client->available());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocketTest::testLargeWrite() {
+
+    if (!EpollSocketImplFactory::isSupported()) {
+        return;
+    }
+
+    static const int SIZE = 4 * 1024 * 1024;
+
+    SocketPair pair;
+
+    std::vector<unsigned char> data(SIZE);
+    for (int i = 0; i < SIZE; ++i) {
+        data[i] = (unsigned char) (i % 251);
+    }
+
+    // Far more than the socket buffers hold, so the writer has to wait for the
+    // reader to drain the connection.
+    StreamReader reader(pair.accepted.get(), SIZE);
+    Thread thread(&reader);
+    thread.start();
+
+    pair.client->getOutputStream()->write(&data[0], SIZE, 0, SIZE);
+
+    thread.join(10000);
+    CPPUNIT_ASSERT(!reader.failed);
+    CPPUNIT_ASSERT(reader.data == data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocketTest::testEndOfStream() {
+
+    if (!EpollSocketImplFactory::isSupported()) {
+        return;
+    }
+
+    SocketPair pair;
+
+    pair.client->getOutputStream()->write('x');
+    pair.client->shutdownOutput();
+
+    InputStream* stream = pair.accepted->getInputStream();
+    CPPUNIT_ASSERT_EQUAL((int) 'x', stream->read());
+    CPPUNIT_ASSERT_EQUAL(-1, stream->read());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocketTest::testReadTimeout() {
+
+    if (!EpollSocketImplFactory::isSupported()) {
+        return;
+    }
+
+    SocketPair pair;
+
+    pair.accepted->setOption(SocketOptions::SOCKET_OPTION_TIMEOUT, 100);
+    CPPUNIT_ASSERT_EQUAL(100, pair.accepted->getOption(SocketOptions::SOCKET_OPTION_TIMEOUT));
+
+    long long start = System::currentTimeMillis();
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a SocketTimeoutException",
+        pair.accepted->getInputStream()->read(),
+        SocketTimeoutException);
+
+    CPPUNIT_ASSERT(System::currentTimeMillis() - start >= 90);
+
+    // The socket is still usable after a timeout.
+    pair.client->getOutputStream()->write('y');
+    CPPUNIT_ASSERT_EQUAL((int) 'y', pair.accepted->getInputStream()->read());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocketTest::testCloseWakesBlockedReader() {
+
+    if (!EpollSocketImplFactory::isSupported()) {
+        return;
+    }
+
+    SocketPair pair;
+
+    BlockedStreamReader reader(pair.accepted.get());
+    Thread thread(&reader);
+    thread.start();
+
+    Thread::sleep(100);
+    pair.accepted->close();
+
+    thread.join(2000);
+    CPPUNIT_ASSERT(!thread.isAlive());
+    CPPUNIT_ASSERT(reader.caughtIOException);
+
+    // Closing also wakes a thread blocked in accept.
+    std::auto_ptr<SocketImpl> target(pair.factory.createSocketImpl());
+    pair.server->close();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException",
+        pair.server->accept(target.get()),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocketTest::testConnectRefused() {
+
+    if (!EpollSocketImplFactory::isSupported()) {
+        return;
+    }
+
+    EpollSocketImplFactory factory;
+
+    // Find a free port by binding and then releasing it.
+    std::auto_ptr<SocketImpl> server(factory.createSocketImpl());
+    server->create();
+    server->bind("127.0.0.1", 0);
+    int port = server->getLocalPort();
+    server->close();
+
+    std::auto_ptr<SocketImpl> client(factory.createSocketImpl());
+    client->create();
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException",
+        client->connect("127.0.0.1", port, 1000),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocketTest::testOptions() {
+
+    if (!EpollSocketImplFactory::isSupported()) {
+        return;
+    }
+
+    SocketPair pair;
+
+    pair.client->setOption(SocketOptions::SOCKET_OPTION_TCP_NODELAY, 1);
+    CPPUNIT_ASSERT(pair.client->getOption(SocketOptions::SOCKET_OPTION_TCP_NODELAY) != 0);
+    pair.client->setOption(SocketOptions::SOCKET_OPTION_TCP_NODELAY, 0);
+    CPPUNIT_ASSERT_EQUAL(0, pair.client->getOption(SocketOptions::SOCKET_OPTION_TCP_NODELAY));
+
+    pair.client->setOption(SocketOptions::SOCKET_OPTION_KEEPALIVE, 1);
+    CPPUNIT_ASSERT(pair.client->getOption(SocketOptions::SOCKET_OPTION_KEEPALIVE) != 0);
+
+    pair.client->setOption(SocketOptions::SOCKET_OPTION_LINGER, 5);
+    CPPUNIT_ASSERT_EQUAL(5, pair.client->getOption(SocketOptions::SOCKET_OPTION_LINGER));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException",
+        pair.client->setOption(SocketOptions::SOCKET_OPTION_BROADCAST, 1),
+        IOException);
+
+    pair.client->close();
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException",
+        pair.client->getOption(SocketOptions::SOCKET_OPTION_TCP_NODELAY),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocketTest::testBindHostName() {
+
+    if (!EpollSocketImplFactory::isSupported()) {
+        return;
+    }
+
+    EpollSocketImplFactory factory;
+    std::auto_ptr<SocketImpl> server(factory.createSocketImpl());
+    std::auto_ptr<SocketImpl> client(factory.createSocketImpl());
+    std::auto_ptr<SocketImpl> accepted(factory.createSocketImpl());
+
+    server->create();
+    server->bind("localhost", 0);
+    server->listen(5);
+    CPPUNIT_ASSERT(server->getLocalPort() > 0);
+
+    client->create();
+    client->connect("localhost", server->getLocalPort(), 2000);
+    server->accept(accepted.get());
+
+    client->getOutputStream()->write('x');
+    CPPUNIT_ASSERT_EQUAL((int) 'x', accepted->getInputStream()->read());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EpollSocketTest::testReadAvailable() {
+
+    if (!EpollSocketImplFactory::isSupported()) {
+        return;
+    }
+
+    SocketPair pair;
+
+    EpollSocket* socket = dynamic_cast<EpollSocket*>(pair.accepted.get());
+    CPPUNIT_ASSERT(socket != NULL);
+
+    unsigned char buffer[10] = { 0 };
+    CPPUNIT_ASSERT_EQUAL(0, socket->readAvailable(buffer, 10, 0, 10));
+
+    unsigned char data[4] = { 'd', 'a', 't', 'a' };
+    pair.client->getOutputStream()->write(data, 4, 0, 4);
+
+    int total = 0;
+    long long end = System::currentTimeMillis() + 2000;
+    while (total < 4 && System::currentTimeMillis() < end) {
+        int result = socket->readAvailable(buffer, 10, 2 + total, 8 - total);
+        CPPUNIT_ASSERT(result != -1);
+        if (result == 0) {
+            Thread::sleep(10);
+        }
+        total += result;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(4, total);
+    CPPUNIT_ASSERT(std::equal(data, data + 4, buffer + 2));
+
+    pair.client->shutdownOutput();
+
+    int result = 0;
+    end = System::currentTimeMillis() + 2000;
+    while ((result = socket->readAvailable(buffer, 10, 0, 10)) == 0 && System::currentTimeMillis() < end) {
+        Thread::sleep(10);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(-1, result);
+}
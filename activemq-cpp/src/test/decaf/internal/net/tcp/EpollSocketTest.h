@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_TCP_EPOLLSOCKETTEST_H_
+#define _DECAF_INTERNAL_NET_TCP_EPOLLSOCKETTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+
+    class EpollSocketTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( EpollSocketTest );
+        CPPUNIT_TEST( testConnectAndExchange );
+        CPPUNIT_TEST( testLargeWrite );
+        CPPUNIT_TEST( testEndOfStream );
+        CPPUNIT_TEST( testReadTimeout );
+        CPPUNIT_TEST( testCloseWakesBlockedReader );
+        CPPUNIT_TEST( testConnectRefused );
+        CPPUNIT_TEST( testOptions );
+        CPPUNIT_TEST( testBindHostName );
+        CPPUNIT_TEST( testReadAvailable );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        EpollSocketTest() {}
+        virtual ~EpollSocketTest() {}
+
+        void testConnectAndExchange();
+        void testLargeWrite();
+        void testEndOfStream();
+        void testReadTimeout();
+        void testCloseWakesBlockedReader();
+        void testConnectRefused();
+        void testOptions();
+        void testBindHostName();
+        void testReadAvailable();
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_NET_TCP_EPOLLSOCKETTEST_H_ */
@@ -78,6 +78,26 @@ void ByteArrayOutputStreamTest::testToByteArray() {
     delete [] array.first;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayOutputStreamTest::testToByteArrayRef() {
+    ByteArrayOutputStream baos;
+    baos.write( (unsigned char*)&testString[0], (int)testString.size(), 0, (int)testString.length() );
+    std::pair<unsigned char*, int> array = baos.toByteArrayRef();
+    CPPUNIT_ASSERT_EQUAL( (int)testString.length(), array.second );
+    for( std::size_t i = 0; i < testString.length(); i++) {
+        CPPUNIT_ASSERT_MESSAGE("Error in byte array", array.first[i] == testString.at(i) );
+    }
+
+    // The array is the stream's own buffer so changes to it are visible.
+    array.first[0] = 'X';
+    CPPUNIT_ASSERT_MESSAGE( "Array was not the internal buffer",
+                            baos.toString() == "X" + testString.substr(1) );
+
+    baos.reset();
+    array = baos.toByteArrayRef();
+    CPPUNIT_ASSERT_EQUAL( 0, array.second );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ByteArrayOutputStreamTest::testToString() {
 
@@ -162,3 +182,29 @@ void ByteArrayOutputStreamTest::testStream()
 
     CPPUNIT_ASSERT( std::string((const char*)buffer) == std::string("abc") );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayOutputStreamTest::testTrimToSize() {
+
+    ByteArrayOutputStream baos;
+    baos.write( (unsigned char*)&testString[0], (int)testString.size(), 0, (int)testString.length() );
+
+    // The written bytes don't fit so nothing changes.
+    baos.trimToSize( 8 );
+    CPPUNIT_ASSERT_EQUAL( testString, baos.toString() );
+
+    baos.reset();
+    baos.trimToSize( 8 );
+    baos.write( (unsigned char*)&testString[0], (int)testString.size(), 0, (int)testString.length() );
+    CPPUNIT_ASSERT_EQUAL( testString, baos.toString() );
+
+    baos.reset();
+    baos.write( (unsigned char*)&testString[0], (int)testString.size(), 0, 4 );
+    baos.trimToSize( 8 );
+    CPPUNIT_ASSERT_EQUAL( testString.substr( 0, 4 ), baos.toString() );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        baos.trimToSize( 0 ),
+        decaf::lang::exceptions::IllegalArgumentException );
+}
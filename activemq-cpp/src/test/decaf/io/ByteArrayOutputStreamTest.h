@@ -36,6 +36,8 @@ namespace io{
         CPPUNIT_TEST( testReset );
         CPPUNIT_TEST( testSize );
         CPPUNIT_TEST( testToByteArray );
+        CPPUNIT_TEST( testToByteArrayRef );
+        CPPUNIT_TEST( testTrimToSize );
         CPPUNIT_TEST( testToString );
         CPPUNIT_TEST( testWrite1 );
         CPPUNIT_TEST( testWrite2 );
@@ -61,6 +63,8 @@ namespace io{
         void testReset();
         void testSize();
         void testToByteArray();
+        void testToByteArrayRef();
+        void testTrimToSize();
         void testToString();
         void testWrite1();
         void testWrite2();
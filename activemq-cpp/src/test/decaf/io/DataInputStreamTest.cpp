@@ -587,6 +587,28 @@ void DataInputStreamTest::testHelper( unsigned char* input, int inputLength,
 ////////////////////////////////////////////////////////////////////////////////
 void DataInputStreamTest::testUTFDecoding() {
 
+    // Test data with a run of plain ASCII longer than a machine word.
+    {
+        unsigned char expect[] = {0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64};
+        unsigned char input[] = { 0x00, 0x0B, 0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64};
+
+        ByteArrayInputStream myStream( input, (int) sizeof(input) / (int) sizeof(unsigned char) );
+        DataInputStream reader( &myStream );
+
+        CPPUNIT_ASSERT_EQUAL( std::string( (char*) expect, sizeof(expect) ), reader.readUTF() );
+    }
+
+    // Test data with plain ASCII followed by 2-byte UTF8 encoding and an embedded NULL.
+    {
+        unsigned char expect[] = {0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64, 0xC2, 0x21, 0x00, 0x21};
+        unsigned char input[] = { 0x00, 0x11, 0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64, 0xC3, 0x82, 0x21, 0xC0, 0x80, 0x21};
+
+        ByteArrayInputStream myStream( input, (int) sizeof(input) / (int) sizeof(unsigned char) );
+        DataInputStream reader( &myStream );
+
+        CPPUNIT_ASSERT_EQUAL( std::string( (char*) expect, sizeof(expect) ), reader.readUTF() );
+    }
+
     // Test data with 1-byte UTF8 encoding.
     {
         unsigned char expect[] = {0x00, 0x0B, 0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64};
@@ -554,3 +554,123 @@ void PointerTest::testThreadSafety() {
         thread[i]->join();
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class CountedValue {
+    public:
+
+        static int liveCount;
+
+        CountedValue() {
+            liveCount++;
+        }
+
+        ~CountedValue() {
+            liveCount--;
+        }
+    };
+
+    int CountedValue::liveCount = 0;
+
+    class CopyingThread : public Thread {
+    private:
+
+        CountDownLatch* latch;
+        const Pointer<CountedValue>* source;
+        std::vector< Pointer<CountedValue> > copies;
+
+    private:
+
+        CopyingThread(const CopyingThread&);
+        CopyingThread& operator= (const CopyingThread&);
+
+    public:
+
+        CopyingThread(CountDownLatch* start, const Pointer<CountedValue>* source) :
+            Thread(), latch(start), source(source), copies() {}
+
+        virtual ~CopyingThread() {}
+
+        virtual void run() {
+            latch->await();
+            for (int i = 0; i < 100; ++i) {
+                copies.push_back(*source);
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PointerTest::testConcurrentFirstCopy() {
+
+    const int NUM_THREADS = 8;
+
+    for (int iteration = 0; iteration < 50; ++iteration) {
+
+        CountDownLatch start(1);
+        std::vector< Pointer<CopyingThread> > threads;
+
+        {
+            // Until it is copied the Pointer holds no shared count, all the threads
+            // race to create it.
+            Pointer<CountedValue> value(new CountedValue());
+
+            for (int i = 0; i < NUM_THREADS; ++i) {
+                threads.push_back(Pointer<CopyingThread>(new CopyingThread(&start, &value)));
+                threads.back()->start();
+            }
+
+            start.countDown();
+
+            for (int i = 0; i < NUM_THREADS; ++i) {
+                threads[i]->join();
+            }
+
+            CPPUNIT_ASSERT_EQUAL(1, CountedValue::liveCount);
+        }
+
+        // The copies held by the threads keep the value alive.
+        CPPUNIT_ASSERT_EQUAL(1, CountedValue::liveCount);
+        threads.clear();
+        CPPUNIT_ASSERT_EQUAL(0, CountedValue::liveCount);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PointerTest::testReleaseUnshared() {
+
+    {
+        Pointer<CountedValue> empty;
+        Pointer<CountedValue> copy(empty);
+        CPPUNIT_ASSERT(copy == NULL);
+    }
+
+    {
+        Pointer<CountedValue> value(new CountedValue());
+        CPPUNIT_ASSERT_EQUAL(1, CountedValue::liveCount);
+
+        // Taking ownership back from a Pointer that was never shared.
+        CountedValue* raw = value.release();
+        CPPUNIT_ASSERT(value == NULL);
+        CPPUNIT_ASSERT_EQUAL(1, CountedValue::liveCount);
+        delete raw;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, CountedValue::liveCount);
+
+    {
+        Pointer<CountedValue> value(new CountedValue());
+        Pointer<CountedValue> other;
+
+        other = value;
+        value.reset();
+        CPPUNIT_ASSERT_EQUAL(1, CountedValue::liveCount);
+
+        other.reset(new CountedValue());
+        CPPUNIT_ASSERT_EQUAL(1, CountedValue::liveCount);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, CountedValue::liveCount);
+}
@@ -37,6 +37,8 @@ namespace lang {
         CPPUNIT_TEST( testReturnByValue );
         CPPUNIT_TEST( testDynamicCast );
         CPPUNIT_TEST( testThreadSafety );
+        CPPUNIT_TEST( testConcurrentFirstCopy );
+        CPPUNIT_TEST( testReleaseUnshared );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -54,6 +56,8 @@ namespace lang {
         void testReturnByValue();
         void testDynamicCast();
         void testThreadSafety();
+        void testConcurrentFirstCopy();
+        void testReleaseUnshared();
 
     };
 
@@ -17,10 +17,83 @@
 
 #include "ConcurrentHashMapTest.h"
 
+#include <decaf/util/concurrent/ConcurrentHashMap.h>
+#include <decaf/util/concurrent/ConcurrentStlMap.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/util/HashMap.h>
+#include <decaf/util/StlMap.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+
+#include <memory>
+#include <string>
+
 using namespace std;
 using namespace decaf;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int MAP_SIZE = 1000;
+
+    void populateMap(ConcurrentHashMap<int, std::string>& map) {
+        for (int i = 0; i < MAP_SIZE; ++i) {
+            map.put(i, Integer::toString(i));
+        }
+    }
+
+    class MapUpdater : public Thread {
+    private:
+
+        ConcurrentHashMap<int, int>* map;
+        AtomicInteger* sharedInserts;
+        int base;
+
+    private:
+
+        MapUpdater(const MapUpdater&);
+        MapUpdater& operator= (const MapUpdater&);
+
+    public:
+
+        bool failed;
+
+        MapUpdater(ConcurrentHashMap<int, int>* map, AtomicInteger* sharedInserts, int base) :
+            Thread(), map(map), sharedInserts(sharedInserts), base(base), failed(false) {
+        }
+
+        virtual ~MapUpdater() {}
+
+        virtual void run() {
+            for (int i = 0; i < MAP_SIZE; ++i) {
+                map->put(base + i, i);
+
+                // Every thread races to claim the same shared keys.
+                if (map->putIfAbsent(-1 - (i % 100), base)) {
+                    sharedInserts->incrementAndGet();
+                }
+            }
+
+            for (int i = 0; i < MAP_SIZE; ++i) {
+                if (map->get(base + i) != i) {
+                    failed = true;
+                }
+                if (i % 2 == 0 && !map->remove(base + i, i)) {
+                    failed = true;
+                }
+            }
+        }
+    };
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 ConcurrentHashMapTest::ConcurrentHashMapTest() {
@@ -33,4 +106,434 @@ ConcurrentHashMapTest::~ConcurrentHashMapTest() {
 ////////////////////////////////////////////////////////////////////////////////
 void ConcurrentHashMapTest::testConstructor() {
 
+    ConcurrentHashMap<string, int> map1;
+    CPPUNIT_ASSERT(map1.isEmpty());
+    CPPUNIT_ASSERT(map1.size() == 0);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw a NoSuchElementException",
+        map1.get("TEST"),
+        decaf::util::NoSuchElementException);
+
+    HashMap<string, int> srcMap;
+    srcMap.put("A", 1);
+    srcMap.put("B", 1);
+    srcMap.put("C", 1);
+
+    ConcurrentHashMap<string, int> destMap(srcMap);
+
+    CPPUNIT_ASSERT(srcMap.size() == 3);
+    CPPUNIT_ASSERT(destMap.size() == 3);
+    CPPUNIT_ASSERT(destMap.get("B") == 1);
+
+    ConcurrentHashMap<int, int> single(0, 0.75f, 1);
+    single.put(1, 1);
+    CPPUNIT_ASSERT_EQUAL(1, single.get(1));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalArgumentException",
+        (ConcurrentHashMap<int, int>(-1)),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalArgumentException",
+        (ConcurrentHashMap<int, int>(16, 0.0f, 16)),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalArgumentException",
+        (ConcurrentHashMap<int, int>(16, 0.75f, 0)),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testConstructorMap() {
+
+    ConcurrentHashMap<int, int> myMap;
+    for (int counter = 0; counter < 125; counter++) {
+        myMap.put(counter, counter);
+    }
+
+    ConcurrentHashMap<int, int> map(myMap);
+    CPPUNIT_ASSERT_EQUAL(125, map.size());
+    for (int counter = 0; counter < 125; counter++) {
+        CPPUNIT_ASSERT_MESSAGE("Failed to construct correct ConcurrentHashMap",
+            myMap.get(counter) == map.get(counter));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testContainsKey() {
+
+    ConcurrentHashMap<string, bool> boolMap;
+    CPPUNIT_ASSERT(boolMap.containsKey("bob") == false);
+
+    boolMap.put("bob", true);
+
+    CPPUNIT_ASSERT(boolMap.containsKey("bob") == true);
+    CPPUNIT_ASSERT(boolMap.containsKey("fred") == false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testClear() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, map.size());
+
+    map.clear();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Clear failed to reset size", 0, map.size());
+    CPPUNIT_ASSERT(map.isEmpty());
+    for (int i = 0; i < MAP_SIZE; i++) {
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Failed to clear all elements",
+            map.get(i),
+            NoSuchElementException);
+    }
+
+    // The map can be refilled after being cleared.
+    populateMap(map);
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, map.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testCopy() {
+
+    ConcurrentHashMap<string, int> destMap;
+    StlMap<string, int> srcMap;
+    ConcurrentHashMap<string, int> srcMap2;
+
+    srcMap.put("A", 1);
+    srcMap.put("B", 2);
+    srcMap.put("C", 3);
+
+    destMap.copy(srcMap);
+    CPPUNIT_ASSERT_EQUAL(3, destMap.size());
+    CPPUNIT_ASSERT(destMap.get("A") == 1);
+    CPPUNIT_ASSERT(destMap.get("C") == 3);
+
+    destMap.copy(srcMap2);
+    CPPUNIT_ASSERT_EQUAL(0, destMap.size());
+
+    srcMap2.put("D", 4);
+    srcMap2.put("E", 5);
+
+    destMap.copy(srcMap2);
+    CPPUNIT_ASSERT_EQUAL(2, destMap.size());
+    CPPUNIT_ASSERT(destMap.get("E") == 5);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testEquals() {
+
+    ConcurrentHashMap<int, std::string> map1;
+    ConcurrentStlMap<int, std::string> map2;
+
+    populateMap(map1);
+    for (int i = 0; i < MAP_SIZE; ++i) {
+        map2.put(i, Integer::toString(i));
+    }
+
+    CPPUNIT_ASSERT(map1.equals(map2));
+    CPPUNIT_ASSERT(map1.equals(map1));
+
+    map2.put(0, "zero");
+    CPPUNIT_ASSERT(!map1.equals(map2));
+
+    map2.remove(0);
+    CPPUNIT_ASSERT(!map1.equals(map2));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testPut() {
+
+    ConcurrentHashMap<string, int> map;
+
+    CPPUNIT_ASSERT(map.put("A", 1) == false);
+    CPPUNIT_ASSERT(map.put("A", 2) == true);
+    CPPUNIT_ASSERT_EQUAL(2, map.get("A"));
+
+    int oldValue = 0;
+    CPPUNIT_ASSERT(map.put("A", 3, oldValue) == true);
+    CPPUNIT_ASSERT_EQUAL(2, oldValue);
+    CPPUNIT_ASSERT(map.put("B", 4, oldValue) == false);
+    CPPUNIT_ASSERT_EQUAL(2, map.size());
+
+    // The reference returned from get can be used to update the value in place.
+    map.get("B") = 5;
+    CPPUNIT_ASSERT_EQUAL(5, map.get("B"));
+
+    int copy = 0;
+    CPPUNIT_ASSERT(map.get("B", copy));
+    CPPUNIT_ASSERT_EQUAL(5, copy);
+    CPPUNIT_ASSERT(!map.get("C", copy));
+    CPPUNIT_ASSERT_EQUAL(5, copy);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testRemove() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("1"), map.remove(1));
+    CPPUNIT_ASSERT(!map.containsKey(1));
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE - 1, map.size());
+
+    // Removing an unmapped key returns a default value.
+    CPPUNIT_ASSERT_EQUAL(std::string(), map.remove(1));
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE - 1, map.size());
+
+    for (int i = 0; i < MAP_SIZE; ++i) {
+        map.remove(i);
+    }
+    CPPUNIT_ASSERT(map.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testContainsValue() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    CPPUNIT_ASSERT(map.containsValue("876"));
+    CPPUNIT_ASSERT(!map.containsValue("No Such Value"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testPutIfAbsent() {
+
+    ConcurrentHashMap<int, std::string> map;
+
+    CPPUNIT_ASSERT(map.putIfAbsent(1, "one"));
+    CPPUNIT_ASSERT(!map.putIfAbsent(1, "uno"));
+    CPPUNIT_ASSERT_EQUAL(std::string("one"), map.get(1));
+    CPPUNIT_ASSERT_EQUAL(1, map.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testRemoveIfMapped() {
+
+    ConcurrentHashMap<int, std::string> map;
+    map.put(1, "one");
+
+    CPPUNIT_ASSERT(!map.remove(1, "uno"));
+    CPPUNIT_ASSERT(map.containsKey(1));
+    CPPUNIT_ASSERT(!map.remove(2, "one"));
+    CPPUNIT_ASSERT(map.remove(1, "one"));
+    CPPUNIT_ASSERT(!map.containsKey(1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testReplace() {
+
+    ConcurrentHashMap<int, std::string> map;
+    map.put(1, "one");
+
+    CPPUNIT_ASSERT(!map.replace(1, "uno", "eins"));
+    CPPUNIT_ASSERT(map.replace(1, "one", "eins"));
+    CPPUNIT_ASSERT_EQUAL(std::string("eins"), map.get(1));
+
+    CPPUNIT_ASSERT_EQUAL(std::string("eins"), map.replace(1, "un"));
+    CPPUNIT_ASSERT_EQUAL(std::string("un"), map.get(1));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw a NoSuchElementException",
+        map.replace(2, "deux"),
+        NoSuchElementException);
+    CPPUNIT_ASSERT(!map.containsKey(2));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testEntrySet() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    Set< MapEntry<int, std::string> >& entries = map.entrySet();
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, entries.size());
+    CPPUNIT_ASSERT(entries.contains(MapEntry<int, std::string>(5, "5")));
+    CPPUNIT_ASSERT(!entries.contains(MapEntry<int, std::string>(5, "6")));
+
+    CPPUNIT_ASSERT(entries.remove(MapEntry<int, std::string>(5, "5")));
+    CPPUNIT_ASSERT(!map.containsKey(5));
+
+    std::auto_ptr< Iterator< MapEntry<int, std::string> > > iterator(entries.iterator());
+    int count = 0;
+    while (iterator->hasNext()) {
+        MapEntry<int, std::string> entry = iterator->next();
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(entry.getKey()), entry.getValue());
+        count++;
+    }
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE - 1, count);
+
+    const ConcurrentHashMap<int, std::string>& constMap = map;
+    std::auto_ptr< Iterator< MapEntry<int, std::string> > > constIterator(constMap.entrySet().iterator());
+    constIterator->next();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an UnsupportedOperationException",
+        constIterator->remove(),
+        UnsupportedOperationException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testKeySetIterator() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    StlMap<int, bool> seen;
+
+    std::auto_ptr< Iterator<int> > iterator(map.keySet().iterator());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalStateException",
+        iterator->remove(),
+        IllegalStateException);
+
+    while (iterator->hasNext()) {
+        int key = iterator->next();
+        CPPUNIT_ASSERT(!seen.containsKey(key));
+        seen.put(key, true);
+
+        if (key % 2 == 0) {
+            iterator->remove();
+        }
+    }
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw a NoSuchElementException",
+        iterator->next(),
+        NoSuchElementException);
+
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, seen.size());
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE / 2, map.size());
+    CPPUNIT_ASSERT(!map.containsKey(10));
+    CPPUNIT_ASSERT(map.containsKey(11));
+
+    CPPUNIT_ASSERT(map.keySet().remove(11));
+    CPPUNIT_ASSERT(!map.keySet().contains(11));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testValues() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    Collection<std::string>& values = map.values();
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, values.size());
+    CPPUNIT_ASSERT(values.contains("999"));
+
+    std::auto_ptr< Iterator<std::string> > iterator(values.iterator());
+    int count = 0;
+    while (iterator->hasNext()) {
+        std::string value = iterator->next();
+        CPPUNIT_ASSERT(map.containsKey(Integer::parseInt(value)));
+        count++;
+    }
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, count);
+
+    values.clear();
+    CPPUNIT_ASSERT(map.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testIteratorWhileModified() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    // Unlike the other maps, changes made while iterating do not invalidate the iterator.
+    std::auto_ptr< Iterator<int> > iterator(map.keySet().iterator());
+    int count = 0;
+    while (iterator->hasNext()) {
+        int key = iterator->next();
+        map.remove(key);
+        map.put(key + MAP_SIZE, Integer::toString(key));
+        count++;
+    }
+
+    CPPUNIT_ASSERT(count >= MAP_SIZE);
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, map.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testGrowKeepsReferences() {
+
+    ConcurrentHashMap<int, int> map(1, 0.75f, 2);
+    map.put(0, 0);
+    int& value = map.get(0);
+
+    for (int i = 1; i < MAP_SIZE * 10; ++i) {
+        map.put(i, i);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE * 10, map.size());
+    value = 42;
+    CPPUNIT_ASSERT_EQUAL(42, map.get(0));
+
+    for (int i = 1; i < MAP_SIZE * 10; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, map.get(i));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testPointerKeys() {
+
+    ConcurrentHashMap<Pointer<std::string>, int,
+                      HashCode< Pointer<std::string> >,
+                      PointerComparator<std::string> > map;
+
+    Pointer<std::string> key1(new std::string("key"));
+    Pointer<std::string> key2(new std::string("key"));
+    Pointer<std::string> other(new std::string("other"));
+
+    // Keys are matched on the value they point to, not the pointer.
+    map.put(key1, 1);
+    CPPUNIT_ASSERT(map.containsKey(key2));
+    CPPUNIT_ASSERT(!map.containsKey(other));
+
+    CPPUNIT_ASSERT(map.put(key2, 2));
+    CPPUNIT_ASSERT_EQUAL(1, map.size());
+    CPPUNIT_ASSERT_EQUAL(2, map.get(key1));
+
+    CPPUNIT_ASSERT_EQUAL(2, map.remove(key2));
+    CPPUNIT_ASSERT(map.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testConcurrentUpdates() {
+
+    static const int NUM_THREADS = 8;
+
+    ConcurrentHashMap<int, int> map;
+    AtomicInteger sharedInserts;
+
+    std::vector<MapUpdater*> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.push_back(new MapUpdater(&map, &sharedInserts, (i + 1) * MAP_SIZE));
+    }
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads[i]->start();
+    }
+
+    bool failed = false;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads[i]->join();
+        failed |= threads[i]->failed;
+        delete threads[i];
+    }
+
+    CPPUNIT_ASSERT(!failed);
+
+    // Each shared key is claimed by exactly one thread.
+    CPPUNIT_ASSERT_EQUAL(100, sharedInserts.get());
+    CPPUNIT_ASSERT_EQUAL(NUM_THREADS * MAP_SIZE / 2 + 100, map.size());
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        int base = (i + 1) * MAP_SIZE;
+        CPPUNIT_ASSERT(!map.containsKey(base));
+        CPPUNIT_ASSERT_EQUAL(1, map.get(base + 1));
+    }
 }
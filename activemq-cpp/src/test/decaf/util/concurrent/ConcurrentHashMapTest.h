@@ -29,6 +29,24 @@ namespace concurrent {
 
         CPPUNIT_TEST_SUITE( ConcurrentHashMapTest );
         CPPUNIT_TEST( testConstructor );
+        CPPUNIT_TEST( testConstructorMap );
+        CPPUNIT_TEST( testContainsKey );
+        CPPUNIT_TEST( testClear );
+        CPPUNIT_TEST( testCopy );
+        CPPUNIT_TEST( testEquals );
+        CPPUNIT_TEST( testPut );
+        CPPUNIT_TEST( testRemove );
+        CPPUNIT_TEST( testContainsValue );
+        CPPUNIT_TEST( testPutIfAbsent );
+        CPPUNIT_TEST( testRemoveIfMapped );
+        CPPUNIT_TEST( testReplace );
+        CPPUNIT_TEST( testEntrySet );
+        CPPUNIT_TEST( testKeySetIterator );
+        CPPUNIT_TEST( testValues );
+        CPPUNIT_TEST( testIteratorWhileModified );
+        CPPUNIT_TEST( testGrowKeepsReferences );
+        CPPUNIT_TEST( testPointerKeys );
+        CPPUNIT_TEST( testConcurrentUpdates );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -37,6 +55,24 @@ namespace concurrent {
         virtual ~ConcurrentHashMapTest();
 
         void testConstructor();
+        void testConstructorMap();
+        void testContainsKey();
+        void testClear();
+        void testCopy();
+        void testEquals();
+        void testPut();
+        void testRemove();
+        void testContainsValue();
+        void testPutIfAbsent();
+        void testRemoveIfMapped();
+        void testReplace();
+        void testEntrySet();
+        void testKeySetIterator();
+        void testValues();
+        void testIteratorWhileModified();
+        void testGrowKeepsReferences();
+        void testPointerKeys();
+        void testConcurrentUpdates();
     };
 
 }}}
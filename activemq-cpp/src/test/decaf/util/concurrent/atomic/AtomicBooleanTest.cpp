@@ -53,6 +53,16 @@ void AtomicBooleanTest::testGetSet() {
     CPPUNIT_ASSERT( true == ai.get() );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void AtomicBooleanTest::testLazySet() {
+    AtomicBoolean ai( true );
+    CPPUNIT_ASSERT( true == ai.getAcquire() );
+    ai.lazySet( false );
+    CPPUNIT_ASSERT( false == ai.getAcquire() );
+    ai.lazySet( true );
+    CPPUNIT_ASSERT( true == ai.get() );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicBooleanTest::testCompareAndSet() {
     AtomicBoolean ai( true );
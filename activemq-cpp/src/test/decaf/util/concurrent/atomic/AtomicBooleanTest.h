@@ -32,6 +32,7 @@ namespace atomic {
         CPPUNIT_TEST( testConstructor );
         CPPUNIT_TEST( testConstructor2 );
         CPPUNIT_TEST( testGetSet );
+        CPPUNIT_TEST( testLazySet );
         CPPUNIT_TEST( testCompareAndSet );
         CPPUNIT_TEST( testCompareAndSetInMultipleThreads );
         CPPUNIT_TEST( testGetAndSet );
@@ -46,6 +47,7 @@ namespace atomic {
         void testConstructor();
         void testConstructor2();
         void testGetSet();
+        void testLazySet();
         void testCompareAndSet();
         void testCompareAndSetInMultipleThreads();
         void testGetAndSet();
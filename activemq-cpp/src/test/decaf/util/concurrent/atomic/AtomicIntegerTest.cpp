@@ -49,6 +49,16 @@ void AtomicIntegerTest::testGetSet() {
     CPPUNIT_ASSERT( 6 == ai.get() );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void AtomicIntegerTest::testLazySet() {
+    AtomicInteger ai( 2 );
+    CPPUNIT_ASSERT( 2 == ai.getAcquire() );
+    ai.lazySet( 5 );
+    CPPUNIT_ASSERT( 5 == ai.getAcquire() );
+    ai.lazySet( 6 );
+    CPPUNIT_ASSERT( 6 == ai.get() );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicIntegerTest::testCompareAndSet() {
     AtomicInteger ai( 25 );
@@ -54,6 +54,18 @@ void AtomicReferenceTest::testGetSet() {
     CPPUNIT_ASSERT( 6 == *( ai.get() ) );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void AtomicReferenceTest::testLazySet() {
+    int value1 = 2;
+    AtomicReference<int> ai( &value1 );
+    CPPUNIT_ASSERT( 2 == *( ai.get() ) );
+    int value2 = 5;
+    ai.lazySet( &value2 );
+    CPPUNIT_ASSERT( 5 == *( ai.get() ) );
+    ai.lazySet( NULL );
+    CPPUNIT_ASSERT( ai.get() == NULL );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicReferenceTest::testCompareAndSet() {
     int value1 = 25;
@@ -22,6 +22,8 @@
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::commands::BrokerInfoTest );
 #include <activemq/commands/BrokerIdTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::commands::BrokerIdTest );
+#include <activemq/commands/MessageIdTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::commands::MessageIdTest );
 #include <activemq/commands/ActiveMQTopicTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::commands::ActiveMQTopicTest );
 #include <activemq/commands/ActiveMQTextMessageTest.h>
@@ -52,6 +54,8 @@ CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::marshal::Primit
 
 #include <activemq/wireformat/openwire/utils/BooleanStreamTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::utils::BooleanStreamTest );
+#include <activemq/wireformat/openwire/utils/FrameDataInputStreamTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::utils::FrameDataInputStreamTest );
 #include <activemq/wireformat/openwire/utils/HexTableTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::utils::HexTableTest );
 #include <activemq/wireformat/openwire/utils/MessagePropertyInterceptorTest.h>
@@ -60,6 +64,8 @@ CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::utils::MessageP
 #include <activemq/wireformat/openwire/OpenWireFormatTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::OpenWireFormatTest );
 
+#include <activemq/wireformat/stomp/StompFrameReaderTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::stomp::StompFrameReaderTest );
 #include <activemq/wireformat/stomp/StompHelperTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::stomp::StompHelperTest );
 #include <activemq/wireformat/stomp/StompWireFormatTest.h>
@@ -92,6 +98,12 @@ CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::SimplePriorityMessageDispatchCh
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::ActiveMQMessageAuditTest );
 #include <activemq/core/ConnectionAuditTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::ConnectionAuditTest );
+#include <activemq/core/DeliveredMessageListTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::DeliveredMessageListTest );
+#include <activemq/core/AdaptivePrefetchControllerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::AdaptivePrefetchControllerTest );
+#include <activemq/core/AckCoalescerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::AckCoalescerTest );
 
 #include <activemq/state/ConnectionStateTrackerTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::state::ConnectionStateTrackerTest );
@@ -154,8 +166,12 @@ CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::MarshallingSupportTest );
 
 #include <activemq/threads/SchedulerTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::SchedulerTest );
+#include <activemq/threads/TimerWheelTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::TimerWheelTest );
 #include <activemq/threads/DedicatedTaskRunnerTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::DedicatedTaskRunnerTest );
+#include <activemq/threads/PooledTaskRunnerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::PooledTaskRunnerTest );
 #include <activemq/threads/CompositeTaskRunnerTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::CompositeTaskRunnerTest );
 
@@ -191,6 +207,10 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::nio::ShortArrayBufferTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::URIEncoderDecoderTest );
 #include <decaf/internal/net/URIHelperTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::URIHelperTest );
+#include <decaf/internal/net/tcp/EpollSelectorTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::tcp::EpollSelectorTest );
+#include <decaf/internal/net/tcp/EpollSocketTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::tcp::EpollSocketTest );
 
 #include <decaf/nio/BufferTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::nio::BufferTest );